@@ -0,0 +1,1502 @@
+/**
+ * @file qs1r_bench.cpp
+ * @brief Per-block microbenchmarks for the receive chain.
+ *
+ * Runs each processing class on synthetic IQ (a tone in noise) at block
+ * sizes 256 .. 16384 and at every processing rate the server supports, and
+ * reports what one sample costs. Stages after the down converter run at the
+ * post processing rate that proc rate decimates to, the way QsDspProcessor
+ * drives them.
+ *
+ * Features:
+ * - QsDownConvertor, the QsFrontEnd over 1 .. N worker threads,
+ *   QsMainRxFilter, QsPostRxFilter, the manual notches (QsBiquadCascade
+ *   against as many QS_IIR objects, 0 / 1 / 4 / 8 enabled), QsAgc, the AM,
+ *   SAM and FM demodulators, NR / ANF, Resampler, QsFFT and every QsSimd
+ *   kernel table the CPU supports
+ * - QsNco LO mixing on interleaved Cpx against split planes
+ * - NR and ANF over every adaptive algorithm (NLMS, block LMS, FDAF) at
+ *   32 .. 512 taps, delay taps / 2
+ * - ns/sample, Msamples/s and the real-time factor: the fraction of one core
+ *   the stage needs at its rate, so below 1.0 keeps up
+ * - Text table, or JSON (--json) for comparing builds and machines
+ * - --pipeline: the real QsDataReader -> QsDspProcessor -> DAC ring path fed
+ *   by a QsSyntheticSource, unpaced, swept over rate, demod mode and the
+ *   NR / ANF / NB / notch switches. Reports the sustained real-time factor,
+ *   CPU per thread per second of signal, ring overflows, how many
+ *   receivers the machine could carry, and per configuration the lowest
+ *   rate at which a real-time source would overflow the read-in ring
+ * - --perf (with --pipeline): hardware counters per DSP stage and for the
+ *   reader conversion, as cycles, IPC and cache / branch misses per sample
+ * - --alloc-check: the --pipeline sweep with QsAllocGuard in abort mode and
+ *   the settings changed while the DSP runs; any heap allocation on the
+ *   reader, DSP or DAC thread after warm-up aborts, and the run exits
+ *   non-zero. Needs a build with __ALLOC_GUARD__ (Debug)
+ * - --verify: every QsSimd table the CPU supports against the scalar one,
+ *   lengths 0 .. 69 and 4101, out of range and non-finite inputs included;
+ *   exits non-zero on a mismatch or a write past the length
+ *
+ * Usage:
+ * 1. cmake -S . -B build-rel -DCMAKE_BUILD_TYPE=Release
+ * 2. cmake --build build-rel --target qs1r_bench
+ * 3. qs1r_bench [--json] [--quick] [--filter <stage>] [--rate <hz>]
+ * 4. qs1r_bench --pipeline [--seconds <s>] [--json] [--rate <hz>] [--perf] [--fe-threads <n>]
+ * 5. qs1r_bench --verify
+ * 6. qs1r_bench --alloc-check [--quick] [--rate <hz>]
+ * 7. qs1r_bench --resampler-ref [--json] [--rate <hz>]
+ *
+ * Notes:
+ * - Each figure is the best of several trials of at least a few ms each.
+ * - In-place stages are fed a fresh copy of the input every call, so their
+ *   figures include one block copy.
+ * - FFT and kernel rows have no rate; their real-time factor is left out.
+ * - Pipeline runs use the server's block size and front end threads
+ *   (--fe-threads overrides the latter); the reader waits for ring space
+ *   instead of dropping, so throughput is what the DSP sustains. "other"
+ *   CPU is the front end workers.
+ * - NB and ANF are only swept when built in (__NOISE_BLANKERS__,
+ *   __AUTO_NOTCH__).
+ * - The iir stage times QsBiquadCascade directly. The DSP chain runs it only
+ *   in an __IIR_NOTCH__ build; the default build notches in the frequency
+ *   domain (QsSpectralNotches, part of main_filter).
+ * - --perf needs perf_event_open on the bench's own threads
+ *   (kernel.perf_event_paranoid <= 2) and a PMU; without, the pipeline
+ *   runs as usual and the reason is printed. Counter reads add a syscall
+ *   per stage, so rtf and CPU figures of a --perf run read high.
+ * - The default build type is Debug (-O0); bench a Release build.
+ * - --verify holds the element-wise kernels to bit equality.
+ *   multiplyCpx, multiplySplit and dotProduct may fuse or reorder, so they
+ *   are held to a few float ulps of the operand magnitudes.
+ * - --resampler-ref measures every Resampler tier from each post rate to
+ *   the audio rate: ns per output, passband ripple and worst residual over
+ *   tones up to 0.35 of the lower rate, and the worst alias of tones
+ *   between the two Nyquist rates. SRC_SINC_BEST_QUALITY is measured the
+ *   same way when the bench is configured with -DQS_RESAMPLER_REF=ON
+ *   (needs libsamplerate; the server does not link it).
+ */
+
+#include "../include/config.h"
+#include "../include/json.hpp"
+#include "../include/qs_agc.hpp"
+#include "../include/qs_alloc_guard.hpp"
+#include "../include/qs_am_demod.hpp"
+#include "../include/qs_arena.hpp"
+#include "../include/qs_auto_notch_filter.hpp"
+#include "../include/qs_biquad_cascade.hpp"
+#include "../include/qs_defaults.hpp"
+#include "../include/qs_defines.hpp"
+#include "../include/qs_downcnv.hpp"
+#include "../include/qs_fft.hpp"
+#include "../include/qs_fm_demod.hpp"
+#include "../include/qs_frontend.hpp"
+#include "../include/qs_globals.hpp"
+#include "../include/qs_iir_filter.hpp"
+#include "../include/qs_main_rx_filter.hpp"
+#include "../include/qs_nco.hpp"
+#include "../include/qs_nr_filter.hpp"
+#include "../include/qs_perf_counters.hpp"
+#include "../include/qs_post_rx_filter.hpp"
+#include "../include/qs_resampler.hpp"
+#include "../include/qs_sam_demod.hpp"
+#include "../include/qs_simd.hpp"
+#include "../include/qs_synth_source.hpp"
+#include "../include/qs_threading.hpp"
+#include "../include/qs_tone_gen.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cfloat>
+#include <climits>
+#include <cmath>
+#include <cstdint>
+#include <cstdio>
+#include <cstring>
+#include <functional>
+#include <iostream>
+#include <limits>
+#include <memory>
+#include <random>
+#include <set>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include <time.h>
+
+#ifdef __LIBSAMPLERATE_REF__
+#include <samplerate.h>
+#endif
+
+using json = nlohmann::json;
+
+static const double BENCH_RATES[] = {25000.0,  50000.0,   125000.0,  250000.0, 500000.0,
+                                     625000.0, 1250000.0, 1562500.0, 2500000.0};
+static const int BENCH_BLOCKS[] = {256, 512, 1024, 2048, 4096, 8192, 16384};
+static const int BENCH_QUICK_BLOCKS[] = {256, 4096, 16384};
+
+static const int BENCH_NOTCHES[] = {0, 1, 4, 8};
+static const int BENCH_ADAPT_TAPS[] = {32, 64, 128, 256, 512};
+static const struct {
+    QSADAPTALG alg;
+    const char *name;
+} BENCH_ADAPT_ALGS[] = {{adNlms, "nlms"}, {adBlockLms, "blocklms"}, {adFdaf, "fdaf"}};
+
+static const int BENCH_MAX_BLOCK = 16384;
+static const double BENCH_BANDWIDTH = 20000.0; // as QS1RServer plans the down converter
+
+struct BenchOptions {
+    bool json = false;
+    bool quick = false;
+    bool pipeline = false;
+    bool perf = false; // pipeline hardware counters
+    bool verify = false;
+    bool alloc_check = false; // pipeline with the allocation guard aborting
+    bool resampler_ref = false; // resampler tiers against libsamplerate
+    std::string filter;
+    double rate = 0.0;
+    int trials = 5;
+    double min_trial_ms = 20.0;
+    double seconds = 1.0; // pipeline measurement window
+    int fe_threads = 0;   // pipeline front end threads, 0 = server default
+};
+
+struct BenchResult {
+    std::string stage;
+    std::string variant;
+    double proc_rate; // rate the chain was planned for; 0 when rate free
+    double rate;      // rate the stage runs at; 0 when rate free
+    int block;
+    double ns_per_sample;
+};
+
+struct PipelineResult {
+    double proc_rate;
+    double post_rate;
+    std::string mode;
+    std::string features;
+    double rtf;        // wall time per second of signal
+    double cpu_reader; // CPU seconds per second of signal, per thread
+    double cpu_dsp;
+    double cpu_drain;
+    double cpu_other;
+    uint64_t overflow_readin; // samples dropped in the window, per ring
+    uint64_t overflow_sd;
+    uint64_t overflow_dac;
+    int receivers;
+    std::vector<QsPerfCounters::Row> perf; // reader, then DSP stages; --perf only
+};
+
+static BenchOptions g_opts;
+static std::vector<BenchResult> g_results;
+static std::vector<PipelineResult> g_pipeline;
+
+// ======== SYNTHETIC INPUT ===========
+
+// a tone at 0.1 of the rate, 20 dB over white noise, same every run
+static void makeSignal(Cpx *dst, int length) {
+    std::mt19937 gen(12345);
+    std::normal_distribution<float> noise(0.0f, 0.01f);
+    for (int i = 0; i < length; i++) {
+        double ph = TWO_PI * 0.1 * i;
+        dst[i] = Cpx(0.1f * std::cos(ph) + noise(gen), 0.1f * std::sin(ph) + noise(gen));
+    }
+}
+
+static void makeSignal(float *dst, int length) {
+    std::mt19937 gen(54321);
+    std::normal_distribution<float> noise(0.0f, 0.01f);
+    for (int i = 0; i < length; i++)
+        dst[i] = 0.1f * std::sin(TWO_PI * 0.1 * i) + noise(gen);
+}
+
+// ======== TIMING ===========
+
+static inline bool wanted(const std::string &stage) {
+    return g_opts.filter.empty() || stage == g_opts.filter;
+}
+
+// best time per call over the trials, each trial looping until min_trial_ms
+static double timeCall(const std::function<void()> &call) {
+    using clock = std::chrono::steady_clock;
+
+    // warm-up: first-call setup, caches, branch predictors
+    for (int i = 0; i < 3; i++)
+        call();
+
+    double best = 1e300;
+    for (int t = 0; t < g_opts.trials; t++) {
+        long iters = 0;
+        auto start = clock::now();
+        double elapsed = 0.0;
+        do {
+            call();
+            iters++;
+            elapsed = std::chrono::duration<double, std::nano>(clock::now() - start).count();
+        } while (elapsed < g_opts.min_trial_ms * 1e6);
+        best = std::min(best, elapsed / iters);
+    }
+    return best;
+}
+
+static void record(const std::string &stage, const std::string &variant, double proc_rate, double rate, int block,
+                   const std::function<void()> &call) {
+    BenchResult r{stage, variant, proc_rate, rate, block, timeCall(call) / block};
+    g_results.push_back(r);
+
+    if (!g_opts.json) {
+        char rtf[16] = "-";
+        if (r.rate > 0.0)
+            std::snprintf(rtf, sizeof(rtf), "%.4f", r.ns_per_sample * r.rate * 1e-9);
+        std::printf("%-14s %-22s %10.1f %10.1f %6d %10.3f %10.2f %8s\n", r.stage.c_str(), r.variant.c_str(),
+                    r.proc_rate, r.rate, r.block, r.ns_per_sample, 1e3 / r.ns_per_sample, rtf);
+        std::fflush(stdout);
+    }
+}
+
+static std::vector<int> blockSizes() {
+    if (g_opts.quick)
+        return std::vector<int>(std::begin(BENCH_QUICK_BLOCKS), std::end(BENCH_QUICK_BLOCKS));
+    return std::vector<int>(std::begin(BENCH_BLOCKS), std::end(BENCH_BLOCKS));
+}
+
+// ======== STAGES ===========
+
+static void benchDownConvertor(double proc_rate, const qs_vect_cpx &src) {
+    if (!wanted("downconvertor"))
+        return;
+
+    for (int n : blockSizes()) {
+        QsDownConvertor dc;
+        dc.setRate(proc_rate, BENCH_BANDWIDTH);
+        qs_vect_cpx in(src.begin(), src.begin() + n);
+        qs_vect_cpx out(n);
+        record("downconvertor", "plan", proc_rate, proc_rate, n, [&] { dc.process(&in[0], &out[0], n); });
+    }
+}
+
+// LO mix and decimation as QsDspProcessor runs them, over 1 .. N threads;
+// a count the rate or block cannot split for runs serially and is skipped
+static void benchFrontEnd(double proc_rate, const qs_vect_cpx &src) {
+    if (!wanted("frontend"))
+        return;
+
+    QsGlobal::g_memory->setDataProcRate(proc_rate);
+    const int cores = static_cast<int>(std::max(1u, std::thread::hardware_concurrency()));
+    for (int n : blockSizes()) {
+        for (int threads = 1; threads <= cores; threads++) {
+            QsToneGenerator tg;
+            tg.init(QsToneGenerator::rateDataRate);
+            QsFrontEnd fe;
+            fe.init(&tg, proc_rate, BENCH_BANDWIDTH, n, threads);
+            if (fe.threads() != threads)
+                continue;
+            // the serial chain decimates in place: a fresh copy for every count
+            qs_vect_cpx in(n);
+            qs_vect_cpx out(n);
+            record("frontend", "threads_" + std::to_string(threads), proc_rate, proc_rate, n, [&] {
+                std::memcpy(&in[0], &src[0], sizeof(Cpx) * n);
+                fe.process(&in[0], &out[0], n);
+            });
+        }
+    }
+}
+
+// everything QsDspProcessor runs at the post processing rate
+static void benchPostStages(double proc_rate, double post_rate, const qs_vect_cpx &src, const qs_vect_f &src_f) {
+    QsGlobal::g_memory->setDataProcRate(proc_rate);
+    QsGlobal::g_memory->setDataPostProcRate(post_rate);
+
+    for (int n : blockSizes()) {
+        qs_vect_cpx work(n);
+        qs_vect_f work_f(n);
+        auto fresh = [&] { std::memcpy(&work[0], &src[0], sizeof(Cpx) * n); };
+        auto fresh_f = [&] { std::memcpy(&work_f[0], &src_f[0], sizeof(float) * n); };
+
+        if (wanted("main_filter")) {
+            QsMainRxFilter filter;
+            filter.init(n);
+            record("main_filter", "ovlp_save", proc_rate, post_rate, n, [&] {
+                fresh();
+                filter.process(work);
+            });
+        }
+
+        if (wanted("post_filter")) {
+            QsPostRxFilter filter;
+            filter.init(n);
+            record("post_filter", "ovlp_save", proc_rate, post_rate, n, [&] {
+                fresh();
+                filter.process(work);
+            });
+        }
+
+        if (wanted("iir")) {
+            QsMemory &mem = *QsGlobal::g_memory;
+            for (int notches : BENCH_NOTCHES) {
+                for (int i = 0; i < MAX_MAN_NOTCHES; i++) {
+                    mem.setNotchEnabled(i, i < notches);
+                    mem.setNotchFrequency(i, 600.0f + 300.0f * i);
+                }
+
+                QsBiquadCascade cascade;
+                cascade.init();
+                record("iir", "cascade_" + std::to_string(notches), proc_rate, post_rate, n, [&] {
+                    fresh();
+                    cascade.process(work);
+                });
+
+                // the eight QS_IIR objects the cascade replaces, one per enabled notch
+                std::vector<std::unique_ptr<QS_IIR>> iirs;
+                for (int i = 0; i < notches; i++) {
+                    iirs.push_back(std::make_unique<QS_IIR>());
+                    iirs.back()->init(i, QS_IIR::iirBandReject);
+                }
+                record("iir", "qs_iir_" + std::to_string(notches), proc_rate, post_rate, n, [&] {
+                    fresh();
+                    for (auto &iir : iirs)
+                        iir->process(work);
+                });
+            }
+            for (int i = 0; i < MAX_MAN_NOTCHES; i++)
+                mem.setNotchEnabled(i, false);
+        }
+
+        if (wanted("agc")) {
+            QsAgc agc;
+            agc.init();
+            record("agc", "default", proc_rate, post_rate, n, [&] {
+                fresh();
+                agc.process(&work[0], n);
+            });
+        }
+
+        if (wanted("am")) {
+            QsAMDemodulator am;
+            am.init();
+            record("am", "envelope", proc_rate, post_rate, n, [&] {
+                fresh();
+                am.process(&work[0], n);
+            });
+        }
+
+        if (wanted("sam")) {
+            const int tracking[] = {samPerSample, samBlock};
+            const char *names[] = {"per_sample", "block"};
+            for (int t = 0; t < 2; t++) {
+                QsGlobal::g_memory->setSamTracking(tracking[t]);
+                QsSAMDemodulator sam;
+                sam.init();
+                record("sam", names[t], proc_rate, post_rate, n, [&] {
+                    fresh();
+                    sam.process(&work[0], n);
+                });
+            }
+            QsGlobal::g_memory->setSamTracking(QS_DEFAULT_SAM_TRACKING);
+        }
+
+        if (wanted("fm")) {
+            QsGlobal::g_memory->setFmDetector(fmPll);
+            QsFMCombinedDemodulator fm;
+            fm.init(NARROW);
+            record("fm", "pll_narrow", proc_rate, post_rate, n, [&] {
+                fresh();
+                fm.process(&work[0], n, NARROW);
+            });
+            fm.init(WIDE);
+            record("fm", "pll_wide", proc_rate, post_rate, n, [&] {
+                fresh();
+                fm.process(&work[0], n, WIDE);
+            });
+
+            QsGlobal::g_memory->setFmDetector(fmQuadrature);
+            fm.init(NARROW);
+            record("fm", "quadrature", proc_rate, post_rate, n, [&] {
+                fresh();
+                fm.process(&work[0], n, NARROW);
+            });
+            QsGlobal::g_memory->setFmDetector(QS_DEFAULT_FM_DETECTOR);
+        }
+
+        if (wanted("nr")) {
+            QsMemory &mem = *QsGlobal::g_memory;
+            mem.setNoiseReductionOn(true);
+            mem.setNoiseReductionMode(nrLms);
+            for (const auto &alg : BENCH_ADAPT_ALGS) {
+                for (int taps : BENCH_ADAPT_TAPS) {
+                    mem.setNoiseReductionAlgorithm(alg.alg);
+                    mem.setNoiseReductionTaps(taps);
+                    mem.setNoiseReductionDelay(taps / 2);
+                    QsNoiseReductionFilter nr;
+                    nr.init(n);
+                    record("nr", std::string(alg.name) + "_t" + std::to_string(taps), proc_rate, post_rate, n, [&] {
+                        fresh_f();
+                        nr.process(&work_f[0], n);
+                    });
+                }
+            }
+            mem.setNoiseReductionAlgorithm(QS_DEFAULT_NOISERED_ALG);
+            mem.setNoiseReductionTaps(QS_DEFAULT_NOISERED_TAPS);
+            mem.setNoiseReductionDelay(QS_DEFAULT_NOISERED_DELAY);
+            mem.setNoiseReductionOn(false);
+        }
+
+        if (wanted("anf")) {
+            QsMemory &mem = *QsGlobal::g_memory;
+            mem.setAutoNotchOn(true);
+            for (const auto &alg : BENCH_ADAPT_ALGS) {
+                for (int taps : BENCH_ADAPT_TAPS) {
+                    mem.setAutoNotchAlgorithm(alg.alg);
+                    mem.setAutoNotchTaps(taps);
+                    mem.setAutoNotchDelay(taps / 2);
+                    QsAutoNotchFilter anf;
+                    anf.init(n);
+                    record("anf", std::string(alg.name) + "_t" + std::to_string(taps), proc_rate, post_rate, n,
+                           [&] {
+                               fresh_f();
+                               anf.process(&work_f[0], n);
+                           });
+                }
+            }
+            mem.setAutoNotchAlgorithm(QS_DEFAULT_AUTONOTCH_ALG);
+            mem.setAutoNotchTaps(QS_DEFAULT_AUTONOTCH_TAPS);
+            mem.setAutoNotchDelay(QS_DEFAULT_AUTONOTCH_DELAY);
+            mem.setAutoNotchOn(false);
+        }
+
+        if (wanted("resampler") && Resampler::ratioSupported(post_rate, QS_DEFAULT_RTA_RATE)) {
+            Resampler rs(post_rate, QS_DEFAULT_RTA_RATE, QS_DEFAULT_RS_QUAL);
+            rs.reserve(n);
+            qs_vect_f out(rs.maxOutput(n));
+            record("resampler", "mono_q" + std::to_string(QS_DEFAULT_RS_QUAL), proc_rate, post_rate, n,
+                   [&] { rs.process(&src_f[0], n, &out[0]); });
+        }
+    }
+}
+
+static void benchFFT(const qs_vect_cpx &src) {
+    if (!wanted("fft"))
+        return;
+
+    for (int n : blockSizes()) {
+        QsFFT fft;
+        fft.resize(n);
+        qs_vect_cpx work(src.begin(), src.begin() + n);
+        // forward then inverse keeps the data bounded without a copy
+        record("fft", "fwd_inv", 0.0, 0.0, n, [&] {
+            fft.doDFTForward(work, n);
+            fft.doDFTInverse(work, n, 1.0f / n);
+        });
+    }
+}
+
+static void benchKernels(const qs_vect_cpx &src, const qs_vect_f &src_f) {
+    if (!wanted("kernel"))
+        return;
+
+    const QsSimdIsa isas[] = {simdScalar, simdSse2, simdAvx2, simdAvx512, simdNeon};
+    for (QsSimdIsa isa : isas) {
+        if (!QsSimd::select(isa))
+            continue;
+        const QsSimdKernels &k = QsSimd::kernels();
+
+        for (int n : blockSizes()) {
+            qs_vect_cpx a(src.begin(), src.begin() + n);
+            qs_vect_cpx b(src.rbegin(), src.rbegin() + n);
+            qs_vect_cpx c(n);
+            qs_vect_f re(src_f.begin(), src_f.begin() + n);
+            qs_vect_f im(src_f.rbegin(), src_f.rbegin() + n);
+            qs_vect_f re2(n), im2(n), il(2 * n);
+            qs_vect_i ints(n);
+            std::vector<short> shorts(n);
+            for (int i = 0; i < n; i++) {
+                il[2 * i] = re[i];
+                il[2 * i + 1] = im[i];
+                ints[i] = static_cast<int>(re[i] * 1e9f);
+            }
+            const int dot_len = n & ~7;
+            volatile float sink = 0.0f;
+
+            record("kernel", std::string(k.name) + ".multiplyCpx", 0.0, 0.0, n,
+                   [&] { k.multiplyCpx(&a[0], &b[0], &c[0], n); });
+            record("kernel", std::string(k.name) + ".multiplySplit", 0.0, 0.0, n,
+                   [&] { k.multiplySplit(&re[0], &im[0], &im[0], &re[0], &re2[0], &im2[0], n); });
+            record("kernel", std::string(k.name) + ".addCpx", 0.0, 0.0, n,
+                   [&] { k.addCpx(&a[0], &b[0], &c[0], n); });
+            record("kernel", std::string(k.name) + ".scaleCpx", 0.0, 0.0, n, [&] { k.scaleCpx(&c[0], 1.0f, n); });
+            record("kernel", std::string(k.name) + ".deInterleave", 0.0, 0.0, n,
+                   [&] { k.deInterleave(&il[0], &re2[0], &im2[0], n); });
+            record("kernel", std::string(k.name) + ".realToComplex", 0.0, 0.0, n,
+                   [&] { k.realToComplex(&re[0], &im[0], &c[0], n); });
+            record("kernel", std::string(k.name) + ".realFromComplex", 0.0, 0.0, n,
+                   [&] { k.realFromComplex(&a[0], &re2[0], n); });
+            record("kernel", std::string(k.name) + ".intToFloat", 0.0, 0.0, n,
+                   [&] { k.intToFloat(&ints[0], &re2[0], n); });
+            record("kernel", std::string(k.name) + ".floatToShort", 0.0, 0.0, n,
+                   [&] { k.floatToShort(&re[0], &shorts[0], n); });
+            record("kernel", std::string(k.name) + ".dotProduct", 0.0, 0.0, n,
+                   [&] { sink = sink + k.dotProduct(&re[0], &im[0], dot_len); });
+        }
+    }
+
+    // back to what the CPU reports as best
+    QsSimd::init();
+
+    // LO mixing: interleaved in place against split planes, the form the
+    // fused halfband path mixes in (generate, then multiplySplit)
+    const QsSimdKernels &k = QsSimd::kernels();
+    QsNco nco;
+    nco.setFrequency(0.1, 1.0);
+    for (int n : blockSizes()) {
+        qs_vect_cpx c(src.begin(), src.begin() + n);
+        qs_vect_f re(src_f.begin(), src_f.begin() + n);
+        qs_vect_f im(src_f.rbegin(), src_f.rbegin() + n);
+        qs_vect_f osc_re(n), osc_im(n);
+        const QsNco::Cursor at = nco.cursor();
+
+        record("kernel", "nco.mix_aos", 0.0, 0.0, n, [&] { nco.mix(&c[0], &c[0], n, at); });
+        record("kernel", std::string("nco.mix_soa.") + k.name, 0.0, 0.0, n, [&] {
+            nco.generate(&osc_re[0], &osc_im[0], n, at);
+            k.multiplySplit(&re[0], &im[0], &osc_re[0], &osc_im[0], &re[0], &im[0], n);
+        });
+    }
+}
+
+// ======== KERNEL PARITY ===========
+
+static const int VERIFY_GUARD = 16; // elements past the length that must stay untouched
+static const float VERIFY_FILL = 12345.0f;
+static const short VERIFY_FILL_S = 0x5A5A;
+
+struct VerifyState {
+    const char *table;
+    int failures = 0;
+
+    void fail(const char *kernel, int length, int index, const std::string &what) {
+        if (failures++ < 20)
+            std::printf("verify %s.%s length %d index %d: %s\n", table, kernel, length, index, what.c_str());
+    }
+};
+
+static bool sameBits(float a, float b) { return std::memcmp(&a, &b, sizeof(float)) == 0; }
+
+static std::string mismatch(double a, double b) {
+    char buf[64];
+    std::snprintf(buf, sizeof(buf), "%.9g != scalar %.9g", a, b);
+    return buf;
+}
+
+// bit equality over the length, the fill value past it
+static void checkExact(VerifyState &st, const char *kernel, int length, const float *got, const float *want,
+                       int count) {
+    for (int i = 0; i < count + VERIFY_GUARD; i++) {
+        if (i >= count && !sameBits(got[i], VERIFY_FILL))
+            return st.fail(kernel, length, i, "wrote past the length");
+        if (i < count && !sameBits(got[i], want[i]))
+            return st.fail(kernel, length, i, mismatch(got[i], want[i]));
+    }
+}
+
+// |got - want| within a few ulps of the magnitude the result was formed from
+static void checkNear(VerifyState &st, const char *kernel, int length, int index, double got, double want,
+                      double magnitude) {
+    if (std::abs(got - want) > 4.0 * FLT_EPSILON * magnitude)
+        st.fail(kernel, length, index, mismatch(got, want));
+}
+
+// the inputs every kernel reads: noise in [-2, 2], ints over the whole range,
+// and for floatToShort values past full scale, boundaries and non-finite ones
+struct VerifyInput {
+    qs_vect_f a, b, c, d;
+    qs_vect_i ints;
+    qs_vect_f to_short;
+
+    explicit VerifyInput(int n) : a(n), b(n), c(n), d(n), ints(n), to_short(n) {
+        std::mt19937 gen(777);
+        std::uniform_real_distribution<float> uni(-2.0f, 2.0f);
+        std::uniform_int_distribution<int> any_int(INT32_MIN, INT32_MAX);
+        for (int i = 0; i < n; i++) {
+            a[i] = uni(gen);
+            b[i] = uni(gen);
+            c[i] = uni(gen);
+            d[i] = uni(gen);
+            ints[i] = any_int(gen);
+        }
+        const int edges[] = {INT32_MIN, INT32_MIN + 1, -1, 0, 1, INT32_MAX - 1, INT32_MAX};
+        for (int i = 0; i < n; i++)
+            if (i % 5 == 0)
+                ints[i] = edges[(i / 5) % 7];
+
+        const float special[] = {1.0f,
+                                 -1.0f,
+                                 1.5f,
+                                 -1.5f,
+                                 32767.0f / 32767.0f + 1e-7f,
+                                 -32768.0f / 32767.0f,
+                                 -32769.0f / 32767.0f,
+                                 1e6f,
+                                 -1e6f,
+                                 1e30f,
+                                 -1e30f,
+                                 std::numeric_limits<float>::infinity(),
+                                 -std::numeric_limits<float>::infinity(),
+                                 std::numeric_limits<float>::quiet_NaN(),
+                                 0.99999f,
+                                 -0.99999f,
+                                 -0.0f};
+        const int specials = static_cast<int>(sizeof(special) / sizeof(special[0]));
+        for (int i = 0; i < n; i++)
+            to_short[i] = i % 3 == 0 ? special[(i / 3) % specials] : uni(gen);
+    }
+};
+
+static void verifyLength(VerifyState &st, const QsSimdKernels &k, const QsSimdKernels &s, const VerifyInput &in,
+                         int n) {
+    const int g = n + VERIFY_GUARD;
+    std::vector<Cpx> ca(n), cb(n);
+    for (int i = 0; i < n; i++) {
+        ca[i] = Cpx(in.a[i], in.b[i]);
+        cb[i] = Cpx(in.c[i], in.d[i]);
+    }
+    std::vector<Cpx> got(g, Cpx(VERIFY_FILL, VERIFY_FILL)), want(g, Cpx(VERIFY_FILL, VERIFY_FILL));
+    qs_vect_f got_re(g, VERIFY_FILL), got_im(g, VERIFY_FILL), want_re(g, VERIFY_FILL), want_im(g, VERIFY_FILL);
+    const uint32_t len = static_cast<uint32_t>(n);
+    auto reset = [&] {
+        std::fill(got.begin(), got.end(), Cpx(VERIFY_FILL, VERIFY_FILL));
+        std::fill(want.begin(), want.end(), Cpx(VERIFY_FILL, VERIFY_FILL));
+        std::fill(got_re.begin(), got_re.end(), VERIFY_FILL);
+        std::fill(got_im.begin(), got_im.end(), VERIFY_FILL);
+        std::fill(want_re.begin(), want_re.end(), VERIFY_FILL);
+        std::fill(want_im.begin(), want_im.end(), VERIFY_FILL);
+    };
+    auto planes = [](const std::vector<Cpx> &v) { return reinterpret_cast<const float *>(v.data()); };
+
+    // multiplyCpx: FMA may round once instead of twice
+    reset();
+    k.multiplyCpx(ca.data(), cb.data(), got.data(), len);
+    s.multiplyCpx(ca.data(), cb.data(), want.data(), len);
+    for (int i = 0; i < n; i++) {
+        double mag = std::abs(ca[i].real() * cb[i].real()) + std::abs(ca[i].imag() * cb[i].imag()) +
+                     std::abs(ca[i].real() * cb[i].imag()) + std::abs(ca[i].imag() * cb[i].real());
+        checkNear(st, "multiplyCpx", n, i, got[i].real(), want[i].real(), mag);
+        checkNear(st, "multiplyCpx", n, i, got[i].imag(), want[i].imag(), mag);
+    }
+    checkExact(st, "multiplyCpx", n, planes(got) + 2 * n, planes(want) + 2 * n, 0);
+
+    // multiplySplit, into separate planes and in place over a
+    for (int alias = 0; alias < 2; alias++) {
+        reset();
+        qs_vect_f ar(in.a.begin(), in.a.begin() + n), ai(in.b.begin(), in.b.begin() + n);
+        qs_vect_f wr = ar, wi = ai;
+        ar.resize(g, VERIFY_FILL);
+        ai.resize(g, VERIFY_FILL);
+        float *dst_re = alias ? ar.data() : got_re.data();
+        float *dst_im = alias ? ai.data() : got_im.data();
+        k.multiplySplit(ar.data(), ai.data(), in.c.data(), in.d.data(), dst_re, dst_im, len);
+        s.multiplySplit(wr.data(), wi.data(), in.c.data(), in.d.data(), want_re.data(), want_im.data(), len);
+        const char *name = alias ? "multiplySplit(in place)" : "multiplySplit";
+        for (int i = 0; i < n; i++) {
+            double mag = std::abs(in.a[i] * in.c[i]) + std::abs(in.b[i] * in.d[i]) + std::abs(in.a[i] * in.d[i]) +
+                         std::abs(in.b[i] * in.c[i]);
+            checkNear(st, name, n, i, dst_re[i], want_re[i], mag);
+            checkNear(st, name, n, i, dst_im[i], want_im[i], mag);
+        }
+        checkExact(st, name, n, dst_re + n, want_re.data() + n, 0);
+        checkExact(st, name, n, dst_im + n, want_im.data() + n, 0);
+    }
+
+    reset();
+    k.addCpx(ca.data(), cb.data(), got.data(), len);
+    s.addCpx(ca.data(), cb.data(), want.data(), len);
+    checkExact(st, "addCpx", n, planes(got), planes(want), 2 * n);
+
+    reset();
+    std::vector<Cpx> scaled(ca);
+    scaled.resize(g, Cpx(VERIFY_FILL, VERIFY_FILL));
+    std::vector<Cpx> scaled_want(scaled);
+    k.scaleCpx(scaled.data(), 0.3f, len);
+    s.scaleCpx(scaled_want.data(), 0.3f, len);
+    checkExact(st, "scaleCpx", n, planes(scaled), planes(scaled_want), 2 * n);
+
+    reset();
+    qs_vect_f il(2 * n);
+    for (int i = 0; i < n; i++) {
+        il[2 * i] = in.a[i];
+        il[2 * i + 1] = in.b[i];
+    }
+    k.deInterleave(il.data(), got_re.data(), got_im.data(), len);
+    s.deInterleave(il.data(), want_re.data(), want_im.data(), len);
+    checkExact(st, "deInterleave", n, got_re.data(), want_re.data(), n);
+    checkExact(st, "deInterleave", n, got_im.data(), want_im.data(), n);
+
+    reset();
+    k.realToComplex(in.a.data(), in.b.data(), got.data(), len);
+    s.realToComplex(in.a.data(), in.b.data(), want.data(), len);
+    checkExact(st, "realToComplex", n, planes(got), planes(want), 2 * n);
+
+    reset();
+    k.realFromComplex(ca.data(), got_re.data(), len);
+    s.realFromComplex(ca.data(), want_re.data(), len);
+    checkExact(st, "realFromComplex", n, got_re.data(), want_re.data(), n);
+
+    reset();
+    k.intToFloat(in.ints.data(), got_re.data(), len);
+    s.intToFloat(in.ints.data(), want_re.data(), len);
+    checkExact(st, "intToFloat", n, got_re.data(), want_re.data(), n);
+
+    // floatToShort: the table against scalar, and scalar against saturation
+    std::vector<short> got_s(g, VERIFY_FILL_S), want_s(g, VERIFY_FILL_S);
+    k.floatToShort(in.to_short.data(), got_s.data(), len);
+    s.floatToShort(in.to_short.data(), want_s.data(), len);
+    for (int i = 0; i < g; i++) {
+        if (i >= n) {
+            if (got_s[i] != VERIFY_FILL_S) {
+                st.fail("floatToShort", n, i, "wrote past the length");
+                break;
+            }
+            continue;
+        }
+        double v = in.to_short[i] * FLOATTOSHORT;
+        short expect = std::isnan(v) ? 0 : static_cast<short>(std::max(-32768.0, std::min(32767.0, std::trunc(v))));
+        if (got_s[i] != want_s[i] || want_s[i] != expect) {
+            char buf[96];
+            std::snprintf(buf, sizeof(buf), "%.9g gives %d, scalar %d, saturated %d", in.to_short[i], got_s[i],
+                          want_s[i], expect);
+            st.fail("floatToShort", n, i, buf);
+            break;
+        }
+    }
+
+    // dotProduct takes a multiple of eight
+    const int dot = n & ~7;
+    double mag = 0.0;
+    for (int i = 0; i < dot; i++)
+        mag += std::abs(in.a[i] * in.b[i]);
+    checkNear(st, "dotProduct", dot, 0, k.dotProduct(in.a.data(), in.b.data(), dot),
+              s.dotProduct(in.a.data(), in.b.data(), dot), mag);
+}
+
+// non-zero when any table disagrees with the scalar reference
+static int verifyKernels() {
+    const int lengths_max = 4101;
+    VerifyInput in(lengths_max);
+    std::vector<int> lengths;
+    for (int n = 0; n <= 69; n++)
+        lengths.push_back(n);
+    lengths.push_back(lengths_max);
+
+    int failures = 0;
+    const QsSimdIsa isas[] = {simdScalar, simdSse2, simdAvx2, simdAvx512, simdNeon};
+    for (QsSimdIsa isa : isas) {
+        if (!QsSimd::select(isa))
+            continue;
+        const QsSimdKernels &k = QsSimd::kernels();
+        VerifyState st;
+        st.table = k.name;
+        for (int n : lengths)
+            verifyLength(st, k, QsSimd::scalar(), in, n);
+        std::printf("verify %-8s %s (%zu lengths)\n", k.name, st.failures ? "FAILED" : "ok", lengths.size());
+        failures += st.failures;
+    }
+    QsSimd::init();
+    return failures;
+}
+
+// ======== RESAMPLER REFERENCE ===========
+
+static const int RSREF_BLOCK = 2048;
+static const int RSREF_BLOCKS = 48;   // input per tone
+static const int RSREF_SETTLE = 8192; // outputs skipped for the filter delay
+static const int RSREF_TONES = 16;    // passband tones
+static const double RSREF_PASSBAND = 0.35; // of the lower rate, tier 0's edge
+static const float RSREF_LEVEL = 0.5f;
+
+typedef std::function<int(const float *, int, float *)> RsProcess;
+
+struct RsRefResult {
+    double post_rate;
+    std::string impl;
+    int taps; // per output; 0 when not known
+    double ns_per_out;
+    double ripple_db;
+    double residual_db;
+    double alias_db; // 0 when upsampling
+};
+
+#ifdef __LIBSAMPLERATE_REF__
+// streaming SRC_SINC_BEST_QUALITY, same call shape as Resampler::process
+class SrcRef {
+  public:
+    SrcRef(double src_rate, double dest_rate) : m_ratio(dest_rate / src_rate) {
+        int err = 0;
+        m_state = src_new(SRC_SINC_BEST_QUALITY, 1, &err);
+        if (!m_state)
+            throw std::runtime_error(src_strerror(err));
+    }
+    ~SrcRef() { src_delete(m_state); }
+    int maxOutput(int input_frames) const { return static_cast<int>(std::ceil(input_frames * m_ratio)) + 64; }
+    int process(const float *input, int input_frames, float *output) {
+        long used = 0, gen = 0;
+        const long cap = maxOutput(input_frames);
+        while (used < input_frames) {
+            SRC_DATA d;
+            d.data_in = input + used;
+            d.input_frames = input_frames - used;
+            d.data_out = output + gen;
+            d.output_frames = cap - gen;
+            d.end_of_input = 0;
+            d.src_ratio = m_ratio;
+            if (src_process(m_state, &d) != 0 || (d.input_frames_used == 0 && d.output_frames_gen == 0))
+                break;
+            used += d.input_frames_used;
+            gen += d.output_frames_gen;
+        }
+        return static_cast<int>(gen);
+    }
+
+  private:
+    SRC_STATE *m_state;
+    double m_ratio;
+};
+#endif
+
+// amplitude of the tone at f and the rms of what is left after removing it,
+// least squares over the settled outputs
+static void fitTone(const std::vector<float> &y, double f, double rate, double &amplitude, double &residual) {
+    double cc = 0, ss = 0, cs = 0, yc = 0, ys = 0;
+    for (size_t n = RSREF_SETTLE; n < y.size(); n++) {
+        double c = std::cos(TWO_PI * f * n / rate), s = std::sin(TWO_PI * f * n / rate);
+        cc += c * c;
+        ss += s * s;
+        cs += c * s;
+        yc += y[n] * c;
+        ys += y[n] * s;
+    }
+    double det = cc * ss - cs * cs;
+    double a = (yc * ss - ys * cs) / det;
+    double b = (ys * cc - yc * cs) / det;
+    double err = 0;
+    for (size_t n = RSREF_SETTLE; n < y.size(); n++) {
+        double e = y[n] - a * std::cos(TWO_PI * f * n / rate) - b * std::sin(TWO_PI * f * n / rate);
+        err += e * e;
+    }
+    amplitude = std::sqrt(a * a + b * b);
+    residual = std::sqrt(err / (y.size() - RSREF_SETTLE));
+}
+
+// a tone through a fresh converter, in RSREF_BLOCK calls
+static std::vector<float> runTone(const std::function<RsProcess()> &make, int max_out, double f, double in_rate) {
+    RsProcess process = make();
+    std::vector<float> in(RSREF_BLOCK), out(max_out), y;
+    for (int b = 0; b < RSREF_BLOCKS; b++) {
+        for (int i = 0; i < RSREF_BLOCK; i++)
+            in[i] = RSREF_LEVEL * static_cast<float>(std::cos(TWO_PI * f * (b * RSREF_BLOCK + i) / in_rate));
+        int n = process(&in[0], RSREF_BLOCK, &out[0]);
+        y.insert(y.end(), out.begin(), out.begin() + n);
+    }
+    return y;
+}
+
+static RsRefResult measureResampler(double in_rate, double out_rate, const std::string &impl, int taps,
+                                    const std::function<RsProcess()> &make, int max_out) {
+    RsRefResult r{in_rate, impl, taps, 0.0, 0.0, -1e300, 0.0};
+    const double level_rms = RSREF_LEVEL / std::sqrt(2.0);
+    const double edge = RSREF_PASSBAND * std::min(in_rate, out_rate);
+
+    double lo = 1e300, hi = -1e300;
+    for (int t = 0; t < RSREF_TONES; t++) {
+        double f = edge * (t + 1) / RSREF_TONES;
+        double amplitude, residual;
+        fitTone(runTone(make, max_out, f, in_rate), f, out_rate, amplitude, residual);
+        double db = 20.0 * std::log10(amplitude / RSREF_LEVEL);
+        lo = std::min(lo, db);
+        hi = std::max(hi, db);
+        r.residual_db = std::max(r.residual_db, 20.0 * std::log10(residual / level_rms + 1e-30));
+    }
+    r.ripple_db = hi - lo;
+
+    // tones the output rate cannot carry, between the two Nyquist rates
+    if (in_rate > out_rate) {
+        r.alias_db = -1e300;
+        for (int t = 1; t <= 3; t++) {
+            double f = 0.5 * out_rate + 0.25 * t * 0.5 * (in_rate - out_rate);
+            std::vector<float> y = runTone(make, max_out, f, in_rate);
+            double power = 0;
+            for (size_t n = RSREF_SETTLE; n < y.size(); n++)
+                power += static_cast<double>(y[n]) * y[n];
+            power /= (y.size() - RSREF_SETTLE);
+            r.alias_db = std::max(r.alias_db, 10.0 * std::log10(power / (level_rms * level_rms) + 1e-30));
+        }
+    }
+
+    // time per output over a steady stream
+    RsProcess process = make();
+    std::vector<float> in(RSREF_BLOCK), out(max_out);
+    makeSignal(&in[0], RSREF_BLOCK);
+    long frames = 0, calls = 0;
+    double ns = timeCall([&] {
+        frames += process(&in[0], RSREF_BLOCK, &out[0]);
+        calls++;
+    });
+    r.ns_per_out = ns / (static_cast<double>(frames) / calls);
+    return r;
+}
+
+static std::vector<RsRefResult> compareResamplers(const std::vector<double> &rates) {
+    std::vector<RsRefResult> results;
+    std::set<double> post_rates;
+    for (double proc_rate : rates)
+        post_rates.insert(QsDownConvertor().setRate(proc_rate, BENCH_BANDWIDTH));
+
+    const double out_rate = QS_DEFAULT_RTA_RATE;
+    for (double post_rate : post_rates) {
+        if (!Resampler::ratioSupported(post_rate, out_rate))
+            continue;
+        for (int q = 0; q <= 3; q++) {
+            Resampler rs(post_rate, out_rate, q);
+            auto make = [&] {
+                auto fresh = std::make_shared<Resampler>(post_rate, out_rate, q);
+                fresh->reserve(RSREF_BLOCK);
+                return RsProcess([fresh](const float *in, int n, float *out) { return fresh->process(in, n, out); });
+            };
+            results.push_back(measureResampler(post_rate, out_rate, "polyphase_q" + std::to_string(q),
+                                               rs.phaseLength(), make, rs.maxOutput(RSREF_BLOCK)));
+        }
+#ifdef __LIBSAMPLERATE_REF__
+        auto make = [&] {
+            auto fresh = std::make_shared<SrcRef>(post_rate, out_rate);
+            return RsProcess([fresh](const float *in, int n, float *out) { return fresh->process(in, n, out); });
+        };
+        results.push_back(measureResampler(post_rate, out_rate, "src_sinc_best", 0, make,
+                                           SrcRef(post_rate, out_rate).maxOutput(RSREF_BLOCK)));
+#endif
+    }
+    return results;
+}
+
+static void printResamplerRef(const std::vector<RsRefResult> &results) {
+    if (g_opts.json) {
+        json doc = json::array();
+        for (const RsRefResult &r : results) {
+            json j;
+            j["post_rate"] = r.post_rate;
+            j["impl"] = r.impl;
+            j["taps"] = r.taps;
+            j["ns_per_out"] = r.ns_per_out;
+            j["ripple_db"] = r.ripple_db;
+            j["residual_db"] = r.residual_db;
+            if (r.alias_db != 0.0)
+                j["alias_db"] = r.alias_db;
+            else
+                j["alias_db"] = nullptr;
+            doc.push_back(j);
+        }
+        std::cout << doc.dump(2) << std::endl;
+        return;
+    }
+
+    std::printf("%10s %-16s %6s %10s %10s %10s %10s\n", "post_rate", "impl", "taps", "ns/out", "ripple_db",
+                "resid_db", "alias_db");
+    for (const RsRefResult &r : results) {
+        char alias[16] = "-";
+        if (r.alias_db != 0.0)
+            std::snprintf(alias, sizeof(alias), "%.1f", r.alias_db);
+        std::printf("%10.2f %-16s %6d %10.2f %10.6f %10.1f %10s\n", r.post_rate, r.impl.c_str(), r.taps,
+                    r.ns_per_out, r.ripple_db, r.residual_db, alias);
+    }
+#ifndef __LIBSAMPLERATE_REF__
+    std::printf("\nno src_sinc_best rows: configure with -DQS_RESAMPLER_REF=ON (libsamplerate)\n");
+#endif
+}
+
+// ======== PIPELINE ===========
+
+struct PipelineMode {
+    QSDEMODMODE mode;
+    const char *name;
+};
+
+static const PipelineMode PIPELINE_MODES[] = {
+    {dmAM, "am"}, {dmSAM, "sam"}, {dmFMN, "fmn"}, {dmFMW, "fmw"}, {dmUSB, "usb"}};
+
+// the switches are swept one at a time, then together, on this mode
+static const PipelineMode PIPELINE_FEATURE_MODE = {dmUSB, "usb"};
+
+static std::vector<std::string> pipelineFeatures() {
+    std::vector<std::string> features = {"none", "nr", "snr"};
+#ifdef __AUTO_NOTCH__
+    features.push_back("anf");
+#endif
+#ifdef __NOISE_BLANKERS__
+    features.push_back("nb");
+#endif
+    features.push_back("notch");
+    features.push_back("all");
+    return features;
+}
+
+static void setFeatures(const std::string &features) {
+    QsMemory &mem = *QsGlobal::g_memory;
+    bool all = features == "all";
+
+    mem.setNoiseReductionOn(all || features == "nr" || features == "snr");
+    mem.setNoiseReductionMode(features == "snr" ? nrSpectral : nrLms);
+    mem.setAutoNotchOn(all || features == "anf");
+    mem.setAvgNoiseBlankerOn(all || features == "nb");
+    mem.setBlockNoiseBlankerOn(all || features == "nb");
+    for (int i = 0; i < 4; i++) {
+        mem.setNotchEnabled(i, all || features == "notch");
+        mem.setNotchFrequency(i, 600.0f + 400.0f * i);
+    }
+    // the squelch would skip the audio stages on the synthetic tone
+    mem.setSquelchOn(false);
+}
+
+// --alloc-check: a different setting of several groups every step, so the
+// DSP thread's snapshot updates run between blocks
+static void churnSettings(int step) {
+    QsMemory &mem = *QsGlobal::g_memory;
+    bool odd = step & 1;
+    mem.setVolume(odd ? 0.3 : 0.6);
+    mem.setAgcThreshold(odd ? -100.0 : -90.0);
+    mem.setFilterLo(odd ? 200 : 300);
+    mem.setFilterHi(odd ? 2800 : 3000);
+    mem.setToneLoFrequency(odd ? 1000.0 : -1000.0);
+    mem.setNotchFrequency(0, odd ? 700.0f : 900.0f);
+    mem.setNoiseReductionTaps(odd ? 64 : 128);
+}
+
+static double processCpuSeconds() {
+    struct timespec ts;
+    clock_gettime(CLOCK_PROCESS_CPUTIME_ID, &ts);
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+}
+
+struct PipelineSnapshot {
+    double wall;
+    uint64_t blocks;
+    double cpu_reader, cpu_dsp, cpu_drain, cpu_process;
+    uint64_t overflow_readin, overflow_sd, overflow_dac;
+};
+
+static PipelineSnapshot snapshot(std::thread &drain) {
+    PipelineSnapshot s;
+    s.wall = std::chrono::duration<double>(std::chrono::steady_clock::now().time_since_epoch()).count();
+    s.blocks = QsGlobal::g_data_reader->blocksRead();
+    s.cpu_reader = QsGlobal::g_data_reader->cpuSeconds();
+    s.cpu_dsp = QsGlobal::g_dsp_proc->cpuSeconds();
+    s.cpu_drain = threadCpuSeconds(drain);
+    s.cpu_process = processCpuSeconds();
+    s.overflow_readin = QsGlobal::g_cpx_readin_ring->overflowCount();
+    s.overflow_sd = QsGlobal::g_cpx_sd_ring->overflowCount();
+    s.overflow_dac = QsGlobal::g_float_dac_ring->overflowCount();
+    return s;
+}
+
+// a counter the CPU lacks is negative: "-"
+static std::string perfCell(double value, int width, int precision) {
+    char buf[32];
+    if (value < 0.0)
+        std::snprintf(buf, sizeof(buf), "%*s", width, "-");
+    else
+        std::snprintf(buf, sizeof(buf), "%*.*f", width, precision, value);
+    return buf;
+}
+
+static void runPipeline(double proc_rate, double post_rate, const PipelineMode &mode, const std::string &features) {
+    QsMemory &mem = *QsGlobal::g_memory;
+    mem.setDataProcRate(proc_rate);
+    mem.setDataPostProcRate(post_rate);
+    mem.setDemodMode(mode.mode);
+    setFeatures(features);
+
+    const int bsize = mem.getReadBlockSize();
+    QsSyntheticSource source;
+    source.init(proc_rate, bsize);
+
+    QsGlobal::g_data_reader->setSource(&source);
+    QsGlobal::g_data_reader->init();
+    QsGlobal::g_dsp_proc->init(1);
+
+    QsGlobal::g_dsp_proc->start();
+    QsGlobal::g_data_reader->start();
+
+    // the DSP thread sets the DAC ring up as it starts; drain it only after
+    std::atomic<bool> draining(true);
+    while (QsGlobal::g_dsp_proc->blocksProcessed() == 0)
+        std::this_thread::sleep_for(std::chrono::milliseconds(1));
+    std::thread drain([&draining] {
+        std::vector<float> sink(8192);
+        while (draining.load(std::memory_order_relaxed)) {
+            if (QsGlobal::g_float_dac_ring->readAvail() > 0)
+                QsGlobal::g_float_dac_ring->read(sink.data(), sink.size());
+            else
+                std::this_thread::yield();
+        }
+    });
+
+    std::this_thread::sleep_for(std::chrono::duration<double>(g_opts.seconds / 4));
+    PipelineSnapshot a = snapshot(drain);
+    QsGlobal::g_data_reader->perf().requestReset();
+    QsGlobal::g_dsp_proc->stats().perf().requestReset();
+    if (g_opts.alloc_check) {
+        // wall clock pacing: the window is spent changing settings
+        auto until = std::chrono::steady_clock::now() + std::chrono::duration<double>(g_opts.seconds);
+        for (int step = 0; std::chrono::steady_clock::now() < until; step++) {
+            churnSettings(step);
+            std::this_thread::sleep_for(std::chrono::milliseconds(20));
+        }
+    } else {
+        std::this_thread::sleep_for(std::chrono::duration<double>(g_opts.seconds));
+    }
+    PipelineSnapshot b = snapshot(drain);
+    std::vector<QsPerfCounters::Row> perf = QsGlobal::g_data_reader->perf().rows();
+    for (const QsPerfCounters::Row &row : QsGlobal::g_dsp_proc->stats().perf().rows())
+        perf.push_back(row);
+
+    QsGlobal::g_data_reader->stop();
+    QsGlobal::g_dsp_proc->stop();
+    draining = false;
+    drain.join();
+    QsGlobal::g_data_reader->setSource(nullptr);
+
+    // as QS1RServer::stopIo does: the next start must not see this run's
+    // samples while the reader sets its ring up again
+    QsGlobal::g_data_reader->clearBuffers();
+    QsGlobal::g_dsp_proc->clearBuffers();
+    QsGlobal::g_float_dac_ring->empty();
+
+    PipelineResult r;
+    r.proc_rate = proc_rate;
+    r.post_rate = post_rate;
+    r.mode = mode.name;
+    r.features = features;
+
+    double signal = static_cast<double>(b.blocks - a.blocks) * bsize / proc_rate;
+    if (signal <= 0.0)
+        signal = 1e-9; // nothing got through the window
+    r.rtf = (b.wall - a.wall) / signal;
+    r.cpu_reader = (b.cpu_reader - a.cpu_reader) / signal;
+    r.cpu_dsp = (b.cpu_dsp - a.cpu_dsp) / signal;
+    r.cpu_drain = (b.cpu_drain - a.cpu_drain) / signal;
+    double cpu_total = (b.cpu_process - a.cpu_process) / signal;
+    r.cpu_other = std::max(0.0, cpu_total - r.cpu_reader - r.cpu_dsp - r.cpu_drain);
+    r.overflow_readin = b.overflow_readin - a.overflow_readin;
+    r.overflow_sd = b.overflow_sd - a.overflow_sd;
+    r.overflow_dac = b.overflow_dac - a.overflow_dac;
+
+    // one DSP thread per receiver must keep up on its own; beyond that the
+    // whole chain's CPU is shared across the cores (drain stands in for
+    // the DAC writer)
+    unsigned int cores = std::max(1u, std::thread::hardware_concurrency());
+    r.receivers = r.cpu_dsp < 1.0 && cpu_total > 0.0 ? static_cast<int>(cores / cpu_total) : 0;
+    r.perf = perf;
+    g_pipeline.push_back(r);
+
+    if (!g_opts.json) {
+        std::printf("%10.1f %9.1f %-5s %-6s %8.4f %8.3f %8.3f %8.3f %8.3f %9llu %9llu %9llu %4d\n", r.proc_rate,
+                    r.post_rate, r.mode.c_str(), r.features.c_str(), r.rtf, r.cpu_reader, r.cpu_dsp, r.cpu_drain,
+                    r.cpu_other, static_cast<unsigned long long>(r.overflow_readin),
+                    static_cast<unsigned long long>(r.overflow_sd), static_cast<unsigned long long>(r.overflow_dac),
+                    r.receivers);
+        for (const QsPerfCounters::Row &row : r.perf)
+            std::printf("%26s %-10s %s %s %s %s %s\n", "", row.name, perfCell(row.cycles, 8, 2).c_str(),
+                        perfCell(row.ipc, 6, 2).c_str(), perfCell(row.l1d_misses, 8, 4).c_str(),
+                        perfCell(row.llc_misses, 8, 4).c_str(), perfCell(row.branch_misses, 8, 4).c_str());
+        std::fflush(stdout);
+    }
+}
+
+static void benchPipeline(const std::vector<double> &rates) {
+    QsGlobal::g_cpx_readin_ring = std::make_unique<QsCircularBuffer<Cpx>>();
+    QsGlobal::g_cpx_sd_ring = std::make_unique<QsCircularBuffer<Cpx>>();
+    QsGlobal::g_float_rt_ring = std::make_unique<QsCircularBuffer<float>>();
+    QsGlobal::g_float_dac_ring = std::make_unique<QsCircularBuffer<float>>();
+    QsGlobal::g_data_reader->perf().setEnabled(g_opts.perf);
+    QsGlobal::g_dsp_proc->stats().perf().setEnabled(g_opts.perf);
+
+    if (!g_opts.json) {
+        std::printf("%10s %9s %-5s %-6s %8s %8s %8s %8s %8s %9s %9s %9s %4s\n", "proc_rate", "post_rate", "mode",
+                    "feat", "rtf", "cpu_rd", "cpu_dsp", "cpu_dac", "cpu_oth", "ovf_in", "ovf_sd", "ovf_dac", "rx");
+        if (g_opts.perf)
+            std::printf("%26s %-10s %8s %6s %8s %8s %8s   (per sample)\n", "", "perf", "cycles", "ipc", "l1d_miss",
+                        "llc_miss", "br_miss");
+    }
+
+    for (double proc_rate : rates) {
+        double post_rate = QsDownConvertor().setRate(proc_rate, BENCH_BANDWIDTH);
+        for (const PipelineMode &mode : PIPELINE_MODES)
+            runPipeline(proc_rate, post_rate, mode, "none");
+        for (const std::string &features : pipelineFeatures())
+            if (features != "none")
+                runPipeline(proc_rate, post_rate, PIPELINE_FEATURE_MODE, features);
+    }
+    setFeatures("none");
+}
+
+// per mode / features: the lowest swept rate the chain cannot sustain,
+// where a paced source would start overflowing the read-in ring; 0 if none
+static std::vector<std::pair<std::string, double>> overflowPoints() {
+    std::vector<std::pair<std::string, double>> points;
+    for (const PipelineResult &r : g_pipeline) {
+        std::string key = r.mode + "/" + r.features;
+        auto it = std::find_if(points.begin(), points.end(), [&](const auto &p) { return p.first == key; });
+        if (it == points.end()) {
+            points.emplace_back(key, 0.0);
+            it = points.end() - 1;
+        }
+        if (r.rtf >= 1.0 && (it->second == 0.0 || r.proc_rate < it->second))
+            it->second = r.proc_rate;
+    }
+    return points;
+}
+
+// ======== OUTPUT ===========
+
+static void printJson() {
+    json doc;
+    doc["version"] = VERSION;
+#ifdef __OPTIMIZE__
+    doc["optimized"] = true;
+#else
+    doc["optimized"] = false;
+#endif
+    doc["compiler"] = __VERSION__;
+    doc["simd"] = QsSimd::name();
+    doc["cpus"] = std::thread::hardware_concurrency();
+    doc["quick"] = g_opts.quick;
+
+    json results = json::array();
+    for (const BenchResult &r : g_results) {
+        json row;
+        row["stage"] = r.stage;
+        row["variant"] = r.variant;
+        row["proc_rate"] = r.proc_rate;
+        row["rate"] = r.rate;
+        row["block"] = r.block;
+        row["ns_per_sample"] = r.ns_per_sample;
+        row["msps"] = 1e3 / r.ns_per_sample;
+        if (r.rate > 0.0)
+            row["rtf"] = r.ns_per_sample * r.rate * 1e-9;
+        else
+            row["rtf"] = nullptr;
+        results.push_back(row);
+    }
+    doc["results"] = results;
+
+    if (g_opts.pipeline) {
+        json pipeline = json::array();
+        for (const PipelineResult &r : g_pipeline) {
+            json row;
+            row["proc_rate"] = r.proc_rate;
+            row["post_rate"] = r.post_rate;
+            row["mode"] = r.mode;
+            row["features"] = r.features;
+            row["rtf"] = r.rtf;
+            row["cpu"] = {{"reader", r.cpu_reader}, {"dsp", r.cpu_dsp}, {"dac_drain", r.cpu_drain},
+                          {"other", r.cpu_other}};
+            row["overflow"] = {{"readin", r.overflow_readin}, {"sd", r.overflow_sd}, {"dac", r.overflow_dac}};
+            row["receivers"] = r.receivers;
+            if (g_opts.perf) {
+                // per sample; null for a counter the CPU lacks
+                auto value = [](double v) { return v < 0.0 ? json(nullptr) : json(v); };
+                json perf = json::array();
+                for (const QsPerfCounters::Row &p : r.perf)
+                    perf.push_back({{"stage", p.name},
+                                    {"samples", p.samples},
+                                    {"cycles", value(p.cycles)},
+                                    {"ipc", value(p.ipc)},
+                                    {"l1d_misses", value(p.l1d_misses)},
+                                    {"llc_misses", value(p.llc_misses)},
+                                    {"branch_misses", value(p.branch_misses)}});
+                row["perf"] = perf;
+            }
+            pipeline.push_back(row);
+        }
+        doc["pipeline"] = pipeline;
+
+        json points;
+        for (const auto &p : overflowPoints()) {
+            if (p.second > 0.0)
+                points[p.first] = p.second;
+            else
+                points[p.first] = nullptr;
+        }
+        doc["overflow_from"] = points;
+        if (g_opts.perf) {
+            std::string error = QsGlobal::g_dsp_proc->stats().perf().error();
+            if (error.empty())
+                doc["perf_error"] = nullptr;
+            else
+                doc["perf_error"] = error;
+        }
+        doc["seconds"] = g_opts.seconds;
+        doc["block"] = QsGlobal::g_memory->getReadBlockSize();
+        doc["fe_threads"] = QsGlobal::g_memory->getFrontEndThreads();
+    }
+
+    std::cout << doc.dump(2) << std::endl;
+}
+
+static void usage(const char *prog) {
+    std::printf("usage: %s [--json] [--quick] [--filter <stage>] [--rate <hz>]\n"
+                "       %s --pipeline [--seconds <s>] [--json] [--quick] [--rate <hz>] [--perf] [--fe-threads <n>]\n"
+                "       %s --verify\n"
+                "       %s --alloc-check [--quick] [--rate <hz>]\n"
+                "       %s --resampler-ref [--json] [--rate <hz>]\n"
+                "  --json          write the results as JSON to stdout\n"
+                "  --quick         three block sizes and shorter trials\n"
+                "  --pipeline      reader -> DSP -> DAC ring from a synthetic source, swept\n"
+                "  --seconds <s>   pipeline measurement window per run (default 1)\n"
+                "  --perf          pipeline hardware counters per stage (perf_event_open)\n"
+                "  --fe-threads <n> pipeline front end threads (default: the server's, %d)\n"
+                "  --verify        check every SIMD kernel table against scalar, exit 1 on a mismatch\n"
+                "  --alloc-check   pipeline sweep aborting on any real-time heap allocation\n"
+                "  --resampler-ref resampler tiers (and libsamplerate, if built in): speed, ripple, alias\n"
+                "  --filter <s>    only stage s (downconvertor, frontend, main_filter, post_filter,\n"
+                "                  iir, agc, am, sam, fm, nr, anf, resampler, fft, kernel)\n"
+                "  --rate <hz>     one processing rate instead of all supported\n",
+                prog, prog, prog, prog, prog, QS_DEFAULT_FE_THREADS);
+}
+
+int main(int argc, char **argv) {
+    for (int i = 1; i < argc; i++) {
+        std::string arg = argv[i];
+        if (arg == "--json") {
+            g_opts.json = true;
+        } else if (arg == "--quick") {
+            g_opts.quick = true;
+        } else if (arg == "--pipeline") {
+            g_opts.pipeline = true;
+        } else if (arg == "--perf") {
+            g_opts.perf = true;
+        } else if (arg == "--verify") {
+            g_opts.verify = true;
+        } else if (arg == "--alloc-check") {
+            g_opts.alloc_check = true;
+            g_opts.pipeline = true;
+        } else if (arg == "--resampler-ref") {
+            g_opts.resampler_ref = true;
+        } else if (arg == "--seconds" && i + 1 < argc) {
+            g_opts.seconds = std::max(0.05, std::atof(argv[++i]));
+        } else if (arg == "--fe-threads" && i + 1 < argc) {
+            g_opts.fe_threads = std::max(1, std::atoi(argv[++i]));
+        } else if (arg == "--filter" && i + 1 < argc) {
+            g_opts.filter = argv[++i];
+        } else if (arg == "--rate" && i + 1 < argc) {
+            g_opts.rate = std::atof(argv[++i]);
+        } else {
+            usage(argv[0]);
+            return arg == "--help" || arg == "-h" ? 0 : 1;
+        }
+    }
+
+    if (g_opts.quick) {
+        g_opts.trials = 3;
+        g_opts.min_trial_ms = 5.0;
+        g_opts.seconds = std::min(g_opts.seconds, 0.3);
+    }
+
+    std::vector<double> rates;
+    for (double rate : BENCH_RATES)
+        if (g_opts.rate == 0.0 || rate == g_opts.rate)
+            rates.push_back(rate);
+    if (rates.empty()) {
+        std::fprintf(stderr, "%s: %.1f is not a supported processing rate\n", argv[0], g_opts.rate);
+        return 1;
+    }
+
+    QsSimd::init();
+    if (g_opts.verify)
+        return verifyKernels() == 0 ? 0 : 1;
+    if (g_opts.alloc_check) {
+        if (!QsAllocGuard::enabled()) {
+            std::fprintf(stderr, "%s: --alloc-check needs a build with __ALLOC_GUARD__ (Debug)\n", argv[0]);
+            return 2;
+        }
+        QsAllocGuard::setAbort(true);
+    }
+
+    QsArena::local().reserve(QS_DEFAULT_ARENA_BYTES);
+
+    // _debug() writes to std::cout even with DEBUG off; the stages log on
+    // every rebuild, so keep it out of the table and the JSON
+    std::streambuf *cout_buf = std::cout.rdbuf(nullptr);
+
+    qs_vect_cpx src(BENCH_MAX_BLOCK);
+    qs_vect_f src_f(BENCH_MAX_BLOCK);
+    makeSignal(&src[0], BENCH_MAX_BLOCK);
+    makeSignal(&src_f[0], BENCH_MAX_BLOCK);
+
+    if (!g_opts.json)
+        std::printf("qs1r_bench %s  simd %s%s\n", VERSION, QsSimd::name(),
+#ifdef __OPTIMIZE__
+                    ""
+#else
+                    "  (unoptimized build)"
+#endif
+        );
+
+    if (g_opts.resampler_ref) {
+        std::vector<RsRefResult> results = compareResamplers(rates);
+        std::cout.rdbuf(cout_buf);
+        printResamplerRef(results);
+        return 0;
+    }
+
+    if (g_opts.pipeline) {
+        if (g_opts.fe_threads > 0)
+            QsGlobal::g_memory->setFrontEndThreads(g_opts.fe_threads);
+        benchPipeline(rates);
+
+        if (!g_opts.json) {
+            std::string error = QsGlobal::g_dsp_proc->stats().perf().error();
+            if (g_opts.perf && !error.empty())
+                std::printf("\nperf counters unavailable: %s\n", error.c_str());
+            std::printf("\nlowest rate a real-time source would overflow at:\n");
+            for (const auto &p : overflowPoints()) {
+                if (p.second > 0.0)
+                    std::printf("  %-12s %10.1f\n", p.first.c_str(), p.second);
+                else
+                    std::printf("  %-12s %10s\n", p.first.c_str(), "none");
+            }
+        }
+
+        std::cout.rdbuf(cout_buf);
+        if (g_opts.json)
+            printJson();
+        if (g_opts.alloc_check) {
+            // an allocation aborted already; this catches a guard that did not
+            uint64_t total = QsAllocGuard::total();
+            std::fprintf(stderr, "alloc check: %llu allocations on armed threads\n",
+                         static_cast<unsigned long long>(total));
+            return total == 0 ? 0 : 1;
+        }
+        return 0;
+    }
+
+    if (!g_opts.json) {
+        std::printf("%-14s %-22s %10s %10s %6s %10s %10s %8s\n", "stage", "variant", "proc_rate", "rate", "block",
+                    "ns/sample", "Msps", "rtf");
+    }
+
+    // post rate stages once per distinct post rate
+    std::set<double> post_done;
+    for (double proc_rate : rates) {
+        benchDownConvertor(proc_rate, src);
+        benchFrontEnd(proc_rate, src);
+
+        double post_rate = QsDownConvertor().setRate(proc_rate, BENCH_BANDWIDTH);
+        if (post_done.insert(post_rate).second)
+            benchPostStages(proc_rate, post_rate, src, src_f);
+    }
+
+    benchFFT(src);
+    benchKernels(src, src_f);
+
+    std::cout.rdbuf(cout_buf);
+    if (g_opts.json)
+        printJson();
+
+    return 0;
+}
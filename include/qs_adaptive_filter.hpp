@@ -0,0 +1,81 @@
+/**
+ * @file qs_adaptive_filter.hpp
+ * @brief Adaptive linear predictor shared by noise reduction and auto notch.
+ *
+ * The QsAdaptiveFilter predicts each input sample from a delayed window of
+ * its past, x[n - delay - j] for j = 0 .. taps-1, and adapts the weights with
+ * one of three algorithms. QsNoiseReductionFilter keeps the prediction (the
+ * correlated part of the signal), QsAutoNotchFilter keeps the error (the
+ * signal with the predictable tones removed).
+ *
+ * Features:
+ * - adNlms: sample-by-sample normalized LMS, the reference behaviour
+ * - adBlockLms: weights frozen for ADAPT_BLOCK samples, filtering and
+ *   gradient computed tap-outer/sample-inner so both vectorise
+ * - adFdaf: constrained overlap-save frequency-domain adaptive filter,
+ *   O(log taps) work per sample
+ * - History kept in a linear buffer, so every dot product is a contiguous
+ *   float loop; input power kept as a running sum
+ *
+ * Usage:
+ * 1. af.configure(adNlms, taps, delay);   // resets when anything changes
+ * 2. af.setRate(rate, leakage);
+ * 3. af.process(in, prediction, error, length);   // either output may be null
+ *
+ * Notes:
+ * - Weights are the same time-domain vector in every mode, so the
+ *   algorithm can be switched without losing what was learned.
+ * - adFdaf works on blocks of the smallest power of two >= taps. Calls
+ *   whose length is not a multiple of that block run as adNlms.
+ * - The step size means the same per-sample convergence in every mode.
+ *   The block modes apply the sum of their block's per-sample steps
+ *   (leakage included) at once, capped at 1 for stability, normalized by
+ *   the input power over the block. adFdaf normalizes by the total power
+ *   rather than per bin: per-bin steps chase the noise bins next to a
+ *   strong carrier and cost the auto notch 20 dB of depth.
+ */
+
+#pragma once
+
+#include "../include/qs_defines.hpp"
+#include "../include/qs_fft.hpp"
+#include "../include/qs_types.hpp"
+
+class QsAdaptiveFilter {
+  public:
+    QsAdaptiveFilter();
+
+    void configure(QSADAPTALG algorithm, int taps, int delay);
+    void setRate(double rate, double leakage);
+    void reset();
+    void clearHistory(); // past input to zeros, weights kept
+
+    void process(const float *in, float *prediction, float *error, int length);
+
+  private:
+    static constexpr int ADAPT_BLOCK = 16; // adBlockLms weight update interval
+    static constexpr int ADAPT_CHUNK = 256; // inputs per history pass
+
+    void runNlms(const float *x, float *prediction, float *error, int length);
+    void runBlockLms(const float *x, float *prediction, float *error, int length);
+    void runFdaf(const float *x, float *prediction, float *error, int length);
+
+    QSADAPTALG m_algorithm;
+    int m_taps;
+    int m_delay;
+    int m_hist_len; // past samples kept ahead of each chunk: delay + m_fft_block
+    int m_fft_block;
+    double m_rate;
+    double m_leakage;
+
+    qs_vect_f m_weights; // reversed: m_weights[i] multiplies x[n - delay - (taps-1-i)]
+    qs_vect_f m_hist;    // m_hist_len past inputs followed by the current chunk
+    qs_vect_f m_acc;     // adFdaf block errors
+
+    // adFdaf
+    QsFFT m_fft;
+    qs_vect_cpx m_u;
+    qs_vect_cpx m_w;
+    qs_vect_cpx m_tmp;
+    double m_block_power; // smoothed window power summed over the bins
+};
@@ -10,18 +10,32 @@
  * Features:
  * - Configurable AGC attack, decay, and hang time constants
  * - Adjustable thresholds, slope, and manual gain for fine control
- * - Peak, average attack, and decay tracking for smooth gain adjustment
- * - Signal delay buffer and magnitude buffer for sample processing
- * - Adjustable sample rate and processing rate parameters
+ * - Average attack and decay tracking with hang for smooth gain adjustment
+ * - Look-ahead: gain follows the undelayed input, applied AGC_DELAY_TC later
+ * - Block engine: envelope and its log for the whole block first, then the
+ *   attack/decay recursion over that float array, then the gain curve and
+ *   the delayed multiply, each its own loop
+ * - Look-ahead delay is a ring, read and refilled by the multiply
+ * - The output limiter (QsSignalOps::Limit): the multiply tracks the peak,
+ *   limit() scales the block once if it passed full scale
  *
  * Usage:
  * 1. Initialize an instance of QsAgc using the constructor.
- * 2. Call `init()` to set up internal parameters.
- * 3. Use `process(qs_vect_cpx &src_dst)` to apply AGC on a given complex signal vector.
+ * 2. Call `init()` to set up internal parameters, and `update()` with each new
+ *    settings snapshot.
+ * 3. Use `process(qs_vect_cpx &src_dst)` to apply AGC and the limiter on a given complex
+ *    signal vector.
+ * 4. Or, for a block in chunks: `apply(chunk, n)` per chunk (state carries
+ *    between calls), then `limit(block, length)` once for the block.
  *
  * Notes:
  * - Constants such as attack, decay, and scaling factors are defined as macros for easy adjustment.
- * - The AGC algorithm modifies the input signal in place through an iterator.
+ * - Levels are log10 of max(|I|, |Q|), taken with QsSignalOps::FastLog2;
+ *   the gain is 10^x through QsSignalOps::FastExp2.
+ * - A new AGC version in update() only recomputes the coefficients; the
+ *   averages and the delay line carry on.
+ * - limit() decides on the peak of everything applied since the last
+ *   limit(), so a chunked block is limited exactly like a whole one.
  *
  * Author: Philip A Covington
  * Date: 2024-10-17
@@ -31,6 +45,7 @@
 
 #include "../include/qs_signalops.hpp"
 #include "../include/qs_defines.hpp"
+#include "../include/qs_dsp_params.hpp"
 
 #define AGC_ATTACK_RISE_TC 0.0005
 #define AGC_ATTACK_FALL_TC 0.020
@@ -38,7 +53,6 @@
 #define AGC_RELEASE_TC 0.001
 #define AGC_OUTPUT_SCALING 0.75
 #define AGC_MIN_CONSTANT 1e-8
-#define AGC_WINDOW_TC 0.018
 #define AGC_DELAY_TC 0.015
 #define AGC_MAX_MAN_GAIN 0.75
 #define AGC_MAX_BUFFER_SZ 2048
@@ -49,12 +63,19 @@ class QsAgc {
     explicit QsAgc();
 
     void init();
+    void update(const QsDspParams &params);
     void process(qs_vect_cpx &src_dst);
+    void process(Cpx *src_dst, int length);
+    void apply(Cpx *src_dst, int length);
+    void limit(Cpx *src_dst, int length);
 
   private:
+    void setCoefficients(const QsDspParams &params);
+    void processLevels(float *level, int length);
+    void applyGain(Cpx *src_dst, const float *gain, int length);
 
-    float update_avg(float avg, float value, float rise_alpha, float fall_alpha);
     int m_post_processing_rate;
+    uint32_t m_version; // pgAgc
 
     bool m_agc_use_hang;
 
@@ -69,32 +90,25 @@ class QsAgc {
     double m_agc_decay_set;
     double m_agc_sample_rate;
 
-    qs_vect_cpx m_agc_signalDelayBuffer;
-    qs_vect_f m_agc_magBuffer;
-    qs_vect_cpx::iterator m_cpx_iterator;
+    qs_vect_cpx m_agc_delay_line; // ring of the last m_agc_delay_samples inputs
+    int m_agc_delay_pos;          // oldest input, the next one out
+    int32_t m_agc_peak_bits;      // max |I|, |Q| since the last limit(), as float bits
 
-    int m_agc_sigdly_ptr;
     int m_agc_hang_timer;
 
-    float m_agc_peak;
     float m_agc_decay_avg;
     float m_agc_attack_avg;
 
-    int m_agc_magbuffer_pos;
-
     double m_agc_current_gain;
     double m_agc_fixed_manual_gain;
 
     float m_agc_knee;
     float m_agc_gain_slope;
 
-    double m_agc_fixed_gain;
-
     float m_agc_attack_rise_alpha;
     float m_agc_attack_fall_alpha;
     float m_agc_decay_rise_alpha;
     float m_agc_decay_fall_alpha;
 
     int m_agc_delay_samples;
-    int m_agc_window_samples;
 };
@@ -0,0 +1,66 @@
+/**
+ * @file qs_alloc_guard.hpp
+ * @brief Debug check that the real-time threads stop allocating after warm-up.
+ *
+ * With __ALLOC_GUARD__ defined (Debug builds), the global operator new and
+ * delete are replaced by thin malloc / free wrappers that count every
+ * allocation made on a thread that has armed the guard. The DSP, reader and
+ * DAC threads arm it after their first QS_DEFAULT_WARMUP_BLOCKS blocks, so
+ * any heap allocation left in the per-block path shows up as a count, or as
+ * an abort when a test asks for one.
+ *
+ * Features:
+ * - Per-thread arming, other threads are not affected
+ * - Per-thread and process-wide counts
+ * - Optional abort on the first allocation, with the thread's name on stderr
+ * - Pause scope for deliberate reconfiguration (new resampler, new rate)
+ *
+ * Usage:
+ * 1. QsAllocGuard::arm("dspproc");          // after warm-up, in the thread
+ * 2. ... per-block work ...
+ * 3. QsAllocGuard::disarm();                 // count() is what leaked
+ * 4. { QsAllocGuard::Pause pause; rebuild(); }
+ *
+ * Notes:
+ * - Without __ALLOC_GUARD__ every call is a no-op and counts stay zero.
+ * - Counts allocations, not bytes; a free on an armed thread is not counted.
+ * - Only operator new is seen; malloc inside C libraries (libusb, ALSA)
+ *   is not.
+ */
+
+#pragma once
+
+#include <cstdint>
+
+class QsAllocGuard {
+  public:
+    static bool enabled();
+
+    // the calling thread only; name must outlive the arming
+    static void arm(const char *name);
+    static void disarm();
+    static bool armed();
+
+    // allocations on the calling thread since arm()
+    static uint64_t count();
+    // allocations on all armed threads since start
+    static uint64_t total();
+
+    // abort() on the first allocation on an armed thread
+    static void setAbort(bool value);
+
+    class Pause {
+      public:
+        Pause() : m_prev(QsAllocGuard::suspend(true)) {}
+        ~Pause() { QsAllocGuard::suspend(m_prev); }
+        Pause(const Pause &) = delete;
+        Pause &operator=(const Pause &) = delete;
+
+      private:
+        bool m_prev;
+    };
+
+  private:
+    // returns the previous state
+    static bool suspend(bool value);
+};
@@ -43,4 +43,5 @@ class QsAMDemodulator {
 
     void init();
     void process(qs_vect_cpx &src_dst);
+    void process(Cpx *src_dst, int length);
 };
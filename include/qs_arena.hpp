@@ -0,0 +1,88 @@
+/**
+ * @file qs_arena.hpp
+ * @brief Per-thread bump arena for block scratch storage.
+ *
+ * Stages that need a temporary buffer for one call (a window while a filter
+ * kernel is rebuilt, a real copy of a complex block) take it from the
+ * calling thread's arena instead of a local vector. The arena is one 64
+ * byte aligned block reserved before the thread's loop; taking scratch is a
+ * pointer bump and a Scope hands it back when it goes out of scope, so the
+ * steady state does no heap allocation.
+ *
+ * Features:
+ * - One arena per thread (QsArena::local()), no locking
+ * - Every slice starts on a QS_ALIGNMENT boundary
+ * - Scopes nest; each rewinds to where it started
+ * - A request that does not fit still succeeds from the heap; the block
+ *   grows to the high water mark when the outermost scope closes, so the
+ *   next pass fits
+ *
+ * Usage:
+ * 1. QsArena::local().reserve(QS_DEFAULT_ARENA_BYTES);   // thread start
+ * 2. QsArena::Scope scratch;
+ *    float *window = scratch.alloc<float>(length);
+ * 3. // released when scratch goes out of scope
+ *
+ * Notes:
+ * - Storage is uninitialized, for trivially copyable types only.
+ * - Slices must not outlive their scope or leave the thread.
+ */
+
+#pragma once
+
+#include "../include/qs_types.hpp"
+
+#include <cstddef>
+#include <type_traits>
+#include <vector>
+
+class QsArena {
+  public:
+    QsArena();
+    ~QsArena();
+    QsArena(const QsArena &) = delete;
+    QsArena &operator=(const QsArena &) = delete;
+
+    // the calling thread's arena
+    static QsArena &local();
+
+    // grow the block to at least bytes; allocates, so call before the loop.
+    // Ignored while scratch is out.
+    void reserve(std::size_t bytes);
+
+    std::size_t capacity() const { return m_capacity; }
+    std::size_t used() const { return m_used; }
+    std::size_t highWater() const { return m_high; }
+
+    template <typename T> T *alloc(std::size_t count) {
+        static_assert(std::is_trivially_copyable<T>::value, "QsArena holds trivially copyable types only");
+        return static_cast<T *>(take(count * sizeof(T)));
+    }
+
+    class Scope {
+      public:
+        explicit Scope(QsArena &arena = QsArena::local()) : m_arena(arena), m_mark(arena.m_used) {}
+        ~Scope() { m_arena.rewind(m_mark); }
+        Scope(const Scope &) = delete;
+        Scope &operator=(const Scope &) = delete;
+
+        template <typename T> T *alloc(std::size_t count) { return m_arena.alloc<T>(count); }
+
+      private:
+        QsArena &m_arena;
+        std::size_t m_mark;
+    };
+
+  private:
+    void *take(std::size_t bytes);
+    void rewind(std::size_t mark);
+
+    unsigned char *m_block;
+    std::size_t m_capacity;
+    std::size_t m_used;
+    std::size_t m_high;
+
+    // requests past the block, freed when the outermost scope closes
+    std::vector<void *> m_spill;
+    std::size_t m_spill_bytes;
+};
@@ -0,0 +1,59 @@
+/**
+ * @file qs_audio_decim.hpp
+ * @brief Integer decimator from the post processing rate to an audio rate.
+ *
+ * The QsAudioDecimator drops the demodulated mono audio by an integer
+ * factor K chosen from the current filter edges, so the adaptive stages
+ * (auto notch, LMS noise reduction), squelch and volume run at rate / K and
+ * the output resampler starts from that rate. Adaptive filter cost falls
+ * roughly with K.
+ *
+ * Features:
+ * - Kaiser lowpass from QsDecimationPlanner, designed for the widest
+ *   audio bandwidth that selects K, so a filter change only redesigns
+ *   when K changes
+ * - Polyphase form: one inner product per output, taps padded to a
+ *   multiple of eight for QsSignalOps::DotProduct8
+ * - K divides the block, so every call returns exactly length / K samples
+ *
+ * Usage:
+ * 1. int k = QsAudioDecimator::chooseFactor(rate, bandwidth, block, out_rate);
+ * 2. decim.configure(k);
+ * 3. decim.reserve(block);                     // keeps process() off the heap
+ * 4. int n = decim.process(in, block, out);   // n = block / k
+ *
+ * Notes:
+ * - K = 1 is a copy. K is at most AUDIO_DECIM_MAX and must leave a rate the
+ *   output Resampler can reach; at 97656.25 Hz no K > 1 does.
+ * - Adaptive filter taps and delays count samples, so at rate / K the same
+ *   settings span K times as long.
+ */
+
+#pragma once
+
+#include "../include/qs_types.hpp"
+
+class QsAudioDecimator {
+  public:
+    QsAudioDecimator();
+
+    static int chooseFactor(double rate, double bandwidth, int block, double out_rate);
+
+    void configure(int factor);
+    void reset();
+    void reserve(int length); // history for calls of up to length inputs; allocates
+    int process(const float *input, int length, float *output);
+    int skip(int length); // silent input: output count, history as if zeros were fed
+
+    int factor() const { return m_factor; }
+    int taps() const { return m_taps; }
+    // input samples from input to output (the taps are symmetric)
+    double groupDelay() const { return m_delay; }
+
+  private:
+    int m_factor;
+    int m_taps;         // a multiple of eight
+    double m_delay;     // (length - 1) / 2 of the unpadded filter
+    qs_vect_f m_coef;   // reversed, zero padded at the oldest end
+    qs_vect_f m_hist;   // m_taps - 1 past inputs followed by the current call
+};
@@ -12,10 +12,12 @@
  * - Automatic adaptation to varying signal conditions.
  * - Configurable adaptation rate and leakage for optimal performance.
  * - Adjustable delay and filter size for flexibility.
+ * - Prediction runs on the shared QsAdaptiveFilter engine; NLMS, block LMS
+ *   or frequency-domain adaptation selected per receiver.
  * 
  * Usage:
  * - Create an instance of the class and call init() to initialize with 
- *   the desired size.
+ *   the desired size, and pass each new settings snapshot to update().
  * - Call process() with a vector of complex signals to apply the notch filtering.
  * 
  * @note This class is suitable for use in digital signal processing (DSP) 
@@ -27,6 +29,7 @@
 
 #pragma once
 
+#include "../include/qs_adaptive_filter.hpp"
 #include "../include/qs_signalops.hpp"
 #include "../include/qs_globals.hpp"
 
@@ -35,22 +38,20 @@ using namespace std;
 class QsAutoNotchFilter {
   private:
     bool m_anf_switch;
-    int m_anf_lms_sz;
+    uint32_t m_version; // pgAutoNotch
     double m_anf_adapt_rate;
     double m_anf_leakage;
-    double m_anf_adapt_size;
-    int m_anf_delay;
-    int m_anf_dl_indx;
-    int m_anf_mask;
 
-    qs_vect_f m_anf_delay_line;
-    qs_vect_f m_anf_coeff;
-
-    qs_vect_cpx::iterator m_cpx_iterator;
+    QsAdaptiveFilter m_anf_engine;
+    qs_vect_f m_anf_in;
+    qs_vect_f m_anf_out;
 
   public:
     QsAutoNotchFilter();
 
     void init(unsigned int size);
+    void update(const QsDspParams &params);
     void process(qs_vect_cpx &src_dst);
+    bool process(float *src_dst, int length); // mono audio, false when off
+    void hold(); // squelch closed: keep the weights, restart from silence
 };
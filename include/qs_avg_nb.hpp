@@ -12,9 +12,14 @@
  * - Real-time processing of complex signals.
  * - Adjustable threshold for noise blanking.
  * - Averaging mechanism to adaptively filter out noise.
+ * - Four samples per qs_v4f step with no per-sample branch: both
+ *   exponential averages are solved as scans (QsSignalOps::ExpAverage4),
+ *   the test is |x|^2 against (threshold * average)^2 and the blend is a
+ *   lane select.
  * 
  * Usage:
  * - Create an instance of the class and call init() to initialize.
+ * - Pass each new settings snapshot to update().
  * - Call process() with a vector of complex signals to apply the noise blanking.
  * 
  * @note This class is designed for use in digital signal processing (DSP) applications.
@@ -33,16 +38,14 @@ using namespace std;
 class QsAveragingNoiseBlanker {
   private:
     Cpx m_anb_avg_sig;
-    float m_anb_magnitude;
     float m_anb_avg_magn;
     bool m_anb_switch;
     double m_anb_thres;
 
-    qs_vect_cpx::iterator m_cpx_iterator;
-
   public:
     QsAveragingNoiseBlanker();
 
     void init();
+    void update(const QsDspParams &params);
     void process(qs_vect_cpx &src_dst);
 };
@@ -0,0 +1,68 @@
+/**
+ * @file qs_biquad_cascade.hpp
+ * @brief Eight manual notches as one biquad cascade over the I/Q block.
+ *
+ * The QsBiquadCascade replaces the eight QS_IIR band-reject objects of the
+ * __IIR_NOTCH__ build. The enabled notches are compacted into a list when
+ * the notch settings change and the block is filtered in a single pass, each
+ * sample running through all enabled sections with I and Q side by side.
+ *
+ * Features:
+ * - Transposed direct form II sections, state held in locals for the pass
+ * - Section count is a template parameter: the section loop unrolls and
+ *   disabled notches cost nothing, with no per-sample branch
+ * - Coefficients follow the notch frequency / bandwidth of each new
+ *   settings snapshot, with no allocation; the post processing rate is
+ *   taken at init()
+ *
+ * Usage:
+ * 1. cascade.init();
+ * 2. cascade.update(params);   // a new settings snapshot
+ * 3. cascade.process(block);   // once per block, after the main filter
+ *
+ * Notes:
+ * - Notches are numbered 0 .. MAX_MAN_NOTCHES - 1, the QsMemory indices.
+ * - A notch whose frequency or bandwidth changes, or that is switched on,
+ *   starts from zero state, as QS_IIR did; the other sections keep theirs.
+ * - QsDspProcessor runs the cascade only when __IIR_NOTCH__ is defined. The
+ *   default CMake build undefines it and notches in the frequency domain
+ *   (QsSpectralNotches); qs1r_bench times the cascade in either build.
+ */
+
+#pragma once
+
+#include "../include/qs_defines.hpp"
+#include "../include/qs_dsp_params.hpp"
+#include "../include/qs_types.hpp"
+
+class QsBiquadCascade {
+  public:
+    QsBiquadCascade();
+
+    void init();
+    void update(const QsDspParams &params);
+    void process(qs_vect_cpx &src_dst);
+    void process(Cpx *data, int length);
+
+    int activeSections() const { return m_active; }
+
+  private:
+    void design(int notch, float f0, float bw);
+
+    template <int V> void run(Cpx *data, int length);
+
+    double m_rate;
+    uint32_t m_version; // pgNotch
+    int m_active;
+    int m_index[MAX_MAN_NOTCHES]; // enabled notches, in QsMemory order
+
+    float m_f0[MAX_MAN_NOTCHES];
+    float m_bw[MAX_MAN_NOTCHES];
+    bool m_valid[MAX_MAN_NOTCHES];
+    bool m_enabled[MAX_MAN_NOTCHES];
+
+    // per notch: b0, b1, b2, a1, a2 (a0 normalized to 1)
+    float m_coef[MAX_MAN_NOTCHES][5];
+    // per notch: s1, s2 for I and Q
+    float m_state[MAX_MAN_NOTCHES][2][2];
+};
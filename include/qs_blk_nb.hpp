@@ -3,18 +3,23 @@
  * @brief   Block Noise Blanker for signal processing.
  * 
  * This class implements a block noise blanker designed to suppress noise 
- * in complex input signals. It utilizes a delay line to maintain a history 
- * of incoming samples and applies a threshold to determine if the signal 
- * should be blanked. If the signal magnitude exceeds the specified threshold, 
- * it replaces the noisy signal with an averaged signal based on previous samples.
+ * in complex input signals. It tracks the long-term average magnitude and
+ * applies a threshold to determine if the signal should be blanked. If the
+ * signal magnitude exceeds the specified threshold, that sample and the
+ * following BNB_HANG_SAMPLES - 1 samples are zeroed.
  * 
  * Features:
  * - Real-time processing of complex signals with noise suppression.
  * - Adjustable threshold and hangtime for blanking.
  * - Ability to enable or disable the noise blanker.
+ * - Four samples per qs_v4f step: the average is solved as a scan
+ *   (QsSignalOps::ExpAverage4) and the test is |x|^2 against
+ *   (threshold * average)^2; groups with no trigger and no hang running
+ *   pass through untouched.
  * 
  * Usage:
  * - Create an instance of the class and call init() to initialize.
+ * - Pass each new settings snapshot to update().
  * - Call process() with a vector of complex signals to apply the noise blanking.
  * 
  * @note This class is designed for use in digital signal processing (DSP) applications.
@@ -30,23 +35,16 @@
 
 class QsBlockNoiseBlanker {
   private:
-    float m_bnb_magnitude;
     float m_bnb_avg_magn;
     bool m_bnb_switch;
     double m_bnb_thres;
-    int m_bnb_sig_index;
-    int m_bnb_dly_index;
     int m_bnb_hangtime;
-    Cpx m_bnb_avg_sig;
-
-    qs_vect_cpx bnb_delay_line;
-
-    qs_vect_cpx::iterator m_cpx_iterator;
 
   public:
     QsBlockNoiseBlanker();
 
     void init();
+    void update(const QsDspParams &params);
     void process(qs_vect_cpx &src_dst);
 
     void setBnbOn(bool value);
@@ -0,0 +1,107 @@
+/**
+ * @file qs_block_tag.hpp
+ * @brief Sequence and time stamp tags carried alongside the sample rings.
+ *
+ * QsDataReader stamps every block it reads with a sequence number and the
+ * monotonic time the read returned. The tag rides next to the samples:
+ * each QsCircularBuffer keeps a small queue of tags, each pinned to the
+ * ring stream position of the first sample it describes, and the consumer
+ * collects the tags of the samples it has read. A stage that turns N
+ * blocks into one (the front end into g_cpx_sd_ring, the post chain into
+ * g_float_dac_ring) forwards one tag covering the whole sequence range.
+ *
+ * Features:
+ * - Sequence ranges: a missing number anywhere downstream means samples
+ *   were dropped upstream (a writer that drops a block drops its tag)
+ * - Two time stamps: the origin (the reader) and entry to the current ring,
+ *   for end to end and per hop latency
+ * - Lock free single producer / single consumer queue, no allocation
+ * - A full queue folds new tags into one held tag instead of losing them,
+ *   so a slow consumer never shows up as a sequence gap
+ *
+ * Usage:
+ * 1. ring->pushTag(tag);                       // writer, before write()
+ * 2. ring->write(samples, n);
+ * 3. ring->read(samples, n);                   // reader
+ * 4. if (ring->popTag(tag, missing)) ...       // tags of the samples read
+ *
+ * Notes:
+ * - The popped tag carries the time stamps of the newest tag read, so
+ *   latency is that of the newest tagged sample in the read.
+ * - clear() is for both sides stopped, like QsCircularBuffer::init().
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+struct QsBlockTag {
+    uint64_t first;    // first reader block sequence covered
+    uint64_t last;     // last reader block sequence covered
+    int64_t origin_ns; // reader time stamp, less the filter delays passed so far
+    int64_t hop_ns;    // entry to the current ring
+    uint64_t pos;      // ring stream index of the first sample covered
+};
+
+class QsBlockTagQueue {
+  public:
+    static const uint32_t CAPACITY = 64; // a power of two
+
+    QsBlockTagQueue() : m_head(0), m_tail(0), m_held_valid(false) {}
+
+    void clear() {
+        m_head.store(0, std::memory_order_relaxed);
+        m_tail.store(0, std::memory_order_relaxed);
+        m_held_valid = false;
+    }
+
+    // writer
+    void push(const QsBlockTag &tag) {
+        if (m_held_valid) {
+            m_held.last = tag.last;
+        } else {
+            m_held = tag;
+            m_held_valid = true;
+        }
+        uint32_t head = m_head.load(std::memory_order_relaxed);
+        if (head - m_tail.load(std::memory_order_acquire) < CAPACITY) {
+            m_queue[head & (CAPACITY - 1)] = m_held;
+            m_head.store(head + 1, std::memory_order_release);
+            m_held_valid = false;
+        }
+    }
+
+    // reader: every tag whose first sample is before pos, merged into one;
+    // missing += sequence numbers skipped between them. False if none.
+    bool pop(uint64_t pos, QsBlockTag &out, uint64_t &missing) {
+        uint32_t tail = m_tail.load(std::memory_order_relaxed);
+        uint32_t head = m_head.load(std::memory_order_acquire);
+        bool found = false;
+        while (tail != head && m_queue[tail & (CAPACITY - 1)].pos < pos) {
+            const QsBlockTag &tag = m_queue[tail & (CAPACITY - 1)];
+            if (!found) {
+                out = tag;
+                found = true;
+            } else {
+                if (tag.first > out.last + 1)
+                    missing += tag.first - out.last - 1;
+                out.last = tag.last;
+                out.origin_ns = tag.origin_ns;
+                out.hop_ns = tag.hop_ns;
+            }
+            tail++;
+        }
+        m_tail.store(tail, std::memory_order_release);
+        return found;
+    }
+
+  private:
+    QsBlockTag m_queue[CAPACITY];
+    std::atomic<uint32_t> m_head; // written by the writer
+    std::atomic<uint32_t> m_tail; // written by the reader
+
+    // writer only: tags waiting for queue space, folded together
+    QsBlockTag m_held;
+    bool m_held_valid;
+};
@@ -14,6 +14,14 @@
  * - Handles circular buffer wrap-around internally.
  * - Provides methods for checking available space for reading and writing.
  * - Can be configured with a custom block size.
+ * - Single producer / single consumer safe: the writer and the reader share
+ *   only the atomic free count, so one thread may write while another reads.
+ * - No allocation after init(): reads into a vector fill its existing
+ *   storage instead of resizing it.
+ * - Overflow count: elements a writer could not place because the ring was
+ *   full, including whole blocks it skipped (noteOverflow()).
+ * - Block tags (qs_block_tag.hpp): sequence and time stamps pinned to the
+ *   stream position of the samples they describe, for latency tracing.
  *
  * Usage:
  * ```
@@ -28,6 +36,8 @@
  * - The buffer size must be initialized before performing read or write operations.
  * - The template allows the buffer to work with both fundamental types (e.g., `float`,
  *   `double`) and complex types (e.g., `std::complex<float>`).
+ * - read() into a vector reads at most rdata.size() elements.
+ * - init() and empty() are not synchronized; call them with both sides stopped.
  *
  * @author  Philip A Covington
  * @date    2024-10-24
@@ -35,7 +45,11 @@
 
 #pragma once
 
+#include "../include/qs_block_tag.hpp"
+#include "../include/qs_types.hpp"
+
 #include <algorithm> // for std::copy
+#include <atomic>
 #include <complex>
 #include <vector>
 
@@ -44,43 +58,39 @@ template <typename T> class QsCircularBuffer {
     uint32_t _size;
     uint32_t _readPtr;
     uint32_t _writePtr;
-    uint32_t _writeAvail;
+    std::atomic<uint32_t> _writeAvail; // the one field both sides touch
     uint32_t m_blocksize;
+    std::atomic<uint64_t> m_overflow; // written by the writer, read by anyone
+    uint64_t m_written;               // elements written since init, writer only
+    uint64_t m_read;                  // elements read since init, reader only
+    QsBlockTagQueue m_tags;
 
-    std::vector<T> _buffer;
+    std::vector<T, QsAlignedAllocator<T>> _buffer;
 
   public:
-    QsCircularBuffer() : _size(0), _readPtr(0), _writePtr(0), _writeAvail(0), m_blocksize(0) {}
+    QsCircularBuffer() : _size(0), _readPtr(0), _writePtr(0), _writeAvail(0), m_blocksize(0), m_overflow(0), m_written(0), m_read(0) {}
 
     void init(uint32_t size) {
         _size = size;
         _buffer.assign(size, T{}); // Allocate and initialize with default value of T
         _readPtr = 0;
         _writePtr = 0;
-        _writeAvail = size;
+        _writeAvail.store(size, std::memory_order_release);
+        m_overflow.store(0, std::memory_order_relaxed);
+        m_written = 0;
+        m_read = 0;
+        m_tags.clear();
     }
 
-    uint32_t read(std::vector<T> &rdata, uint32_t length = 0) {
-        uint32_t availableToRead = readAvail();
-        if (length == 0 || length > availableToRead) {
-            length = availableToRead;
+    // fills rdata's existing storage, no reallocation
+    template <typename A> uint32_t read(std::vector<T, A> &rdata, uint32_t length = 0) {
+        if (length == 0 || length > rdata.size()) {
+            length = rdata.size();
         }
-
-        rdata.clear();
-        rdata.reserve(length);
-
-        uint32_t firstChunk = std::min(length, _size - _readPtr);
-        uint32_t secondChunk = length - firstChunk;
-
-        rdata.insert(rdata.end(), _buffer.begin() + _readPtr, _buffer.begin() + _readPtr + firstChunk);
-        _readPtr = (_readPtr + firstChunk) % _size;
-
-        if (secondChunk > 0) {
-            rdata.insert(rdata.end(), _buffer.begin(), _buffer.begin() + secondChunk);
-            _readPtr = secondChunk;
+        if (length == 0) {
+            return 0;
         }
-
-        return length;
+        return read(rdata.data(), length);
     }
 
     uint32_t read(T *rdata, uint32_t length = 0) {
@@ -100,15 +110,20 @@ template <typename T> class QsCircularBuffer {
             _readPtr = secondChunk;
         }
 
+        // hand the space back to the writer once the copy is done
+        _writeAvail.fetch_add(length, std::memory_order_release);
+        m_read += length;
+
         return length;
     }
 
-    uint32_t write(const std::vector<T> &wdata, uint32_t length = 0) {
+    template <typename A> uint32_t write(const std::vector<T, A> &wdata, uint32_t length = 0) {
         uint32_t availableToWrite = writeAvail();
         if (length == 0 || length > wdata.size()) {
             length = wdata.size();
         }
         if (length > availableToWrite) {
+            noteOverflow(length - availableToWrite);
             length = availableToWrite;
         }
 
@@ -123,7 +138,8 @@ template <typename T> class QsCircularBuffer {
             _writePtr = secondChunk;
         }
 
-        _writeAvail -= length;
+        _writeAvail.fetch_sub(length, std::memory_order_release);
+        m_written += length;
 
         return length;
     }
@@ -131,6 +147,7 @@ template <typename T> class QsCircularBuffer {
     uint32_t write(const T *wdata, uint32_t length = 0) {
         uint32_t availableToWrite = writeAvail();
         if (length > availableToWrite) {
+            noteOverflow(length - availableToWrite);
             length = availableToWrite;
         }
 
@@ -145,23 +162,68 @@ template <typename T> class QsCircularBuffer {
             _writePtr = secondChunk;
         }
 
-        _writeAvail -= length;
+        _writeAvail.fetch_sub(length, std::memory_order_release);
+        m_written += length;
+
+        return length;
+    }
+
+    // length default values (silence for float audio) without a source buffer
+    uint32_t writeZeros(uint32_t length) {
+        uint32_t availableToWrite = writeAvail();
+        if (length > availableToWrite) {
+            noteOverflow(length - availableToWrite);
+            length = availableToWrite;
+        }
+
+        uint32_t firstChunk = std::min(length, _size - _writePtr);
+        uint32_t secondChunk = length - firstChunk;
+
+        std::fill(_buffer.begin() + _writePtr, _buffer.begin() + _writePtr + firstChunk, T{});
+        _writePtr = (_writePtr + firstChunk) % _size;
+
+        if (secondChunk > 0) {
+            std::fill(_buffer.begin(), _buffer.begin() + secondChunk, T{});
+            _writePtr = secondChunk;
+        }
+
+        _writeAvail.fetch_sub(length, std::memory_order_release);
+        m_written += length;
 
         return length;
     }
 
     uint32_t size() { return _size; }
 
-    uint32_t writeAvail() { return _writeAvail; }
+    uint32_t writeAvail() { return _writeAvail.load(std::memory_order_acquire); }
 
-    uint32_t readAvail() { return _size - _writeAvail; }
+    uint32_t readAvail() { return _size - _writeAvail.load(std::memory_order_acquire); }
 
     void empty() {
         _readPtr = 0;
         _writePtr = 0;
-        _writeAvail = _size;
+        _writeAvail.store(_size, std::memory_order_release);
+        m_written = 0;
+        m_read = 0;
+        m_tags.clear();
+    }
+
+    // writer: tag the samples of the next write(); stamps the position
+    void pushTag(QsBlockTag tag) {
+        tag.pos = m_written;
+        m_tags.push(tag);
     }
 
+    // reader: the tags of everything read so far, merged; false if none
+    bool popTag(QsBlockTag &tag, uint64_t &missing) { return m_tags.pop(m_read, tag, missing); }
+
+    // a writer that drops a block instead of writing part of it
+    void noteOverflow(uint32_t length) { m_overflow.fetch_add(length, std::memory_order_relaxed); }
+
+    uint64_t overflowCount() { return m_overflow.load(std::memory_order_relaxed); }
+
+    void resetOverflowCount() { m_overflow.store(0, std::memory_order_relaxed); }
+
     void setBlockSize(uint32_t value) { m_blocksize = value; }
 
     uint32_t blockSize() { return m_blocksize; }
@@ -29,11 +29,14 @@
 
 #pragma once
 
+#include "../include/qs_perf_counters.hpp"
 #include "../include/qs_sleep.hpp"
 #include "../include/qs_types.hpp"
 #include <atomic>
 #include <thread>
 
+class QsSyntheticSource;
+
 class QsDataReader {
   public:
     QsDataReader();
@@ -46,6 +49,17 @@ class QsDataReader {
     void init();         // Method to initialize the data reader
     bool isRunning();
 
+    // read from source instead of EP6 (nullptr: the device); set while
+    // stopped. With a source the reader waits for ring space rather than
+    // overflowing, so the pipeline runs as fast as the DSP drains it.
+    void setSource(QsSyntheticSource *source);
+    // blocks written to the read-in ring since start(), any thread
+    uint64_t blocksRead();
+    // CPU time of the reader thread, while running
+    double cpuSeconds();
+    // hardware counters around the block conversion, off until enabled
+    QsPerfCounters &perf() { return m_perf; }
+
   private:
     void run();            // Method containing the main logic for the thread
     void onQs1rReadFail(); // Method for handling failure
@@ -54,6 +68,8 @@ class QsDataReader {
     std::atomic<bool> m_thread_go;
     std::atomic<bool> m_is_running;
     bool m_qs1r_fail_emitted;
+    std::atomic<uint64_t> m_blocks;
+    QsSyntheticSource *m_source;
 
     int m_result;
     int m_channels;
@@ -72,6 +88,7 @@ class QsDataReader {
     qs_vect_cpx cpx_out;
 
     QsSleep sleep;
+    QsPerfCounters m_perf;
 
     // The thread object
     std::thread m_thread;
@@ -0,0 +1,94 @@
+/**
+ * @file qs_decim_planner.hpp
+ * @brief Cost-model driven planner for the QsDownConvertor decimation chain.
+ *
+ * The QsDecimationPlanner factors the total decimation from the hardware
+ * processing rate down to the post processing rate into a chain of stages
+ * and picks the cheapest chain that still meets the -140 dB alias
+ * rejection of the halfband designs in qs_downcnv_coeff.hpp.
+ *
+ * Features:
+ * - Output rate rule shared by QsDownConvertor and QS1RServer
+ * - Candidate chains: an optional leading integer CIC decimate-by-R (order
+ *   3..7) with a 3 tap droop compensator, followed by any sequence of
+ *   halfband and Kaiser-designed polyphase FIR decimate-by-3/4/5 stages
+ * - CIC alias rejection is checked numerically over every alias band that
+ *   folds onto the passband
+ * - Cost is reported as MACs and adds per input sample and a single score
+ *
+ * Usage:
+ * 1. QsDecimPlan plan = QsDecimationPlanner::plan(in_rate, bandwidth);
+ * 2. Build the stages in plan.stages in order (see QsDownConvertor::setRate).
+ * 3. plan.toString() describes the chain and its cost for logging.
+ *
+ * Notes:
+ * - The output rate is always the one the original greedy halfband chain
+ *   produced, so downstream filters, resampler ratios and the rates the
+ *   server reports do not change. That rule halves the rate, so the total
+ *   decimation is a power of two and radix 3/5 stages only appear for
+ *   callers that plan other ratios.
+ * - A MAC is one real coefficient applied to one complex sample; an add is
+ *   one complex integer add. Adds are weighted at QS_DECIM_ADD_COST MACs.
+ */
+
+#pragma once
+
+#include <string>
+#include <vector>
+
+#define QS_DECIM_MIN_OUTPUT_RATE (7900.0 * 2.0)
+#define QS_DECIM_ALIAS_DB 140.0
+// Relative cost of one integrator/comb add against one MAC. The halfband
+// MACs vectorise while each CIC integrator is a serial add chain, so on a
+// SIMD host they cost about the same (measured at -O0, -O2 and -O3).
+// Builds for targets without float SIMD can lower this.
+#ifndef QS_DECIM_ADD_COST
+#define QS_DECIM_ADD_COST 1.0
+#endif
+#define QS_DECIM_CIC_MIN_ORDER 3
+#define QS_DECIM_CIC_MAX_ORDER 7
+#define QS_DECIM_CIC_MAX_RATIO 16
+
+enum class QsDecimKind { CIC, HalfBand, PolyFir };
+
+struct QsDecimStage {
+    QsDecimKind kind;
+    int ratio;      // decimation factor of this stage
+    int size;       // CIC order, halfband or FIR tap count
+    double in_rate; // sample rate at the stage input
+    double macs;    // MACs per chain input sample
+    double adds;    // adds per chain input sample
+};
+
+struct QsDecimPlan {
+    std::vector<QsDecimStage> stages;
+    double in_rate = 0.0;
+    double out_rate = 0.0;
+    double bandwidth = 0.0;
+    double macs = 0.0;
+    double adds = 0.0;
+    double cost = 0.0;
+
+    std::string toString() const;
+    // seconds from chain input to output, linear phase stages
+    double groupDelay() const;
+};
+
+class QsDecimationPlanner {
+  public:
+    static double outputRate(double in_rate, double bandwidth);
+    static QsDecimPlan plan(double in_rate, double bandwidth);
+
+    // design helpers shared with the stage implementations
+    static int halfBandTaps(double in_rate, double bandwidth);
+    static double cicAliasDb(int order, int ratio, double passband);
+    static double cicCompensator(int order, int ratio, double passband);
+    static int kaiserLength(int ratio, double passband);
+    static std::vector<float> kaiserLowpass(int length, int ratio);
+
+  private:
+    static bool addStage(QsDecimPlan &plan, QsDecimKind kind, int ratio, double &rate, double &weight);
+    static void search(const QsDecimPlan &head, int remaining, double rate, double weight, QsDecimPlan &best,
+                       bool &have_best);
+    static void finish(QsDecimPlan &plan);
+};
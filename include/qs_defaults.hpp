@@ -68,6 +68,8 @@
 #define QS_DEFAULT_SAM_ALPHA 2.0
 #define QS_DEFAULT_SAM_BETA 177.78
 #define QS_DEFAULT_SAM_ZETA 0.15
+#define QS_DEFAULT_SAM_TRACKING 0 // samPerSample
+#define QS_DEFAULT_AUDIO_RATE_STAGE false
 
 #define QS_DEFAULT_FMN_BW 6000.0
 #define QS_DEFAULT_FMN_LIMIT 8000.0
@@ -77,6 +79,8 @@
 #define QS_DEFAULT_FMW_LIMIT 15000.0
 #define QS_DEFAULT_FMW_ZETA 0.707
 
+#define QS_DEFAULT_FM_DETECTOR 0 // fmPll
+
 //****************************************************//
 //-----------------------MNB--------------------------//
 //****************************************************//
@@ -103,6 +107,7 @@
 #define QS_DEFAULT_AUTONOTCH_LEAK 0.001
 #define QS_DEFAULT_AUTONOTCH_DELAY 64
 #define QS_DEFAULT_AUTONOTCH_TAPS 128
+#define QS_DEFAULT_AUTONOTCH_ALG 0 // adNlms
 
 //****************************************************//
 //-----------------NOISE REDUCTION--------------------//
@@ -112,6 +117,8 @@
 #define QS_DEFAULT_NOISERED_LEAK 1.0
 #define QS_DEFAULT_NOISERED_DELAY 256
 #define QS_DEFAULT_NOISERED_TAPS 512
+#define QS_DEFAULT_NOISERED_MODE 0 // nrLms
+#define QS_DEFAULT_NOISERED_ALG 0  // adNlms
 
 //****************************************************//
 //--------------------SQUELCH-------------------------//
@@ -137,7 +144,7 @@
 //****************************************************//
 //----------------------RESAMPLER---------------------//
 //****************************************************//
-#define QS_DEFAULT_RS_QUAL 3
+#define QS_DEFAULT_RS_QUAL 3 // 0 fast (60 dB) .. 3 best (120 dB)
 
 //****************************************************//
 //----------------------RT AUDIO----------------------//
@@ -160,6 +167,33 @@
 //****************************************************//
 #define QS_DEFAULT_FIRST_DS_FACTOR 1
 
+//****************************************************//
+//--------------PARALLEL FRONT END--------------------//
+//****************************************************//
+#define QS_DEFAULT_FE_THREADS 1 // serial; FrontEndThreads setting / command, qs1r_bench --fe-threads
+#define QS_FE_PARALLEL_MIN_RATE 1250000.0
+#define QS_FE_HEAD_DECIM 4
+
+//****************************************************//
+//-----------------SCRATCH ARENA----------------------//
+//****************************************************//
+#define QS_DEFAULT_ARENA_BYTES (256 * 1024) // per DSP / IO thread, reserved before the loop
+#define QS_DEFAULT_WARMUP_BLOCKS 8          // blocks before the allocation guard arms
+
+//****************************************************//
+//-----------------LATENCY TRACING--------------------//
+//****************************************************//
+#define QS_DEFAULT_LATENCY_WINDOW_S 10 // rolling window, seconds per histogram generation
+
+//****************************************************//
+//------------------TRACE RECORDER--------------------//
+//****************************************************//
+#define QS_DEFAULT_TRACE_EVENTS (1 << 16)   // per thread ring, a power of two (24 bytes each)
+#define QS_DEFAULT_TRACE_MISS_DELAY_MS 250  // dump this long after a deadline miss
+#define QS_DEFAULT_TRACE_HOLDOFF_S 30       // at most one automatic dump per holdoff
+#define QS_DEFAULT_TRACE_DIR "qs1r_traces/"    // every dump, relative to the server's working directory
+#define QS_DEFAULT_TRACE_FILE "qs1r_trace.json" // Trace dump without a name
+
 //****************************************************//
 //-----------------RT AUDIO RATE----------------------//
 //****************************************************//
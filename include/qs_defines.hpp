@@ -10,6 +10,14 @@ int modeStringToInt(std::string mode);
 
 enum QSTXVFOMODE { txFollowRXVfo = 0, txFollowTXVfo = 1 };
 
+enum QSNRMODE { nrLms = 0, nrSpectral = 1 };
+
+enum QSADAPTALG { adNlms = 0, adBlockLms = 1, adFdaf = 2 };
+
+enum QSFMDETECTOR { fmPll = 0, fmQuadrature = 1 };
+
+enum QSSAMTRACKING { samPerSample = 0, samBlock = 1 };
+
 #define NUMBER_OF_RECEIVERS 1
 #define MAX_RECEIVERS 2
 
@@ -10,6 +10,10 @@
  * Features:
  * - Supports up to 10 stages of decimation
  * - Includes Half-Band filters and CIC filters for efficient downconversion
+ * - Half-Band kernels are templates specialised on tap count and coefficients,
+ *   split polyphase and vectorised across samples in float
+ * - Chain chosen by QsDecimationPlanner: optional integer CIC decimate-by-R,
+ *   halfbands and radix 3/5 polyphase FIR stages, cheapest first
  * - Custom decimation filters with varying coefficients
  * - Multi-stage processing for optimized bandwidth and rate control
  * - Thread safety through mutex locks for concurrent access
@@ -18,11 +22,17 @@
  * 1. Create an instance of QsDownConvertor.
  * 2. Use `setRate(double in_rate, double bandwidth)` to set the input rate and bandwidth.
  * 3. Process a signal by calling `process(Cpx *in_cpx, Cpx *out_cpx, int length)`.
- * 4. The class automatically selects the appropriate decimation filters based on the rate and bandwidth.
+ * 4. The class automatically selects the appropriate decimation filters based on the rate and bandwidth;
+ *    `plan()` returns the chosen chain and its cost.
+ * 5. `setStages(plan, first, last)` builds only a slice of a plan, e.g. the
+ *    per-thread head and the serial tail of the parallel front end.
+ * 6. `process(in, out, length, nco, at)` mixes with the LO NCO and decimates in
+ *    one pass; a halfband first stage mixes while it splits the polyphase
+ *    planes, any other first stage mixes in place first.
  *
  * Notes:
  * - Decimation filters like Half-Band and CIC are nested classes within QsDownConvertor.
- * - Memory management is handled within the decimation classes, with buffers being allocated and deleted as needed.
+ * - Half-Band history is sized to the filter length; no per-stage block buffer is kept.
  * - Thread synchronization is provided by QMutex to ensure safe multithreading.
  *
  * Author: Philip A Covington
@@ -33,9 +43,16 @@
 
 #include "../include/qs_signalops.hpp"
 #include "../include/qs_defines.hpp"
+#include "../include/qs_decim_planner.hpp"
 #include "../include/qs_downcnv_coeff.hpp"
 #include "../include/qs_globals.hpp"
+#include "../include/qs_nco.hpp"
+#include <algorithm>
+#include <cstdint>
+#include <cstring>
+#include <iterator>
 #include <mutex>
+#include <vector>
 
 #define MAX_STAGES 10
 
@@ -44,7 +61,11 @@ class QsDownConvertor {
     QsDownConvertor();
     ~QsDownConvertor();
     int process(Cpx *in_cpx, Cpx *out_cpx, int length);
+    int process(Cpx *in_cpx, Cpx *out_cpx, int length, const QsNco &nco, QsNco::Cursor at);
     double setRate(double in_rate, double bandwidth);
+    double setStages(const QsDecimPlan &plan, int first, int last);
+    static int historyLength(const QsDecimPlan &plan, int first, int last);
+    const QsDecimPlan &plan() const { return m_Plan; }
 
   private:
     class DecimateBy2 {
@@ -52,63 +73,234 @@ class QsDownConvertor {
         DecimateBy2() {};
         virtual ~DecimateBy2() {};
         virtual int Decimate(Cpx *in_cpx, Cpx *out_cpx, int length) = 0;
+        // mix with the NCO starting at `at`, then decimate
+        virtual int MixDecimate(const QsNco &nco, QsNco::Cursor at, Cpx *in_cpx, Cpx *out_cpx, int length) {
+            nco.mix(in_cpx, in_cpx, length, at);
+            return Decimate(in_cpx, out_cpx, length);
+        }
     };
 
-    class HalfBandDecimateBy2 : public DecimateBy2 {
+    // Halfband decimate-by-2 specialised at compile time on tap count and
+    // coefficient table. The filter is split into its two polyphase branches:
+    // the even-indexed taps run against the even input samples and the lone
+    // center tap against the odd ones, the remaining odd taps being zero.
+    // Inputs are de-interleaved into split re/im float planes and filtered in
+    // chunks of HB_CHUNK outputs, tap-outer/sample-inner, so the compiler
+    // emits packed float multiply-adds across neighbouring output samples.
+    // As a first stage it can also apply the LO while splitting, saving a
+    // full-rate pass over memory.
+    template <int N, const double (&H)[N]> class HalfBandDecimateBy2 : public DecimateBy2 {
+        static_assert(N >= 7 && ((N - 3) % 4) == 0, "halfband length must be 4k+3");
+
       public:
-        HalfBandDecimateBy2(int length, const double *pCoef);
-        ~HalfBandDecimateBy2() {
-            if (m_pHBFirBuf)
-                delete m_pHBFirBuf;
+        HalfBandDecimateBy2() {
+            std::fill(std::begin(m_even_re), std::end(m_even_re), 0.0f);
+            std::fill(std::begin(m_even_im), std::end(m_even_im), 0.0f);
+            std::fill(std::begin(m_odd_re), std::end(m_odd_re), 0.0f);
+            std::fill(std::begin(m_odd_im), std::end(m_odd_im), 0.0f);
+        }
+        ~HalfBandDecimateBy2() {}
+        int Decimate(Cpx *in_cpx, Cpx *out_cpx, int length) override {
+            return run<false>(nullptr, QsNco::Cursor{0, 0}, in_cpx, out_cpx, length);
+        }
+        int MixDecimate(const QsNco &nco, QsNco::Cursor at, Cpx *in_cpx, Cpx *out_cpx, int length) override {
+            return run<true>(&nco, at, in_cpx, out_cpx, length);
         }
-        int Decimate(Cpx *in_cpx, Cpx *out_cpx, int length);
 
       private:
-        Cpx *m_pHBFirBuf;
-        int m_FirLength;
-        const double *m_pCoef;
+        template <bool MIX> int run(const QsNco *nco, QsNco::Cursor at, Cpx *in_cpx, Cpx *out_cpx, int length);
+
+        static constexpr int HB_CHUNK = 256;                 // outputs per inner pass
+        static constexpr int EVEN_TAPS = (N + 1) / 2;        // non-zero even taps
+        static constexpr int HALF_TAPS = EVEN_TAPS / 2;      // after symmetric folding
+        static constexpr int EVEN_HIST = (N - 1) / 2;        // even branch history
+        static constexpr int ODD_HIST = (EVEN_HIST + 1) / 2; // center tap delay
+        static constexpr float CENTER = static_cast<float>(H[(N - 1) / 2]);
+
+        struct Taps {
+            float h[HALF_TAPS];
+        };
+        static constexpr Taps foldTaps() {
+            Taps t{};
+            for (int k = 0; k < HALF_TAPS; k++)
+                t.h[k] = static_cast<float>(H[2 * k]);
+            return t;
+        }
+        static constexpr Taps TAPS = foldTaps();
+
+        // odd trailing input carried into the next call
+        Cpx m_pending;
+        bool m_have_pending = false;
+
+        alignas(64) float m_even_re[EVEN_HIST + HB_CHUNK];
+        alignas(64) float m_even_im[EVEN_HIST + HB_CHUNK];
+        alignas(64) float m_odd_re[ODD_HIST + HB_CHUNK];
+        alignas(64) float m_odd_im[ODD_HIST + HB_CHUNK];
+        alignas(64) float m_acc_re[HB_CHUNK];
+        alignas(64) float m_acc_im[HB_CHUNK];
+        alignas(64) float m_osc_re[2 * HB_CHUNK]; // LO for the fused path
+        alignas(64) float m_osc_im[2 * HB_CHUNK];
     };
 
-    class HalfBand11TapDecimateBy2 : public DecimateBy2 {
+    // Integer CIC decimate-by-R of order K. Samples are scaled to fixed
+    // point and run through wrapping 64 bit integrators and combs, so the
+    // recursive structure stays exact; a 3 tap [c, 1-2c, c] FIR at the
+    // output rate compensates the passband droop. Each integrator runs as
+    // one pass over a chunk, the combs only at the output rate.
+    class CICDecimateByR : public DecimateBy2 {
       public:
-        HalfBand11TapDecimateBy2();
-        ~HalfBand11TapDecimateBy2() {}
-        int Decimate(Cpx *in_cpx, Cpx *out_cpx, int length);
-        double H0; // unwrapped coeeficients
-        double H2;
-        double H4;
-        double H5;
-        double H6;
-        double H8;
-        double H10;
-        Cpx d0; // unwrapped delay buffer
-        Cpx d1;
-        Cpx d2;
-        Cpx d3;
-        Cpx d4;
-        Cpx d5;
-        Cpx d6;
-        Cpx d7;
-        Cpx d8;
-        Cpx d9;
+        CICDecimateByR(int order, int ratio, double passband);
+        ~CICDecimateByR() {}
+        int Decimate(Cpx *in_cpx, Cpx *out_cpx, int length) override;
+
+      private:
+        static constexpr int MAX_ORDER = QS_DECIM_CIC_MAX_ORDER;
+        static constexpr int CIC_CHUNK = 512; // inputs per pass
+        int m_order;
+        int m_ratio;
+        int m_phase;
+        float m_scale_out;
+        float m_comp_c;
+        float m_comp_m;
+        uint64_t m_int_re[MAX_ORDER];
+        uint64_t m_int_im[MAX_ORDER];
+        uint64_t m_comb_re[MAX_ORDER];
+        uint64_t m_comb_im[MAX_ORDER];
+        Cpx m_comp_d1;
+        Cpx m_comp_d2;
+        alignas(64) uint64_t m_buf_re[CIC_CHUNK];
+        alignas(64) uint64_t m_buf_im[CIC_CHUNK];
     };
 
-    class CIC3DecimateBy2 : public DecimateBy2 {
+    // Polyphase FIR decimate-by-M for the radix 3, 4 and 5 stages. Only every
+    // M-th output is computed; inputs are kept in split re/im planes so the
+    // per-output dot product vectorises across taps.
+    class FirDecimateByM : public DecimateBy2 {
       public:
-        CIC3DecimateBy2();
-        ~CIC3DecimateBy2() {}
-        int Decimate(Cpx *in_cpx, Cpx *out_cpx, int length);
+        FirDecimateByM(int ratio, const std::vector<float> &taps);
+        ~FirDecimateByM() {}
+        int Decimate(Cpx *in_cpx, Cpx *out_cpx, int length) override;
 
       private:
-        Cpx m_Xodd;
-        Cpx m_Xeven;
+        static constexpr int FIR_CHUNK = 1024; // inputs per pass
+        int m_ratio;
+        int m_length;
+        int m_padded;   // m_length rounded up to eight, for DotProduct8
+        int m_capacity; // inputs the planes hold
+        int m_fill;
+        qs_vect_f m_taps; // reversed, zero padded at the newest end
+        QsSplitCpx m_hist;
     };
 
+    static DecimateBy2 *makeHalfBand(int taps);
     void deleteFilters();
 
+    QsDecimPlan m_Plan;
     double m_OutputRate;
     double m_InRate;
     double m_MaxBW;
     std::mutex m_Mutex;
     DecimateBy2 *m_pDecimators[MAX_STAGES];
 };
+
+template <int N, const double (&H)[N]>
+template <bool MIX>
+int QsDownConvertor::HalfBandDecimateBy2<N, H>::run(const QsNco *nco, QsNco::Cursor at, Cpx *in_cpx, Cpx *out_cpx,
+                                                    int length) {
+    const float *in = reinterpret_cast<const float *>(in_cpx);
+    float *out = reinterpret_cast<float *>(out_cpx);
+    if (length <= 0)
+        return 0;
+    const int lead = m_have_pending ? 1 : 0;
+    const int total = (length + lead) / 2;
+    const Cpx carry = m_pending;
+    if (((length + lead) & 1) != 0) {
+        m_pending = in_cpx[length - 1];
+        if (MIX)
+            nco->mix(&m_pending, &m_pending, 1, nco->cursor(at, length - 1));
+        m_have_pending = true;
+    } else {
+        m_have_pending = false;
+    }
+
+    // every input of a chunk is loaded before any of its outputs is stored,
+    // and output j never passes input 2j, so in_cpx == out_cpx is safe
+    for (int base = 0; base < total; base += HB_CHUNK) {
+        const int n = std::min(HB_CHUNK, total - base);
+        // input complex index 2(base + i) - lead feeds even plane slot i
+        const float *src = in + 4 * base;
+        const int shift = 2 * lead;
+        int first = 0;
+
+        // ======== POLYPHASE SPLIT ===========
+        if (MIX) {
+            // LO for input complex indices [a, 2(base + n) - lead)
+            const int a = std::max(0, 2 * base - lead);
+            nco->generate(m_osc_re, m_osc_im, 2 * (base + n) - lead - a, nco->cursor(at, a));
+            const int d = 2 * base - lead - a; // 0, or -1 when the carry leads the first chunk
+            if (lead && base == 0) {
+                m_even_re[EVEN_HIST] = carry.real();
+                m_even_im[EVEN_HIST] = carry.imag();
+                m_odd_re[ODD_HIST] = src[0] * m_osc_re[0] - src[1] * m_osc_im[0];
+                m_odd_im[ODD_HIST] = src[0] * m_osc_im[0] + src[1] * m_osc_re[0];
+                first = 1;
+            }
+            for (int i = first; i < n; i++) {
+                const float er = src[4 * i - shift], ei = src[4 * i + 1 - shift];
+                const float or_ = src[4 * i + 2 - shift], oi = src[4 * i + 3 - shift];
+                const float ce = m_osc_re[2 * i + d], se = m_osc_im[2 * i + d];
+                const float co = m_osc_re[2 * i + 1 + d], so = m_osc_im[2 * i + 1 + d];
+                m_even_re[EVEN_HIST + i] = er * ce - ei * se;
+                m_even_im[EVEN_HIST + i] = er * se + ei * ce;
+                m_odd_re[ODD_HIST + i] = or_ * co - oi * so;
+                m_odd_im[ODD_HIST + i] = or_ * so + oi * co;
+            }
+        } else {
+            if (lead && base == 0) {
+                m_even_re[EVEN_HIST] = carry.real();
+                m_even_im[EVEN_HIST] = carry.imag();
+                m_odd_re[ODD_HIST] = src[0];
+                m_odd_im[ODD_HIST] = src[1];
+                first = 1;
+            }
+            for (int i = first; i < n; i++) {
+                m_even_re[EVEN_HIST + i] = src[4 * i - shift];
+                m_even_im[EVEN_HIST + i] = src[4 * i + 1 - shift];
+                m_odd_re[ODD_HIST + i] = src[4 * i + 2 - shift];
+                m_odd_im[ODD_HIST + i] = src[4 * i + 3 - shift];
+            }
+        }
+
+        // ======== CENTER TAP ===========
+        for (int i = 0; i < n; i++) {
+            m_acc_re[i] = CENTER * m_odd_re[i];
+            m_acc_im[i] = CENTER * m_odd_im[i];
+        }
+
+        // ======== EVEN BRANCH (symmetric fold) ===========
+        for (int k = 0; k < HALF_TAPS; k++) {
+            const float h = TAPS.h[k];
+            const float *ar = m_even_re + k;
+            const float *br = m_even_re + (EVEN_TAPS - 1 - k);
+            const float *ai = m_even_im + k;
+            const float *bi = m_even_im + (EVEN_TAPS - 1 - k);
+            for (int i = 0; i < n; i++) {
+                m_acc_re[i] += h * (ar[i] + br[i]);
+                m_acc_im[i] += h * (ai[i] + bi[i]);
+            }
+        }
+
+        float *dst = out + 2 * base;
+        for (int i = 0; i < n; i++) {
+            dst[2 * i] = m_acc_re[i];
+            dst[2 * i + 1] = m_acc_im[i];
+        }
+
+        // ======== HISTORY ===========
+        std::memmove(m_even_re, m_even_re + n, sizeof(float) * EVEN_HIST);
+        std::memmove(m_even_im, m_even_im + n, sizeof(float) * EVEN_HIST);
+        std::memmove(m_odd_re, m_odd_re + n, sizeof(float) * ODD_HIST);
+        std::memmove(m_odd_im, m_odd_im + n, sizeof(float) * ODD_HIST);
+    }
+    return total;
+}
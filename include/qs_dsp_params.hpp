@@ -0,0 +1,112 @@
+/**
+ * @file qs_dsp_params.hpp
+ * @brief Snapshot of the receiver settings the DSP chain reads.
+ *
+ * QsMemory publishes a QsDspParams for receiver 1 through a QsSeqlock
+ * every time the command side changes one of these settings. The DSP
+ * thread copies it once per block, and only when the sequence moved, then
+ * hands it to the stages' update(). Each group of settings carries its own
+ * version, so a stage rebuilds its filter or coefficients only when its
+ * own group changed, not on every volume step.
+ *
+ * Features:
+ * - Plain data: copied whole, compared by version, never by value
+ * - One version per QsParamGroup, bumped by the setters of that group
+ *
+ * Usage:
+ * 1. QsDspParams p = QsGlobal::g_memory->params();   // any thread
+ * 2. if (p.version[pgAgc] != m_version) { ... }      // in a stage's update()
+ *
+ * Notes:
+ * - Versions start at 1, so a stage whose m_version is 0 takes the first
+ *   snapshot it sees.
+ * - Outputs of the DSP chain (S meter value, AGC gain) are not settings and
+ *   stay plain QsMemory fields.
+ */
+
+#pragma once
+
+#include "../include/qs_defines.hpp"
+
+#include <cstdint>
+
+enum QsParamGroup {
+    pgFilter = 0, // main and post filter edges
+    pgAgc,
+    pgToneGen, // tone LO, CW offset and TX offset frequencies
+    pgDemod,   // mode, binaural, detectors, audio rate stage
+    pgNoiseBlanker,
+    pgAutoNotch,
+    pgNoiseReduction,
+    pgSquelch,
+    pgVolume,
+    pgNotch, // manual notches
+    pgSMeter,
+    pgCount
+};
+
+struct QsDspParams {
+    uint32_t version[pgCount];
+
+    // FILTER
+    int filter_lo;
+    int filter_hi;
+
+    // AGC
+    double agc_decay;
+    double agc_threshold;
+    double agc_fixed_gain;
+    double agc_slope;
+    double agc_hang_time;
+    bool agc_hang_switch;
+
+    // TONE GENERATORS
+    double tone_lo_freq;
+    double offset_freq;
+    double tx_offset_freq;
+
+    // DEMOD
+    QSDEMODMODE demod_mode;
+    bool binaural;
+    int fm_detector;
+    int sam_tracking;
+    bool audio_rate_stage;
+
+    // NOISE BLANKERS
+    bool anb_on;
+    double anb_threshold;
+    bool bnb_on;
+    double bnb_threshold;
+
+    // ANF
+    bool anf_on;
+    double anf_rate;
+    double anf_leak;
+    int anf_delay;
+    int anf_taps;
+    int anf_alg;
+
+    // NR
+    bool nr_on;
+    double nr_rate;
+    double nr_leak;
+    int nr_delay;
+    int nr_taps;
+    int nr_mode;
+    int nr_alg;
+
+    // SQUELCH
+    bool squelch_on;
+    double squelch_threshold;
+
+    // VOLUME
+    double volume;
+
+    // MANUAL NOTCHES
+    float notch_freq[MAX_MAN_NOTCHES];
+    float notch_bw[MAX_MAN_NOTCHES];
+    bool notch_on[MAX_MAN_NOTCHES];
+
+    // S METER
+    double smeter_correction;
+};
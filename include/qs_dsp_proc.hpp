@@ -4,14 +4,16 @@
  *
  * This class is responsible for initializing, managing, and processing digital signals
  * through various audio processing components, including noise blankers, filters, and demodulators.
- * It utilizes libresamplerate resampling for audio signal conversion and handles buffer management
- * for efficient signal processing.
+ * It resamples the audio to the output rate with a rational polyphase resampler and handles
+ * buffer management for efficient signal processing.
  *
  * Features:
  * - Integration with multiple DSP components such as tone generators, noise blankers, and filters.
  * - Resampling functionality to adjust audio sample rates.
  * - Thread management for real-time audio processing.
  * - Buffer management for input and output signals.
+ * - Settings from QsMemory's versioned snapshot: one sequence check per
+ *   block, and the stages see a change only when their group moved.
  *
  * Usage:
  * - Create an instance of QsDspProcessor and call init() to set up DSP components.
@@ -56,17 +58,20 @@ class QsAMDemodulator;
 class QsToneGenerator;
 class QsAveragingNoiseBlanker;
 class QsBlockNoiseBlanker;
-class QsDownConvertor;
+class QsFrontEnd;
 class QsMainRxFilter;
 class QsPostRxFilter;
 class QsSAMDemodulator;
 class QsFMCombinedDemodulator;
 class QsNoiseReductionFilter;
+class QsSpectralNotches;
+class QsSpectralNoiseReduction;
 class QsAutoNotchFilter;
 class QsSMeter;
 class QsSquelch;
 class QsVolume;
-class QS_IIR;
+class QsBiquadCascade;
+class QsAudioDecimator;
 class Resampler;
 class QsSleep;
 
@@ -74,6 +79,8 @@ class QsSleep;
 #include <memory>
 #include <thread>
 
+#include "../include/qs_dsp_params.hpp"
+#include "../include/qs_dsp_stats.hpp"
 #include "../include/qs_types.hpp"
 #include "../include/qs_sleep.hpp"
 
@@ -83,7 +90,7 @@ class QsDspProcessor {
     std::unique_ptr<QsToneGenerator> p_tg0;
     std::unique_ptr<QsAveragingNoiseBlanker> p_anb;
     std::unique_ptr<QsBlockNoiseBlanker> p_bnb;
-    std::unique_ptr<QsDownConvertor> p_downconv;
+    std::unique_ptr<QsFrontEnd> p_frontend;
     std::unique_ptr<QsToneGenerator> p_tg1;
     std::unique_ptr<QsAgc> p_agc;
     std::unique_ptr<QsMainRxFilter> p_main_filter;
@@ -92,18 +99,14 @@ class QsDspProcessor {
     std::unique_ptr<QsSAMDemodulator> p_sam;
     std::unique_ptr<QsFMCombinedDemodulator> p_fm;
     std::unique_ptr<QsNoiseReductionFilter> p_nr;
+    std::unique_ptr<QsSpectralNotches> p_notches;
+    std::unique_ptr<QsSpectralNoiseReduction> p_snr;
     std::unique_ptr<QsAutoNotchFilter> p_anf;
     std::unique_ptr<QsSMeter> p_sm;
     std::unique_ptr<QsSquelch> p_sq;
     std::unique_ptr<QsVolume> p_vol;
-    std::unique_ptr<QS_IIR> p_iir0;
-    std::unique_ptr<QS_IIR> p_iir1;
-    std::unique_ptr<QS_IIR> p_iir2;
-    std::unique_ptr<QS_IIR> p_iir3;
-    std::unique_ptr<QS_IIR> p_iir4;
-    std::unique_ptr<QS_IIR> p_iir5;
-    std::unique_ptr<QS_IIR> p_iir6;
-    std::unique_ptr<QS_IIR> p_iir7;
+    std::unique_ptr<QsBiquadCascade> p_iir_notches;
+    std::unique_ptr<QsAudioDecimator> p_audio_decim;
     std::unique_ptr<Resampler> resampler;
 
     explicit QsDspProcessor();
@@ -116,6 +119,13 @@ class QsDspProcessor {
     void stop();
     bool isRunning();
 
+    // post processing blocks since start(), any thread
+    uint64_t blocksProcessed();
+    // CPU time of the DSP thread (not the front end workers), while running
+    double cpuSeconds();
+    // per-stage time per block, any thread
+    QsDspStats &stats() { return m_stats; }
+
   private:
     void run();
 
@@ -130,8 +140,15 @@ class QsDspProcessor {
 
     std::atomic<bool> m_thread_go;
     std::atomic<bool> m_is_running;
+    std::atomic<uint64_t> m_blocks;
+    QsDspStats m_stats;
     bool m_dac_bypass;
     bool m_rt_audio_bypass;
+    bool m_squelched; // previous block was muted by the squelch
+
+    // settings the stages run with, and the snapshot they came from
+    QsDspParams m_params;
+    uint64_t m_params_seq;
 
     double m_processing_rate;
     double m_post_processing_rate;
@@ -148,10 +165,16 @@ class QsDspProcessor {
     double m_rs_output_rate;
     double m_rs_input_rate;
     int m_rs_quality;
-    qs_vect_f rs_in_interleaved;
+    qs_vect_f au_f; // mono audio after the audio rate stage
+    qs_vect_f rs_out_mono;
+    qs_vect_cpx rs_out_cpx;
     qs_vect_f rs_out_interleaved;
 
     std::thread m_thread;
+    void syncParams();
     void initResampler(int size);
+    void updateAudioRate();
+    void processChunks(Cpx *data, int length, int demod_mode);
+    int holdAudio();
     void initManualNotch();
 };
@@ -0,0 +1,147 @@
+/**
+ * @file qs_dsp_stats.hpp
+ * @brief Per-stage time accounting for the DSP thread.
+ *
+ * QsDspProcessor::run() takes a time stamp at each stage boundary and
+ * charges the interval to that stage. At the end of every post processing
+ * block the per-stage totals go into log-linear histograms, so the server
+ * can report p50 / p99 / max nanoseconds per block for each stage, and how
+ * much of the block's real-time budget the whole chain used.
+ *
+ * Features:
+ * - Time stamps from QsTicks (one rdtsc on x86, no syscall); ticks are
+ *   converted to ns only when a report is made
+ * - Each lap is also a trace span when the trace recorder is on
+ * - Histograms with 8 buckets per octave, so percentiles are within 1/8
+ * - Budget utilization: busy time over signal time since reset, and the
+ *   per-block figure as its own histogram (the "block" row)
+ * - Reset from any thread; the DSP thread applies it at the next block end
+ * - Off switch: with stats and trace disabled the stage boundaries skip
+ *   the clock
+ * - Optional hardware counters per stage (perf()), charged at the same
+ *   boundaries
+ *
+ * Usage:
+ * 1. stats.configure(post_rate, block_size);          // top of run()
+ * 2. uint64_t t = stats.begin();
+ *    p_agc->process(...);
+ *    t = stats.lap(stAgc, t);                          // charge and restart
+ * 3. stats.endBlock();                                 // once per post block
+ * 4. stats.report();                                   // any thread
+ *
+ * Notes:
+ * - Writers are the DSP thread only; report() from another thread may see
+ *   a block half recorded, never torn counts.
+ * - Front end and noise blanker time is charged to the post block that
+ *   ends next, so "block" covers the whole thread.
+ * - Counter samples are the stage's input block: read-in samples for the
+ *   noise blankers and front end, post processing samples after.
+ */
+
+#pragma once
+
+#include "../include/qs_histogram.hpp"
+#include "../include/qs_perf_counters.hpp"
+#include "../include/qs_ticks.hpp"
+#include "../include/qs_trace.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+enum QsDspStage {
+    stNoiseBlanker = 0,
+    stFrontEnd, // LO mix (tone generator) and down converter, fused in the front end
+    stMainFilter,
+    stNotch,
+    stToneGen, // CW offset tone
+    stSMeter,
+    stAgc,
+    stDemod,
+    stPostFilter,
+    stAudioRate,
+    stSquelch,
+    stAutoNotch,
+    stNoiseReduction,
+    stResampler,
+    stVolume,
+    stOutput, // ring writes
+    stBlock,  // the whole block
+    stCount
+};
+
+class QsDspStats {
+  public:
+    struct Summary {
+        uint64_t count;
+        double p50_ns;
+        double p99_ns;
+        double max_ns;
+        double mean_ns;
+    };
+
+    QsDspStats();
+
+    static const char *stageName(QsDspStage stage);
+
+    // block duration for the utilization figures; DSP thread, top of run()
+    void configure(double post_rate, int block_size);
+
+    void setEnabled(bool value) { m_enabled.store(value, std::memory_order_relaxed); }
+    bool enabled() const { return m_enabled.load(std::memory_order_relaxed); }
+
+    // start of a timed run of stages; 0 when stats, trace and counters are off
+    inline uint64_t begin() {
+        if (m_perf.active())
+            m_perf.mark();
+        return enabled() || QsTrace::enabled() || m_perf.active() ? QsTicks::now() : 0;
+    }
+
+    // charge now - since to stage, return now (the next stage's start);
+    // the same interval goes to the trace as a span
+    inline uint64_t lap(QsDspStage stage, uint64_t since) {
+        if (!since)
+            return 0;
+        uint64_t now = QsTicks::now();
+        m_pending[stage] += now - since;
+        m_touched |= 1u << stage;
+        if (QsTrace::enabled())
+            QsTrace::complete(stageName(stage), since, now);
+        if (m_perf.active())
+            m_perf.lap(stage, stage <= stFrontEnd ? m_block_size : 0);
+        return now;
+    }
+
+    // a post processing block is done: record every stage it touched
+    void endBlock();
+
+    // per stage hardware counters, off until enabled; close() as run() ends
+    QsPerfCounters &perf() { return m_perf; }
+
+    // any thread
+    void requestReset() { m_reset.store(true, std::memory_order_relaxed); }
+    Summary summary(QsDspStage stage) const;
+    uint64_t blocks() const { return m_blocks.load(std::memory_order_relaxed); }
+    // busy time over signal time since reset
+    double utilization() const;
+    // "blocks n, util u, peak p, <stage> p50/p99/max, ..." in ns per block
+    std::string report() const;
+
+  private:
+    void clear();
+
+    std::atomic<bool> m_enabled;
+    std::atomic<bool> m_reset;
+
+    // DSP thread only
+    uint64_t m_pending[stCount];
+    uint32_t m_touched;
+
+    double m_block_ns;
+    int m_block_size;
+    std::atomic<uint64_t> m_blocks;
+    std::atomic<uint64_t> m_busy; // ticks, every block since reset
+
+    QsHistogram m_hist[stCount];
+    QsPerfCounters m_perf;
+};
@@ -1,5 +1,6 @@
 #pragma once
 
+#include "../include/qs_dsp_params.hpp"
 #include "../include/qs_types.hpp" // Complex vector definition
 #include <cmath>
 
@@ -11,12 +12,17 @@ class QsFMCombinedDemodulator {
 
     // Initialize the demodulator with a given mode (NARROW or WIDE)
     void init(DemodMode mode);
+    // Detector (fmPll or fmQuadrature) from a new settings snapshot
+    void update(const QsDspParams &params);
 
-    // Process the input vector of complex samples and demodulate them
+    // Process the input vector of complex samples and demodulate them; the
+    // detector is QsMemory's FM detector setting
     void process(qs_vect_cpx &src_dst, DemodMode mode=NARROW);
+    void process(Cpx *src_dst, int length, DemodMode mode=NARROW);
 
   private:
     DemodMode m_mode; // Mode selector (NARROW or WIDE)
+    int m_detector;   // fmPll or fmQuadrature
 
     // Internal variables for demodulation parameters
     float m_bw;           // Bandwidth
@@ -36,6 +42,15 @@ class QsFMCombinedDemodulator {
     float m_dc_alpha;     // Alpha coefficient for DC error compensation
     float m_outgain;      // Output gain factor
 
-    // Utility functions could be declared here if needed (e.g., private helper functions)
+    Cpx m_prev; // Last input sample, for the quadrature discriminator
+
+    // loop constants and state for a mode, the detector unchanged
+    void configure(DemodMode mode);
+
+    // PLL detector: tracks the carrier with an NCO, best for weak signals
+    void processPll(Cpx *src_dst, int length);
+    // Quadrature detector: arg(x[n] * conj(x[n-1])), block-wise; the phase
+    // steps live in the thread's QsArena for the call
+    void processQuadrature(Cpx *src_dst, int length);
 };
 
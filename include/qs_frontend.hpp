@@ -0,0 +1,87 @@
+/**
+ * @file qs_frontend.hpp
+ * @brief Full-rate receive front end: LO mixing and decimation, optionally
+ *        split across several cores.
+ *
+ * The QsFrontEnd applies the tone generator (LO) and runs the decimation
+ * chain chosen by QsDecimationPlanner. At the highest FPGA rates the
+ * full-rate head of the chain is split across a QsWorkerPool: every worker
+ * owns a private copy of the head stages, mixes and decimates one segment of
+ * the block, and is warmed up on the filter-history overlap that precedes
+ * its segment so its outputs are identical to the serial chain. The
+ * decimated segments land in disjoint slices of one buffer and the
+ * low-rate tail of the chain runs serially on the calling thread.
+ *
+ * Features:
+ * - Serial path identical to QsToneGenerator::process + QsDownConvertor::process
+ * - LO mixing fused into the first decimation stage on both paths
+ * - Parallel head for input rates >= QS_FE_PARALLEL_MIN_RATE
+ * - Overlap sized from the head stages' history, rounded to the head decimation
+ * - Persistent threads, no allocation per block
+ *
+ * Usage:
+ * 1. fe.init(&tone_gen, in_rate, bandwidth, block_size, threads);
+ * 2. n = fe.process(in, out, block_size);   // returns decimated length
+ *
+ * Notes:
+ * - QsDspProcessor takes the thread count from the FrontEndThreads setting
+ *   (server command of the same name), capped at the core count; the
+ *   default of 1 keeps the serial path.
+ * - The noise blankers run before the front end and stay serial; their
+ *   long running averages do not split across segments.
+ * - In parallel mode a block of another length than the init block size
+ *   runs the head serially on the calling thread; a length that is not a
+ *   multiple of the head decimation shifts the decimation phase once.
+ */
+
+#pragma once
+
+#include "../include/qs_decim_planner.hpp"
+#include "../include/qs_types.hpp"
+#include "../include/qs_worker_pool.hpp"
+
+#include <memory>
+#include <vector>
+
+class QsDownConvertor;
+class QsToneGenerator;
+
+class QsFrontEnd {
+  public:
+    QsFrontEnd();
+    ~QsFrontEnd();
+
+    double init(QsToneGenerator *tg, double in_rate, double bandwidth, int block_size, int threads);
+    int process(Cpx *in_cpx, Cpx *out_cpx, int length);
+
+    int threads() const { return m_parallel ? m_pool.size() : 1; }
+    const QsDecimPlan &plan() const { return m_plan; }
+
+  private:
+    struct Segment {
+        std::unique_ptr<QsDownConvertor> head;
+        qs_vect_cpx scratch;
+        int start;
+        int length;
+    };
+
+    int processSerial(Cpx *in_cpx, Cpx *out_cpx, int length);
+    static void segmentJob(void *ctx, int index);
+    void runSegment(Segment &seg);
+
+    QsToneGenerator *m_tg;
+    QsDecimPlan m_plan;
+    std::unique_ptr<QsDownConvertor> m_chain; // whole chain (serial) or tail (parallel)
+    std::unique_ptr<QsDownConvertor> m_odd_head; // head for blocks of another size
+    std::vector<Segment> m_segments;
+    QsWorkerPool m_pool;
+
+    qs_vect_cpx m_prev; // last m_overlap inputs of the previous block
+    qs_vect_cpx m_mid;  // head outputs, one slice per segment
+    const Cpx *m_in;
+    int m_in_length;
+    int m_block_size;
+    int m_overlap;
+    int m_head_decim;
+    bool m_parallel;
+};
@@ -35,6 +35,7 @@
 #include "../include/qs_dac_writer.hpp"
 #include "../include/qs_dsp_proc.hpp"
 #include "../include/qs_circ_buf.hpp"
+#include "../include/qs_latency.hpp"
 #include <libusb-1.0/libusb.h>
 
 #include <memory>
@@ -56,6 +57,7 @@ public:
 	static std::unique_ptr<QsCircularBuffer<float>> g_float_dac_ring;
 	static std::unique_ptr<QsIOLib_LibUSB> g_io;
 	static std::unique_ptr<QsMemory> g_memory;	
+	static std::unique_ptr<QsLatency> g_latency;
 	static bool g_swap_iq;
 	static bool g_is_hardware_init;
 }; 
\ No newline at end of file
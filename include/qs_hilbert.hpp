@@ -14,6 +14,8 @@
  * Usage:
  * - Initialize with the number of taps.
  * - Call process() to transform real or complex input into complex output.
+ *   Real input must hold length + taps - 1 samples; the complex overload
+ *   keeps that history itself, so its output lags the input by taps / 2.
  * 
  * @note This class is primarily used for signal processing in DSP applications.
  * 
@@ -33,7 +35,9 @@ class QsHilbert {
     int process(qs_vect_cpx &in_cpx, qs_vect_cpx &out_cpx, unsigned int length);
 
   private:
+    int process(const float *in_f, Cpx *out_cpx, unsigned int length);
     float filter(const float input[]);
     qs_vect_f MakeHilbertTaps(int wtype, unsigned int length);
     qs_vect_f m_taps;
+    qs_vect_f m_hist; // last taps - 1 real inputs, for the complex overload
 };
@@ -0,0 +1,73 @@
+/**
+ * @file qs_histogram.hpp
+ * @brief Log-linear histogram of unsigned values for the timing statistics.
+ *
+ * Counts values in 8 buckets per octave (exact below 16), so a percentile
+ * read back is within 1/8 of the true value at any scale, from a few ticks
+ * to seconds of ns. One thread records; any thread may read.
+ *
+ * Features:
+ * - 512 buckets cover the whole uint64_t range, no configuration
+ * - record() is a handful of relaxed loads and stores, no locked RMW
+ * - Count, sum, max and percentiles; merge() sums two for a combined view
+ *
+ * Usage:
+ * 1. QsHistogram h;
+ * 2. h.record(ns);                        // writer thread
+ * 3. h.percentile(0.99);                  // any thread
+ *
+ * Notes:
+ * - A reader may see a record half applied (bucket counted, sum not yet);
+ *   it never sees a torn value.
+ * - clear() and merge() into a histogram are for its writer (or a local
+ *   copy) only.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+
+class QsHistogram {
+  public:
+    static const int BUCKETS = 512;
+
+    QsHistogram();
+
+    // single writer: plain load / store, no locked read-modify-write
+    inline void record(uint64_t v) {
+        bump(m_bucket[bucketOf(v)], 1);
+        bump(m_count, 1);
+        bump(m_sum, v);
+        if (v > m_max.load(std::memory_order_relaxed))
+            m_max.store(v, std::memory_order_relaxed);
+    }
+
+    void clear();
+    void merge(const QsHistogram &other);
+
+    uint64_t count() const { return m_count.load(std::memory_order_relaxed); }
+    uint64_t sum() const { return m_sum.load(std::memory_order_relaxed); }
+    uint64_t max() const { return m_max.load(std::memory_order_relaxed); }
+    double mean() const;
+    // q in 0..1, from the bucket midpoints, never above max()
+    double percentile(double q) const;
+
+  private:
+    static inline void bump(std::atomic<uint64_t> &a, uint64_t v) {
+        a.store(a.load(std::memory_order_relaxed) + v, std::memory_order_relaxed);
+    }
+
+    static inline int bucketOf(uint64_t v) {
+        if (v < 16)
+            return static_cast<int>(v);
+        int octave = 63 - __builtin_clzll(v);
+        return (octave - 2) * 8 + static_cast<int>((v >> (octave - 3)) & 7);
+    }
+    static double bucketMid(int index);
+
+    std::atomic<uint64_t> m_bucket[BUCKETS];
+    std::atomic<uint64_t> m_count;
+    std::atomic<uint64_t> m_sum;
+    std::atomic<uint64_t> m_max;
+};
@@ -0,0 +1,119 @@
+/**
+ * @file qs_latency.hpp
+ * @brief Rolling latency histograms along the receive path, USB read to DAC.
+ *
+ * The block tags (qs_block_tag.hpp) carry the reader's time stamp down the
+ * chain. Each stage that takes a tag off a ring, or hands one to the next,
+ * records how long the samples spent in that hop:
+ *
+ *   readin    g_cpx_readin_ring, reader to DSP thread
+ *   frontend  noise blankers, LO and decimation chain (plus its group delay)
+ *   sd        g_cpx_sd_ring, front end to post processing
+ *   post      post processing to g_float_dac_ring (plus the audio decimator
+ *             and resampler group delay)
+ *   dac       g_float_dac_ring and the EP2 write
+ *   total     reader time stamp to EP2 write done, delays included
+ *
+ * Features:
+ * - Rolling window: two histogram generations per hop, swapped every
+ *   QS_DEFAULT_LATENCY_WINDOW_S seconds; a report covers the last one to
+ *   two windows
+ * - Sequence gaps per hop: block numbers missing from the tags a hop
+ *   received. A drop shows at its own hop and every hop after it
+ * - Reset from any thread; each hop's writer applies it on its next record
+ *
+ * Usage:
+ * 1. ring->read(samples, n);
+ *    bool tagged = QsGlobal::g_latency->take(lhSdRing, *ring, tag);
+ * 2. ... process ...
+ *    if (tagged)
+ *        QsGlobal::g_latency->pass(lhPost, *next, tag, delay_ns, m);
+ *    next->write(out, m);
+ * 3. QsGlobal::g_latency->report();                         // any thread
+ *
+ * Notes:
+ * - Each hop has one writer thread (the DSP thread for readin .. post, the
+ *   DAC writer for dac and total).
+ * - Latency is that of the newest tagged sample a read returned; samples
+ *   earlier in the same block waited up to one block longer.
+ */
+
+#pragma once
+
+#include "../include/qs_block_tag.hpp"
+#include "../include/qs_circ_buf.hpp"
+#include "../include/qs_histogram.hpp"
+
+#include <atomic>
+#include <chrono>
+#include <cstdint>
+#include <string>
+
+enum QsLatencyHop { lhReadIn = 0, lhFrontEnd, lhSdRing, lhPost, lhDacRing, lhTotal, lhCount };
+
+class QsLatency {
+  public:
+    QsLatency();
+
+    static inline int64_t now() {
+        return std::chrono::duration_cast<std::chrono::nanoseconds>(
+                   std::chrono::steady_clock::now().time_since_epoch())
+            .count();
+    }
+
+    static const char *hopName(QsLatencyHop hop);
+
+    // hop writer thread: to_ns - from_ns, to_ns also drives the window
+    void record(QsLatencyHop hop, int64_t from_ns, int64_t to_ns);
+    // hop writer thread: sequence check of a tag taken off a ring
+    void arrive(QsLatencyHop hop, const QsBlockTag &tag, uint64_t missing);
+
+    // after a read from ring: collect the tag of the samples read, check its
+    // sequence and record the time in the ring; tag.hop_ns becomes now, the
+    // start of the stage that follows. False (nothing recorded) if untagged.
+    template <typename T> bool take(QsLatencyHop hop, QsCircularBuffer<T> &ring, QsBlockTag &tag) {
+        uint64_t missing = 0;
+        if (!ring.popTag(tag, missing))
+            return false;
+        int64_t t = now();
+        arrive(hop, tag, missing);
+        record(hop, tag.hop_ns, t);
+        tag.hop_ns = t;
+        return true;
+    }
+
+    // before a write of length to ring: record the stage since take() plus
+    // its filter group delay, and tag the samples. A write that will not fit
+    // whole goes untagged, so the drop shows as a sequence gap downstream.
+    template <typename T>
+    void pass(QsLatencyHop hop, QsCircularBuffer<T> &ring, QsBlockTag tag, int64_t delay_ns, uint32_t length) {
+        int64_t t = now();
+        record(hop, tag.hop_ns - delay_ns, t);
+        tag.origin_ns -= delay_ns;
+        tag.hop_ns = t;
+        if (ring.writeAvail() >= length)
+            ring.pushTag(tag);
+    }
+
+    // any thread
+    void requestReset();
+    uint64_t gaps(QsLatencyHop hop) const { return m_hop[hop].gaps.load(std::memory_order_relaxed); }
+    // "<hop> p50/p99/max us gaps n, ..." over the rolling window
+    std::string report() const;
+
+  private:
+    struct Hop {
+        QsHistogram gen[2];
+        std::atomic<int> current;
+        int64_t window_start; // writer only
+        std::atomic<bool> reset;
+        std::atomic<uint64_t> gaps;
+        uint64_t last; // writer only: last sequence received
+        bool seen;
+    };
+
+    void rotate(Hop &hop, int64_t t);
+
+    int64_t m_window_ns;
+    Hop m_hop[lhCount];
+};
@@ -12,9 +12,15 @@
  * - Initialize and apply a bandpass FIR filter on complex signals.
  * - Generate real and complex window functions (e.g., Blackman-Harris).
  * - Dynamic filter creation based on input parameters such as frequency range and sample rate.
+ * - Frequency-domain stage hook (QsSpectralStage): manual notches, spectral NR
+ *   and the like share the filter's one forward and one inverse FFT per block.
  * 
  * Usage:
  * - Initialize the filter with a specified size.
+ * - Pass each new settings snapshot to `update()`; the kernel is rebuilt when
+ *   the filter edges or a stage's static gains change.
+ * - Register frequency-domain stages with `addStage()` before `init()`;
+ *   registering a stage again is a no-op.
  * - Use `process()` to filter complex signals.
  * - Generate real or complex windows with static methods like `MakeWindow()`.
  * 
@@ -30,11 +36,13 @@
 #include "../include/qs_defines.hpp"
 #include "../include/qs_fft.hpp"
 #include "../include/qs_globals.hpp"
+#include "../include/qs_spectral_stage.hpp"
 #include "../include/qs_stringclass.hpp"
 
 #include <algorithm>
 #include <iterator>
 #include <memory>
+#include <vector>
 
 #define BLACKMANHARRIS_WINDOW 12
 
@@ -44,10 +52,13 @@ class QsMainRxFilter {
     QsMainRxFilter();
 
     void init(int size);
+    void update(const QsDspParams &params);
     void process(qs_vect_cpx &src_dst);
+    void addStage(QsSpectralStage *stage);
 
     static void MakeWindow(int wtype, int size, qs_vect_cpx &window);
     static void MakeWindow(int wtype, int size, qs_vect_f &window);
+    static void MakeWindow(int wtype, int size, float *window);
     static qs_vect_f MakeWindow(int wtype, int size);
     static qs_vect_cpx MakeWindowComplex(int wtype, int size);
 
@@ -56,6 +67,7 @@ class QsMainRxFilter {
     float m_samplerate;
     int m_filter_lo;
     int m_filter_hi;
+    uint32_t m_version; // pgFilter
     float m_one_over_norm;
 
     std::unique_ptr<QsFFT> p_ovlpfft;
@@ -67,9 +79,15 @@ class QsMainRxFilter {
     qs_vect_cpx cpx_1;
     qs_vect_cpx ovlp;
     qs_vect_cpx filt_cpx0;
+    qs_vect_f kernel_gain;
+    qs_vect_cpx block_cpx0; // kernel with this block's dynamic gains
+    qs_vect_f block_gain;
+
+    std::vector<QsSpectralStage *> m_stages; // not owned
 
     void MakeFirBandpass(float lo, float hi, float samplerate, int wtype, qs_vect_f &taps_re, qs_vect_f &taps_im,
                          int length);
 
     void MakeFilter(float lo, float hi);
+    bool MakeBlockFilter();
 };
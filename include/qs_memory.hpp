@@ -3,6 +3,9 @@
 
 #include "../include/qs_defaults.hpp"
 #include "../include/qs_defines.hpp"
+#include "../include/qs_dsp_params.hpp"
+#include "../include/qs_seqlock.hpp"
+#include <mutex>
 #include <string>
 
 class QsMemory {
@@ -12,6 +15,12 @@ class QsMemory {
 
     void clockCorrectionChanged(double);
 
+    // DSP SETTINGS SNAPSHOT, receiver 1; the setters below publish
+    QsDspParams params();
+    uint64_t paramsSequence();
+    // one wait-free attempt, for the DSP thread
+    bool tryParams(QsDspParams &value, uint64_t &seq);
+
     // VOLUME
     void setVolume(double value, int rx_num = 0);
     double getVolume(int rx_num = 0);
@@ -67,6 +76,16 @@ class QsMemory {
     void setBinauralMode(bool value, int rx_num = 0);
     bool getBinauralMode(int rx_num = 0);
 
+    void setFmDetector(int value, int rx_num = 0);
+    int getFmDetector(int rx_num = 0);
+
+    void setSamTracking(int value, int rx_num = 0);
+    int getSamTracking(int rx_num = 0);
+
+    // AUDIO RATE STAGE
+    void setAudioRateStage(bool value, int rx_num = 0);
+    bool getAudioRateStage(int rx_num = 0);
+
     // AVG NOISEBLANKER
     void setAvgNoiseBlankerThreshold(double value, int rx_num = 0);
     double getAvgNoiseBlankerThreshold(int rx_num = 0);
@@ -98,6 +117,9 @@ class QsMemory {
     void setAutoNotchTaps(int value, int rx_num = 0);
     int getAutoNotchTaps(int rx_num = 0);
 
+    void setAutoNotchAlgorithm(int value, int rx_num = 0);
+    int getAutoNotchAlgorithm(int rx_num = 0);
+
     // NR
 
     void setNoiseReductionOn(bool value, int rx_num = 0);
@@ -115,6 +137,12 @@ class QsMemory {
     void setNoiseReductionTaps(int value, int rx_num = 0);
     int getNoiseReductionTaps(int rx_num = 0);
 
+    void setNoiseReductionMode(int value, int rx_num = 0);
+    int getNoiseReductionMode(int rx_num = 0);
+
+    void setNoiseReductionAlgorithm(int value, int rx_num = 0);
+    int getNoiseReductionAlgorithm(int rx_num = 0);
+
     // S METER
 
     void setSMeterCurrentValue(double value, int rx_num = 0);
@@ -204,6 +232,9 @@ class QsMemory {
     void setResamplerQuality(int value);
     int getResamplerQuality();
 
+    void setFrontEndThreads(int value);
+    int getFrontEndThreads();
+
     void setResamplerRate(double value);
     double getResamplerRate();
 
@@ -261,6 +292,13 @@ class QsMemory {
     double getGateLevelVal();
 
   private:
+    void publish(QsParamGroup group, int rx_num = 0);
+    void fillParams(QsDspParams &p);
+
+    std::mutex m_params_mutex;
+    QsDspParams m_params_next; // under m_params_mutex
+    QsSeqlock<QsDspParams> m_params;
+
     double m_volume[MAX_RECEIVERS];
 
     // AGC
@@ -291,6 +329,9 @@ class QsMemory {
 
     // BINAURAL
     bool m_binaural_mode[MAX_RECEIVERS];
+    int m_fm_detector[MAX_RECEIVERS];
+    int m_sam_tracking[MAX_RECEIVERS];
+    bool m_audio_rate_stage[MAX_RECEIVERS];
 
     // ANB
     double m_avg_nb_threshold[MAX_RECEIVERS];
@@ -304,6 +345,7 @@ class QsMemory {
     bool m_autonotch_switch[MAX_RECEIVERS];
     double m_autonotch_rate[MAX_RECEIVERS];
     double m_autonotch_leak[MAX_RECEIVERS];
+    int m_autonotch_alg[MAX_RECEIVERS];
     int m_autonotch_delay[MAX_RECEIVERS];
     int m_autonotch_taps[MAX_RECEIVERS];
 
@@ -313,6 +355,8 @@ class QsMemory {
     double m_noise_reduction_leak[MAX_RECEIVERS];
     int m_noise_reduction_delay[MAX_RECEIVERS];
     int m_noise_reduction_taps[MAX_RECEIVERS];
+    int m_noise_reduction_mode[MAX_RECEIVERS];
+    int m_noise_reduction_alg[MAX_RECEIVERS];
 
     // S METER
     double m_s_meter_cv[MAX_RECEIVERS];
@@ -374,6 +418,7 @@ class QsMemory {
     int m_tx_block_size;
 
     int m_resampler_quality;
+    int m_fe_threads;
 
     double m_resampler_rate;
     double m_enc_clock_freq;
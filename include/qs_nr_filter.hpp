@@ -12,10 +12,12 @@
  * - Adaptive noise reduction based on the signal content.
  * - Configurable adaptation rate and leakage for performance tuning.
  * - Flexible delay handling for varied signal processing needs.
+ * - Prediction runs on the shared QsAdaptiveFilter engine; NLMS, block LMS
+ *   or frequency-domain adaptation selected per receiver.
  * 
  * Usage:
  * - Create an instance of the class and call init() to set the desired 
- *   size.
+ *   size, and pass each new settings snapshot to update().
  * - Use process() to apply the noise reduction to a vector of complex signals.
  * 
  * @note This class is intended for use in digital signal processing (DSP) 
@@ -27,6 +29,7 @@
 
 #pragma once
 
+#include "../include/qs_adaptive_filter.hpp"
 #include "../include/qs_signalops.hpp"
 #include "../include/qs_globals.hpp"
 
@@ -35,22 +38,20 @@ using namespace std;
 class QsNoiseReductionFilter {
   private:
     bool m_nr_switch;
-    int m_nr_lms_sz;
-    int m_nr_delay;
-    int m_nr_dl_indx;
-    int m_nr_mask;
+    uint32_t m_version; // pgNoiseReduction
     double m_nr_adapt_rate;
     double m_nr_leakage;
-    double m_nr_adapt_size;
 
-    qs_vect_f m_nr_delay_line;
-    qs_vect_f m_nr_coeff;
-
-    qs_vect_cpx::iterator m_cpx_iterator;
+    QsAdaptiveFilter m_nr_engine;
+    qs_vect_f m_nr_in;
+    qs_vect_f m_nr_out;
 
   public:
     QsNoiseReductionFilter();
 
     void init(unsigned int size);
+    void update(const QsDspParams &params);
     void process(qs_vect_cpx &src_dst);
+    bool process(float *src_dst, int length); // mono audio, false when off
+    void hold(); // squelch closed: keep the weights, restart from silence
 };
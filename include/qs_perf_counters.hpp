@@ -0,0 +1,116 @@
+/**
+ * @file qs_perf_counters.hpp
+ * @brief Hardware performance counters charged to processing stages.
+ *
+ * Stage time says how long a stage takes, not why. QsPerfCounters opens a
+ * group of perf_event_open counters on the owning thread (cycles,
+ * instructions, L1D read misses, last level cache misses, branch misses)
+ * and charges the counts between stage boundaries to the stage, so a
+ * report can tell a compute bound stage (high IPC, few misses) from one
+ * waiting on memory.
+ *
+ * Features:
+ * - One group read per stage boundary; the counters only run while the
+ *   thread does, user space only
+ * - Per stage totals, reported per sample: cycles, IPC, L1D, LLC and
+ *   branch misses
+ * - Enable, disable and reset from any thread; the owner opens, closes
+ *   and clears at its next sync()
+ * - Degrades to a reason ("not permitted", "no hardware counters") when
+ *   the kernel refuses; counters the CPU lacks are reported as "-"
+ *
+ * Usage:
+ * 1. QsPerfCounters perf(names, stages);  // stage names outlive the object
+ * 2. perf.setEnabled(true);               // any thread
+ * 3. perf.sync();                         // owner, once per block
+ *    if (perf.active()) perf.mark();
+ *    ... stage ...
+ *    if (perf.active()) perf.lap(stage, samples);
+ * 4. perf.close();                        // owner, before the thread ends
+ * 5. perf.report();                       // any thread
+ *
+ * Notes:
+ * - A group read is a read() syscall, about a microsecond: off by default,
+ *   for profiling runs rather than production.
+ * - perf_event_paranoid above 2 forbids even user space self-monitoring;
+ *   most virtual machines expose no PMU at all.
+ * - Counts are not scaled for multiplexing. The group is scheduled as a
+ *   whole, so ratios hold even when the PMU is shared.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <memory>
+#include <string>
+#include <vector>
+
+enum QsPerfEvent {
+    peCycles = 0, // group leader
+    peInstructions,
+    peL1dMisses, // L1D read misses
+    peLlcMisses, // last level cache misses
+    peBranchMisses,
+    peCount
+};
+
+class QsPerfCounters {
+  public:
+    // per sample of the stage's input; negative when the counter is missing
+    struct Row {
+        const char *name;
+        uint64_t samples;
+        double cycles;
+        double ipc;
+        double l1d_misses;
+        double llc_misses;
+        double branch_misses;
+    };
+
+    QsPerfCounters(const char *const *names, int stages);
+    ~QsPerfCounters();
+
+    // any thread
+    void setEnabled(bool value);
+    bool enabled() const { return m_enabled.load(std::memory_order_relaxed); }
+    void requestReset() { m_reset.store(true, std::memory_order_relaxed); }
+    // why the counters could not be opened, "" if they could
+    std::string error() const;
+    // stages with samples since reset
+    std::vector<Row> rows() const;
+    // "<stage> cyc c ipc i l1d m llc m br m, ..." per sample, or the error
+    std::string report() const;
+
+    // owner thread: open, close or clear as requested; true while counting
+    bool sync();
+    void close();
+    inline bool active() const { return m_fd[peCycles] >= 0; }
+
+    // counters now, the start of the next stage
+    void mark();
+    // charge the counts since the last mark or lap to stage
+    void lap(int stage, uint64_t samples);
+    void addSamples(int stage, uint64_t samples);
+
+  private:
+    bool open();
+    bool read(uint64_t *values);
+    void clear();
+    void add(int stage, int slot, uint64_t value);
+
+    // owner thread
+    int m_fd[peCount];
+    uint64_t m_id[peCount];
+    uint64_t m_last[peCount];
+
+    std::atomic<bool> m_enabled;
+    std::atomic<bool> m_reset;
+    std::atomic<int> m_errno;
+    std::atomic<unsigned> m_present; // a bit per QsPerfEvent opened
+
+    const char *const *m_names;
+    int m_stages;
+    // per stage: peCount totals, then samples
+    std::unique_ptr<std::atomic<uint64_t>[]> m_sum;
+};
@@ -12,6 +12,8 @@
  * 
  * Usage:
  * - Initialize with the desired size.
+ * - Pass each new settings snapshot to update(); the filter is rebuilt when
+ *   its edges move.
  * - Use MakeWindow methods to create filtering windows.
  * - Call process() to filter incoming complex signals.
  * 
@@ -42,10 +44,12 @@ class QsPostRxFilter {
     QsPostRxFilter();
 
     void init(int size);
+    void update(const QsDspParams &params);
     void process(qs_vect_cpx &src_dst);
 
     static void MakeWindow(int wtype, int size, qs_vect_cpx &window);
     static void MakeWindow(int wtype, int size, qs_vect_f &window);
+    static void MakeWindow(int wtype, int size, float *window);
     static qs_vect_f MakeWindow(int wtype, int size);
     static qs_vect_cpx MakeWindowComplex(int wtype, int size);
 
@@ -54,6 +58,7 @@ class QsPostRxFilter {
     float m_samplerate;
     int m_filter_lo;
     int m_filter_hi;
+    uint32_t m_version; // pgFilter
     float m_one_over_norm;
 
     std::unique_ptr<QsFFT> p_ovlpfft;
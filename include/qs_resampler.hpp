@@ -1,17 +1,78 @@
+/**
+ * @file qs_resampler.hpp
+ * @brief Rational polyphase resampler from the post processing rate to the audio rate.
+ *
+ * The Resampler converts by an exact ratio L/M, found from the two rates,
+ * with a Kaiser windowed sinc prototype split into L phases. Each output is
+ * one inner product of a phase with the newest input samples, so the cost
+ * per output is the phase length, independent of the ratio.
+ *
+ * Features:
+ * - Quality tiers 0 .. 3 (QsMemory resampler quality), trading stopband
+ *   attenuation and passband width for taps; higher is better
+ * - Phases padded to a multiple of eight taps and reversed, so every inner
+ *   product is a contiguous qs_v4f loop with no tail
+ * - Mono path for the demodulated audio, stereo path (real = left,
+ *   imag = right) for binaural; both share the phase table
+ * - Pass-through copy when the two rates are equal
+ * - skip() for silent input: advances the phase, returns the output count
+ *   and leaves the history as if zeros had been fed, with no filtering
+ *
+ * Usage:
+ * 1. Resampler rs(62500.0, 48000.0, quality);
+ * 2. int frames = rs.process(in, length, out);   // out holds maxOutput(length)
+ * 3. int frames = rs.skip(length);   // silent input: count only, no output
+ * 4. rs.reserve(length);             // before the first block, keeps process() off the heap
+ *
+ * Notes:
+ * - Rates must sit on a quarter hertz (97656.25 Hz is 1.5625 MHz / 16) and
+ *   the ratio must fit RS_MAX_PHASES phases; ratioSupported() checks both,
+ *   the constructor throws otherwise.
+ * - The stopband starts at half the lower of the two rates, so nothing
+ *   aliases; the passband is the tier's fraction of that.
+ * - Input history is kept per channel. The right channel history is only
+ *   advanced by the stereo path, so switching binaural on replays one
+ *   phase length of stale right channel input.
+ */
+
 #pragma once
 
-#include <samplerate.h>
-#include <stdexcept>
-#include <vector>
+#include "../include/qs_defaults.hpp"
+#include "../include/qs_types.hpp"
 
 class Resampler {
   public:
-    Resampler(int src_rate, int dest_rate);
-    ~Resampler();
+    Resampler(double src_rate, double dest_rate, int quality = QS_DEFAULT_RS_QUAL);
+
+    int process(const float *input, int input_frames, float *output);
+    int process(const Cpx *input, int input_frames, Cpx *output);
+    int skip(int input_frames);
+    void reset();
+    void reserve(int input_frames); // history for calls of up to input_frames; allocates
+
+    int maxOutput(int input_frames) const;
+    bool passThrough() const { return m_interp == m_decim; }
+    int interpolation() const { return m_interp; }
+    int decimation() const { return m_decim; }
+    int phaseLength() const { return m_taps; }
+    // input samples from input to output, linear phase prototype
+    double groupDelay() const { return passThrough() ? 0.0 : (m_taps * m_interp - 1) / (2.0 * m_interp); }
 
-    void process(const float *input, size_t input_frames, float *output, size_t *output_frames);
+    static bool ratioSupported(double src_rate, double dest_rate);
 
   private:
-    SRC_STATE *src_state;
-    float src_ratio;
+    void design(double src_rate, double dest_rate, int quality);
+    void append(qs_vect_f &hist, const float *input, int input_frames, int stride);
+    void retire(qs_vect_f &hist, int input_frames);
+    void silence(qs_vect_f &hist, int input_frames);
+
+    int m_interp;  // L
+    int m_decim;   // M
+    int m_taps;    // taps per phase, a multiple of eight
+    int m_phase;   // phase of the next output, 0 .. L-1
+    int m_offset;  // input index of the next output's newest sample, relative to this call
+
+    qs_vect_f m_coef;   // L phases of m_taps, reversed (oldest sample first)
+    qs_vect_f m_hist_l; // m_taps - 1 past inputs followed by the current call
+    qs_vect_f m_hist_r;
 };
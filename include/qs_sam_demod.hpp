@@ -10,15 +10,24 @@
  * - Adjustable bandwidth and limits for the demodulation process.
  * - Calculation of phase errors and normalization of output.
  * - Utilizes iterative processing over complex vectors.
+ * - samBlock tracking: the carrier loop runs once per SAM_TRACK_BLOCK
+ *   samples on the segment's mean phase, so the de-rotation is a phasor
+ *   table built by doubling and the per-sample sin, cos, atan2 and hypot
+ *   disappear.
  * 
  * Usage:
- * - Initialize the demodulator with the `init()` method.
+ * - Initialize the demodulator with the `init()` method, and pass each new
+ *   settings snapshot to `update()`.
  * - Process the input signal using the `process()` method, which modifies the 
  *   provided vector in place.
  * 
  * Notes:
  * - Ensure that the input vector is populated with valid complex samples before 
  *   invoking the `process()` method.
+ * - The tracking mode (samPerSample or samBlock) is QsMemory's SAM tracking
+ *   setting. Both use the same loop constants; samBlock holds the NCO
+ *   frequency over a segment, so the phase is interpolated linearly between
+ *   updates.
  * 
  * Author: Philip A Covington
  * Date: 202-10-17
@@ -57,6 +66,7 @@ class QsSAMDemodulator {
     float m_sam_y0;
     float m_sam_y1;
     float m_sam_dc_alpha;
+    int m_sam_tracking; // samPerSample or samBlock
 
     qs_vect_cpx::iterator m_cpx_vect_iterator;
 
@@ -64,5 +74,11 @@ class QsSAMDemodulator {
     explicit QsSAMDemodulator();
 
     void init();
+    void update(const QsDspParams &params);
     void process(qs_vect_cpx &src_dst);
+    void process(Cpx *src_dst, int length);
+
+  private:
+    void processSample(Cpx *src_dst, int length);
+    void processBlock(Cpx *src_dst, int length);
 };
@@ -0,0 +1,94 @@
+/**
+ * @file qs_seqlock.hpp
+ * @brief Sequence lock publishing a small value from writers to a real-time reader.
+ *
+ * QsSeqlock<T> holds one copy of a trivially copyable T and a sequence
+ * number. A writer makes the sequence odd, copies the value in and makes it
+ * even again; a reader copies the value out and keeps it only if the
+ * sequence was even and unchanged across the copy. The reader never blocks
+ * and never makes the writer wait.
+ *
+ * Features:
+ * - sequence(): one acquire load, so a reader can skip the copy when
+ *   nothing was published since its last snapshot
+ * - tryLoad(): a single attempt that leaves the caller's copy untouched
+ *   when a write is in progress, for the real-time thread
+ * - load(): retries until it gets a whole value, for everyone else
+ * - The value is kept as relaxed atomic words, so a racing copy is stale
+ *   or rejected, never undefined behaviour
+ *
+ * Usage:
+ * 1. QsSeqlock<Params> lock(initial);          // or lock() for a zeroed value
+ * 2. lock.store(next);                          // writers, serialized by the caller
+ * 3. if (lock.sequence() != seq)                // reader, once per block
+ *        lock.tryLoad(params, seq);
+ *
+ * Notes:
+ * - Writers must be serialized (a mutex on the writing side); the reader
+ *   side is wait-free.
+ * - The sequence starts at 2 and grows by 2 per store, so 0 never matches
+ *   a published value.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <cstring>
+#include <type_traits>
+
+template <typename T> class QsSeqlock {
+    static_assert(std::is_trivially_copyable<T>::value, "QsSeqlock needs a trivially copyable value");
+
+  public:
+    QsSeqlock() : m_seq(0) { store(T()); }
+    explicit QsSeqlock(const T &value) : m_seq(0) { store(value); }
+    QsSeqlock(const QsSeqlock &) = delete;
+    QsSeqlock &operator=(const QsSeqlock &) = delete;
+
+    void store(const T &value) {
+        uint64_t buf[WORDS] = {};
+        std::memcpy(buf, &value, sizeof(T));
+
+        uint64_t seq = m_seq.load(std::memory_order_relaxed);
+        m_seq.store(seq + 1, std::memory_order_relaxed);
+        // the odd sequence is visible before any word changes
+        std::atomic_thread_fence(std::memory_order_release);
+        for (int i = 0; i < WORDS; i++)
+            m_words[i].store(buf[i], std::memory_order_relaxed);
+        m_seq.store(seq + 2, std::memory_order_release);
+    }
+
+    // last published sequence, even while a store is in progress
+    inline uint64_t sequence() const { return m_seq.load(std::memory_order_acquire) & ~uint64_t(1); }
+
+    // one attempt; false (value untouched) if a store overlapped the copy
+    bool tryLoad(T &value, uint64_t &seq) const {
+        uint64_t before = m_seq.load(std::memory_order_acquire);
+        if (before & 1)
+            return false;
+        uint64_t buf[WORDS];
+        for (int i = 0; i < WORDS; i++)
+            buf[i] = m_words[i].load(std::memory_order_relaxed);
+        // the word loads complete before the sequence is read again
+        std::atomic_thread_fence(std::memory_order_acquire);
+        if (m_seq.load(std::memory_order_relaxed) != before)
+            return false;
+        std::memcpy(&value, buf, sizeof(T));
+        seq = before;
+        return true;
+    }
+
+    uint64_t load(T &value) const {
+        uint64_t seq = 0;
+        while (!tryLoad(value, seq)) {
+        }
+        return seq;
+    }
+
+  private:
+    static constexpr int WORDS = static_cast<int>((sizeof(T) + sizeof(uint64_t) - 1) / sizeof(uint64_t));
+
+    std::atomic<uint64_t> m_seq;
+    std::atomic<uint64_t> m_words[WORDS];
+};
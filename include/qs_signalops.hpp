@@ -12,6 +12,10 @@
  * - Overloaded Add functions for adding constants or arrays to different data types.
  * - Support for both real and complex number operations.
  * - Functions for rounding, absolute value computation, and type conversions.
+ * - The block kernels on the data path (complex multiply / add / scale,
+ *   (de)interleave, int and short conversion, DotProduct8) run through the
+ *   QsSimd table chosen at startup; see qs_simd.hpp. Complex multiply also
+ *   takes split planes (QsSplitCpx).
  *
  * Usage:
  * - Use the `Add()` methods to apply values to signal arrays.
@@ -37,6 +41,8 @@
 #include <memory>
 #include <vector>
 
+#include "../include/qs_simd.hpp"
+#include "../include/qs_split_cpx.hpp"
 #include "../include/qs_types.hpp"
 #include "inttypes.h"
 
@@ -126,10 +132,7 @@ class QsSignalOps {
     }
 
     inline static void Add(Cpx *src1, Cpx *src2, Cpx *dst, uint32_t length) {
-        for (uint32_t i = 0; i < length; i++) {
-            dst[i].real(src1[i].real() + src2[i].real());
-            dst[i].imag(src1[i].imag() + src2[i].imag());
-        }
+        QsSimd::kernels().addCpx(src1, src2, dst, length);
     }
 
     inline static void Add(float *src1_re, float *src1_im, float *src2_re, float *src2_im, float *dst_re, float *dst_im,
@@ -155,9 +158,7 @@ class QsSignalOps {
     }
 
     inline static void RealFromComplex(Cpx *src, float *dst_re, uint32_t length) {
-        for (uint32_t i = 0; i < length; i++) {
-            dst_re[i] = static_cast<float>(src[i].real());
-        }
+        QsSimd::kernels().realFromComplex(src, dst_re, length);
     }
 
     inline static void ImagFromComplex(Cpx *src, float *dst_im, uint32_t length) {
@@ -186,9 +187,7 @@ class QsSignalOps {
     }
 
     inline static void Convert(int *src, float *dst, uint32_t length) {
-        for (uint32_t i = 0; i < length; i++) {
-            dst[i] = static_cast<float>(src[i]) * INTTOFLOAT;
-        }
+        QsSimd::kernels().intToFloat(src, dst, length);
     }
 
     inline static void Convert24(int *src, float *dst, uint32_t length) {
@@ -238,15 +237,11 @@ class QsSignalOps {
     }
 
     inline static void Convert(float *src, short *dst, uint32_t length) {
-        for (uint32_t i = 0; i < length; i++) {
-            dst[i] = static_cast<short>(src[i] * FLOATTOSHORT);
-        }
+        QsSimd::kernels().floatToShort(src, dst, length);
     }
 
     inline static void Convert(qs_vect_f &src, qs_vect_s &dst, uint32_t length) {
-        for (uint32_t i = 0; i < length; i++) {
-            dst[i] = static_cast<short>(src[i] * FLOATTOSHORT);
-        }
+        QsSimd::kernels().floatToShort(src.data(), reinterpret_cast<short *>(dst.data()), length);
     }
 
     inline static void Copy(char *src, char *dst, uint32_t length) { memcpy(dst, src, sizeof(char) * length); }
@@ -305,17 +300,11 @@ class QsSignalOps {
     }
 
     inline static void DeInterleave(float *src, float *dst_re, float *dst_im, uint32_t length) {
-        for (uint32_t i = 0; i < length; i++) {
-            dst_re[i] = src[2 * i];
-            dst_im[i] = src[2 * i + 1];
-        }
+        QsSimd::kernels().deInterleave(src, dst_re, dst_im, length);
     }
 
     inline static void DeInterleave(qs_vect_f &src, qs_vect_f &dst_re, qs_vect_f &dst_im, uint32_t length) {
-        for (uint32_t i = 0; i < length; i++) {
-            dst_re[i] = src[2 * i];
-            dst_im[i] = src[2 * i + 1];
-        }
+        QsSimd::kernels().deInterleave(src.data(), dst_re.data(), dst_im.data(), length);
     }
 
     inline static void DeInterleaveIntToFloat(int *src, float *dst_re, float *dst_im, uint32_t length) {
@@ -650,48 +639,32 @@ class QsSignalOps {
     }
 
     inline static void Multiply(Cpx *src, Cpx *src_dst, uint32_t length) {
-        for (uint32_t i = 0; i < length; i++) {
-            float tmp_real = src_dst[i].real();
-            float tmp_imag = src_dst[i].imag();
-            src_dst[i].real((src[i].real() * tmp_real) - (src[i].imag() * tmp_imag));
-            src_dst[i].imag((src[i].real() * tmp_imag) + (src[i].imag() * tmp_real));
-        }
+        QsSimd::kernels().multiplyCpx(src, src_dst, src_dst, length);
     }
 
     inline static void Multiply(Cpx *src1, Cpx *src2, Cpx *dst, uint32_t length) {
-        for (uint32_t i = 0; i < length; i++) {
-            dst[i].real((src1[i].real() * src2[i].real()) - (src1[i].imag() * src2[i].imag()));
-            dst[i].imag((src1[i].real() * src2[i].imag()) + (src1[i].imag() * src2[i].real()));
-        }
+        QsSimd::kernels().multiplyCpx(src1, src2, dst, length);
     }
 
     inline static void Multiply(qs_vect_cpx &src1, qs_vect_cpx &src2, qs_vect_cpx &dst, uint32_t length) {
-        for (uint32_t i = 0; i < length; i++) {
-            dst[i].real((src1[i].real() * src2[i].real()) - (src1[i].imag() * src2[i].imag()));
-            dst[i].imag((src1[i].real() * src2[i].imag()) + (src1[i].imag() * src2[i].real()));
-        }
+        QsSimd::kernels().multiplyCpx(src1.data(), src2.data(), dst.data(), length);
     }
 
     inline static void Multiply(float *src1_re, float *src1_im, float *src2_re, float *src2_im, float *dst_re,
                                 float *dst_im, uint32_t length) {
-        for (uint32_t i = 0; i < length; i++) {
-            dst_re[i] = (src2_re[i] * src1_re[i]) - (src2_im[i] * src1_im[i]);
-            dst_im[i] = (src2_re[i] * src1_im[i]) + (src2_im[i] * src1_re[i]);
-        }
+        QsSimd::kernels().multiplySplit(src1_re, src1_im, src2_re, src2_im, dst_re, dst_im, length);
+    }
+
+    inline static void Multiply(const QsSplitCpx &src1, const QsSplitCpx &src2, QsSplitCpx &dst, uint32_t length) {
+        QsSimd::kernels().multiplySplit(src1.re(), src1.im(), src2.re(), src2.im(), dst.re(), dst.im(), length);
     }
 
     inline static void Multiply(Cpx *src_dst, const float val, uint32_t length) {
-        for (uint32_t i = 0; i < length; i++) {
-            src_dst[i].real(src_dst[i].real() * val);
-            src_dst[i].imag(src_dst[i].imag() * val);
-        }
+        QsSimd::kernels().scaleCpx(src_dst, val, length);
     }
 
     inline static void Multiply(qs_vect_cpx &src_dst, const float val, uint32_t length) {
-        for (uint32_t i = 0; i < length; i++) {
-            src_dst[i].real(src_dst[i].real() * val);
-            src_dst[i].imag(src_dst[i].imag() * val);
-        }
+        QsSimd::kernels().scaleCpx(src_dst.data(), val, length);
     }
 
     inline static void Multiply(float *src_dst_re, float *src_dst_im, const float val, uint32_t length) {
@@ -775,17 +748,11 @@ class QsSignalOps {
     }
 
     inline static void RealToComplex(float *re_src, float *im_src, Cpx *dest, uint32_t length) {
-        for (uint32_t i = 0; i < length; i++) {
-            dest[i].real(re_src[i]);
-            dest[i].imag(im_src[i]);
-        }
+        QsSimd::kernels().realToComplex(re_src, im_src, dest, length);
     }
 
     inline static void RealToComplex(qs_vect_f &re_src, qs_vect_f &im_src, qs_vect_cpx &dest, uint32_t length) {
-        for (uint32_t i = 0; i < length; i++) {
-            dest[i].real(re_src[i]);
-            dest[i].imag(im_src[i]);
-        }
+        QsSimd::kernels().realToComplex(re_src.data(), im_src.data(), dest.data(), length);
     }
 
     inline static void RealToComplex(float *re_src, Cpx *dest, uint32_t length) {
@@ -837,19 +804,13 @@ class QsSignalOps {
     }
 
     inline static void Scale(Cpx *src_dst, float val, uint32_t length) {
-        for (uint32_t i = 0; i < length; i++) {
-            src_dst[i].real(src_dst[i].real() * val);
-            src_dst[i].imag(src_dst[i].imag() * val);
-        }
+        QsSimd::kernels().scaleCpx(src_dst, val, length);
     }
 
     inline static void Scale(qs_vect_cpx &src_dst, float val, uint32_t length) {
         if (src_dst.size() < length)
             length = src_dst.size();
-        for (uint32_t i = 0; i < length; i++) {
-            src_dst[i].real(src_dst[i].real() * val);
-            src_dst[i].imag(src_dst[i].imag() * val);
-        }
+        QsSimd::kernels().scaleCpx(src_dst.data(), val, length);
     }
 
     inline static void Scale(float *src_dst_re, float *src_dst_im, float val, uint32_t length) {
@@ -948,4 +909,160 @@ class QsSignalOps {
     }
 
     inline static void Zero(int64_t *src, uint32_t length) { memset(src, 0, sizeof(int64_t) * length); }
+
+    // t where the mask is all ones, f where it is zero. Done on the bits, so
+    // under the default -ftrapping-math the compiler can still vectorise
+    // it; a float ?: would keep the loop scalar.
+    inline static float Select(int32_t mask, float t, float f) {
+        int32_t ti, fi, r;
+        float out;
+        memcpy(&ti, &t, sizeof(float));
+        memcpy(&fi, &f, sizeof(float));
+        r = (ti & mask) | (fi & ~mask);
+        memcpy(&out, &r, sizeof(float));
+        return out;
+    }
+
+    // atan2 from an odd 11th order minimax polynomial for atan on [0, 1],
+    // |error| < 2e-6 rad. Branch free, so block loops over it vectorise.
+    inline static float FastAtan2(float y, float x) {
+        int32_t xi, yi;
+        memcpy(&xi, &x, sizeof(float));
+        memcpy(&yi, &y, sizeof(float));
+        const float ax = std::fabs(x);
+        const float ay = std::fabs(y);
+        // |y| > |x|, compared as integers: non-negative floats order like their bits
+        const int32_t steep = -static_cast<int32_t>((yi & 0x7fffffff) > (xi & 0x7fffffff));
+        const float z = Select(steep, ax, ay) / (Select(steep, ay, ax) + 1e-30f);
+        const float z2 = z * z;
+        float p = 0.05265332f - 0.01172120f * z2;
+        p = -0.11643287f + p * z2;
+        p = 0.19354346f + p * z2;
+        p = -0.33262347f + p * z2;
+        p = 0.99997726f + p * z2;
+        const float a = p * z;
+        const float b = Select(steep, 1.57079633f - a, a);
+        const float c = Select(xi >> 31, 3.14159265f - b, b); // x < 0
+        return std::copysign(c, y);
+    }
+
+    // log2 of a positive normal float: exponent from the bits, mantissa
+    // folded into [sqrt(1/2), sqrt(2)) and taken through the atanh series
+    // to r^7, |error| < 1.1e-6. Branch free like FastAtan2.
+    inline static float FastLog2(float x) {
+        int32_t xi;
+        memcpy(&xi, &x, sizeof(float));
+        const int32_t e = (xi - 0x3f3504f3) >> 23; // 0x3f3504f3 = sqrt(1/2)
+        const int32_t mi = xi - (e << 23);
+        float m;
+        memcpy(&m, &mi, sizeof(float));
+        const float r = (m - 1.0f) / (m + 1.0f);
+        const float r2 = r * r;
+        float p = 0.41219858f * r2 + 0.57707801f; // 2 / (k ln 2), k = 7, 5
+        p = p * r2 + 0.96179669f;                   // k = 3
+        p = p * r2 + 2.88539008f;                   // k = 1
+        return static_cast<float>(e) + p * r;
+    }
+
+    // 2^x for x in [-126, 126]: integer part into the exponent bits,
+    // 2^f for |f| <= 1/2 from its Taylor series to f^6, |relative error|
+    // < 3e-7. Branch free like FastAtan2.
+    inline static float FastExp2(float x) {
+        const float t = x + 12582912.0f; // 1.5 * 2^23: rounds x to an integer
+        int32_t ti;
+        memcpy(&ti, &t, sizeof(float));
+        const float f = x - (t - 12582912.0f);
+        float p = 1.5403530e-4f * f + 1.3333558e-3f;
+        p = p * f + 9.6181291e-3f;
+        p = p * f + 5.5504109e-2f;
+        p = p * f + 2.4022651e-1f;
+        p = p * f + 6.9314718e-1f;
+        p = p * f + 1.0f;
+        const int32_t bits = (ti - 0x4b400000 + 127) << 23;
+        float scale;
+        memcpy(&scale, &bits, sizeof(float));
+        return p * scale;
+    }
+
+    // sqrt of a non-negative float without libm: under the default
+    // -fmath-errno a sqrt call keeps its loop scalar. Bit-trick reciprocal
+    // square root of x + 1e-30 (so that 0 gives 0) and three Newton steps,
+    // relative error < 3e-7 for x above 1e-20.
+    inline static float FastSqrt(float x) {
+        const float c = x + 1e-30f;
+        int32_t ci;
+        memcpy(&ci, &c, sizeof(float));
+        const int32_t ri = 0x5f3759df - (ci >> 1);
+        float r;
+        memcpy(&r, &ri, sizeof(float));
+        const float half = 0.5f * c;
+        r = r * (1.5f - half * r * r);
+        r = r * (1.5f - half * r * r);
+        r = r * (1.5f - half * r * r);
+        return x * r;
+    }
+
+    // FastSqrt on four lanes
+    inline static qs_v4f FastSqrt(qs_v4f x) {
+        const qs_v4f c = x + 1e-30f;
+        qs_v4f r = (qs_v4f)(0x5f3759df - ((qs_v4i)c >> 1));
+        const qs_v4f half = 0.5f * c;
+        r = r * (1.5f - half * r * r);
+        r = r * (1.5f - half * r * r);
+        r = r * (1.5f - half * r * r);
+        return x * r;
+    }
+
+    // Inner product of two float arrays, n a multiple of eight, on the
+    // widest vector unit QsSimd found (the compiler will not reassociate a
+    // scalar sum)
+    inline static float DotProduct8(const float *a, const float *b, int n) {
+        return QsSimd::kernels().dotProduct(a, b, n);
+    }
+
+    // Four steps of the exponential average state = keep * state +
+    // (1 - keep) * x[j], in place on the lanes of x, with kp = {keep,
+    // keep^2, keep^3, keep^4}. Solved as a scan: two shift-and-add steps
+    // with keep and keep^2, then keep^(j+1) times the state carried in, so
+    // only the carry is serial.
+    inline static void ExpAverage4(qs_v4f &x, qs_v4f kp, float &state) {
+        const qs_v4f zero = {0.0f, 0.0f, 0.0f, 0.0f};
+        qs_v4f t = (1.0f - kp[0]) * x;
+        t += kp[0] * QS_V4F_SHUFFLE(zero, t, 3, 4, 5, 6);
+        t += kp[1] * QS_V4F_SHUFFLE(zero, t, 2, 3, 4, 5);
+        x = t + kp * state;
+        state = x[3];
+    }
+
+    // dst[i] = arg(src[i] * conj(src[i - 1])), with prev as src[-1]: the
+    // phase step per sample, i.e. the instantaneous frequency in rad/sample
+    inline static void PhaseDifference(const Cpx *src, Cpx prev, float *dst, uint32_t length) {
+        const float *in = reinterpret_cast<const float *>(src);
+        float last_re = prev.real();
+        float last_im = prev.imag();
+        uint32_t i = 0;
+        // fixed groups of eight, staged with the previous sample in a local
+        // buffer, so the product and atan2 form one loop that vectorises
+        // without a runtime trip count or alias checks
+        for (; i + 8 <= length; i += 8) {
+            float c[18];
+            c[0] = last_re;
+            c[1] = last_im;
+            memcpy(c + 2, in + 2 * i, 16 * sizeof(float));
+            for (int j = 0; j < 8; j++) {
+                float re = c[2 * j + 2] * c[2 * j] + c[2 * j + 3] * c[2 * j + 1];
+                float im = c[2 * j + 3] * c[2 * j] - c[2 * j + 2] * c[2 * j + 1];
+                dst[i + j] = FastAtan2(im, re);
+            }
+            last_re = c[16];
+            last_im = c[17];
+        }
+        for (; i < length; i++) {
+            float re = in[2 * i] * last_re + in[2 * i + 1] * last_im;
+            float im = in[2 * i + 1] * last_re - in[2 * i] * last_im;
+            dst[i] = FastAtan2(im, re);
+            last_re = in[2 * i];
+            last_im = in[2 * i + 1];
+        }
+    }
 };
\ No newline at end of file
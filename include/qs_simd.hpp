@@ -0,0 +1,93 @@
+/**
+ * @file qs_simd.hpp
+ * @brief Runtime selected SIMD kernels behind the QsSignalOps block operations.
+ *
+ * QsSimd holds one table of function pointers for the block kernels on the
+ * data path (reader conversion, overlap-save filters, FFT scaling, DAC
+ * conversion, FIR inner products), in interleaved and split plane
+ * (QsSplitCpx) form. The table is chosen once at startup from the CPU:
+ * AVX-512, AVX2, SSE2 on x86, NEON on ARM. The scalar table is the
+ * reference every backend is held to.
+ *
+ * Features:
+ * - QsSignalOps keeps its overloads and forwards to the table, so callers
+ *   are unchanged
+ * - Each backend handles any length: vector body, scalar tail
+ * - Unaligned loads and stores throughout; no alignment contract
+ * - The pointer starts on the scalar table (constant initialized), so the
+ *   kernels are safe before init() and from static constructors
+ *
+ * Usage:
+ * 1. QsSimd::init();                          // once, at startup
+ * 2. QsSimd::kernels().multiplyCpx(a, b, dst, n);
+ * 3. QsSimd::select(simdScalar);              // force a backend (benches)
+ *
+ * Notes:
+ * - x86 backends are built with per-function target attributes, so the
+ *   binary runs on any x86-64 and only uses what cpuid reports.
+ * - Results match the scalar table exactly for the element-wise kernels.
+ *   multiplyCpx / multiplySplit may use FMA and dotProduct sums in a
+ *   different order, so these agree with scalar to float rounding, not bit
+ *   for bit.
+ * - select() is not synchronized with running DSP threads; call it before
+ *   they start.
+ * - qs1r_bench --verify checks every table the CPU supports against the
+ *   scalar one.
+ */
+
+#pragma once
+
+#include "../include/qs_types.hpp"
+
+#include <cstdint>
+
+enum QsSimdIsa { simdScalar = 0, simdSse2 = 1, simdAvx2 = 2, simdAvx512 = 3, simdNeon = 4 };
+
+struct QsSimdKernels {
+    QsSimdIsa isa;
+    const char *name;
+
+    // dst = a * b (complex)
+    void (*multiplyCpx)(const Cpx *a, const Cpx *b, Cpx *dst, uint32_t length);
+    // the same on split planes; dst may alias a or b
+    void (*multiplySplit)(const float *a_re, const float *a_im, const float *b_re, const float *b_im, float *dst_re,
+                          float *dst_im, uint32_t length);
+    // dst = a + b (complex)
+    void (*addCpx)(const Cpx *a, const Cpx *b, Cpx *dst, uint32_t length);
+    // src_dst *= val, both parts
+    void (*scaleCpx)(Cpx *src_dst, float val, uint32_t length);
+    // interleaved re/im pairs to split arrays
+    void (*deInterleave)(const float *src, float *dst_re, float *dst_im, uint32_t length);
+    // split arrays to complex
+    void (*realToComplex)(const float *re, const float *im, Cpx *dst, uint32_t length);
+    // real part of each complex sample
+    void (*realFromComplex)(const Cpx *src, float *dst_re, uint32_t length);
+    // full scale int32 to float, * INTTOFLOAT
+    void (*intToFloat)(const int *src, float *dst, uint32_t length);
+    // float to short, * FLOATTOSHORT, truncated, saturated; NaN gives 0
+    void (*floatToShort)(const float *src, short *dst, uint32_t length);
+    // sum of a[i] * b[i], length a multiple of eight
+    float (*dotProduct)(const float *a, const float *b, int length);
+};
+
+class QsSimd {
+  public:
+    static void init();
+    static bool select(QsSimdIsa isa);
+    static bool supported(QsSimdIsa isa);
+
+    static const QsSimdKernels &kernels() { return *s_active; }
+    static const QsSimdKernels &scalar();
+    static const char *name() { return s_active->name; }
+
+  private:
+    static const QsSimdKernels *table(QsSimdIsa isa);
+
+    // defined by the backend sources; nullptr where not built
+    static const QsSimdKernels *sse2Kernels();
+    static const QsSimdKernels *avx2Kernels();
+    static const QsSimdKernels *avx512Kernels();
+    static const QsSimdKernels *neonKernels();
+
+    static const QsSimdKernels *s_active;
+};
@@ -9,10 +9,12 @@
  * @usage
  * To use the QsSMeter class, create an instance, call the `init()` method to set up any 
  * required parameters, and then use the `process()` method to perform measurements 
- * on the provided complex vector data.
+ * on the provided complex vector data. `update()` takes the S meter correction from
+ * each new settings snapshot.
  *
  * @notes
  * Ensure that the input vector is properly initialized before calling the `process()` method.
+ * A block handled in chunks gives the same reading through accumulate() and publish().
  *
  * @author Philip A Covington
  * @date 2024-10-17
@@ -29,6 +31,7 @@ class QsSMeter {
   private:
     float m_sm_tmp_val;
     double m_sm_value;
+    double m_sm_correction;
 
     qs_vect_cpx::iterator m_cpx_iterator;
 
@@ -36,5 +39,10 @@ class QsSMeter {
     QsSMeter();
 
     void init();
+    void update(const QsDspParams &params);
     void process(qs_vect_cpx &src_dst);
+
+    // chunked: accumulate() each part of the block, publish() once at its end
+    void accumulate(const Cpx *src, int length);
+    void publish();
 };
@@ -0,0 +1,41 @@
+/**
+ * @file qs_spectral_notch.hpp
+ * @brief Manual notches applied in the main filter's spectrum.
+ *
+ * The QsSpectralNotches stage turns the eight manual notches in QsMemory
+ * into one static gain curve that QsMainRxFilter folds into its kernel.
+ * Each enabled notch contributes the magnitude response of the band-reject
+ * biquad QS_IIR used for it, so notch depth and width are unchanged while
+ * the per-sample IIR work disappears.
+ *
+ * Features:
+ * - All eight notches for the cost of a kernel rebuild when one changes
+ * - Zero phase, nulls at +f0 and -f0 like the I/Q biquad pair
+ *
+ * Usage:
+ * 1. main_filter.addStage(&notches) before main_filter.init(size).
+ *
+ * Notes:
+ * - Notches are numbered 0 .. MAX_MAN_NOTCHES - 1, the QsMemory indices.
+ * - A new notch snapshot rebuilds the kernel only if an enabled notch moved
+ *   or a notch was switched.
+ */
+
+#pragma once
+
+#include "../include/qs_defines.hpp"
+#include "../include/qs_spectral_stage.hpp"
+
+class QsSpectralNotches : public QsSpectralStage {
+  public:
+    QsSpectralNotches();
+
+    bool update(const QsDspParams &params) override;
+    void kernelGains(float *gain, int bins, float samplerate) override;
+
+  private:
+    uint32_t m_version; // pgNotch
+    float m_f0[MAX_MAN_NOTCHES];
+    float m_bw[MAX_MAN_NOTCHES];
+    bool m_enabled[MAX_MAN_NOTCHES];
+};
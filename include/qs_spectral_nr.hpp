@@ -0,0 +1,52 @@
+/**
+ * @file qs_spectral_nr.hpp
+ * @brief Spectral-subtraction noise reduction on the main filter's spectrum.
+ *
+ * The QsSpectralNoiseReduction stage is the nrSpectral alternative to the
+ * LMS QsNoiseReductionFilter. It runs inside QsMainRxFilter on the filtered
+ * spectrum of every block: a per-bin noise floor is tracked from the
+ * smoothed bin power and each bin is scaled by a floored subtraction gain,
+ * smoothed across neighbouring bins and over time to keep musical noise
+ * down.
+ *
+ * Features:
+ * - No FFT of its own; shares the main filter's transforms, and its gains
+ *   are cut to the filter length with the kernel so they never alias
+ * - Works before demodulation, so it serves every mode
+ * - Active when NR is on and QsMemory's NR mode is nrSpectral
+ *
+ * Usage:
+ * 1. main_filter.addStage(&nr) before main_filter.init(size).
+ *
+ * Notes:
+ * - Noise is the minimum of the smoothed bin power over the last one to two
+ *   windows of SNR_MIN_BLOCKS blocks (minimum statistics), so it follows a
+ *   falling floor at once and a rising one within two windows. A carrier
+ *   that stays on for longer than that is indistinguishable from noise in
+ *   its bin and is attenuated too; use the LMS mode for AM carriers.
+ */
+
+#pragma once
+
+#include "../include/qs_spectral_stage.hpp"
+
+class QsSpectralNoiseReduction : public QsSpectralStage {
+  public:
+    QsSpectralNoiseReduction();
+
+    void prepare(int bins) override;
+    bool update(const QsDspParams &params) override;
+    bool blockGains(const Cpx *spectrum, float *gain, int bins) override;
+
+  private:
+    void reset(int bins);
+
+    bool m_enabled; // NR on in nrSpectral mode
+    bool m_active;
+    int m_window_count;
+    qs_vect_f m_power;    // smoothed bin power
+    qs_vect_f m_min_cur;  // minimum over the current window
+    qs_vect_f m_min_prev; // minimum over the previous window
+    qs_vect_f m_gain;     // time-smoothed gain
+    qs_vect_f m_raw;      // this block's gain before smoothing
+};
@@ -0,0 +1,55 @@
+/**
+ * @file qs_spectral_stage.hpp
+ * @brief Frequency-domain stage hook for the main receive filter.
+ *
+ * A QsSpectralStage is registered with QsMainRxFilter and works on the
+ * spectrum the filter already computes, so any number of stages share the
+ * filter's one forward and one inverse FFT per block.
+ *
+ * Features:
+ * - Static gains (e.g. manual notches) are folded into the filter kernel
+ *   when they change and cost nothing per block
+ * - Dynamic gains (e.g. spectral noise reduction) see the filtered
+ *   spectrum of every block and are applied to that block's kernel
+ * - prepare() sizes per-bin state up front, so no stage allocates on the
+ *   DSP thread once the filter is running
+ *
+ * Usage:
+ * 1. Derive from QsSpectralStage and override the hooks you need.
+ * 2. main_filter.addStage(&stage) before main_filter.init(size).
+ *
+ * Notes:
+ * - The spectrum has 2 * size bins at the post processing rate; bin k is
+ *   k * rate / (2 * size) Hz for k < size and negative above.
+ * - Static gains are applied as a zero-phase response and the combined
+ *   kernel is cut back to size taps, so filtering stays a linear
+ *   convolution. Responses longer than about size / 2 samples (notches
+ *   narrower than roughly rate / size Hz) lose some depth.
+ * - Dynamic gains go through the same cut, once per block, so a gain that
+ *   changes every block cannot wrap the convolution around the transform.
+ *   That costs one more FFT pair per block while any stage returns true.
+ */
+
+#pragma once
+
+#include "../include/qs_dsp_params.hpp"
+#include "../include/qs_types.hpp"
+
+class QsSpectralStage {
+  public:
+    virtual ~QsSpectralStage() {}
+
+    // size per-bin state, called from the filter's init(); blockGains()
+    // must then not allocate
+    virtual void prepare(int /*bins*/) {}
+
+    // new settings from the DSP thread's snapshot; true asks the filter to
+    // rebuild its kernel
+    virtual bool update(const QsDspParams & /*params*/) { return false; }
+    // multiply this stage's static gains into gain[0 .. bins)
+    virtual void kernelGains(float * /*gain*/, int /*bins*/, float /*samplerate*/) {}
+
+    // multiply this block's gains into gain[0 .. bins), given the filtered
+    // spectrum; false when the stage applies none
+    virtual bool blockGains(const Cpx * /*spectrum*/, float * /*gain*/, int /*bins*/) { return false; }
+};
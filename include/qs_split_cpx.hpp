@@ -0,0 +1,64 @@
+/**
+ * @file qs_split_cpx.hpp
+ * @brief Split complex (structure of arrays) block: separate real and imaginary planes.
+ *
+ * The pipeline hands blocks between stages as qs_vect_cpx, re / im pairs
+ * side by side. Kernels that combine two complex blocks (spectral multiply,
+ * mixing, FIR dot products) need a shuffle per vector in that layout to
+ * pair the real parts with the imaginary ones. On split planes the same
+ * kernels are plain lane-wise arithmetic.
+ *
+ * Features:
+ * - Two qs_vect_f planes, each starting on a 64 byte boundary
+ * - load() / store() convert from / to interleaved Cpx through the QsSimd
+ *   de/interleave kernels, for the stage boundaries that stay interleaved
+ * - QsSignalOps::Multiply has a split plane overload
+ *
+ * Usage:
+ * 1. QsSplitCpx x(length);
+ * 2. x.load(cpx, length);                       // interleaved -> planes
+ * 3. QsSignalOps::Multiply(h, x, y, length);    // y = h * x
+ * 4. y.store(cpx, length);                      // planes -> interleaved
+ *
+ * Notes:
+ * - Kernels take any pointer and length; the alignment keeps vector loads
+ *   off cache line splits, it is not a contract.
+ */
+
+#pragma once
+
+#include "../include/qs_simd.hpp"
+#include "../include/qs_types.hpp"
+
+#include <algorithm>
+
+class QsSplitCpx {
+  public:
+    QsSplitCpx() {}
+    explicit QsSplitCpx(size_t length) { resize(length); }
+
+    void resize(size_t length) {
+        m_re.resize(length);
+        m_im.resize(length);
+    }
+    size_t size() const { return m_re.size(); }
+
+    float *re() { return m_re.data(); }
+    float *im() { return m_im.data(); }
+    const float *re() const { return m_re.data(); }
+    const float *im() const { return m_im.data(); }
+
+    void zero() {
+        std::fill(m_re.begin(), m_re.end(), 0.0f);
+        std::fill(m_im.begin(), m_im.end(), 0.0f);
+    }
+
+    void load(const Cpx *src, uint32_t length) {
+        QsSimd::kernels().deInterleave(reinterpret_cast<const float *>(src), re(), im(), length);
+    }
+    void store(Cpx *dst, uint32_t length) const { QsSimd::kernels().realToComplex(re(), im(), dst, length); }
+
+  private:
+    qs_vect_f m_re;
+    qs_vect_f m_im;
+};
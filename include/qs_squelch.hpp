@@ -4,21 +4,22 @@
  *
  * The QsSquelch class provides methods to manage squelch operations,
  * which are used to suppress noise in audio or signal processing applications.
- * The class allows for the initialization of squelch parameters and processing
- * of input data based on the configured threshold.
+ * The class allows for the initialization of squelch parameters and decides,
+ * once per block, whether the block is muted against the configured threshold.
  *
  * Features:
  * - Enable or disable squelch functionality.
  * - Set and get squelch threshold for signal processing.
- * - Process a vector of complex signals, applying squelch logic.
+ * - Decide per block whether the squelch is closed; the caller mutes.
  *
  * Usage:
  * To use the QsSquelch class, create an instance, initialize it, and then
- * call the process method with the source/destination vector:
+ * ask closed() once per block:
  *
  *   QsSquelch squelch;
  *   squelch.init();                   // Initialize squelch parameters
- *   squelch.process(src_dst);         // Process signals with squelch logic
+ *   squelch.update(params);           // New settings snapshot, DSP thread
+ *   if (squelch.closed()) { ... }     // Mute this block
  *
  * This class is useful in scenarios where it is necessary to filter out
  * unwanted signals or noise below a certain threshold in communication systems
@@ -30,7 +31,6 @@
 
 #pragma once
 
-#include "../include/qs_signalops.hpp"
 #include "../include/qs_globals.hpp"
 
 class QsSquelch {
@@ -44,5 +44,9 @@ class QsSquelch {
     QsSquelch();
 
     void init();
-    void process(qs_vect_cpx &src_dst);
+    void update(const QsDspParams &params);
+
+    // Updates the hysteresis from the S meter and returns true when the
+    // block is to be muted; call once per block.
+    bool closed();
 };
\ No newline at end of file
@@ -21,6 +21,7 @@ class QsState {
     int m_ps_block_size;
     int m_tx_block_size;
     int m_rs_quality;
+    int m_fe_threads;
     int m_rta_audio_frames;
     int m_main_filter_taps;
     int m_rta_in_dev_id;
@@ -53,6 +54,7 @@ class QsState {
     int psBlockSize();
     int txBlockSize();
     int rsQual();
+    int frontEndThreads();
     int rtAudioFrameSize();
     int mainFilterTapSize();
     int rtAudioInDevId();
@@ -73,6 +75,7 @@ class QsState {
 
     void readSettings();
     void setBlockSize(int blocksz);
+    void setFrontEndThreads(int threads);
     void setPsBlockSize(int blocksz);
     void setTxBlockSize(int blocksz);
 
@@ -0,0 +1,54 @@
+/**
+ * @file qs_synth_source.hpp
+ * @brief In-memory IQ source standing in for the QS1R's EP6 stream.
+ *
+ * QsSyntheticSource fills blocks of interleaved 32 bit I/Q, the format the
+ * FPGA sends on EP6, from a table built once in init(): a tone in white
+ * noise, sized to a whole number of tone cycles so the stream wraps without
+ * a step. QsDataReader reads from it instead of the USB device when one is
+ * attached, which lets the reader, DSP and DAC ring path run with no
+ * hardware (benchmarks, bring-up on a laptop).
+ *
+ * Features:
+ * - Same call shape and return as QsIOLib_LibUSB::readEP6
+ * - No pacing: read() returns at once, so a consumer runs as fast as the
+ *   pipeline behind it allows
+ * - Tone offset and levels in Hz and dBFS; the tone is moved to the nearest
+ *   frequency that fits the table
+ *
+ * Usage:
+ * 1. QsSyntheticSource source;
+ *    source.init(rate, block_size);
+ * 2. QsGlobal::g_data_reader->setSource(&source);   // before start()
+ * 3. source.read(buffer, block_size * 2 * sizeof(int));
+ *
+ * Notes:
+ * - init() allocates; read() does not.
+ * - One reader at a time; the read position is not synchronized.
+ */
+
+#pragma once
+
+#include "../include/qs_types.hpp"
+
+#include <cstdint>
+
+class QsSyntheticSource {
+  public:
+    QsSyntheticSource();
+
+    void init(double rate, int block_size, double tone_hz = 1000.0, double tone_dbfs = -30.0,
+              double noise_dbfs = -100.0);
+
+    // length bytes of interleaved int32 I/Q; returns length
+    int read(unsigned char *buffer, unsigned int length);
+
+    double toneFrequency() const { return m_tone_hz; }
+    uint64_t bytesRead() const { return m_bytes_read; }
+
+  private:
+    qs_vect_i m_table; // interleaved I/Q
+    unsigned int m_pos;
+    double m_tone_hz;
+    uint64_t m_bytes_read;
+};
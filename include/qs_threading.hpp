@@ -7,6 +7,10 @@
 #include <optional>
 #include <stdexcept>
 #include <thread>
+#ifndef _WIN32
+#include <pthread.h>
+#include <time.h>
+#endif
 
 class Thread {
   public:
@@ -129,3 +133,27 @@ class Thread {
 #endif
     }
 };
+
+// CPU time a running std::thread has used, in seconds; 0 once it has been
+// joined or where the platform has no per-thread clock
+inline double threadCpuSeconds(std::thread &thread) {
+    if (!thread.joinable())
+        return 0.0;
+#ifdef _WIN32
+    FILETIME created, exited, kernel, user;
+    if (!GetThreadTimes(thread.native_handle(), &created, &exited, &kernel, &user))
+        return 0.0;
+    ULARGE_INTEGER k, u;
+    k.LowPart = kernel.dwLowDateTime;
+    k.HighPart = kernel.dwHighDateTime;
+    u.LowPart = user.dwLowDateTime;
+    u.HighPart = user.dwHighDateTime;
+    return (k.QuadPart + u.QuadPart) * 1e-7;
+#else
+    clockid_t clock;
+    struct timespec ts;
+    if (pthread_getcpuclockid(thread.native_handle(), &clock) != 0 || clock_gettime(clock, &ts) != 0)
+        return 0.0;
+    return ts.tv_sec + ts.tv_nsec * 1e-9;
+#endif
+}
@@ -6,11 +6,15 @@
  * @features
  * - Generates sine wave signals at defined frequencies.
  * - Supports different operational modes indicated by the QSDSPPOS enumeration.
+ * - Segmented, thread-safe mixing of one block for the parallel front end.
+ * - Block NCO (QsNco): 32 bit phase accumulator and table lookup, vectorised
+ *   mixing, phase continuous across blocks and frequency changes.
  *
  * @usage
  * To use the QsToneGenerator class, create an instance, initialize it with the desired 
  * operating position using the `init()` method, and then call the `process()` method to 
- * generate the sine wave signals into the provided complex vector.
+ * generate the sine wave signals into the provided complex vector. `update()` retunes
+ * the NCO from a new settings snapshot, phase continuous.
  *
  * @notes
  * Ensure that the input vector is correctly sized and initialized before calling the 
@@ -22,6 +26,8 @@
 
 #pragma once
 
+#include "../include/qs_dsp_params.hpp"
+#include "../include/qs_nco.hpp"
 #include "../include/qs_signalops.hpp"
 
 class QsToneGenerator {
@@ -32,20 +38,26 @@ class QsToneGenerator {
     explicit QsToneGenerator();
 
     void process(qs_vect_cpx &src_dst);
+    void process(Cpx *src_dst, int length);
     void init(QSDSPPOS pos);
+    void update(const QsDspParams &params);
+
+    // Segmented mixing for the parallel front end. mixSegment() mixes any
+    // sample range of the block (offset may be negative to reach back into
+    // the previous block) and can run on several threads at once, endBlock()
+    // advances the NCO past the block. Segments mix to the same values as
+    // process() on the whole block.
+    void mixSegment(const Cpx *src, Cpx *dst, int offset, int length) const;
+    void endBlock(int length);
+
+    // oscillator for the fused mix-and-decimate path of QsDownConvertor
+    const QsNco &nco() const { return m_nco; }
 
   private:
     // TONE GENERATOR
     QSDSPPOS m_tg_pos;
+    uint32_t m_version; // pgToneGen
     double m_rate;
-    double m_tg_inc;
-    double m_tg_osc_cos;
-    double m_tg_osc_sin;
-    double m_tg_osc1_re;
-    double m_tg_osc1_im;
     double m_tg_lo_freq;
-    double m_tg_osc_re;
-    double m_tg_osc_im;
-
-    qs_vect_cpx::iterator cpx_itr;
+    QsNco m_nco;
 };
@@ -0,0 +1,99 @@
+/**
+ * @file qs_trace.hpp
+ * @brief Flight recorder of thread activity, written as Chrome trace JSON.
+ *
+ * Every traced thread owns a fixed ring of events: spans (a name, a start
+ * and a duration) and instants. The ring overwrites its oldest events, so
+ * it always holds the last few seconds of each thread's timeline. dump()
+ * writes all rings to a file that chrome://tracing and ui.perfetto.dev
+ * open directly. A deadline miss (DAC underrun, ring overflow) asks for a
+ * dump of its own, written by a background thread a moment after the miss
+ * so the events on both sides of it are in the file.
+ *
+ * Features:
+ * - Off: one relaxed load and a branch per trace point
+ * - On: one rdtsc (QsTicks) and three relaxed stores per span, no locks,
+ *   no allocation after the thread's first attach()
+ * - Bounded: QS_DEFAULT_TRACE_EVENTS events per thread
+ * - The DSP stage laps (QsDspStats) double as spans
+ * - Automatic dumps on a deadline miss, at most one per
+ *   QS_DEFAULT_TRACE_HOLDOFF_S seconds
+ *
+ * Usage:
+ * 1. QsTrace::attach("dspproc");              // thread start, before warm-up
+ * 2. { QsTrace::Span span("ep6 read"); ... }  // a span
+ *    QsTrace::instant("filter design");       // a point
+ *    QsTrace::miss("dac underrun");           // a glitch: point and dump
+ * 3. QsTrace::setEnabled(true);               // any thread
+ * 4. QsTrace::dumpNamed("qs1r_trace.json");   // any non real-time thread
+ *
+ * Notes:
+ * - Names must be string literals (or otherwise live forever); the rings
+ *   store the pointer.
+ * - A thread that never called attach() gets a ring named "thread" on its
+ *   first event, which allocates; the real-time threads attach up front.
+ * - A thread's ring outlives the thread and is reused by the next thread
+ *   attaching with the same name, so restarts share one timeline row.
+ * - Dumps requested over the network take a file name, not a path: they
+ *   and the automatic dumps land in QS_DEFAULT_TRACE_DIR.
+ */
+
+#pragma once
+
+#include "../include/qs_ticks.hpp"
+
+#include <atomic>
+#include <cstdint>
+#include <string>
+
+class QsTrace {
+  public:
+    // the calling thread's ring, found by name or made; allocates once
+    static void attach(const char *name);
+
+    // any thread; enabling starts the automatic dump writer
+    static void setEnabled(bool value);
+    static inline bool enabled() { return s_enabled.load(std::memory_order_relaxed); }
+
+    // a span measured by the caller, QsTicks stamps
+    static inline void complete(const char *name, uint64_t start, uint64_t stop) {
+        if (enabled())
+            record(name, start, stop - start, false);
+    }
+    static inline void instant(const char *name) {
+        if (enabled())
+            record(name, QsTicks::now(), 0, true);
+    }
+
+    // a deadline miss: an instant, counted, and a dump shortly after
+    static void miss(const char *what);
+    static uint64_t misses();
+
+    // all rings as Chrome trace JSON; allocates, not for real-time threads
+    static bool dump(const std::string &path);
+    // dump() to QS_DEFAULT_TRACE_DIR + name; false for a name that is not
+    // a plain file name ("", ".", or containing a '/' or "..")
+    static bool dumpNamed(const std::string &name);
+    // "<0|1> threads n events n misses n"
+    static std::string status();
+
+    class Span {
+      public:
+        explicit Span(const char *name) : m_name(enabled() ? name : nullptr), m_start(m_name ? QsTicks::now() : 0) {}
+        ~Span() {
+            if (m_name)
+                complete(m_name, m_start, QsTicks::now());
+        }
+        Span(const Span &) = delete;
+        Span &operator=(const Span &) = delete;
+
+      private:
+        const char *m_name;
+        uint64_t m_start;
+    };
+
+  private:
+    static void record(const char *name, uint64_t start, uint64_t duration, bool instant);
+
+    static std::atomic<bool> s_enabled;
+};
@@ -11,6 +11,11 @@
  * - Definition of complex number type using float precision.
  * - Type definitions for vectors of complex numbers, floating-point numbers,
  *   integers, and unsigned 16-bit integers.
+ * - qs_v4f / qs_v4i: four-lane SIMD values (GCC and Clang vector
+ *   extension) for kernels the compiler does not vectorise on its own.
+ * - The qs_vect_* types allocate through QsAlignedAllocator, so every
+ *   block starts on a 64 byte (cache line, AVX-512 register) boundary and
+ *   no two blocks share a line.
  *
  * Usage:
  * Include this header file in any source file where signal processing or 
@@ -31,11 +36,42 @@
 #pragma once
 
 #include <complex>
+#include <cstddef>
+#include <cstdint>
+#include <new>
 #include <vector>
 
 typedef std::complex<float> Cpx;
 
-typedef std::vector<Cpx> qs_vect_cpx;
-typedef std::vector<float> qs_vect_f;
-typedef std::vector<int> qs_vect_i;
-typedef std::vector<uint16_t> qs_vect_s;
+#define QS_ALIGNMENT 64
+
+template <typename T, std::size_t Align = QS_ALIGNMENT> struct QsAlignedAllocator {
+    typedef T value_type;
+    template <typename U> struct rebind {
+        typedef QsAlignedAllocator<U, Align> other;
+    };
+
+    QsAlignedAllocator() noexcept {}
+    template <typename U> QsAlignedAllocator(const QsAlignedAllocator<U, Align> &) noexcept {}
+
+    T *allocate(std::size_t n) { return static_cast<T *>(::operator new(n * sizeof(T), std::align_val_t(Align))); }
+    void deallocate(T *p, std::size_t) noexcept { ::operator delete(p, std::align_val_t(Align)); }
+
+    template <typename U> bool operator==(const QsAlignedAllocator<U, Align> &) const noexcept { return true; }
+    template <typename U> bool operator!=(const QsAlignedAllocator<U, Align> &) const noexcept { return false; }
+};
+
+typedef std::vector<Cpx, QsAlignedAllocator<Cpx>> qs_vect_cpx;
+typedef std::vector<float, QsAlignedAllocator<float>> qs_vect_f;
+typedef std::vector<int, QsAlignedAllocator<int>> qs_vect_i;
+typedef std::vector<uint16_t, QsAlignedAllocator<uint16_t>> qs_vect_s;
+
+// four floats, one SIMD register on SSE / NEON; GCC and Clang vector extension
+typedef float qs_v4f __attribute__((vector_size(16)));
+typedef int qs_v4i __attribute__((vector_size(16)));
+
+#if defined(__clang__)
+#define QS_V4F_SHUFFLE(a, b, i0, i1, i2, i3) __builtin_shufflevector(a, b, i0, i1, i2, i3)
+#else
+#define QS_V4F_SHUFFLE(a, b, i0, i1, i2, i3) __builtin_shuffle(a, b, qs_v4i{i0, i1, i2, i3})
+#endif
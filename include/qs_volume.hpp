@@ -10,11 +10,12 @@
  * - Adjusts amplitude of real-valued signals represented as `qs_vect_f`.
  * 
  * Usage:
- * - Create an instance of `QsVolume` and use the `process` methods to modify the amplitude
- *   of input signals.
+ * - Create an instance of `QsVolume`, call `init()`, pass each new settings snapshot to
+ *   `update()` and use the `process` methods to modify the amplitude of input signals.
  * 
  * Notes:
- * - Volume adjustments are based on a logarithmic scale (decibels).
+ * - Volume adjustments are based on a logarithmic scale (decibels); the gain is computed
+ *   once per volume change, not per block.
  * - Ensure that the input signals are properly initialized before processing.
  * 
  * Author: Philip A Covington
@@ -33,6 +34,7 @@ class QsVolume {
   private:
     float m_volume_db;
     float m_volume_val;
+    uint32_t m_version; // pgVolume
 
     qs_vect_cpx::iterator cpx_itr;
     qs_vect_f::iterator f_itr;
@@ -40,6 +42,10 @@ class QsVolume {
   public:
     QsVolume();
 
+    void init();
+    void update(const QsDspParams &params);
     void process(qs_vect_cpx &src_dst);
     void process(qs_vect_f &src_dst);
+    void process(float *src_dst, int length);
+    void processToStereo(const float *src, float *dst, int length); // dst interleaved L/R
 };
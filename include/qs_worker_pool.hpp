@@ -0,0 +1,65 @@
+/**
+ * @file qs_worker_pool.hpp
+ * @brief Small persistent thread pool for splitting one DSP block across cores.
+ *
+ * The QsWorkerPool keeps a fixed set of worker threads parked on a condition
+ * variable. run() hands them a job as a plain function pointer plus context
+ * and an index count, takes part in the work on the calling thread and
+ * returns once every index has been processed.
+ *
+ * Features:
+ * - Threads are created once in start(), nothing is allocated per run()
+ * - Jobs are `void (*)(void *ctx, int index)`, no std::function
+ * - The calling thread counts as one of the pool's threads
+ *
+ * Usage:
+ * 1. QsWorkerPool pool; pool.start(4);
+ * 2. pool.run(&MyClass::job, this, segments);
+ * 3. pool.stop() (also done by the destructor).
+ *
+ * Notes:
+ * - run() is not re-entrant; only one thread may submit work at a time.
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+class QsWorkerPool {
+  public:
+    typedef void (*Job)(void *ctx, int index);
+
+    QsWorkerPool();
+    ~QsWorkerPool();
+
+    QsWorkerPool(const QsWorkerPool &) = delete;
+    QsWorkerPool &operator=(const QsWorkerPool &) = delete;
+
+    void start(int threads);
+    void stop();
+    int size() const { return static_cast<int>(m_threads.size()) + 1; }
+
+    void run(Job job, void *ctx, int count);
+
+  private:
+    void workerLoop();
+    void drain();
+
+    std::vector<std::thread> m_threads;
+    std::mutex m_mutex;
+    std::condition_variable m_cv_go;
+    std::condition_variable m_cv_done;
+
+    Job m_job;
+    void *m_ctx;
+    int m_count;
+    std::atomic<int> m_next;
+    int m_active;
+    uint64_t m_generation;
+    bool m_quit;
+};
@@ -1,10 +1,12 @@
 #include "../include/qs1r_server.hpp"
+#include "../include/qs_arena.hpp"
 #include "../include/qs_audio.hpp"
 #include "../include/qs_bitstream.hpp"
 #include "../include/qs_bytearray.hpp"
 #include "../include/qs_dac_writer.hpp"
 #include "../include/qs_datareader.hpp"
 #include "../include/qs_datastreamclass.hpp"
+#include "../include/qs_decim_planner.hpp"
 #include "../include/qs_debugloggerclass.hpp"
 #include "../include/qs_dsp_proc.hpp"
 #include "../include/qs_fft.hpp"
@@ -17,9 +19,11 @@
 #include "../include/qs_listclass.hpp"
 #include "../include/qs_memory.hpp"
 #include "../include/qs_signalops.hpp"
+#include "../include/qs_simd.hpp"
 #include "../include/qs_sleep.hpp"
 #include "../include/qs_state.hpp"
 #include "../include/qs_stringclass.hpp"
+#include "../include/qs_trace.hpp"
 #include "../include/qs_uuid.hpp"
 #include "qs1r_server.hpp"
 #include <algorithm>
@@ -27,6 +31,8 @@
 #include <cstdint>
 #include <sstream>
 
+#define NR_ALG_SPECTRAL 3 // NoiseReductionAlgorithm value for the spectral stage
+
 QS1RServer::QS1RServer()
     : p_rta(std::make_unique<QsAudio>()), p_qsState(std::make_unique<QsState>()),
       p_io_thread(std::make_unique<QsIoThread>()), m_is_fpga_loaded(false), m_is_io_setup(false),
@@ -70,6 +76,7 @@ void QS1RServer::shutdown() {
     p_qsState->setStartupVolume(QsGlobal::g_memory->getVolume());
     p_qsState->setStartupAGCDecaySpeed(QsGlobal::g_memory->getAgcDecaySpeed());
     p_qsState->setStartupAGCThreshold(QsGlobal::g_memory->getAgcThreshold());
+    p_qsState->setFrontEndThreads(QsGlobal::g_memory->getFrontEndThreads());
     p_qsState->setPGA(QsGlobal::g_memory->getAdcPgaOn());
     p_qsState->setRAND(QsGlobal::g_memory->getAdcRandomOn());
     p_qsState->setDITH(QsGlobal::g_memory->getAdcDitherOn());
@@ -85,6 +92,8 @@ void QS1RServer::shutdown() {
 
 void QS1RServer::initialize() {
     error_flag = false;
+    QsSimd::init();
+    _debug() << "signal kernels: " << QsSimd::name();
     initSupportedSampleRatesList();
     showStartupMessage();
     initSMeterCorrectionMap();
@@ -195,6 +204,7 @@ void QS1RServer::initQsMemory() {
     QsGlobal::g_memory->setDataProcRate(p_qsState->startupSampleRate());
     QsGlobal::g_memory->setReadBlockSize(p_qsState->blockSize());
     QsGlobal::g_memory->setResamplerQuality(p_qsState->rsQual());
+    QsGlobal::g_memory->setFrontEndThreads(p_qsState->frontEndThreads());
     QsGlobal::g_memory->setEncodeFreqCorrect(p_qsState->clockCorrection());
     QsGlobal::g_memory->setEncodeClockFrequency(p_qsState->encodeClockFrequency());
     QsGlobal::g_memory->setTxBlockSize(p_qsState->txBlockSize());
@@ -500,13 +510,9 @@ bool QS1RServer::setFpgaForSampleRate(double samplerate) {
 }
 
 double QS1RServer::estimateDownConvertorRate(double in_rate, double bandwidth) {
-    double f = in_rate;
-    double hb51tapbw = (.5 - .333);
-    double min_output_rate = (7900.0 * 2.0);
-    while ((f > (bandwidth / hb51tapbw)) && (f > min_output_rate)) {
-        f /= 2.0;
-    }
-    return f;
+    QsDecimPlan plan = QsDecimationPlanner::plan(in_rate, bandwidth);
+    _debug() << "Decimation plan: " << plan.toString();
+    return plan.out_rate;
 }
 
 int QS1RServer::frequencyToPhaseIncrement(double freq) {
@@ -581,6 +587,7 @@ QSDEMODMODE QS1RServer::modeStringToMode(String smode) {
 // Sets up the DSP chain
 // ------------------------------------------------------------
 void QS1RServer::setupIo() {
+    QsTrace::Span span("setupIo");
     int rx_num = 1;
 
     m_is_io_setup = false;
@@ -608,6 +615,7 @@ void QS1RServer::setupIo() {
 // Starts the DSP processing
 // ------------------------------------------------------------
 void QS1RServer::startIo(bool iswav) {
+    QsTrace::Span span("startIo");
     if (m_is_io_running) {
         stopIo();
     }
@@ -652,6 +660,7 @@ void QS1RServer::startIo(bool iswav) {
 void QS1RServer::stopIo() {
     if (!m_is_io_running)
         return;
+    QsTrace::Span span("stopIo");
 
     // The order of stopping threads below
     // is important!
@@ -1336,6 +1345,9 @@ String QS1RServer::doCommandProcessor(String value, int rx_num) {
     if (rx_num > NUMBER_OF_RECEIVERS)
         return "NAK";
 
+    QsTrace::attach("command");
+    QsTrace::Span span("command");
+
     String response;
 
     response = "?";
@@ -1480,6 +1492,39 @@ String QS1RServer::doCommandProcessor(String value, int rx_num) {
         }
     }
 
+    //
+    // AudioRateStage n, n = 0,1
+    //
+    else if (cmd.cmd.compare("AudioRateStage") == 0) // turns on/off decimated audio rate stage
+    {
+        if (cmd.RW == CMD::cmd_write) {
+            QsGlobal::g_memory->setAudioRateStage((bool)cmd.ivalue);
+            response = "OK";
+        } else if (cmd.RW == CMD::cmd_read) {
+            bool value = QsGlobal::g_memory->getAudioRateStage(rx_num - 1);
+            response.append(cmd.cmd);
+            response.append(String("="));
+            response.append(String::number(value));
+        }
+    }
+
+    //
+    // AutoNotchAlgorithm n, n = 0 (NLMS), 1 (block LMS), 2 (frequency domain)
+    //
+    else if (cmd.cmd.compare("AutoNotchAlgorithm") == 0) // select auto notch adaptive algorithm
+    {
+        if (cmd.RW == CMD::cmd_write) {
+            QsGlobal::g_memory->setAutoNotchAlgorithm(
+                (cmd.ivalue == adBlockLms || cmd.ivalue == adFdaf) ? cmd.ivalue : adNlms);
+            response = "OK";
+        } else if (cmd.RW == CMD::cmd_read) {
+            int value = QsGlobal::g_memory->getAutoNotchAlgorithm(rx_num - 1);
+            response.append(cmd.cmd);
+            response.append(String("="));
+            response.append(String::number(value));
+        }
+    }
+
     //
     // AutoNotchSwitch n, n = 0,1
     //
@@ -1620,6 +1665,24 @@ String QS1RServer::doCommandProcessor(String value, int rx_num) {
         }
     }
 
+    //
+    // DspStats n, n = 0,1 or reset
+    //
+    else if (cmd.cmd.compare("DspStats") == 0) // per stage DSP time per block
+    {
+        if (cmd.RW == CMD::cmd_write) {
+            if (cmd.svalue.compare("reset") == 0)
+                QsGlobal::g_dsp_proc->stats().requestReset();
+            else
+                QsGlobal::g_dsp_proc->stats().setEnabled((bool)cmd.ivalue);
+            response = "OK";
+        } else if (cmd.RW == CMD::cmd_read) {
+            response.append(cmd.cmd);
+            response.append(String("="));
+            response.append(String::fromStdString(QsGlobal::g_dsp_proc->stats().report()));
+        }
+    }
+
     //****************************************************//
     //----------------------E-----------------------------//
     //****************************************************//
@@ -1660,6 +1723,22 @@ String QS1RServer::doCommandProcessor(String value, int rx_num) {
     //----------------------F-----------------------------//
     //****************************************************//
 
+    //
+    // FmDetector n, n = 0 (PLL), 1 (quadrature)
+    //
+    else if (cmd.cmd.compare("FmDetector") == 0) // select FM detector
+    {
+        if (cmd.RW == CMD::cmd_write) {
+            QsGlobal::g_memory->setFmDetector(cmd.ivalue == fmQuadrature ? fmQuadrature : fmPll);
+            response = "OK";
+        } else if (cmd.RW == CMD::cmd_read) {
+            int value = QsGlobal::g_memory->getFmDetector(rx_num - 1);
+            response.append(cmd.cmd);
+            response.append(String("="));
+            response.append(String::number(value));
+        }
+    }
+
     //
     // Freq d, d = 0.0 to 62.5e6 Hz
     //
@@ -1831,6 +1910,31 @@ String QS1RServer::doCommandProcessor(String value, int rx_num) {
         }
     }
 
+    //
+    // FrontEndThreads n, n >= 1; 1 runs the front end serially
+    //
+    else if (cmd.cmd.compare("FrontEndThreads") == 0) // cores the full-rate front end is split across
+    {
+        if (cmd.RW == CMD::cmd_write) {
+            if (cmd.ivalue < 1) {
+                response = "NAK";
+            } else {
+                QsGlobal::g_memory->setFrontEndThreads(cmd.ivalue);
+                // the front end is built in setupIo()
+                if (m_is_io_running) {
+                    stopIo();
+                    setupIo();
+                    startIo();
+                }
+                response = "OK";
+            }
+        } else if (cmd.RW == CMD::cmd_read) {
+            response.append(cmd.cmd);
+            response.append(String("="));
+            response.append(String::number(QsGlobal::g_memory->getFrontEndThreads()));
+        }
+    }
+
     //****************************************************//
     //----------------------G-----------------------------//
     //****************************************************//
@@ -1862,6 +1966,22 @@ String QS1RServer::doCommandProcessor(String value, int rx_num) {
     //----------------------L-----------------------------//
     //****************************************************//
 
+    //
+    // Latency reset
+    //
+    else if (cmd.cmd.compare("Latency") == 0) // per hop latency, USB read to DAC write
+    {
+        if (cmd.RW == CMD::cmd_write) {
+            if (cmd.svalue.compare("reset") == 0)
+                QsGlobal::g_latency->requestReset();
+            response = "OK";
+        } else if (cmd.RW == CMD::cmd_read) {
+            response.append(cmd.cmd);
+            response.append(String("="));
+            response.append(String::fromStdString(QsGlobal::g_latency->report()));
+        }
+    }
+
     //****************************************************//
     //----------------------M-----------------------------//
     //****************************************************//
@@ -2038,6 +2158,30 @@ String QS1RServer::doCommandProcessor(String value, int rx_num) {
         }
     }
 
+    //
+    // NoiseReductionAlgorithm n, n = 0 (NLMS), 1 (block LMS), 2 (frequency domain LMS), 3 (spectral)
+    //
+    else if (cmd.cmd.compare("NoiseReductionAlgorithm") == 0) // select noise reduction algorithm
+    {
+        if (cmd.RW == CMD::cmd_write) {
+            if (cmd.ivalue == NR_ALG_SPECTRAL) {
+                QsGlobal::g_memory->setNoiseReductionMode(nrSpectral);
+            } else {
+                QsGlobal::g_memory->setNoiseReductionAlgorithm(
+                    (cmd.ivalue == adBlockLms || cmd.ivalue == adFdaf) ? cmd.ivalue : adNlms);
+                QsGlobal::g_memory->setNoiseReductionMode(nrLms);
+            }
+            response = "OK";
+        } else if (cmd.RW == CMD::cmd_read) {
+            int value = QsGlobal::g_memory->getNoiseReductionMode(rx_num - 1) == nrSpectral
+                            ? NR_ALG_SPECTRAL
+                            : QsGlobal::g_memory->getNoiseReductionAlgorithm(rx_num - 1);
+            response.append(cmd.cmd);
+            response.append(String("="));
+            response.append(String::number(value));
+        }
+    }
+
     //****************************************************//
     //----------------------O-----------------------------//
     //****************************************************//
@@ -2109,6 +2253,28 @@ String QS1RServer::doCommandProcessor(String value, int rx_num) {
         }
     }
 
+    //
+    // PerfCounters n, n = 0,1 or reset
+    //
+    else if (cmd.cmd.compare("PerfCounters") == 0) // hardware counters per DSP stage and reader conversion
+    {
+        if (cmd.RW == CMD::cmd_write) {
+            if (cmd.svalue.compare("reset") == 0) {
+                QsGlobal::g_dsp_proc->stats().perf().requestReset();
+                QsGlobal::g_data_reader->perf().requestReset();
+            } else {
+                QsGlobal::g_dsp_proc->stats().perf().setEnabled((bool)cmd.ivalue);
+                QsGlobal::g_data_reader->perf().setEnabled((bool)cmd.ivalue);
+            }
+            response = "OK";
+        } else if (cmd.RW == CMD::cmd_read) {
+            response.append(cmd.cmd);
+            response.append(String("="));
+            response.append(String::fromStdString("dsp: " + QsGlobal::g_dsp_proc->stats().perf().report() +
+                                                  "; reader: " + QsGlobal::g_data_reader->perf().report()));
+        }
+    }
+
     //****************************************************//
     //----------------------R-----------------------------//
     //****************************************************//
@@ -2201,6 +2367,22 @@ String QS1RServer::doCommandProcessor(String value, int rx_num) {
         }
     }
 
+    //
+    // SamTracking n, n = 0 (per sample), 1 (block)
+    //
+    else if (cmd.cmd.compare("SamTracking") == 0) // select SAM carrier tracking
+    {
+        if (cmd.RW == CMD::cmd_write) {
+            QsGlobal::g_memory->setSamTracking(cmd.ivalue == samBlock ? samBlock : samPerSample);
+            response = "OK";
+        } else if (cmd.RW == CMD::cmd_read) {
+            int value = QsGlobal::g_memory->getSamTracking(rx_num - 1);
+            response.append(cmd.cmd);
+            response.append(String("="));
+            response.append(String::number(value));
+        }
+    }
+
     //
     // SampleRate d, d = {supported sample rate}
     //
@@ -2300,6 +2482,27 @@ String QS1RServer::doCommandProcessor(String value, int rx_num) {
     //----------------------T-----------------------------//
     //****************************************************//
 
+    //
+    // Trace n, n = 0,1 or dump [name], written under QS_DEFAULT_TRACE_DIR
+    //
+    else if (cmd.cmd.compare("Trace") == 0) // thread activity recorder, Chrome trace JSON
+    {
+        if (cmd.RW == CMD::cmd_write) {
+            if (cmd.svalue.startsWith("dump")) {
+                std::string name = cmd.svalue.length() > 5 ? cmd.svalue.mid(5, std::string::npos).toStdString()
+                                                           : std::string(QS_DEFAULT_TRACE_FILE);
+                response = QsTrace::dumpNamed(name) ? "OK" : "NAK";
+            } else {
+                QsTrace::setEnabled((bool)cmd.ivalue);
+                response = "OK";
+            }
+        } else if (cmd.RW == CMD::cmd_read) {
+            response.append(cmd.cmd);
+            response.append(String("="));
+            response.append(String::fromStdString(QsTrace::status()));
+        }
+    }
+
     //
     // ToneFrequency d, n = -20000.0 to 20000.0
     //
@@ -2378,9 +2581,9 @@ String QS1RServer::doCommandProcessor(String value, int rx_num) {
         if (cmd.RW == CMD::cmd_write) {
             response = "NAK";
         } else if (cmd.RW == CMD::cmd_read) {
-            short *data = new short[WB_BLOCK_SIZE];
+            QsArena::Scope scratch;
+            short *data = scratch.alloc<short>(WB_BLOCK_SIZE);
             int value = QsGlobal::g_io->readEP8((unsigned char *)data, WB_BLOCK_SIZE * sizeof(short));
-            delete[] data;
             response.append(cmd.cmd);
             response.append(String("="));
             response.append(String::number(value));
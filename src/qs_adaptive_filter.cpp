@@ -0,0 +1,260 @@
+#include "../include/qs_adaptive_filter.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+
+#define ADAPT_EPSILON 1e-10
+#define FDAF_POWER_SMOOTH 0.9 // per-block smoothing of the input power
+
+// Contiguous dot product with eight independent partial sums, so the
+// reduction vectorises without relaxed floating point.
+static inline float dotProduct(const float *a, const float *b, int n) {
+    float part[8] = {0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f, 0.0f};
+    int i = 0;
+    for (; i + 8 <= n; i += 8)
+        for (int j = 0; j < 8; j++)
+            part[j] += a[i + j] * b[i + j];
+    float sum = ((part[0] + part[4]) + (part[1] + part[5])) + ((part[2] + part[6]) + (part[3] + part[7]));
+    for (; i < n; i++)
+        sum += a[i] * b[i];
+    return sum;
+}
+
+// Step for a block of n updates: the sum of the n per-sample steps once
+// leakage is accounted for, rate * (1 + scl1 + ... + scl1^(n-1)), capped
+// at 1 so the block update stays stable.
+static inline double blockStep(double rate, double scl1, int n) {
+    double weight = (scl1 < 1.0) ? (1.0 - std::pow(scl1, n)) / (1.0 - scl1) : n;
+    return std::min(rate * weight, 1.0);
+}
+
+QsAdaptiveFilter::QsAdaptiveFilter()
+    : m_algorithm(adNlms), m_taps(0), m_delay(0), m_hist_len(0), m_fft_block(0), m_rate(0.0), m_leakage(0.0),
+      m_block_power(0.0) {}
+
+void QsAdaptiveFilter::configure(QSADAPTALG algorithm, int taps, int delay) {
+    taps = std::max(1, taps);
+    delay = std::max(0, delay);
+    if (taps == m_taps && delay == m_delay) {
+        // weights carry over between algorithms
+        m_algorithm = algorithm;
+        return;
+    }
+
+    m_algorithm = algorithm;
+    m_taps = taps;
+    m_delay = delay;
+
+    m_fft_block = 16;
+    while (m_fft_block < m_taps)
+        m_fft_block <<= 1;
+    m_hist_len = m_delay + m_fft_block;
+
+    m_weights.assign(m_taps, 0.0f);
+    m_hist.assign(m_hist_len + std::max(ADAPT_CHUNK, m_fft_block), 0.0f);
+    m_acc.assign(std::max(ADAPT_CHUNK, m_fft_block), 0.0f);
+
+    m_fft.resize(2 * m_fft_block);
+    m_u.assign(2 * m_fft_block, Cpx(0.0, 0.0));
+    m_w.assign(2 * m_fft_block, Cpx(0.0, 0.0));
+    m_tmp.assign(2 * m_fft_block, Cpx(0.0, 0.0));
+    m_block_power = 0.0;
+}
+
+void QsAdaptiveFilter::setRate(double rate, double leakage) {
+    m_rate = rate;
+    m_leakage = leakage;
+}
+
+void QsAdaptiveFilter::reset() {
+    std::fill(m_weights.begin(), m_weights.end(), 0.0f);
+    std::fill(m_hist.begin(), m_hist.end(), 0.0f);
+    m_block_power = 0.0;
+}
+
+void QsAdaptiveFilter::clearHistory() { std::fill(m_hist.begin(), m_hist.end(), 0.0f); }
+
+void QsAdaptiveFilter::process(const float *in, float *prediction, float *error, int length) {
+    if (m_taps == 0 || length <= 0)
+        return;
+
+    if (m_algorithm == adFdaf && (length % m_fft_block) == 0)
+        runFdaf(in, prediction, error, length);
+    else if (m_algorithm == adBlockLms)
+        runBlockLms(in, prediction, error, length);
+    else
+        runNlms(in, prediction, error, length);
+}
+
+void QsAdaptiveFilter::runNlms(const float *x, float *prediction, float *error, int length) {
+    const int L = m_taps;
+    const int D = m_delay;
+    const float scl1 = static_cast<float>(1.0 - m_rate * m_leakage);
+    float *w = m_weights.data();
+    float *h = m_hist.data();
+
+    for (int base = 0; base < length; base += ADAPT_CHUNK) {
+        const int n = std::min(ADAPT_CHUNK, length - base);
+        std::memcpy(h + m_hist_len, x + base, sizeof(float) * n);
+
+        // window of the first sample; u[L-1] is x[n - D]
+        const float *u = h + m_hist_len - D - L + 1;
+        double sum_sq = 0.0;
+        for (int i = 0; i < L; i++)
+            sum_sq += u[i] * u[i];
+
+        for (int k = 0; k < n; k++, u++) {
+            float accum = dotProduct(w, u, L);
+
+            float e = x[base + k] - accum;
+            if (prediction)
+                prediction[base + k] = accum;
+            if (error)
+                error[base + k] = e;
+
+            float g = static_cast<float>(m_rate / (sum_sq + ADAPT_EPSILON)) * e;
+            for (int i = 0; i < L; i++)
+                w[i] = w[i] * scl1 + g * u[i];
+
+            // slide the power window one sample
+            sum_sq += u[L] * u[L] - u[0] * u[0];
+        }
+
+        std::memmove(h, h + n, sizeof(float) * m_hist_len);
+    }
+}
+
+void QsAdaptiveFilter::runBlockLms(const float *x, float *prediction, float *error, int length) {
+    const int L = m_taps;
+    const int D = m_delay;
+    const double scl1 = 1.0 - m_rate * m_leakage;
+    float *w = m_weights.data();
+    float *h = m_hist.data();
+
+    for (int base = 0; base < length; base += ADAPT_CHUNK) {
+        const int n = std::min(ADAPT_CHUNK, length - base);
+        std::memcpy(h + m_hist_len, x + base, sizeof(float) * n);
+
+        for (int b0 = 0; b0 < n; b0 += ADAPT_BLOCK) {
+            // A short last block still runs full width; the windows past its
+            // end read allocated history and their errors are zeroed.
+            const int b = std::min(ADAPT_BLOCK, n - b0);
+            const float *u = h + m_hist_len + b0 - D - L + 1; // window of sample b0
+
+            // ======== FILTER (weights frozen over the block) ===========
+            float acc[ADAPT_BLOCK] = {};
+            for (int i = 0; i < L; i++) {
+                const float wi = w[i];
+                const float *ui = u + i;
+                for (int k = 0; k < ADAPT_BLOCK; k++)
+                    acc[k] += wi * ui[k];
+            }
+
+            // window power over L taps, averaged across the block
+            double sum_sq = 0.0;
+            for (int i = 0; i < L + b - 1; i++)
+                sum_sq += u[i] * u[i];
+            sum_sq *= static_cast<double>(L) / (L + b - 1);
+
+            float e[ADAPT_BLOCK] = {};
+            for (int k = 0; k < b; k++) {
+                e[k] = x[base + b0 + k] - acc[k];
+                if (prediction)
+                    prediction[base + b0 + k] = acc[k];
+                if (error)
+                    error[base + b0 + k] = e[k];
+            }
+
+            // ======== GRADIENT + UPDATE ===========
+            // mean of the b normalized gradients times the block step,
+            // eight taps at a time so the partial sums stay in registers
+            const float leak = static_cast<float>(std::pow(scl1, b));
+            const float scale = static_cast<float>(blockStep(m_rate, scl1, b) / (b * (sum_sq + ADAPT_EPSILON)));
+            int i = 0;
+            for (; i + 8 <= L; i += 8) {
+                float g[8] = {};
+                for (int k = 0; k < ADAPT_BLOCK; k++)
+                    for (int j = 0; j < 8; j++)
+                        g[j] += e[k] * u[i + j + k];
+                for (int j = 0; j < 8; j++)
+                    w[i + j] = w[i + j] * leak + scale * g[j];
+            }
+            for (; i < L; i++) {
+                float g = 0.0f;
+                for (int k = 0; k < ADAPT_BLOCK; k++)
+                    g += e[k] * u[i + k];
+                w[i] = w[i] * leak + scale * g;
+            }
+        }
+
+        std::memmove(h, h + n, sizeof(float) * m_hist_len);
+    }
+}
+
+void QsAdaptiveFilter::runFdaf(const float *x, float *prediction, float *error, int length) {
+    const int L = m_taps;
+    const int D = m_delay;
+    const int M = m_fft_block;
+    const int M2 = 2 * M;
+    const float inv = 1.0f / M2;
+    float *w = m_weights.data();
+    float *h = m_hist.data();
+
+
+    for (int base = 0; base < length; base += M) {
+        std::memcpy(h + m_hist_len, x + base, sizeof(float) * M);
+
+        // ======== FILTER (overlap-save) ===========
+        // window of 2M inputs ending at x[n - D] for the block's last sample
+        const float *win = h + m_hist_len - D - M;
+        for (int q = 0; q < M2; q++)
+            m_u[q] = Cpx(win[q], 0.0f);
+        m_fft.doDFTForward(m_u, M2);
+
+        for (int j = 0; j < M2; j++)
+            m_w[j] = Cpx(j < L ? w[L - 1 - j] : 0.0f, 0.0f);
+        m_fft.doDFTForward(m_w, M2);
+
+        for (int k = 0; k < M2; k++)
+            m_tmp[k] = m_u[k] * m_w[k];
+        m_fft.doDFTInverse(m_tmp, M2, inv);
+
+        for (int k = 0; k < M; k++) {
+            float y = m_tmp[M + k].real();
+            float e = x[base + k] - y;
+            if (prediction)
+                prediction[base + k] = y;
+            if (error)
+                error[base + k] = e;
+            m_acc[k] = e;
+        }
+
+        // ======== GRADIENT (constrained to L taps) ===========
+        double bin_power = 0.0;
+        for (int k = 0; k < M2; k++)
+            bin_power += std::norm(m_u[k]);
+        m_block_power = (m_block_power == 0.0) ? bin_power
+                                               : FDAF_POWER_SMOOTH * m_block_power + (1.0 - FDAF_POWER_SMOOTH) * bin_power;
+
+        // Parseval: the bins hold 2M times the window energy; scale to L taps
+        double sum_sq = m_block_power * L / (static_cast<double>(M2) * M2);
+
+        for (int q = 0; q < M; q++) {
+            m_tmp[q] = Cpx(0.0f, 0.0f);
+            m_tmp[M + q] = Cpx(m_acc[q], 0.0f);
+        }
+        m_fft.doDFTForward(m_tmp, M2);
+        for (int k = 0; k < M2; k++)
+            m_tmp[k] = std::conj(m_u[k]) * m_tmp[k];
+        m_fft.doDFTInverse(m_tmp, M2, inv);
+
+        const double scl1 = 1.0 - m_rate * m_leakage;
+        const float leak = static_cast<float>(std::pow(scl1, M));
+        const float step = static_cast<float>(blockStep(m_rate, scl1, M) / (M * (sum_sq + ADAPT_EPSILON)));
+        for (int j = 0; j < L; j++)
+            w[L - 1 - j] = w[L - 1 - j] * leak + step * m_tmp[j].real();
+
+        std::memmove(h, h + M, sizeof(float) * m_hist_len);
+    }
+}
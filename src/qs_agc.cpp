@@ -207,50 +207,63 @@
 // }
 
 #include "../include/qs_agc.hpp"
+#include "../include/qs_arena.hpp"
 #include "../include/qs_globals.hpp"
 #include "../include/qs_signalops.hpp"
-#include <iterator>
+#include <algorithm>
 #include <stdexcept>
 
 using namespace std;
 
+#define AGC_LOG10_2 0.30102999566f  // log10(x) = log2(x) * log10(2)
+#define AGC_LOG2_10 3.32192809489f  // 10^x = 2^(x * log2(10))
+
 QsAgc::QsAgc()
-    : m_post_processing_rate(0), m_agc_use_hang(false), m_agc_threshold(-90), m_agc_manual_gain(0), m_agc_slope(0),
+    : m_post_processing_rate(0), m_version(0), m_agc_use_hang(false), m_agc_threshold(-90), m_agc_manual_gain(0), m_agc_slope(0),
       m_agc_hang_time(0), m_agc_hang_time_set(0), m_agc_decay(QS_DEFAULT_AGC_LONG_DECAY), m_agc_decay_set(0),
-      m_agc_sample_rate(0), m_agc_sigdly_ptr(0), m_agc_hang_timer(0), m_agc_peak(0), m_agc_decay_avg(0),
-      m_agc_attack_avg(0), m_agc_magbuffer_pos(0), m_agc_current_gain(0), m_agc_fixed_manual_gain(0), m_agc_knee(0),
-      m_agc_gain_slope(0), m_agc_fixed_gain(0), m_agc_attack_rise_alpha(0), m_agc_attack_fall_alpha(0),
-      m_agc_decay_rise_alpha(0), m_agc_decay_fall_alpha(0), m_agc_delay_samples(0), m_agc_window_samples(0) {}
+      m_agc_sample_rate(0), m_agc_delay_pos(0), m_agc_peak_bits(0), m_agc_hang_timer(0), m_agc_decay_avg(0), m_agc_attack_avg(0), m_agc_current_gain(0),
+      m_agc_fixed_manual_gain(0), m_agc_knee(0), m_agc_gain_slope(0), m_agc_attack_rise_alpha(0),
+      m_agc_attack_fall_alpha(0), m_agc_decay_rise_alpha(0), m_agc_decay_fall_alpha(0),
+      m_agc_delay_samples(0) {}
 
 void QsAgc::init() {
-    m_agc_decay = QsGlobal::g_memory->getAgcDecaySpeed();
     m_post_processing_rate = QsGlobal::g_memory->getDataPostProcRate();
-    m_agc_use_hang = QsGlobal::g_memory->getAgcHangTimeSwitch();
-    m_agc_threshold = QsGlobal::g_memory->getAgcThreshold();
-    m_agc_manual_gain = QsGlobal::g_memory->getAgcFixedGain();
-    m_agc_slope = QsGlobal::g_memory->getAgcSlope();
-    m_agc_hang_time = QsGlobal::g_memory->getAgcHangTime();
-    m_agc_hang_time_set = m_post_processing_rate * m_agc_hang_time * 0.001; // Convert to ms
-
-    m_agc_decay_set = m_agc_use_hang ? m_agc_decay + m_agc_hang_time : m_agc_decay;
 
     if (m_agc_sample_rate != m_post_processing_rate) {
         m_agc_sample_rate = m_post_processing_rate;
-        m_agc_signalDelayBuffer.resize(AGC_MAX_BUFFER_SZ, cpx_zero);
-        m_agc_magBuffer.resize(AGC_MAX_BUFFER_SZ, 0.0);
-        m_agc_sigdly_ptr = 0;
+        m_agc_delay_samples = min((int)(m_post_processing_rate * AGC_DELAY_TC), AGC_MAX_BUFFER_SZ - 1);
+        m_agc_delay_line.assign(m_agc_delay_samples, cpx_zero);
+        m_agc_delay_pos = 0;
+        m_agc_peak_bits = 0;
         m_agc_hang_timer = 0;
-        m_agc_peak = -16;
         m_agc_decay_avg = -5;
         m_agc_attack_avg = -5;
-        m_agc_magbuffer_pos = 0;
         m_agc_current_gain = 0.0;
     }
 
+    setCoefficients(QsGlobal::g_memory->params());
+}
+
+void QsAgc::update(const QsDspParams &params) {
+    if (params.version[pgAgc] != m_version)
+        setCoefficients(params); // state carries on
+}
+
+void QsAgc::setCoefficients(const QsDspParams &params) {
+    m_version = params.version[pgAgc];
+    m_agc_decay = params.agc_decay;
+    m_agc_use_hang = params.agc_hang_switch;
+    m_agc_threshold = params.agc_threshold;
+    m_agc_manual_gain = params.agc_fixed_gain;
+    m_agc_slope = params.agc_slope;
+    m_agc_hang_time = params.agc_hang_time;
+    m_agc_hang_time_set = m_post_processing_rate * m_agc_hang_time * 0.001; // Convert to ms
+
+    m_agc_decay_set = m_agc_use_hang ? m_agc_decay + m_agc_hang_time : m_agc_decay;
+
     m_agc_fixed_manual_gain = pow(10.0, m_agc_manual_gain / 20.0);
     m_agc_knee = m_agc_threshold / 20.0;
     m_agc_gain_slope = m_agc_slope / 100.0;
-    m_agc_fixed_gain = AGC_OUTPUT_SCALING * pow(10.0, m_agc_knee * (m_agc_gain_slope - 1.0));
 
     m_agc_attack_rise_alpha = 1.0 - exp(-1.0 / (m_post_processing_rate * AGC_ATTACK_RISE_TC));
     m_agc_attack_fall_alpha = 1.0 - exp(-1.0 / (m_post_processing_rate * AGC_ATTACK_FALL_TC));
@@ -259,85 +272,151 @@ void QsAgc::init() {
     m_agc_decay_fall_alpha = m_agc_use_hang
                                  ? 1.0 - exp(-1.0 / (m_post_processing_rate * AGC_RELEASE_TC))
                                  : 1.0 - exp(-1.0 / (m_post_processing_rate * m_agc_decay_set * 0.001)); // No hang
+}
+
+// Attack and decay averages over the block's log envelope; level[k] is
+// replaced by the larger of the two after sample k.
+void QsAgc::processLevels(float *level, int length) {
+    float attack = m_agc_attack_avg;
+    float decay = m_agc_decay_avg;
+    const float attack_rise = m_agc_attack_rise_alpha;
+    const float attack_fall = m_agc_attack_fall_alpha;
+    const float decay_rise = m_agc_decay_rise_alpha;
+    const float decay_fall = m_agc_decay_fall_alpha;
+
+    if (m_agc_use_hang) {
+        int hang_timer = m_agc_hang_timer;
+        const int hang_time_set = m_agc_hang_time_set;
+        for (int k = 0; k < length; k++) {
+            const float mag = level[k];
+            attack += (mag > attack ? attack_rise : attack_fall) * (mag - attack);
+            if (mag > decay) {
+                decay += decay_rise * (mag - decay);
+                hang_timer = 0;
+            } else if (hang_timer < hang_time_set) {
+                hang_timer++;
+            } else {
+                decay += decay_fall * (mag - decay);
+            }
+            level[k] = max(attack, decay);
+        }
+        m_agc_hang_timer = hang_timer;
+    } else {
+        for (int k = 0; k < length; k++) {
+            const float mag = level[k];
+            attack += (mag > attack ? attack_rise : attack_fall) * (mag - attack);
+            decay += (mag > decay ? decay_rise : decay_fall) * (mag - decay);
+            level[k] = max(attack, decay);
+        }
+    }
 
-    m_agc_delay_samples = min((int)(m_post_processing_rate * AGC_DELAY_TC), AGC_MAX_BUFFER_SZ - 1);
-    m_agc_window_samples = m_post_processing_rate * AGC_WINDOW_TC;
+    m_agc_attack_avg = attack;
+    m_agc_decay_avg = decay;
 }
 
-float QsAgc::update_avg(float avg, float value, float rise_alpha, float fall_alpha) {
-    return value > avg ? (1.0 - rise_alpha) * avg + rise_alpha * value : (1.0 - fall_alpha) * avg + fall_alpha * value;
+// |x| as its float bits: non-negative floats order like their bits, so
+// maxima over magnitudes are integer ones
+static inline int32_t absBits(float x) {
+    int32_t bits;
+    memcpy(&bits, &x, sizeof(float));
+    return bits & 0x7fffffff;
 }
 
-void QsAgc::process(qs_vect_cpx &src_dst) {
-    if (m_agc_decay != QsGlobal::g_memory->getAgcDecaySpeed()) {
-        m_agc_decay = QsGlobal::g_memory->getAgcDecaySpeed();
-        m_agc_decay_set = m_agc_use_hang ? m_agc_decay + m_agc_hang_time : m_agc_decay;
-        m_agc_decay_rise_alpha =
-            1.0 - exp(-1.0 / (m_post_processing_rate * m_agc_decay_set * 0.001 * AGC_RISEFALL_RATIO));
-        m_agc_decay_fall_alpha = m_agc_use_hang ? 1.0 - exp(-1.0 / (m_post_processing_rate * AGC_RELEASE_TC))
-                                                : 1.0 - exp(-1.0 / (m_post_processing_rate * m_agc_decay_set * 0.001));
+// Output k is the input m_agc_delay_samples earlier times gain[k]: each ring
+// slot is read and then refilled with the new input, in runs up to the ring
+// end. The peak of the products is kept for limit().
+void QsAgc::applyGain(Cpx *src_dst, const float *gain, int length) {
+    float *y = reinterpret_cast<float *>(src_dst);
+    int32_t peak = m_agc_peak_bits;
+    const int delay = m_agc_delay_samples;
+    int pos = m_agc_delay_pos;
+
+    int k = 0;
+    while (k < length) {
+        const int run = delay > 0 ? min(length - k, delay - pos) : length - k;
+        float *ring = delay > 0 ? reinterpret_cast<float *>(m_agc_delay_line.data() + pos) : y + 2 * k;
+        for (int j = 0; j < run; j++, k++) {
+            const float re = ring[2 * j] * gain[k];
+            const float im = ring[2 * j + 1] * gain[k];
+            ring[2 * j] = y[2 * k];
+            ring[2 * j + 1] = y[2 * k + 1];
+            y[2 * k] = re;
+            y[2 * k + 1] = im;
+            peak = max(peak, max(absBits(re), absBits(im)));
+        }
+        if (delay > 0 && (pos += run) == delay)
+            pos = 0;
     }
 
-    if (m_agc_threshold != QsGlobal::g_memory->getAgcThreshold() ||
-        m_agc_manual_gain != QsGlobal::g_memory->getAgcFixedGain() ||
-        m_agc_slope != QsGlobal::g_memory->getAgcSlope() || m_agc_hang_time != QsGlobal::g_memory->getAgcHangTime()) {
-        init(); // Re-initialize on parameter change
-    }
+    m_agc_delay_pos = pos;
+    m_agc_peak_bits = peak;
+}
 
-    if (m_agc_decay == 0) {
-        for (auto &sample : src_dst) {
-            sample *= m_agc_fixed_manual_gain;
-        }
-    } else {
-        float mag;
-        Cpx delayed_input;
-        for (auto &sample : src_dst) {
-            Cpx in = sample;
-            delayed_input = m_agc_signalDelayBuffer[m_agc_sigdly_ptr];
-            m_agc_signalDelayBuffer[m_agc_sigdly_ptr++] = in;
-
-            if (m_agc_sigdly_ptr >= m_agc_delay_samples)
-                m_agc_sigdly_ptr = 0; // Wrap buffer
-
-            mag = log10(fmax(fabs(in.real()), fabs(in.imag())) + AGC_MIN_CONSTANT);
-
-            float old_mag = m_agc_magBuffer[m_agc_magbuffer_pos];
-            m_agc_magBuffer[m_agc_magbuffer_pos++] = mag;
-            if (m_agc_magbuffer_pos >= m_agc_window_samples)
-                m_agc_magbuffer_pos = 0; // Wrap buffer
-
-            if (mag > m_agc_peak) {
-                m_agc_peak = mag;
-            } else if (old_mag == m_agc_peak) {
-                m_agc_peak = *max_element(m_agc_magBuffer.begin(), m_agc_magBuffer.begin() + m_agc_window_samples);
-            }
+// QsSignalOps::Limit on the peak apply() tracked: a block whose peak passes
+// full scale is brought back to 0.95.
+void QsAgc::limit(Cpx *src_dst, int length) {
+    float peak;
+    memcpy(&peak, &m_agc_peak_bits, sizeof(float));
+    m_agc_peak_bits = 0;
+    if (peak <= 1.0f)
+        return;
+
+    const float scale = 0.95f / peak;
+    float *y = reinterpret_cast<float *>(src_dst);
+    for (int k = 0; k < 2 * length; k++)
+        y[k] *= scale;
+}
 
-            if (m_agc_use_hang) {
-                m_agc_attack_avg = update_avg(m_agc_attack_avg, mag, m_agc_attack_rise_alpha, m_agc_attack_fall_alpha);
-                if (mag > m_agc_decay_avg) {
-                    m_agc_decay_avg = update_avg(m_agc_decay_avg, mag, m_agc_decay_rise_alpha, m_agc_decay_fall_alpha);
-                    m_agc_hang_timer = 0;
-                } else if (m_agc_hang_timer < m_agc_hang_time_set) {
-                    m_agc_hang_timer++;
-                } else {
-                    m_agc_decay_avg = update_avg(m_agc_decay_avg, mag, m_agc_decay_rise_alpha, m_agc_decay_fall_alpha);
-                }
-            } else {
-                m_agc_attack_avg = update_avg(m_agc_attack_avg, mag, m_agc_attack_rise_alpha, m_agc_attack_fall_alpha);
-                m_agc_decay_avg = update_avg(m_agc_decay_avg, mag, m_agc_decay_rise_alpha, m_agc_decay_fall_alpha);
-            }
+void QsAgc::process(qs_vect_cpx &src_dst) { process(src_dst.data(), static_cast<int>(src_dst.size())); }
 
-            mag = max(m_agc_attack_avg, m_agc_decay_avg);
-            m_agc_current_gain =
-                mag <= m_agc_knee ? m_agc_fixed_gain : AGC_OUTPUT_SCALING * pow(10.0, mag * (m_agc_gain_slope - 1.0));
+void QsAgc::process(Cpx *src_dst, int length) {
+    apply(src_dst, length);
+    limit(src_dst, length);
+}
+
+void QsAgc::apply(Cpx *src_dst, int length) {
+    if (length <= 0)
+        return;
+
+    // per sample: log10 envelope, then AGC level, then gain
+    QsArena::Scope scratch;
+    float *level = scratch.alloc<float>(length);
 
-            sample = delayed_input * static_cast<float>(m_agc_current_gain);
+    if (m_agc_decay == 0) {
+        // manual gain, no look-ahead
+        const float gain = static_cast<float>(m_agc_fixed_manual_gain);
+        float *y = reinterpret_cast<float *>(src_dst);
+        int32_t peak = m_agc_peak_bits;
+        for (int k = 0; k < 2 * length; k++) {
+            y[k] *= gain;
+            peak = max(peak, absBits(y[k]));
         }
+        m_agc_peak_bits = peak;
+        return;
+    }
 
-        double gain_db = 20.0 * log10(m_agc_current_gain) + 3.0;
-        QsGlobal::g_memory->setAgcCurrentGain(gain_db);
-        QsGlobal::g_memory->setAgcCurrentGainC(round(gain_db));
+    // log10 of max(|I|, |Q|) of the undelayed input
+    const float *in = reinterpret_cast<const float *>(src_dst);
+    for (int k = 0; k < length; k++) {
+        const int32_t bits = max(absBits(in[2 * k]), absBits(in[2 * k + 1]));
+        float mag;
+        memcpy(&mag, &bits, sizeof(float));
+        level[k] = QsSignalOps::FastLog2(mag + AGC_MIN_CONSTANT) * AGC_LOG10_2;
     }
-}
 
+    processLevels(level, length);
+
+    // Gain below the knee is the gain at the knee, so clamp the level there
+    // rather than select; the curve is then one expression per sample.
+    const float knee = m_agc_knee;
+    const float slope = (m_agc_gain_slope - 1.0f) * AGC_LOG2_10;
+    for (int k = 0; k < length; k++)
+        level[k] = AGC_OUTPUT_SCALING * QsSignalOps::FastExp2(max(level[k], knee) * slope);
 
+    applyGain(src_dst, level, length);
+    m_agc_current_gain = level[length - 1];
+
+    double gain_db = 20.0 * log10(m_agc_current_gain) + 3.0;
+    QsGlobal::g_memory->setAgcCurrentGain(gain_db);
+    QsGlobal::g_memory->setAgcCurrentGainC(round(gain_db));
+}
@@ -0,0 +1,103 @@
+#include "../include/qs_alloc_guard.hpp"
+
+#include <algorithm>
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <new>
+
+// plain thread_local PODs: no TLS constructors, safe to touch from inside
+// operator new at any point in a thread's life
+static thread_local const char *t_name = nullptr;
+static thread_local bool t_armed = false;
+static thread_local bool t_paused = false;
+static thread_local uint64_t t_count = 0;
+
+static std::atomic<uint64_t> s_total(0);
+static std::atomic<bool> s_abort(false);
+
+#ifdef __ALLOC_GUARD__
+
+static inline void onAllocate(std::size_t size) {
+    if (!t_armed || t_paused)
+        return;
+    t_count++;
+    s_total.fetch_add(1, std::memory_order_relaxed);
+    if (s_abort.load(std::memory_order_relaxed)) {
+        std::fprintf(stderr, "QsAllocGuard: %zu byte allocation on armed thread %s\n", size, t_name ? t_name : "?");
+        std::abort();
+    }
+}
+
+static inline void *guardedMalloc(std::size_t size) {
+    onAllocate(size);
+    void *p = std::malloc(size ? size : 1);
+    if (!p)
+        throw std::bad_alloc();
+    return p;
+}
+
+static inline void *guardedAlignedMalloc(std::size_t size, std::align_val_t align) {
+    onAllocate(size);
+    void *p = nullptr;
+    std::size_t a = std::max(static_cast<std::size_t>(align), sizeof(void *));
+    if (posix_memalign(&p, a, size ? size : 1) != 0)
+        throw std::bad_alloc();
+    return p;
+}
+
+void *operator new(std::size_t size) { return guardedMalloc(size); }
+void *operator new[](std::size_t size) { return guardedMalloc(size); }
+void *operator new(std::size_t size, std::align_val_t align) { return guardedAlignedMalloc(size, align); }
+void *operator new[](std::size_t size, std::align_val_t align) { return guardedAlignedMalloc(size, align); }
+
+void *operator new(std::size_t size, const std::nothrow_t &) noexcept {
+    onAllocate(size);
+    return std::malloc(size ? size : 1);
+}
+void *operator new[](std::size_t size, const std::nothrow_t &) noexcept {
+    onAllocate(size);
+    return std::malloc(size ? size : 1);
+}
+
+void operator delete(void *p) noexcept { std::free(p); }
+void operator delete[](void *p) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t) noexcept { std::free(p); }
+void operator delete(void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void *p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete[](void *p, std::size_t, std::align_val_t) noexcept { std::free(p); }
+void operator delete(void *p, const std::nothrow_t &) noexcept { std::free(p); }
+void operator delete[](void *p, const std::nothrow_t &) noexcept { std::free(p); }
+
+bool QsAllocGuard::enabled() { return true; }
+
+#else
+
+bool QsAllocGuard::enabled() { return false; }
+
+#endif
+
+void QsAllocGuard::arm(const char *name) {
+    t_name = name;
+    t_count = 0;
+    t_paused = false;
+    t_armed = true;
+}
+
+void QsAllocGuard::disarm() { t_armed = false; }
+
+bool QsAllocGuard::armed() { return t_armed; }
+
+uint64_t QsAllocGuard::count() { return t_count; }
+
+uint64_t QsAllocGuard::total() { return s_total.load(std::memory_order_relaxed); }
+
+void QsAllocGuard::setAbort(bool value) { s_abort.store(value, std::memory_order_relaxed); }
+
+bool QsAllocGuard::suspend(bool value) {
+    bool prev = t_paused;
+    t_paused = value;
+    return prev;
+}
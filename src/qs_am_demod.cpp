@@ -30,8 +30,12 @@ void QsAMDemodulator::init() {
     m_am_z1 = 0.0;
 }
 
-void QsAMDemodulator::process(qs_vect_cpx &src_dst) {
-    for (auto &sample : src_dst) {
+void QsAMDemodulator::process(qs_vect_cpx &src_dst) { process(src_dst.data(), static_cast<int>(src_dst.size())); }
+
+void QsAMDemodulator::process(Cpx *src_dst, int length) {
+    for (int i = 0; i < length; i++) {
+        Cpx &sample = src_dst[i];
+
         // Compute the magnitude using std::norm() to avoid recalculating real/imaginary parts
         m_am_mag = std::sqrt(std::norm(sample));
         
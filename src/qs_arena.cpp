@@ -0,0 +1,60 @@
+#include "../include/qs_arena.hpp"
+
+#include <algorithm>
+#include <new>
+
+static inline std::size_t roundUp(std::size_t bytes) {
+    return (bytes + QS_ALIGNMENT - 1) & ~std::size_t(QS_ALIGNMENT - 1);
+}
+
+QsArena::QsArena() : m_block(nullptr), m_capacity(0), m_used(0), m_high(0), m_spill_bytes(0) {}
+
+QsArena::~QsArena() {
+    for (void *p : m_spill)
+        ::operator delete(p, std::align_val_t(QS_ALIGNMENT));
+    if (m_block)
+        ::operator delete(m_block, std::align_val_t(QS_ALIGNMENT));
+}
+
+QsArena &QsArena::local() {
+    thread_local QsArena arena;
+    return arena;
+}
+
+void QsArena::reserve(std::size_t bytes) {
+    bytes = roundUp(bytes);
+    if (bytes <= m_capacity || m_used != 0)
+        return;
+    if (m_block)
+        ::operator delete(m_block, std::align_val_t(QS_ALIGNMENT));
+    m_block = static_cast<unsigned char *>(::operator new(bytes, std::align_val_t(QS_ALIGNMENT)));
+    m_capacity = bytes;
+}
+
+void *QsArena::take(std::size_t bytes) {
+    bytes = roundUp(std::max<std::size_t>(bytes, 1));
+    void *p;
+    if (m_used + bytes <= m_capacity) {
+        p = m_block + m_used;
+        m_used += bytes;
+    } else {
+        // does not fit: serve it from the heap and learn the size
+        p = ::operator new(bytes, std::align_val_t(QS_ALIGNMENT));
+        m_spill.push_back(p);
+        m_spill_bytes += bytes;
+    }
+    m_high = std::max(m_high, m_used + m_spill_bytes);
+    return p;
+}
+
+void QsArena::rewind(std::size_t mark) {
+    m_used = mark;
+    if (mark != 0 || m_spill.empty())
+        return;
+
+    for (void *p : m_spill)
+        ::operator delete(p, std::align_val_t(QS_ALIGNMENT));
+    m_spill.clear();
+    m_spill_bytes = 0;
+    reserve(m_high);
+}
@@ -0,0 +1,80 @@
+#include "../include/qs_audio_decim.hpp"
+#include "../include/qs_decim_planner.hpp"
+#include "../include/qs_resampler.hpp"
+#include "../include/qs_signalops.hpp"
+
+#include <algorithm>
+#include <cstring>
+
+#define AUDIO_DECIM_MAX 8
+// widest audio bandwidth for a factor K is AUDIO_DECIM_PASSBAND * rate / K:
+// 0.7 of the decimated Nyquist, inside the output resampler's passband at
+// every quality tier
+#define AUDIO_DECIM_PASSBAND 0.35
+
+QsAudioDecimator::QsAudioDecimator() : m_factor(1), m_taps(0), m_delay(0.0) {}
+
+int QsAudioDecimator::chooseFactor(double rate, double bandwidth, int block, double out_rate) {
+    for (int k = AUDIO_DECIM_MAX; k > 1; k--) {
+        if (block % k != 0 || bandwidth > AUDIO_DECIM_PASSBAND * rate / k)
+            continue;
+        if (Resampler::ratioSupported(rate / k, out_rate))
+            return k;
+    }
+    return 1;
+}
+
+void QsAudioDecimator::configure(int factor) {
+    m_factor = std::max(factor, 1);
+    m_taps = 0;
+    m_delay = 0.0;
+    m_coef.clear();
+
+    if (m_factor > 1) {
+        int length = QsDecimationPlanner::kaiserLength(m_factor, AUDIO_DECIM_PASSBAND / m_factor);
+        std::vector<float> taps = QsDecimationPlanner::kaiserLowpass(length, m_factor);
+        m_taps = (length + 7) & ~7;
+        m_delay = (length - 1) / 2.0;
+        m_coef.assign(m_taps, 0.0f);
+        // symmetric, so reversed is the same order; zeros at the oldest end
+        std::copy(taps.begin(), taps.end(), m_coef.begin() + (m_taps - length));
+    }
+    reset();
+}
+
+void QsAudioDecimator::reset() { m_hist.assign(std::max(m_taps - 1, 0), 0.0f); }
+
+void QsAudioDecimator::reserve(int length) { m_hist.reserve(std::max(m_taps - 1, 0) + length); }
+
+int QsAudioDecimator::process(const float *input, int length, float *output) {
+    if (m_factor == 1) {
+        memcpy(output, input, length * sizeof(float));
+        return length;
+    }
+
+    size_t past = m_taps - 1;
+    if (m_hist.size() < past + length)
+        m_hist.resize(past + length);
+    memcpy(&m_hist[past], input, length * sizeof(float));
+
+    // output j ends at input j * K + K - 1, the newest sample of its window
+    const float *coef = &m_coef[0];
+    const float *hist = &m_hist[m_factor - 1];
+    int produced = length / m_factor;
+    for (int j = 0; j < produced; j++)
+        output[j] = QsSignalOps::DotProduct8(coef, hist + j * m_factor, m_taps);
+
+    memmove(&m_hist[0], &m_hist[length], past * sizeof(float));
+    return produced;
+}
+
+int QsAudioDecimator::skip(int length) {
+    if (m_factor > 1) {
+        int past = m_taps - 1;
+        int keep = std::max(past - length, 0);
+        if (keep > 0)
+            memmove(&m_hist[0], &m_hist[past - keep], keep * sizeof(float));
+        std::fill(m_hist.begin() + keep, m_hist.begin() + past, 0.0f);
+    }
+    return length / m_factor;
+}
@@ -82,98 +82,59 @@
 
 #include "../include/qs_auto_notch_filter.hpp"
 
-QsAutoNotchFilter::QsAutoNotchFilter()
-    : m_anf_lms_sz(0), m_anf_mask(0), m_anf_switch(false), m_anf_adapt_rate(0), m_anf_leakage(0), m_anf_adapt_size(0),
-      m_anf_delay(0), m_anf_dl_indx(0) {}
+QsAutoNotchFilter::QsAutoNotchFilter() : m_anf_switch(false), m_version(0), m_anf_adapt_rate(0), m_anf_leakage(0) {}
 
 void QsAutoNotchFilter::init(unsigned int size) {
-    m_anf_lms_sz = size;
-    m_anf_mask = m_anf_lms_sz - 1;
+    // Scratch for the real parts and the prediction error
+    m_anf_in.resize(size);
+    m_anf_out.resize(size);
 
     // Initialize auto-notch filter parameters from global memory
-    m_anf_switch = QsGlobal::g_memory->getAutoNotchOn();
-    m_anf_adapt_rate = QsGlobal::g_memory->getAutoNotchRate();
-    m_anf_leakage = QsGlobal::g_memory->getAutoNotchLeak();
-    m_anf_adapt_size = QsGlobal::g_memory->getAutoNotchTaps();
-    m_anf_delay = QsGlobal::g_memory->getAutoNotchDelay();
-    m_anf_dl_indx = 0;
-
-    // Resize and initialize the delay line and coefficient vectors
-    m_anf_delay_line.resize(size);
-    QsSignalOps::Zero(m_anf_delay_line);
-    m_anf_coeff.resize(size * 2); // Preallocate larger size for flexibility
-    QsSignalOps::Zero(m_anf_coeff);
+    m_version = 0;
+    update(QsGlobal::g_memory->params());
+    m_anf_engine.reset();
+}
+
+void QsAutoNotchFilter::update(const QsDspParams &params) {
+    if (params.version[pgAutoNotch] == m_version)
+        return;
+    m_version = params.version[pgAutoNotch];
+
+    m_anf_switch = params.anf_on;
+    m_anf_adapt_rate = params.anf_rate;
+    m_anf_leakage = params.anf_leak;
+    m_anf_engine.setRate(m_anf_adapt_rate, m_anf_leakage);
+
+    // The engine restarts itself when taps or delay change
+    m_anf_engine.configure(static_cast<QSADAPTALG>(params.anf_alg), params.anf_taps, params.anf_delay);
 }
 
 void QsAutoNotchFilter::process(qs_vect_cpx &src_dst) {
-    // Check if auto-notch filtering is enabled
-    m_anf_switch = QsGlobal::g_memory->getAutoNotchOn();
+    int length = static_cast<int>(src_dst.size());
+    if (static_cast<int>(m_anf_in.size()) < length)
+        m_anf_in.resize(length);
+
+    for (int i = 0; i < length; i++)
+        m_anf_in[i] = src_dst[i].real();
 
+    if (process(m_anf_in.data(), length)) {
+        for (int i = 0; i < length; i++)
+            src_dst[i] = Cpx(m_anf_in[i], m_anf_in[i]);
+    }
+}
+
+bool QsAutoNotchFilter::process(float *src_dst, int length) {
+    // Check if auto-notch filtering is enabled
     if (m_anf_switch) {
-        // Fetch updated parameters from global memory
-        m_anf_adapt_rate = QsGlobal::g_memory->getAutoNotchRate();
-        m_anf_leakage = QsGlobal::g_memory->getAutoNotchLeak();
-
-        // Adjust the filter size if the input size has changed
-        if (m_anf_lms_sz != src_dst.size()) {
-            m_anf_lms_sz = src_dst.size();
-            m_anf_mask = m_anf_lms_sz - 1;
-            m_anf_delay_line.resize(m_anf_lms_sz);
-            QsSignalOps::Zero(m_anf_delay_line);
-            m_anf_coeff.resize(m_anf_lms_sz * 2);
-            QsSignalOps::Zero(m_anf_coeff);
-        }
-
-        // Update number of taps if it has changed
-        unsigned int new_adapt_size = QsGlobal::g_memory->getAutoNotchTaps();
-        if (m_anf_adapt_size != new_adapt_size) {
-            m_anf_adapt_size = new_adapt_size;
-            m_anf_dl_indx = 0;
-            QsSignalOps::Zero(m_anf_delay_line);
-            QsSignalOps::Zero(m_anf_coeff);
-        }
-
-        // Update the delay if it has changed
-        unsigned int new_delay = QsGlobal::g_memory->getAutoNotchDelay();
-        if (m_anf_delay != new_delay) {
-            m_anf_delay = new_delay;
-            m_anf_dl_indx = 0;
-            QsSignalOps::Zero(m_anf_delay_line);
-            QsSignalOps::Zero(m_anf_coeff);
-        }
-
-        // Precompute scaling factor for leakage
-        double scl1 = 1.0 - m_anf_adapt_rate * m_anf_leakage;
-
-        // Process each sample in the source/destination vector
-        for (auto &sample : src_dst) {
-            // Update the delay line with the current sample's real part
-            m_anf_delay_line[m_anf_dl_indx] = sample.real();
-            double accum = 0.0;
-            double sum_sq = 0.0;
-
-            // Compute the adaptive filter output
-            for (unsigned int j = 0; j < m_anf_adapt_size; j++) {
-                unsigned int k = (j + m_anf_delay + m_anf_dl_indx) & m_anf_mask;
-                sum_sq += m_anf_delay_line[k] * m_anf_delay_line[k];
-                accum += m_anf_coeff[j] * m_anf_delay_line[k];
-            }
-
-            // Calculate error and apply it to the output
-            double error = sample.real() - accum;
-            sample = Cpx(error, error); // Set real and imaginary parts to the error
-
-            // Update the adaptive coefficients based on the error
-            double scl2 = m_anf_adapt_rate / (sum_sq + 1e-10); // Prevent division by zero
-            error *= scl2;
-
-            for (unsigned int j = 0; j < m_anf_adapt_size; j++) {
-                unsigned int k = (j + m_anf_delay + m_anf_dl_indx) & m_anf_mask;
-                m_anf_coeff[j] = m_anf_coeff[j] * scl1 + error * m_anf_delay_line[k];
-            }
-
-            // Update the delay line index
-            m_anf_dl_indx = (m_anf_dl_indx + 1) & m_anf_mask;
-        }
+        if (static_cast<int>(m_anf_out.size()) < length)
+            m_anf_out.resize(length);
+
+        m_anf_engine.process(src_dst, nullptr, m_anf_out.data(), length);
+
+        // Keep the prediction error: the signal with its tones removed
+        memcpy(src_dst, m_anf_out.data(), length * sizeof(float));
     }
+    return m_anf_switch;
 }
+
+void QsAutoNotchFilter::hold() { m_anf_engine.clearHistory(); }
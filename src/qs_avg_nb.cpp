@@ -1,27 +1,74 @@
 #include "../include/qs_avg_nb.hpp"
 
+#define ANB_SIG_KEEP 0.75f  // short-term average that replaces a blanked sample
+#define ANB_MAGN_KEEP 0.999f // long-term average magnitude
+
 QsAveragingNoiseBlanker ::QsAveragingNoiseBlanker()
-    : m_anb_avg_sig(0), m_anb_magnitude(0), m_anb_avg_magn(0), m_anb_switch(false), m_anb_thres(0) {}
+    : m_anb_avg_sig(0), m_anb_avg_magn(0), m_anb_switch(false), m_anb_thres(0) {}
 
 void QsAveragingNoiseBlanker ::init() {
     m_anb_avg_sig = cpx_zero;
-    m_anb_magnitude = 0.0;
     m_anb_avg_magn = 0.0;
+    update(QsGlobal::g_memory->params());
+}
+
+void QsAveragingNoiseBlanker::update(const QsDspParams &params) {
+    m_anb_switch = params.anb_on;
+    m_anb_thres = params.anb_threshold;
 }
 
 void QsAveragingNoiseBlanker::process(qs_vect_cpx &src_dst) {
-    m_anb_switch = QsGlobal::g_memory->getAvgNoiseBlankerOn();
-    m_anb_thres = QsGlobal::g_memory->getAvgNoiseBlankerThreshold();
-    if (m_anb_switch) {
-        for (m_cpx_iterator = src_dst.begin(); m_cpx_iterator != src_dst.end(); m_cpx_iterator++) {
-            m_anb_magnitude = sqrt((*m_cpx_iterator).real() * (*m_cpx_iterator).real() +
-                                   (*m_cpx_iterator).imag() * (*m_cpx_iterator).imag());
-            m_anb_avg_sig = Cpx((m_anb_avg_sig.real() * 0.75) + ((*m_cpx_iterator).real() * 0.25),
-                                (m_anb_avg_sig.imag() * 0.75) + ((*m_cpx_iterator).imag() * 0.25));
-            m_anb_avg_magn = (0.999 * m_anb_avg_magn) + (0.001 * m_anb_magnitude);
-            if (m_anb_magnitude > (m_anb_thres * m_anb_avg_magn)) {
-                *m_cpx_iterator = m_anb_avg_sig;
-            }
+    if (!m_anb_switch)
+        return;
+
+    const uint32_t length = src_dst.size();
+    float *io = reinterpret_cast<float *>(src_dst.data());
+    const float thres = m_anb_thres;
+    const float sk = ANB_SIG_KEEP, mk = ANB_MAGN_KEEP;
+    const qs_v4f sig_kp = {sk, sk * sk, sk * sk * sk, sk * sk * sk * sk};
+    const qs_v4f magn_kp = {mk, mk * mk, mk * mk * mk, mk * mk * mk * mk};
+    float sig_re = m_anb_avg_sig.real();
+    float sig_im = m_anb_avg_sig.imag();
+    float avg_magn = m_anb_avg_magn;
+
+    // Four samples at a time: both averages as scans, then blank where
+    // |x|^2 > (thres * avg)^2 with a lane select.
+    uint32_t i = 0;
+    for (; i + 4 <= length; i += 4) {
+        float *x = io + 2 * i;
+        qs_v4f lo, hi;
+        memcpy(&lo, x, sizeof(qs_v4f));
+        memcpy(&hi, x + 4, sizeof(qs_v4f));
+        const qs_v4f re = QS_V4F_SHUFFLE(lo, hi, 0, 2, 4, 6);
+        const qs_v4f im = QS_V4F_SHUFFLE(lo, hi, 1, 3, 5, 7);
+        const qs_v4f pwr = re * re + im * im;
+        qs_v4f avg = QsSignalOps::FastSqrt(pwr);
+        qs_v4f avg_re = re, avg_im = im;
+        QsSignalOps::ExpAverage4(avg_re, sig_kp, sig_re);
+        QsSignalOps::ExpAverage4(avg_im, sig_kp, sig_im);
+        QsSignalOps::ExpAverage4(avg, magn_kp, avg_magn);
+        const qs_v4f limit = thres * avg;
+        const qs_v4i blank = pwr > limit * limit;
+        const qs_v4f out_re = (qs_v4f)(((qs_v4i)avg_re & blank) | ((qs_v4i)re & ~blank));
+        const qs_v4f out_im = (qs_v4f)(((qs_v4i)avg_im & blank) | ((qs_v4i)im & ~blank));
+        lo = QS_V4F_SHUFFLE(out_re, out_im, 0, 4, 1, 5);
+        hi = QS_V4F_SHUFFLE(out_re, out_im, 2, 6, 3, 7);
+        memcpy(x, &lo, sizeof(qs_v4f));
+        memcpy(x + 4, &hi, sizeof(qs_v4f));
+    }
+    for (; i < length; i++) {
+        float *x = io + 2 * i;
+        const float pwr = x[0] * x[0] + x[1] * x[1];
+        sig_re = ANB_SIG_KEEP * sig_re + (1.0f - ANB_SIG_KEEP) * x[0];
+        sig_im = ANB_SIG_KEEP * sig_im + (1.0f - ANB_SIG_KEEP) * x[1];
+        avg_magn = ANB_MAGN_KEEP * avg_magn + (1.0f - ANB_MAGN_KEEP) * QsSignalOps::FastSqrt(pwr);
+        const float limit = thres * avg_magn;
+        if (pwr > limit * limit) {
+            x[0] = sig_re;
+            x[1] = sig_im;
         }
     }
+
+    m_anb_avg_sig = Cpx(sig_re, sig_im);
+    m_anb_avg_magn = avg_magn;
 }
@@ -0,0 +1,208 @@
+#include "../include/qs_biquad_cascade.hpp"
+#include "../include/qs_globals.hpp"
+#include "../include/qs_trace.hpp"
+
+#include <cmath>
+#include <cstring>
+
+QsBiquadCascade::QsBiquadCascade() : m_rate(0.0), m_version(0), m_active(0) {
+    for (int i = 0; i < MAX_MAN_NOTCHES; i++) {
+        m_index[i] = 0;
+        m_f0[i] = 0.0f;
+        m_bw[i] = 0.0f;
+        m_valid[i] = false;
+        m_enabled[i] = false;
+        for (int c = 0; c < 5; c++)
+            m_coef[i][c] = 0.0f;
+        for (int s = 0; s < 2; s++)
+            m_state[i][s][0] = m_state[i][s][1] = 0.0f;
+    }
+}
+
+void QsBiquadCascade::init() {
+    m_rate = QsGlobal::g_memory->getDataPostProcRate();
+    const QsDspParams params = QsGlobal::g_memory->params();
+    for (int i = 0; i < MAX_MAN_NOTCHES; i++)
+        design(i, params.notch_freq[i], params.notch_bw[i]);
+    m_version = 0;
+    update(params);
+}
+
+// RBJ band-reject biquad, the same section QS_IIR::initBandReject builds
+void QsBiquadCascade::design(int notch, float f0, float bw) {
+    QsTrace::Span span("notch design");
+    m_f0[notch] = f0;
+    m_bw[notch] = bw;
+    m_valid[notch] = m_f0[notch] > 0.0f && m_bw[notch] > 0.0f && m_f0[notch] < m_rate / 2.0;
+
+    for (int s = 0; s < 2; s++)
+        m_state[notch][s][0] = m_state[notch][s][1] = 0.0f;
+
+    if (!m_valid[notch])
+        return;
+
+    double w0 = TWO_PI * m_f0[notch] / m_rate;
+    double alpha = sin(w0) / (2.0 * (m_f0[notch] / m_bw[notch]));
+    double A = 1.0 / (1.0 + alpha);
+
+    m_coef[notch][0] = static_cast<float>(A);
+    m_coef[notch][1] = static_cast<float>(A * -2.0 * cos(w0));
+    m_coef[notch][2] = static_cast<float>(A);
+    m_coef[notch][3] = static_cast<float>(A * -2.0 * cos(w0));
+    m_coef[notch][4] = static_cast<float>(A * (1.0 - alpha));
+}
+
+void QsBiquadCascade::update(const QsDspParams &params) {
+    if (params.version[pgNotch] == m_version)
+        return;
+    m_version = params.version[pgNotch];
+
+    m_active = 0;
+    for (int i = 0; i < MAX_MAN_NOTCHES; i++) {
+        if (m_f0[i] != params.notch_freq[i] || m_bw[i] != params.notch_bw[i])
+            design(i, params.notch_freq[i], params.notch_bw[i]);
+        bool enabled = params.notch_on[i];
+        if (enabled && !m_enabled[i])
+            for (int s = 0; s < 2; s++)
+                m_state[i][s][0] = m_state[i][s][1] = 0.0f;
+        m_enabled[i] = enabled;
+        if (m_valid[i] && enabled)
+            m_index[m_active++] = i;
+    }
+}
+
+void QsBiquadCascade::process(qs_vect_cpx &src_dst) { process(src_dst.data(), static_cast<int>(src_dst.size())); }
+
+void QsBiquadCascade::process(Cpx *data, int length) {
+    // two sections per vector
+    switch ((m_active + 1) / 2) {
+    case 0:
+        break;
+    case 1:
+        run<1>(data, length);
+        break;
+    case 2:
+        run<2>(data, length);
+        break;
+    case 3:
+        run<3>(data, length);
+        break;
+    default:
+        run<MAX_MAN_NOTCHES / 2>(data, length);
+        break;
+    }
+}
+
+
+// Sections are the SIMD lanes: each four-float vector holds I and Q of
+// two sections. The cascade is skewed so that at step t section k works on
+// sample t - k; every section then takes what the section before it
+// produced on the previous step, and all of them update at once. The first
+// and last steps of a block run only the sections that have a sample, so
+// nothing but the section states is carried across blocks.
+template <int V> void QsBiquadCascade::run(Cpx *data, int length) {
+    constexpr int S = 2 * V; // sections, the last one a pass-through when m_active is odd
+    constexpr int L = 4 * V; // lane 2k + c is section k, channel c (0 = I, 1 = Q)
+
+    alignas(16) float b0[L], b1[L], b2[L], a1[L], a2[L];
+    alignas(16) float s1[L], s2[L], x[L], y[L];
+
+    // gather the enabled sections into locals for the pass
+    for (int k = 0; k < S; k++) {
+        const int n = (k < m_active) ? m_index[k] : -1;
+        for (int c = 0; c < 2; c++) {
+            const int l = 2 * k + c;
+            b0[l] = (n < 0) ? 1.0f : m_coef[n][0];
+            b1[l] = (n < 0) ? 0.0f : m_coef[n][1];
+            b2[l] = (n < 0) ? 0.0f : m_coef[n][2];
+            a1[l] = (n < 0) ? 0.0f : m_coef[n][3];
+            a2[l] = (n < 0) ? 0.0f : m_coef[n][4];
+            s1[l] = (n < 0) ? 0.0f : m_state[n][0][c];
+            s2[l] = (n < 0) ? 0.0f : m_state[n][1][c];
+            y[l] = 0.0f;
+        }
+    }
+
+    // std::complex<float> is two contiguous floats: I then Q
+    float *io = reinterpret_cast<float *>(data);
+    const int steps = length + S - 1;
+
+    // ramp up / down: only sections lo .. hi have a sample on step t
+    auto partial = [&](int t) {
+        const int lo = (t >= length) ? t - length + 1 : 0;
+        const int hi = (t < S - 1) ? t : S - 1;
+        for (int l = L - 1; l >= 2; l--)
+            x[l] = y[l - 2];
+        if (t < length) {
+            x[0] = io[2 * t];
+            x[1] = io[2 * t + 1];
+        }
+        for (int l = 2 * lo; l < 2 * hi + 2; l++) {
+            float p1 = b1[l] * x[l] + s2[l];
+            float p2 = b2[l] * x[l];
+            y[l] = b0[l] * x[l] + s1[l];
+            s1[l] = p1 - a1[l] * y[l];
+            s2[l] = p2 - a2[l] * y[l];
+        }
+        if (hi == S - 1) {
+            io[2 * (t - S + 1)] = y[L - 2];
+            io[2 * (t - S + 1) + 1] = y[L - 1];
+        }
+    };
+
+    int t = 0;
+    for (; t < steps && t < S - 1; t++)
+        partial(t);
+
+    if (t < length) {
+        // steady state: every section busy, whole vectors
+        qs_v4f B0[V], B1[V], B2[V], A1[V], A2[V], S1[V], S2[V], X[V], Y[V];
+        for (int v = 0; v < V; v++) {
+            std::memcpy(&B0[v], b0 + 4 * v, sizeof(qs_v4f));
+            std::memcpy(&B1[v], b1 + 4 * v, sizeof(qs_v4f));
+            std::memcpy(&B2[v], b2 + 4 * v, sizeof(qs_v4f));
+            std::memcpy(&A1[v], a1 + 4 * v, sizeof(qs_v4f));
+            std::memcpy(&A2[v], a2 + 4 * v, sizeof(qs_v4f));
+            std::memcpy(&S1[v], s1 + 4 * v, sizeof(qs_v4f));
+            std::memcpy(&S2[v], s2 + 4 * v, sizeof(qs_v4f));
+            std::memcpy(&Y[v], y + 4 * v, sizeof(qs_v4f));
+        }
+
+        for (; t < length; t++) {
+            qs_v4f in = {io[2 * t], io[2 * t + 1], 0.0f, 0.0f};
+            X[0] = QS_V4F_SHUFFLE(in, Y[0], 0, 1, 4, 5);
+#pragma GCC unroll 4
+            for (int v = 1; v < V; v++)
+                X[v] = QS_V4F_SHUFFLE(Y[v - 1], Y[v], 2, 3, 4, 5);
+            // the input terms first, so only one multiply-add per state
+            // waits on Y
+#pragma GCC unroll 4
+            for (int v = 0; v < V; v++) {
+                qs_v4f p1 = B1[v] * X[v] + S2[v];
+                qs_v4f p2 = B2[v] * X[v];
+                Y[v] = B0[v] * X[v] + S1[v];
+                S1[v] = p1 - A1[v] * Y[v];
+                S2[v] = p2 - A2[v] * Y[v];
+            }
+            io[2 * (t - S + 1)] = Y[V - 1][2];
+            io[2 * (t - S + 1) + 1] = Y[V - 1][3];
+        }
+
+        for (int v = 0; v < V; v++) {
+            std::memcpy(s1 + 4 * v, &S1[v], sizeof(qs_v4f));
+            std::memcpy(s2 + 4 * v, &S2[v], sizeof(qs_v4f));
+            std::memcpy(y + 4 * v, &Y[v], sizeof(qs_v4f));
+        }
+    }
+
+    for (; t < steps; t++)
+        partial(t);
+
+    for (int k = 0; k < m_active && k < S; k++) {
+        const int n = m_index[k];
+        for (int c = 0; c < 2; c++) {
+            m_state[n][0][c] = s1[2 * k + c];
+            m_state[n][1][c] = s2[2 * k + c];
+        }
+    }
+}
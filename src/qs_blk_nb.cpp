@@ -1,40 +1,76 @@
 #include "../include/qs_blk_nb.hpp"
 
+#define BNB_MAGN_KEEP 0.999f // long-term average magnitude
+#define BNB_HANG_SAMPLES 7   // samples zeroed from a trigger on
+
 QsBlockNoiseBlanker ::QsBlockNoiseBlanker()
-    : m_bnb_magnitude(0), m_bnb_avg_magn(0), m_bnb_switch(false), m_bnb_thres(0), m_bnb_sig_index(0),
-      m_bnb_dly_index(0), m_bnb_hangtime(0), m_bnb_avg_sig(0) {}
+    : m_bnb_avg_magn(0), m_bnb_switch(false), m_bnb_thres(0), m_bnb_hangtime(0) {}
 
 void QsBlockNoiseBlanker ::init() {
-    bnb_delay_line.resize(8, cpx_zero);
-    m_bnb_avg_sig = cpx_zero;
-
-    m_bnb_magnitude = 0.0;
     m_bnb_avg_magn = 0.0;
-    m_bnb_sig_index = 0;
-    m_bnb_dly_index = 0;
     m_bnb_hangtime = 0;
+    update(QsGlobal::g_memory->params());
+}
+
+void QsBlockNoiseBlanker::update(const QsDspParams &params) {
+    m_bnb_switch = params.bnb_on;
+    m_bnb_thres = params.bnb_threshold;
 }
 
 void QsBlockNoiseBlanker ::process(qs_vect_cpx &src_dst) {
-    m_bnb_switch = QsGlobal::g_memory->getBlockNoiseBlankerOn();
-    m_bnb_thres = QsGlobal::g_memory->getBlockNoiseBlankerThreshold();
-    if (m_bnb_switch) {
-        for (m_cpx_iterator = src_dst.begin(); m_cpx_iterator != src_dst.end(); m_cpx_iterator++) {
-            m_bnb_magnitude = sqrt((*m_cpx_iterator).real() * (*m_cpx_iterator).real() +
-                                   (*m_cpx_iterator).imag() * (*m_cpx_iterator).imag());
-            bnb_delay_line[m_bnb_sig_index] = (*m_cpx_iterator);
-            m_bnb_avg_magn = (0.999 * m_bnb_avg_magn) + (0.001 * m_bnb_magnitude);
-            if ((m_bnb_hangtime == 0) && (m_bnb_magnitude > m_bnb_thres * m_bnb_avg_magn)) {
-                m_bnb_hangtime = 7;
-            }
-            if (m_bnb_hangtime > 0) {
-                (*m_cpx_iterator) = cpx_zero;
-                m_bnb_hangtime--;
-            } else {
-                (*m_cpx_iterator) = bnb_delay_line[m_bnb_dly_index];
+    if (!m_bnb_switch)
+        return;
+
+    const uint32_t length = src_dst.size();
+    float *io = reinterpret_cast<float *>(src_dst.data());
+    const float thres = m_bnb_thres;
+    const float mk = BNB_MAGN_KEEP;
+    const qs_v4f magn_kp = {mk, mk * mk, mk * mk * mk, mk * mk * mk * mk};
+    float avg_magn = m_bnb_avg_magn;
+    int hangtime = m_bnb_hangtime;
+
+    // Four samples at a time: the average as a scan and the trigger test
+    // |x|^2 > (thres * avg)^2 on all lanes. The hang is serial, but only
+    // groups with a trigger or a hang running need the per-sample walk.
+    uint32_t i = 0;
+    for (; i + 4 <= length; i += 4) {
+        float *x = io + 2 * i;
+        qs_v4f lo, hi;
+        memcpy(&lo, x, sizeof(qs_v4f));
+        memcpy(&hi, x + 4, sizeof(qs_v4f));
+        const qs_v4f re = QS_V4F_SHUFFLE(lo, hi, 0, 2, 4, 6);
+        const qs_v4f im = QS_V4F_SHUFFLE(lo, hi, 1, 3, 5, 7);
+        const qs_v4f pwr = re * re + im * im;
+        qs_v4f avg = QsSignalOps::FastSqrt(pwr);
+        QsSignalOps::ExpAverage4(avg, magn_kp, avg_magn);
+        const qs_v4f limit = thres * avg;
+        const qs_v4i trigger = pwr > limit * limit;
+        if (hangtime == 0 && (trigger[0] | trigger[1] | trigger[2] | trigger[3]) == 0)
+            continue;
+        for (int j = 0; j < 4; j++) {
+            if (hangtime == 0 && trigger[j])
+                hangtime = BNB_HANG_SAMPLES;
+            if (hangtime > 0) {
+                x[2 * j] = 0.0f;
+                x[2 * j + 1] = 0.0f;
+                hangtime--;
             }
-            m_bnb_sig_index = (m_bnb_sig_index + 7) & 7;
-            m_bnb_dly_index = (m_bnb_dly_index + 7) & 7;
         }
     }
+    for (; i < length; i++) {
+        float *x = io + 2 * i;
+        const float pwr = x[0] * x[0] + x[1] * x[1];
+        avg_magn = BNB_MAGN_KEEP * avg_magn + (1.0f - BNB_MAGN_KEEP) * QsSignalOps::FastSqrt(pwr);
+        const float limit = thres * avg_magn;
+        if (hangtime == 0 && pwr > limit * limit)
+            hangtime = BNB_HANG_SAMPLES;
+        if (hangtime > 0) {
+            x[0] = 0.0f;
+            x[1] = 0.0f;
+            hangtime--;
+        }
+    }
+
+    m_bnb_avg_magn = avg_magn;
+    m_bnb_hangtime = hangtime;
 }
@@ -1,11 +1,15 @@
 #include "../include/qs_dac_writer.hpp"
 #include "../include/qs1r_server.hpp"
+#include "../include/qs_alloc_guard.hpp"
+#include "../include/qs_arena.hpp"
 #include "../include/qs_debugloggerclass.hpp"
 #include "../include/qs_signalops.hpp"
+#include "../include/qs_trace.hpp"
 
 QsDacWriter::QsDacWriter() : m_bsize(0), m_bsizeX2(0), m_thread_go(false), m_is_running(false) {}
 
 void QsDacWriter::init(bool test_mode) {
+    QsTrace::Span span("dac init");
     m_testMode = test_mode;
     m_bsize = QsGlobal::g_memory->getDACBlockSize();
     m_bsizeX2 = m_bsize * 2;
@@ -32,26 +36,55 @@ void QsDacWriter::run() {
     QsSignalOps::Zero(out_f);
     QsSignalOps::Zero(out_s);
 
+    QsArena::local().reserve(QS_DEFAULT_ARENA_BYTES);
+    QsTrace::attach("dacwriter");
+    unsigned int blocks = 0;
+    bool primed = false; // the ring has had a block: running dry now is an underrun
+
     while (m_thread_go) {
+        bool tagged = false;
+        QsBlockTag tag;
+        uint64_t missing = 0;
+
         if (m_testMode) {
             generateTone(m_toneFrequency, m_toneAmplitude, m_sampleRate);
             QsSignalOps::Convert(out_f, out_s, m_bsizeX2);
         } else if (QsGlobal::g_float_dac_ring->readAvail() >= m_bsizeX2) {
             QsGlobal::g_float_dac_ring->read(out_f, m_bsizeX2);
+            tagged = QsGlobal::g_float_dac_ring->popTag(tag, missing);
             QsSignalOps::Convert(out_f, out_s, m_bsizeX2);
+            primed = true;
         } else {
             QsSignalOps::Zero(out_s);
+            if (primed)
+                QsTrace::miss("dac underrun");
         }
 
         // AUDIO DAC takes 16-bit data per channel
         int result = QsGlobal::g_io->writeEP2(reinterpret_cast<unsigned char *>(&out_s[0]), m_bsizeX2 * sizeof(short));
         if (result == -1) {
             // Failure handling
+            QsAllocGuard::Pause pause;
             sleep.msleep(100);
             _debug() << "Failed EP2 write.";
+        } else if (tagged) {
+            // the samples are out: ring wait plus EP2 write, and end to end
+            int64_t now = QsLatency::now();
+            QsGlobal::g_latency->arrive(lhDacRing, tag, missing);
+            QsGlobal::g_latency->record(lhDacRing, tag.hop_ns, now);
+            QsGlobal::g_latency->arrive(lhTotal, tag, missing);
+            QsGlobal::g_latency->record(lhTotal, tag.origin_ns, now);
         }
+
+        // from here on the block path must stay off the heap
+        if (++blocks == QS_DEFAULT_WARMUP_BLOCKS)
+            QsAllocGuard::arm("dacwriter");
     }
 
+    QsAllocGuard::disarm();
+    if (QsAllocGuard::enabled())
+        _debug() << "DAC writer: " << QsAllocGuard::count() << " heap allocations after warm-up";
+
     m_is_running = false;
     _debug() << "DAC writer thread stopped.";
 }
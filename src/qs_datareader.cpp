@@ -1,11 +1,19 @@
 #include "../include/qs_datareader.hpp"
+#include "../include/qs_alloc_guard.hpp"
+#include "../include/qs_arena.hpp"
 #include "../include/qs_debugloggerclass.hpp"
 #include "../include/qs_globals.hpp"
+#include "../include/qs_synth_source.hpp"
+#include "../include/qs_threading.hpp"
+#include "../include/qs_trace.hpp"
 #include "../include/qs_types.hpp"
 
+static const char *const READER_STAGES[] = {"convert"};
+
 QsDataReader::QsDataReader()
-    : m_thread_go(false), m_is_running(false), m_qs1r_fail_emitted(false), m_result(-1), m_channels(1), m_bsize(0),
-      m_bsizeX2(0), m_buffer_min_level(0), m_circbufsize(0), m_rec_center_freq(0), m_samplerate(50000.0) {}
+    : m_thread_go(false), m_is_running(false), m_qs1r_fail_emitted(false), m_blocks(0), m_source(nullptr), m_result(-1), m_channels(1), m_bsize(0),
+      m_bsizeX2(0), m_buffer_min_level(0), m_circbufsize(0), m_rec_center_freq(0), m_samplerate(50000.0),
+      m_perf(READER_STAGES, 1) {}
 
 QsDataReader::~QsDataReader() {
     stop(); // Ensure the thread is stopped before destruction
@@ -17,6 +25,7 @@ QsDataReader::~QsDataReader() {
 void QsDataReader::reinit() { init(); }
 
 void QsDataReader::init() {
+    QsTrace::Span span("reader init");
     m_bsize = QsGlobal::g_memory->getReadBlockSize();
     m_bsizeX2 = m_bsize * 2;
 
@@ -41,6 +50,7 @@ void QsDataReader::start() {
     // Start the thread only if it isn't already running
     if (!m_is_running && !m_thread_go) {
         m_thread_go = true;
+        m_blocks = 0;
         m_thread = std::thread(&QsDataReader::run, this); // Launch the run() method in a new thread
     }
 }
@@ -56,12 +66,34 @@ void QsDataReader::run() {
     QsGlobal::g_cpx_readin_ring->init(m_circbufsize);
     QsGlobal::g_cpx_readin_ring->empty();
 
+    QsArena::local().reserve(QS_DEFAULT_ARENA_BYTES);
+    QsTrace::attach("datareader");
+    unsigned int blocks = 0;
+
     m_is_running = true;
     m_qs1r_fail_emitted = false;
 
     while (m_thread_go) {
-        if (QsGlobal::g_io->readEP6(reinterpret_cast<unsigned char *>(&in_interleaved_i[0]), m_bsizeX2 * sizeof(int)) ==
-            -1) {
+        if (m_source && QsGlobal::g_cpx_readin_ring->writeAvail() < static_cast<uint32_t>(m_bsize)) {
+            // unpaced: hold the block until the DSP has made room for it
+            QsTrace::Span span("readin wait");
+            while (m_thread_go && QsGlobal::g_cpx_readin_ring->writeAvail() < static_cast<uint32_t>(m_bsize))
+                std::this_thread::yield();
+        }
+        if (!m_thread_go)
+            break;
+
+        unsigned char *raw = reinterpret_cast<unsigned char *>(&in_interleaved_i[0]);
+        const unsigned int raw_len = m_bsizeX2 * sizeof(int);
+        int result = m_source ? m_source->read(raw, raw_len) : QsGlobal::g_io->readEP6(raw, raw_len);
+
+        // sequence and read time ride with the block for latency tracing
+        uint64_t seq = m_blocks.load(std::memory_order_relaxed);
+        int64_t now = QsLatency::now();
+        QsBlockTag tag{seq, seq, now, now, 0};
+
+        if (result == -1) {
+            QsAllocGuard::Pause pause;
             if (!m_qs1r_fail_emitted) {
                 _debug() << "QS1R read failed!";
                 m_qs1r_fail_emitted = true;
@@ -72,22 +104,43 @@ void QsDataReader::run() {
             sleep.usleep(1000);
         }
 
-        // Convert interleaved integers into floats
-        QsSignalOps::Convert(&in_interleaved_i[0], &in_interleaved_f[0], m_bsizeX2);
-
-        // Deinterleave into in_re_f and in_im_f
-        if (!QsGlobal::g_swap_iq) {
-            QsSignalOps::DeInterleave(&in_interleaved_f[0], &in_re_f[0], &in_im_f[0], m_bsize);
-        } else {
-            QsSignalOps::DeInterleave(&in_interleaved_f[0], &in_im_f[0], &in_re_f[0], m_bsize);
+        {
+            QsTrace::Span span("convert");
+            if (m_perf.sync())
+                m_perf.mark();
+            if (!QsGlobal::g_swap_iq) {
+                // interleaved I/Q integers already have the Cpx layout: one
+                // conversion straight into the output block
+                QsSignalOps::Convert(&in_interleaved_i[0], reinterpret_cast<float *>(&cpx_out[0]), m_bsizeX2);
+            } else {
+                // Convert interleaved integers into floats
+                QsSignalOps::Convert(&in_interleaved_i[0], &in_interleaved_f[0], m_bsizeX2);
+                // Deinterleave swapped into in_im_f and in_re_f, then rejoin
+                QsSignalOps::DeInterleave(&in_interleaved_f[0], &in_im_f[0], &in_re_f[0], m_bsize);
+                QsSignalOps::RealToComplex(&in_re_f[0], &in_im_f[0], &cpx_out[0], m_bsize);
+            }
+            if (m_perf.active())
+                m_perf.lap(0, m_bsize);
         }
 
-        // Convert in_re_f and in_im_f to Complex
-        QsSignalOps::RealToComplex(&in_re_f[0], &in_im_f[0], &cpx_out[0], m_bsize);
-
+        // a block cut short keeps no tag: a sequence gap downstream
+        if (QsGlobal::g_cpx_readin_ring->writeAvail() >= static_cast<uint32_t>(m_bsize))
+            QsGlobal::g_cpx_readin_ring->pushTag(tag);
+        else
+            QsTrace::miss("readin overflow");
         QsGlobal::g_cpx_readin_ring->write(cpx_out, m_bsize);
+        m_blocks.fetch_add(1, std::memory_order_relaxed);
+
+        // from here on the block path must stay off the heap
+        if (++blocks == QS_DEFAULT_WARMUP_BLOCKS)
+            QsAllocGuard::arm("datareader");
     }
 
+    m_perf.close();
+    QsAllocGuard::disarm();
+    if (QsAllocGuard::enabled())
+        _debug() << "DataReader: " << QsAllocGuard::count() << " heap allocations after warm-up";
+
     m_is_running = false;
     _debug() << "DataReader thread stopped.";
 }
@@ -103,4 +156,10 @@ void QsDataReader::clearBuffers() { QsGlobal::g_cpx_readin_ring->empty(); }
 
 bool QsDataReader::isRunning() {
     return m_thread_go;
-}
\ No newline at end of file
+}
+
+void QsDataReader::setSource(QsSyntheticSource *source) { m_source = source; }
+
+uint64_t QsDataReader::blocksRead() { return m_blocks.load(std::memory_order_relaxed); }
+
+double QsDataReader::cpuSeconds() { return threadCpuSeconds(m_thread); }
\ No newline at end of file
@@ -0,0 +1,269 @@
+#include "../include/qs_decim_planner.hpp"
+#include "../include/qs_downcnv_coeff.hpp"
+#include "../include/qs_globals.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <sstream>
+#include <stdexcept>
+
+namespace {
+
+struct HalfBandSpec {
+    int taps;
+    double max_bw;
+};
+
+// ordered shortest first; fraction of the stage input rate that is protected
+const HalfBandSpec HALFBANDS[] = {
+    {HB11TAP_LENGTH, HB11TAP_MAX}, {HB15TAP_LENGTH, HB15TAP_MAX}, {HB19TAP_LENGTH, HB19TAP_MAX},
+    {HB23TAP_LENGTH, HB23TAP_MAX}, {HB27TAP_LENGTH, HB27TAP_MAX}, {HB31TAP_LENGTH, HB31TAP_MAX},
+    {HB35TAP_LENGTH, HB35TAP_MAX}, {HB39TAP_LENGTH, HB39TAP_MAX}, {HB43TAP_LENGTH, HB43TAP_MAX},
+    {HB47TAP_LENGTH, HB47TAP_MAX}, {HB51TAP_LENGTH, HB51TAP_MAX},
+};
+
+// Kaiser's length estimate runs a few dB short of the target attenuation
+const double KAISER_DESIGN_DB = QS_DECIM_ALIAS_DB + 6.0;
+const int CIC_ALIAS_POINTS = 64;
+const int CIC_COMP_POINTS = 256;
+
+// magnitude of an order-K, ratio-R CIC at f (cycles per input sample), unity DC gain
+double cicMag(int order, int ratio, double f) {
+    double den = ratio * std::sin(ONE_PI * f);
+    if (std::fabs(den) < 1e-300)
+        return 1.0;
+    return std::pow(std::fabs(std::sin(ONE_PI * f * ratio) / den), order);
+}
+
+double besselI0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    for (int k = 1; k < 64; k++) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+        if (term < sum * 1e-16)
+            break;
+    }
+    return sum;
+}
+
+const char *kindName(QsDecimKind kind) {
+    switch (kind) {
+    case QsDecimKind::CIC:
+        return "CIC";
+    case QsDecimKind::HalfBand:
+        return "HB";
+    case QsDecimKind::PolyFir:
+        return "FIR";
+    }
+    return "?";
+}
+
+} // namespace
+
+double QsDecimationPlanner::outputRate(double in_rate, double bandwidth) {
+    double f = in_rate;
+    while ((f > (bandwidth / HB51TAP_MAX)) && (f > QS_DECIM_MIN_OUTPUT_RATE))
+        f /= 2.0;
+    return f;
+}
+
+int QsDecimationPlanner::halfBandTaps(double in_rate, double bandwidth) {
+    for (const HalfBandSpec &hb : HALFBANDS) {
+        if (in_rate >= (bandwidth / hb.max_bw))
+            return hb.taps;
+    }
+    return 0;
+}
+
+double QsDecimationPlanner::cicAliasDb(int order, int ratio, double passband) {
+    // every band k/R +/- passband folds onto the passband at the output
+    double worst = 0.0;
+    for (int k = 1; k < ratio; k++) {
+        double centre = static_cast<double>(k) / ratio;
+        for (int i = 0; i <= CIC_ALIAS_POINTS; i++) {
+            double f = centre - passband + (2.0 * passband * i) / CIC_ALIAS_POINTS;
+            worst = std::max(worst, cicMag(order, ratio, f));
+        }
+    }
+    return -20.0 * std::log10(worst + 1e-300);
+}
+
+double QsDecimationPlanner::cicCompensator(int order, int ratio, double passband) {
+    // least squares fit of [c, 1-2c, c] at the output rate to the inverse droop
+    double num = 0.0;
+    double den = 0.0;
+    for (int i = 0; i <= CIC_COMP_POINTS; i++) {
+        double f = (passband * i) / CIC_COMP_POINTS;
+        double g = cicMag(order, ratio, f);
+        double u = 1.0 - std::cos(TWO_PI * f * ratio);
+        num += (g - 1.0) * g * u;
+        den += (g * u) * (g * u);
+    }
+    if (den <= 0.0)
+        return 0.0;
+    return 0.5 * num / den;
+}
+
+int QsDecimationPlanner::kaiserLength(int ratio, double passband) {
+    double transition = (1.0 / ratio - passband) - passband;
+    if (transition <= 0.0)
+        return 0;
+    int length = static_cast<int>(std::ceil((KAISER_DESIGN_DB - 7.95) / (14.36 * transition))) + 1;
+    return length | 1;
+}
+
+std::vector<float> QsDecimationPlanner::kaiserLowpass(int length, int ratio) {
+    std::vector<float> taps(length);
+    double beta = 0.1102 * (KAISER_DESIGN_DB - 8.7);
+    double fc = 0.5 / ratio;
+    double mid = 0.5 * (length - 1);
+    double norm = besselI0(beta);
+    double sum = 0.0;
+    std::vector<double> h(length);
+    for (int n = 0; n < length; n++) {
+        double t = n - mid;
+        double sinc = (t == 0.0) ? 2.0 * fc : std::sin(TWO_PI * fc * t) / (ONE_PI * t);
+        double r = (mid > 0.0) ? t / mid : 0.0;
+        h[n] = sinc * besselI0(beta * std::sqrt(std::max(0.0, 1.0 - r * r))) / norm;
+        sum += h[n];
+    }
+    for (int n = 0; n < length; n++)
+        taps[n] = static_cast<float>(h[n] / sum);
+    return taps;
+}
+
+bool QsDecimationPlanner::addStage(QsDecimPlan &plan, QsDecimKind kind, int ratio, double &rate,
+                                   double &weight) {
+    QsDecimStage stage{kind, ratio, 0, rate, 0.0, 0.0};
+    double passband = plan.bandwidth / rate;
+
+    switch (kind) {
+    case QsDecimKind::HalfBand:
+        stage.size = halfBandTaps(rate, plan.bandwidth);
+        if (stage.size == 0)
+            return false;
+        // non-zero even taps plus the center tap, once per output
+        stage.macs = weight * (((stage.size + 1) / 2) + 1) / 2.0;
+        break;
+    case QsDecimKind::PolyFir:
+        stage.size = kaiserLength(ratio, passband);
+        if (stage.size == 0)
+            return false;
+        stage.macs = weight * stage.size / ratio;
+        break;
+    case QsDecimKind::CIC:
+        for (int order = QS_DECIM_CIC_MIN_ORDER; order <= QS_DECIM_CIC_MAX_ORDER; order++) {
+            if (cicAliasDb(order, ratio, passband) >= QS_DECIM_ALIAS_DB) {
+                stage.size = order;
+                break;
+            }
+        }
+        if (stage.size == 0)
+            return false;
+        // integrators and float->int per input, combs and int->float per output
+        stage.adds = weight * ((stage.size + 1) + (stage.size + 1) / static_cast<double>(ratio));
+        // 3 tap droop compensator per output
+        stage.macs = weight * 3.0 / ratio;
+        break;
+    }
+
+    plan.stages.push_back(stage);
+    rate /= ratio;
+    weight /= ratio;
+    return true;
+}
+
+void QsDecimationPlanner::finish(QsDecimPlan &plan) {
+    plan.macs = 0.0;
+    plan.adds = 0.0;
+    for (const QsDecimStage &stage : plan.stages) {
+        plan.macs += stage.macs;
+        plan.adds += stage.adds;
+    }
+    plan.cost = plan.macs + QS_DECIM_ADD_COST * plan.adds;
+}
+
+void QsDecimationPlanner::search(const QsDecimPlan &head, int remaining, double rate, double weight,
+                                 QsDecimPlan &best, bool &have_best) {
+    if (remaining == 1) {
+        QsDecimPlan cand = head;
+        finish(cand);
+        // strict compare keeps the first (plain halfband) chain on ties
+        if (!have_best || cand.cost < best.cost) {
+            best = cand;
+            have_best = true;
+        }
+        return;
+    }
+
+    for (int radix : {2, 3, 4, 5}) {
+        if ((remaining % radix) != 0)
+            continue;
+        QsDecimPlan next = head;
+        double r = rate;
+        double w = weight;
+        QsDecimKind kind = (radix == 2) ? QsDecimKind::HalfBand : QsDecimKind::PolyFir;
+        if (addStage(next, kind, radix, r, w))
+            search(next, remaining / radix, r, w, best, have_best);
+    }
+}
+
+QsDecimPlan QsDecimationPlanner::plan(double in_rate, double bandwidth) {
+    QsDecimPlan best;
+    best.in_rate = in_rate;
+    best.bandwidth = bandwidth;
+    best.out_rate = outputRate(in_rate, bandwidth);
+
+    int decimation = static_cast<int>(std::lround(in_rate / best.out_rate));
+    if (decimation <= 1) {
+        finish(best);
+        return best;
+    }
+
+    bool have_best = false;
+
+    // leading CIC ratio, 1 meaning no CIC stage
+    for (int cic_ratio = 1; cic_ratio <= std::min(decimation, QS_DECIM_CIC_MAX_RATIO); cic_ratio++) {
+        if ((decimation % cic_ratio) != 0)
+            continue;
+
+        QsDecimPlan head;
+        head.in_rate = in_rate;
+        head.bandwidth = bandwidth;
+        head.out_rate = best.out_rate;
+        double rate = in_rate;
+        double weight = 1.0;
+
+        if (cic_ratio > 1 && !addStage(head, QsDecimKind::CIC, cic_ratio, rate, weight))
+            continue;
+        search(head, decimation / cic_ratio, rate, weight, best, have_best);
+    }
+
+    if (!have_best)
+        throw std::runtime_error("QsDecimationPlanner: no decimation chain meets the alias spec");
+    return best;
+}
+
+double QsDecimPlan::groupDelay() const {
+    double delay = 0.0;
+    for (const QsDecimStage &stage : stages) {
+        if (stage.kind == QsDecimKind::CIC)
+            // N combs of R samples, then the 3 tap compensator at the output rate
+            delay += (stage.size * (stage.ratio - 1) / 2.0 + stage.ratio) / stage.in_rate;
+        else
+            delay += (stage.size - 1) / 2.0 / stage.in_rate;
+    }
+    return delay;
+}
+
+std::string QsDecimPlan::toString() const {
+    std::ostringstream os;
+    os << in_rate << " -> " << out_rate << " sps:";
+    for (size_t i = 0; i < stages.size(); i++) {
+        const QsDecimStage &stage = stages[i];
+        os << (i ? " ->" : "") << " " << kindName(stage.kind) << stage.size << "/" << stage.ratio;
+    }
+    os << " | " << macs << " MACs + " << adds << " adds per input, cost " << cost;
+    return os.str();
+}
@@ -1,8 +1,12 @@
 #include "../include/qs_downcnv.hpp"
 #include "../include/qs_debugloggerclass.hpp"
 
-#define MIN_OUTPUT_RATE (7900.0 * 2.0)
-#define MAX_HALF_BAND_BUFSIZE 32768
+#include <cmath>
+#include <stdexcept>
+
+// fixed point scale into the CIC integrators (2^28), leaving 35 bits for the
+// K*log2(R) register growth of the largest CIC the planner can pick
+#define CIC_FIXED_SCALE 268435456.0
 
 QsDownConvertor ::QsDownConvertor() {
     m_InRate = 100000.0;
@@ -23,51 +27,98 @@ void QsDownConvertor ::deleteFilters() {
 }
 
 double QsDownConvertor ::setRate(double in_rate, double bandwidth) {
-    int n = 0;
-    double f = in_rate;
-
     if ((m_InRate != in_rate) || (m_MaxBW != bandwidth)) {
         m_InRate = in_rate;
         m_MaxBW = bandwidth;
 
         _debug() << "Inrate=" << m_InRate << " BW=" << m_MaxBW;
 
-        // m_Mutex.lock();
-        deleteFilters();
-
-        while ((f > (m_MaxBW / HB51TAP_MAX)) && (f > MIN_OUTPUT_RATE)) {
-            if (f >= (m_MaxBW / CIC3_MAX)) // See if can use CIC order 3
-                m_pDecimators[n++] = new QsDownConvertor::CIC3DecimateBy2;
-            else if (f >= (m_MaxBW / HB11TAP_MAX)) // See if can use fixed 11 Tap Halfband
-                m_pDecimators[n++] = new QsDownConvertor::HalfBand11TapDecimateBy2();
-            else if (f >= (m_MaxBW / HB15TAP_MAX)) // See if can use Halfband 15 Tap
-                m_pDecimators[n++] = new QsDownConvertor::HalfBandDecimateBy2(HB15TAP_LENGTH, HB15TAP_H);
-            else if (f >= (m_MaxBW / HB19TAP_MAX)) // See if can use Halfband 19 Tap
-                m_pDecimators[n++] = new QsDownConvertor::HalfBandDecimateBy2(HB19TAP_LENGTH, HB19TAP_H);
-            else if (f >= (m_MaxBW / HB23TAP_MAX)) // See if can use Halfband 23 Tap
-                m_pDecimators[n++] = new QsDownConvertor::HalfBandDecimateBy2(HB23TAP_LENGTH, HB23TAP_H);
-            else if (f >= (m_MaxBW / HB27TAP_MAX)) // See if can use Halfband 27 Tap
-                m_pDecimators[n++] = new QsDownConvertor::HalfBandDecimateBy2(HB27TAP_LENGTH, HB27TAP_H);
-            else if (f >= (m_MaxBW / HB31TAP_MAX)) // See if can use Halfband 31 Tap
-                m_pDecimators[n++] = new QsDownConvertor::HalfBandDecimateBy2(HB31TAP_LENGTH, HB31TAP_H);
-            else if (f >= (m_MaxBW / HB35TAP_MAX)) // See if can use Halfband 35 Tap
-                m_pDecimators[n++] = new QsDownConvertor::HalfBandDecimateBy2(HB35TAP_LENGTH, HB35TAP_H);
-            else if (f >= (m_MaxBW / HB39TAP_MAX)) // See if can use Halfband 39 Tap
-                m_pDecimators[n++] = new QsDownConvertor::HalfBandDecimateBy2(HB39TAP_LENGTH, HB39TAP_H);
-            else if (f >= (m_MaxBW / HB43TAP_MAX)) // See if can use Halfband 43 Tap
-                m_pDecimators[n++] = new QsDownConvertor::HalfBandDecimateBy2(HB43TAP_LENGTH, HB43TAP_H);
-            else if (f >= (m_MaxBW / HB47TAP_MAX)) // See if can use Halfband 47 Tap
-                m_pDecimators[n++] = new QsDownConvertor::HalfBandDecimateBy2(HB47TAP_LENGTH, HB47TAP_H);
-            else if (f >= (m_MaxBW / HB51TAP_MAX)) // See if can use Halfband 51 Tap
-                m_pDecimators[n++] = new QsDownConvertor::HalfBandDecimateBy2(HB51TAP_LENGTH, HB51TAP_H);
-            f /= 2.0;
+        QsDecimPlan plan = QsDecimationPlanner::plan(in_rate, bandwidth);
+        _debug() << "Decimation plan: " << plan.toString();
+        setStages(plan, 0, static_cast<int>(plan.stages.size()));
+    }
+    return m_OutputRate;
+}
+
+double QsDownConvertor ::setStages(const QsDecimPlan &plan, int first, int last) {
+    if (first < 0 || last > static_cast<int>(plan.stages.size()) || first > last)
+        throw std::runtime_error("QsDownConvertor: bad decimation plan slice");
+    if ((last - first) >= MAX_STAGES)
+        throw std::runtime_error("QsDownConvertor: decimation plan has too many stages");
+
+    // m_Mutex.lock();
+    deleteFilters();
+
+    int n = 0;
+    double rate = (first < last) ? plan.stages[first].in_rate : plan.out_rate;
+    for (int i = first; i < last; i++) {
+        const QsDecimStage &stage = plan.stages[i];
+        switch (stage.kind) {
+        case QsDecimKind::CIC:
+            m_pDecimators[n++] =
+                new QsDownConvertor::CICDecimateByR(stage.size, stage.ratio, plan.bandwidth / stage.in_rate);
+            break;
+        case QsDecimKind::HalfBand:
+            m_pDecimators[n++] = makeHalfBand(stage.size);
+            break;
+        case QsDecimKind::PolyFir:
+            m_pDecimators[n++] = new QsDownConvertor::FirDecimateByM(
+                stage.ratio, QsDecimationPlanner::kaiserLowpass(stage.size, stage.ratio));
+            break;
         }
-        // m_Mutex.unlock();
-        m_OutputRate = f;
+        rate = stage.in_rate / stage.ratio;
     }
+    // m_Mutex.unlock();
+
+    m_Plan = plan;
+    m_InRate = (first < last) ? plan.stages[first].in_rate : plan.out_rate;
+    m_MaxBW = plan.bandwidth;
+    m_OutputRate = rate;
     return m_OutputRate;
 }
 
+int QsDownConvertor ::historyLength(const QsDecimPlan &plan, int first, int last) {
+    // input samples needed to flush every stage's state in the slice
+    int length = 0;
+    double in_rate = (first < last) ? plan.stages[first].in_rate : plan.out_rate;
+    for (int i = first; i < last; i++) {
+        const QsDecimStage &stage = plan.stages[i];
+        int span = stage.size;
+        if (stage.kind == QsDecimKind::CIC)
+            span = stage.size * stage.ratio + 2 * stage.ratio; // integrator/comb span plus compensator
+        length += static_cast<int>(std::ceil(span * in_rate / stage.in_rate));
+    }
+    return length;
+}
+
+QsDownConvertor::DecimateBy2 *QsDownConvertor ::makeHalfBand(int taps) {
+    switch (taps) {
+    case HB11TAP_LENGTH:
+        return new QsDownConvertor::HalfBandDecimateBy2<HB11TAP_LENGTH, HB11TAP_H>();
+    case HB15TAP_LENGTH:
+        return new QsDownConvertor::HalfBandDecimateBy2<HB15TAP_LENGTH, HB15TAP_H>();
+    case HB19TAP_LENGTH:
+        return new QsDownConvertor::HalfBandDecimateBy2<HB19TAP_LENGTH, HB19TAP_H>();
+    case HB23TAP_LENGTH:
+        return new QsDownConvertor::HalfBandDecimateBy2<HB23TAP_LENGTH, HB23TAP_H>();
+    case HB27TAP_LENGTH:
+        return new QsDownConvertor::HalfBandDecimateBy2<HB27TAP_LENGTH, HB27TAP_H>();
+    case HB31TAP_LENGTH:
+        return new QsDownConvertor::HalfBandDecimateBy2<HB31TAP_LENGTH, HB31TAP_H>();
+    case HB35TAP_LENGTH:
+        return new QsDownConvertor::HalfBandDecimateBy2<HB35TAP_LENGTH, HB35TAP_H>();
+    case HB39TAP_LENGTH:
+        return new QsDownConvertor::HalfBandDecimateBy2<HB39TAP_LENGTH, HB39TAP_H>();
+    case HB43TAP_LENGTH:
+        return new QsDownConvertor::HalfBandDecimateBy2<HB43TAP_LENGTH, HB43TAP_H>();
+    case HB47TAP_LENGTH:
+        return new QsDownConvertor::HalfBandDecimateBy2<HB47TAP_LENGTH, HB47TAP_H>();
+    case HB51TAP_LENGTH:
+        return new QsDownConvertor::HalfBandDecimateBy2<HB51TAP_LENGTH, HB51TAP_H>();
+    }
+    throw std::runtime_error("QsDownConvertor: no halfband with the requested tap count");
+}
+
 int QsDownConvertor ::process(Cpx *in_cpx, Cpx *out_cpx, int length) {
     int j;
 
@@ -79,161 +130,141 @@ int QsDownConvertor ::process(Cpx *in_cpx, Cpx *out_cpx, int length) {
     while (m_pDecimators[j]) {
         n = m_pDecimators[j++]->Decimate(in_cpx, in_cpx, n);
     }
-    memcpy(out_cpx, in_cpx, sizeof(Cpx) * n);
+    if (out_cpx != in_cpx)
+        memcpy(out_cpx, in_cpx, sizeof(Cpx) * n);
     // m_Mutex.unlock();
 
     return n;
 }
 
-QsDownConvertor ::HalfBandDecimateBy2 ::HalfBandDecimateBy2(int len, const double *pCoef)
-    : m_FirLength(len), m_pCoef(pCoef) {
-    // create buffer for FIR implementation
-    m_pHBFirBuf = new Cpx[MAX_HALF_BAND_BUFSIZE];
-    Cpx CPXZERO(0.0, 0.0);
-    for (int i = 0; i < MAX_HALF_BAND_BUFSIZE; i++)
-        m_pHBFirBuf[i] = CPXZERO;
-}
+int QsDownConvertor ::process(Cpx *in_cpx, Cpx *out_cpx, int length, const QsNco &nco, QsNco::Cursor at) {
+    // the first stage applies the LO, the rest of the chain is unchanged
+    if (!m_pDecimators[0]) {
+        nco.mix(in_cpx, out_cpx, length, at);
+        return length;
+    }
 
-int QsDownConvertor ::HalfBandDecimateBy2 ::Decimate(Cpx *in_cpx, Cpx *out_cpx, int length) {
-    int i;
-    int j;
-    int numoutsamples = 0;
-    if (length < m_FirLength) // safety net to make sure InLength is large enough to process
-        return length / 2;
-    // copy input samples into buffer starting at position m_FirLength-1
-    for (i = 0, j = m_FirLength - 1; i < length; i++)
-        m_pHBFirBuf[j++] = in_cpx[i];
-    // perform decimation FIR filter on even samples
-    for (i = 0; i < length; i += 2) {
-        Cpx acc;
-        acc.real(m_pHBFirBuf[i].real() * m_pCoef[0]);
-        acc.imag(m_pHBFirBuf[i].imag() * m_pCoef[0]);
-
-        for (j = 2; j < m_FirLength; j += 2) { // only use even coefficients since odd are zero (except center point)
-            acc.real(acc.real() + (m_pHBFirBuf[i + j].real() * m_pCoef[j]));
-            acc.imag(acc.imag() + (m_pHBFirBuf[i + j].imag() * m_pCoef[j]));
-        }
+    int n = m_pDecimators[0]->MixDecimate(nco, at, in_cpx, in_cpx, length);
+    int j = 1;
+    while (m_pDecimators[j]) {
+        n = m_pDecimators[j++]->Decimate(in_cpx, in_cpx, n);
+    }
+    if (out_cpx != in_cpx)
+        memcpy(out_cpx, in_cpx, sizeof(Cpx) * n);
 
-        // now multiply the center coefficient
-        acc.real(acc.real() + (m_pHBFirBuf[i + (m_FirLength - 1) / 2].real() * m_pCoef[(m_FirLength - 1) / 2]));
-        acc.imag(acc.imag() + (m_pHBFirBuf[i + (m_FirLength - 1) / 2].imag() * m_pCoef[(m_FirLength - 1) / 2]));
+    return n;
+}
 
-        out_cpx[numoutsamples++] = acc; // put output buffer
+QsDownConvertor::CICDecimateByR::CICDecimateByR(int order, int ratio, double passband)
+    : m_order(order), m_ratio(ratio), m_phase(0), m_comp_d1(0.0, 0.0), m_comp_d2(0.0, 0.0) {
+    if (order < 1 || order > MAX_ORDER)
+        throw std::runtime_error("CICDecimateByR: unsupported order");
+    for (int k = 0; k < MAX_ORDER; k++) {
+        m_int_re[k] = m_int_im[k] = 0;
+        m_comb_re[k] = m_comb_im[k] = 0;
     }
-    // need to copy last m_FirLength - 1 input samples in buffer to beginning of buffer
-    //  for FIR wrap around management
-    for (i = 0, j = length - m_FirLength + 1; i < m_FirLength - 1; i++)
-        m_pHBFirBuf[i] = in_cpx[j++];
-    return numoutsamples;
+    m_scale_out = static_cast<float>(1.0 / (std::pow(static_cast<double>(ratio), order) * CIC_FIXED_SCALE));
+    m_comp_c = static_cast<float>(QsDecimationPlanner::cicCompensator(order, ratio, passband));
+    m_comp_m = 1.0f - 2.0f * m_comp_c;
 }
 
-QsDownConvertor ::HalfBand11TapDecimateBy2 ::HalfBand11TapDecimateBy2() {
-    // preload only the taps that are used since evey other one is zero
-    // except center tap 5
-    H0 = HB11TAP_H[0];
-    H2 = HB11TAP_H[2];
-    H4 = HB11TAP_H[4];
-    H5 = HB11TAP_H[5];
-    H6 = HB11TAP_H[6];
-    H8 = HB11TAP_H[8];
-    H10 = HB11TAP_H[10];
-    Cpx CPXZERO(0.0, 0.0);
-    d0 = CPXZERO;
-    d1 = CPXZERO;
-    d2 = CPXZERO;
-    d3 = CPXZERO;
-    d4 = CPXZERO;
-    d5 = CPXZERO;
-    d6 = CPXZERO;
-    d7 = CPXZERO;
-    d8 = CPXZERO;
-    d9 = CPXZERO;
-}
+int QsDownConvertor::CICDecimateByR::Decimate(Cpx *in_cpx, Cpx *out_cpx, int length) {
+    const float *in = reinterpret_cast<const float *>(in_cpx);
+    int j = 0;
+
+    // outputs trail their inputs by at least R-1 samples, and a chunk is
+    // fully read before its outputs are stored, so in_cpx == out_cpx is safe
+    for (int base = 0; base < length; base += CIC_CHUNK) {
+        const int n = std::min(CIC_CHUNK, length - base);
+        const float *src = in + 2 * base;
 
-int QsDownConvertor::HalfBand11TapDecimateBy2::Decimate(Cpx *in_cpx, Cpx *out_cpx, int length) {
-    // StartPerformance();
-    // First calculate the beginning 10 samples using previous samples in the delay buffer
-    Cpx tmpout[9]; // Use temp buffer so outbuf can be the same as inbuf
-
-    tmpout[0] = Cpx(H0 * d0.real() + H2 * d2.real() + H4 * d4.real() + H5 * d5.real() + H6 * d6.real() +
-                        H8 * d8.real() + H10 * in_cpx[0].real(),
-                    H0 * d0.imag() + H2 * d2.imag() + H4 * d4.imag() + H5 * d5.imag() + H6 * d6.imag() +
-                        H8 * d8.imag() + H10 * in_cpx[0].imag());
-
-    tmpout[1] = Cpx(H0 * d2.real() + H2 * d4.real() + H4 * d6.real() + H5 * d7.real() + H6 * d8.real() +
-                        H8 * in_cpx[0].real() + H10 * in_cpx[2].real(),
-                    H0 * d2.imag() + H2 * d4.imag() + H4 * d6.imag() + H5 * d7.imag() + H6 * d8.imag() +
-                        H8 * in_cpx[0].imag() + H10 * in_cpx[2].imag());
-
-    tmpout[2] = Cpx(H0 * d4.real() + H2 * d6.real() + H4 * d8.real() + H5 * d9.real() + H6 * in_cpx[0].real() +
-                        H8 * in_cpx[2].real() + H10 * in_cpx[4].real(),
-                    H0 * d4.imag() + H2 * d6.imag() + H4 * d8.imag() + H5 * d9.imag() + H6 * in_cpx[0].imag() +
-                        H8 * in_cpx[2].imag() + H10 * in_cpx[4].imag());
-
-    tmpout[3] = Cpx(H0 * d6.real() + H2 * d8.real() + H4 * in_cpx[0].real() + H5 * in_cpx[1].real() +
-                        H6 * in_cpx[2].real() + H8 * in_cpx[4].real() + H10 * in_cpx[6].real(),
-                    H0 * d6.imag() + H2 * d8.imag() + H4 * in_cpx[0].imag() + H5 * in_cpx[1].imag() +
-                        H6 * in_cpx[2].imag() + H8 * in_cpx[4].imag() + H10 * in_cpx[6].imag());
-
-    tmpout[4] = Cpx(H0 * d8.real() + H2 * in_cpx[0].real() + H4 * in_cpx[2].real() + H5 * in_cpx[3].real() +
-                        H6 * in_cpx[4].real() + H8 * in_cpx[6].real() + H10 * in_cpx[8].real(),
-                    H0 * d8.imag() + H2 * in_cpx[0].imag() + H4 * in_cpx[2].imag() + H5 * in_cpx[3].imag() +
-                        H6 * in_cpx[4].imag() + H8 * in_cpx[6].imag() + H10 * in_cpx[8].imag());
-
-    tmpout[5] = Cpx(H0 * in_cpx[0].real() + H2 * in_cpx[2].real() + H4 * in_cpx[4].real() + H5 * in_cpx[5].real() +
-                        H6 * in_cpx[6].real() + H8 * in_cpx[8].real() + H10 * in_cpx[10].real(),
-                    H0 * in_cpx[0].imag() + H2 * in_cpx[2].imag() + H4 * in_cpx[4].imag() + H5 * in_cpx[5].imag() +
-                        H6 * in_cpx[6].imag() + H8 * in_cpx[8].imag() + H10 * in_cpx[10].imag());
-
-    tmpout[6] = Cpx(H0 * in_cpx[2].real() + H2 * in_cpx[4].real() + H4 * in_cpx[6].real() + H5 * in_cpx[7].real() +
-                        H6 * in_cpx[8].real() + H8 * in_cpx[10].real() + H10 * in_cpx[12].real(),
-                    H0 * in_cpx[2].imag() + H2 * in_cpx[4].imag() + H4 * in_cpx[6].imag() + H5 * in_cpx[7].imag() +
-                        H6 * in_cpx[8].imag() + H8 * in_cpx[10].imag() + H10 * in_cpx[12].imag());
-
-    tmpout[7] = Cpx(H0 * in_cpx[4].real() + H2 * in_cpx[6].real() + H4 * in_cpx[8].real() + H5 * in_cpx[9].real() +
-                        H6 * in_cpx[10].real() + H8 * in_cpx[12].real() + H10 * in_cpx[14].real(),
-                    H0 * in_cpx[4].imag() + H2 * in_cpx[6].imag() + H4 * in_cpx[8].imag() + H5 * in_cpx[9].imag() +
-                        H6 * in_cpx[10].imag() + H8 * in_cpx[12].imag() + H10 * in_cpx[14].imag());
-
-    tmpout[8] = Cpx(H0 * in_cpx[6].real() + H2 * in_cpx[8].real() + H4 * in_cpx[10].real() + H5 * in_cpx[11].real() +
-                        H6 * in_cpx[12].real() + H8 * in_cpx[14].real() + H10 * in_cpx[16].real(),
-                    H0 * in_cpx[6].imag() + H2 * in_cpx[8].imag() + H4 * in_cpx[10].imag() + H5 * in_cpx[11].imag() +
-                        H6 * in_cpx[12].imag() + H8 * in_cpx[14].imag() + H10 * in_cpx[16].imag());
-
-    // Now loop through remaining input samples
-    Cpx *pIn = &in_cpx[8];
-    Cpx *pOut = &out_cpx[9];
-    for (int i = 0; i < (length - 11 - 6) / 2; i++) {
-        *pOut = Cpx(H0 * pIn[0].real() + H2 * pIn[2].real() + H4 * pIn[4].real() + H5 * pIn[5].real() +
-                        H6 * pIn[6].real() + H8 * pIn[8].real() + H10 * pIn[10].real(),
-                    H0 * pIn[0].imag() + H2 * pIn[2].imag() + H4 * pIn[4].imag() + H5 * pIn[5].imag() +
-                        H6 * pIn[6].imag() + H8 * pIn[8].imag() + H10 * pIn[10].imag());
-        pOut++;
-        pIn += 2; // Skip every second sample for decimation
+        // ======== FIXED POINT ===========
+        for (int i = 0; i < n; i++) {
+            m_buf_re[i] = static_cast<uint64_t>(static_cast<int64_t>(src[2 * i] * CIC_FIXED_SCALE));
+            m_buf_im[i] = static_cast<uint64_t>(static_cast<int64_t>(src[2 * i + 1] * CIC_FIXED_SCALE));
+        }
+
+        // ======== INTEGRATORS ===========
+        // two's complement wrap in the integrators cancels in the combs
+        for (int k = 0; k < m_order; k++) {
+            uint64_t acc_re = m_int_re[k];
+            uint64_t acc_im = m_int_im[k];
+            for (int i = 0; i < n; i++) {
+                acc_re += m_buf_re[i];
+                acc_im += m_buf_im[i];
+                m_buf_re[i] = acc_re;
+                m_buf_im[i] = acc_im;
+            }
+            m_int_re[k] = acc_re;
+            m_int_im[k] = acc_im;
+        }
+
+        // ======== COMBS + COMPENSATOR ===========
+        int i = m_ratio - 1 - m_phase;
+        for (; i < n; i += m_ratio) {
+            uint64_t acc_re = m_buf_re[i];
+            uint64_t acc_im = m_buf_im[i];
+            for (int k = 0; k < m_order; k++) {
+                uint64_t d_re = m_comb_re[k];
+                uint64_t d_im = m_comb_im[k];
+                m_comb_re[k] = acc_re;
+                m_comb_im[k] = acc_im;
+                acc_re -= d_re;
+                acc_im -= d_im;
+            }
+
+            Cpx y(static_cast<int64_t>(acc_re) * m_scale_out, static_cast<int64_t>(acc_im) * m_scale_out);
+            out_cpx[j++] = Cpx(m_comp_c * (y.real() + m_comp_d2.real()) + m_comp_m * m_comp_d1.real(),
+                               m_comp_c * (y.imag() + m_comp_d2.imag()) + m_comp_m * m_comp_d1.imag());
+            m_comp_d2 = m_comp_d1;
+            m_comp_d1 = y;
+        }
+        m_phase = (m_phase + n) % m_ratio;
     }
 
-    // EndPerformance();
-    return length; // Adjust this return based on your needs
+    return j;
 }
 
-QsDownConvertor::CIC3DecimateBy2::CIC3DecimateBy2() {
-    m_Xodd = Cpx(0.0, 0.0);
-    m_Xeven = Cpx(0.0, 0.0);
+QsDownConvertor::FirDecimateByM::FirDecimateByM(int ratio, const std::vector<float> &taps)
+    : m_ratio(ratio), m_length(static_cast<int>(taps.size())), m_padded((static_cast<int>(taps.size()) + 7) & ~7),
+      m_capacity(static_cast<int>(taps.size()) - 1 + FIR_CHUNK), m_fill(static_cast<int>(taps.size()) - 1) {
+    if (ratio < 2 || taps.empty())
+        throw std::runtime_error("FirDecimateByM: bad ratio or empty filter");
+    // time reversed so output n is a forward dot product over the planes;
+    // the zero taps past the end read up to m_padded - m_length samples
+    // beyond the window, which the planes are sized for
+    m_taps.assign(m_padded, 0.0f);
+    std::reverse_copy(taps.begin(), taps.end(), m_taps.begin());
+    m_hist.resize(m_capacity + m_padded - m_length);
+    m_hist.zero();
 }
 
-int QsDownConvertor::CIC3DecimateBy2::Decimate(Cpx *in_cpx, Cpx *out_cpx, int length) {
-    int i, j;
-    Cpx even, odd;
-
-    for (i = 0, j = 0; i < length; i += 2, j++) { // mag gn=8
-        even = in_cpx[i];
-        odd = in_cpx[i + 1];
-
-        out_cpx[j] = Cpx(.125 * (std::real(odd) + std::real(m_Xeven) + 3.0 * (std::real(m_Xodd) + std::real(even))),
-                         .125 * (std::imag(odd) + std::imag(m_Xeven) + 3.0 * (std::imag(m_Xodd) + std::imag(even))));
+int QsDownConvertor::FirDecimateByM::Decimate(Cpx *in_cpx, Cpx *out_cpx, int length) {
+    const float *h = m_taps.data();
+    float *re = m_hist.re();
+    float *im = m_hist.im();
+    int j = 0;
+    int i = 0;
+
+    // inputs are consumed before the outputs that depend on them are
+    // stored, and j < i / M, so in_cpx == out_cpx is safe
+    while (i < length) {
+        int take = std::min(length - i, m_capacity - m_fill);
+        QsSimd::kernels().deInterleave(reinterpret_cast<const float *>(in_cpx + i), re + m_fill, im + m_fill, take);
+        m_fill += take;
+        i += take;
+
+        int pos = 0;
+        for (; pos + m_length <= m_fill; pos += m_ratio) {
+            float acc_re = QsSignalOps::DotProduct8(h, re + pos, m_padded);
+            float acc_im = QsSignalOps::DotProduct8(h, im + pos, m_padded);
+            out_cpx[j++] = Cpx(acc_re, acc_im);
+        }
 
-        m_Xodd = odd;
-        m_Xeven = even;
+        // keep the unconsumed tail as history
+        m_fill -= pos;
+        std::memmove(re, re + pos, sizeof(float) * m_fill);
+        std::memmove(im, im + pos, sizeof(float) * m_fill);
     }
 
     return j;
@@ -1,16 +1,20 @@
 #include "../include/qs_dsp_proc.hpp"
 
 #include "../include/qs_agc.hpp"
+#include "../include/qs_alloc_guard.hpp"
 #include "../include/qs_am_demod.hpp"
+#include "../include/qs_arena.hpp"
+#include "../include/qs_audio_decim.hpp"
 #include "../include/qs_auto_notch_filter.hpp"
 #include "../include/qs_avg_nb.hpp"
+#include "../include/qs_biquad_cascade.hpp"
 #include "../include/qs_blk_nb.hpp"
 #include "../include/qs_debugloggerclass.hpp"
 #include "../include/qs_defines.hpp"
 #include "../include/qs_downcnv.hpp"
 #include "../include/qs_fm_demod.hpp"
+#include "../include/qs_frontend.hpp"
 #include "../include/qs_globals.hpp"
-#include "../include/qs_iir_filter.hpp"
 #include "../include/qs_io_libusb.hpp"
 #include "../include/qs_main_rx_filter.hpp"
 #include "../include/qs_nr_filter.hpp"
@@ -20,16 +24,22 @@
 #include "../include/qs_signalops.hpp"
 #include "../include/qs_sleep.hpp"
 #include "../include/qs_smeter.hpp"
+#include "../include/qs_spectral_notch.hpp"
+#include "../include/qs_spectral_nr.hpp"
 #include "../include/qs_squelch.hpp"
 #include "../include/qs_state.hpp"
 #include "../include/qs_threading.hpp"
 #include "../include/qs_tone_gen.hpp"
+#include "../include/qs_trace.hpp"
 #include "../include/qs_volume.hpp"
+#include <algorithm>
 #include <cmath>
 
+#define DSP_CHUNK 256 // samples per pass of the per-sample stages, 2 KB of Cpx
+
 QsDspProcessor::QsDspProcessor()
     : m_rx_num(0), m_bsize(0), m_bsizeX2(0), m_sd_buffer_size(0), m_ps_size(0), m_req_outframes(0), m_outframesX2(0),
-      m_thread_go(false), m_is_running(false), m_dac_bypass(false), m_rt_audio_bypass(false), m_processing_rate(0),
+      m_thread_go(false), m_is_running(false), m_blocks(0), m_dac_bypass(false), m_rt_audio_bypass(false), m_squelched(false), m_params(), m_params_seq(0), m_processing_rate(0),
       m_post_processing_rate(0), m_rs_rate(0), m_rs_quality(4), resampler(nullptr), m_rs_output_rate(0),
       m_rs_input_rate(0) {
     QsSleep sleep;
@@ -38,10 +48,11 @@ QsDspProcessor::QsDspProcessor()
 QsDspProcessor::~QsDspProcessor() {}
 
 void QsDspProcessor::init(int rx_num) {
+    QsTrace::Span span("dsp init");
     p_tg0 = std::make_unique<QsToneGenerator>();
     p_anb = std::make_unique<QsAveragingNoiseBlanker>();
     p_bnb = std::make_unique<QsBlockNoiseBlanker>();
-    p_downconv = std::make_unique<QsDownConvertor>();
+    p_frontend = std::make_unique<QsFrontEnd>();
     p_tg1 = std::make_unique<QsToneGenerator>();
     p_agc = std::make_unique<QsAgc>();
     p_main_filter = std::make_unique<QsMainRxFilter>();
@@ -50,20 +61,21 @@ void QsDspProcessor::init(int rx_num) {
     p_sam = std::make_unique<QsSAMDemodulator>();    ;
     p_fm = std::make_unique<QsFMCombinedDemodulator>();
     p_nr = std::make_unique<QsNoiseReductionFilter>();
+    p_notches = std::make_unique<QsSpectralNotches>();
+    p_snr = std::make_unique<QsSpectralNoiseReduction>();
     p_anf = std::make_unique<QsAutoNotchFilter>();
     p_sm = std::make_unique<QsSMeter>();
     p_sq = std::make_unique<QsSquelch>();
     p_vol = std::make_unique<QsVolume>();
-    p_iir0 = std::make_unique<QS_IIR>();
-    p_iir1 = std::make_unique<QS_IIR>();
-    p_iir2 = std::make_unique<QS_IIR>();
-    p_iir3 = std::make_unique<QS_IIR>();
-    p_iir4 = std::make_unique<QS_IIR>();
-    p_iir5 = std::make_unique<QS_IIR>();
-    p_iir6 = std::make_unique<QS_IIR>();
-    p_iir7 = std::make_unique<QS_IIR>();
+    p_iir_notches = std::make_unique<QsBiquadCascade>();
+    p_audio_decim = std::make_unique<QsAudioDecimator>();
 
     m_rx_num = rx_num;
+    m_squelched = false;
+    // the stages read the same snapshot in their init(); the first block
+    // syncs again, whatever was published in between
+    m_params = QsGlobal::g_memory->params();
+    m_params_seq = 0;
     m_bsize = QsGlobal::g_memory->getReadBlockSize();
     m_bsizeX2 = m_bsize * 2;
     m_ps_size = m_bsize;
@@ -110,8 +122,11 @@ void QsDspProcessor::init(int rx_num) {
     // TONE GEN
     p_tg0->init(QsToneGenerator::rateDataRate);
 
-    // Downconvertor
-    p_downconv->setRate(m_processing_rate, 20000.00);
+    // Downconvertor, split across cores at the highest rates
+    unsigned int fe_threads =
+        std::min<unsigned int>(QsGlobal::g_memory->getFrontEndThreads(), std::thread::hardware_concurrency());
+    fe_threads = std::max(1u, fe_threads);
+    p_frontend->init(p_tg0.get(), m_processing_rate, 20000.00, m_bsize, fe_threads);
 
     // SM
     p_sm->init();
@@ -119,6 +134,9 @@ void QsDspProcessor::init(int rx_num) {
     // SQUELCH
     p_sq->init();
 
+    // VOLUME
+    p_vol->init();
+
     // AGC
     p_agc->init();
 
@@ -130,7 +148,11 @@ void QsDspProcessor::init(int rx_num) {
     // POST FILTER
     p_post_filter->init(m_bsize);
 
-    // MAIN FIR
+    // MAIN FIR, with the frequency-domain stages on its spectrum
+#ifndef __IIR_NOTCH__
+    p_main_filter->addStage(p_notches.get());
+#endif
+    p_main_filter->addStage(p_snr.get());
     p_main_filter->init(m_bsize);
 
 #ifdef __AUTO_NOTCH__
@@ -141,30 +163,24 @@ void QsDspProcessor::init(int rx_num) {
     // NR
     p_nr->init(m_bsize);
 
-    // RESAMPLER
+    // AUDIO RATE STAGE AND RESAMPLER, decimation chosen per block in run()
+    p_audio_decim->configure(1);
+    au_f.resize(m_bsize);
     initResampler(m_bsize);
 
     // CW TONE GEN
     p_tg1->init(QsToneGenerator::ratePostDataRate);
 
 #ifdef __IIR_NOTCH__
-    // Instantiate 8 manual notch filters
-    p_iir0->init(1, QS_IIR::iirBandReject);
-    p_iir1->init(2, QS_IIR::iirBandReject);
-    p_iir2->init(3, QS_IIR::iirBandReject);
-    p_iir3->init(4, QS_IIR::iirBandReject);
-    p_iir4->init(5, QS_IIR::iirBandReject);
-    p_iir5->init(6, QS_IIR::iirBandReject);
-    p_iir6->init(7, QS_IIR::iirBandReject);
-    p_iir7->init(8, QS_IIR::iirBandReject);
+    // 8 manual notch filters, one biquad cascade
+    p_iir_notches->init();
 #endif
 }
 
 void QsDspProcessor::reinit() { init(m_rx_num); }
 
 void QsDspProcessor::run() {
-    size_t sz = 0;
-    size_t outframes = 0;
+    int outframes = 0;
 
     m_sd_buffer_size = m_bsize * SD_RING_SZ_MULT;
     m_ps_size = m_bsize;
@@ -184,6 +200,12 @@ void QsDspProcessor::run() {
     m_req_outframes = std::ceil((double)m_bsize * m_rs_output_rate / m_rs_input_rate);
     m_outframesX2 = m_req_outframes * 2;
 
+    m_stats.configure(m_rs_input_rate, m_bsize);
+
+    // latency tracing: the decimation chain's delay, fixed until init()
+    const int64_t fe_delay_ns = std::llround(p_frontend->plan().groupDelay() * 1e9);
+    QsBlockTag in_tag, post_tag;
+
     QsSignalOps::Zero(re_f);
     QsSignalOps::Zero(im_f);
     QsSignalOps::Zero(rs_cpx_n);
@@ -191,6 +213,11 @@ void QsDspProcessor::run() {
     QsGlobal::g_float_rt_ring->init(m_outframesX2 * RT_RING_SZ_MULT);
     QsGlobal::g_float_dac_ring->init(m_outframesX2 * DAC_RING_SZ_MULT);
 
+    // stage scratch comes from this thread's arena
+    QsArena::local().reserve(QS_DEFAULT_ARENA_BYTES);
+    QsTrace::attach("dspproc");
+    unsigned int blocks = 0;
+
     m_is_running = true;
     m_thread_go = true;
 
@@ -199,7 +226,10 @@ void QsDspProcessor::run() {
         // read data from reader ring buffer
         while (QsGlobal::g_cpx_readin_ring->readAvail() >= m_bsize & m_thread_go == true) {
 
-            QsGlobal::g_cpx_readin_ring->read(in_cpx);
+            QsGlobal::g_cpx_readin_ring->read(in_cpx, m_bsize);
+            bool tagged = QsGlobal::g_latency->take(lhReadIn, *QsGlobal::g_cpx_readin_ring, in_tag);
+            syncParams();
+            uint64_t t = m_stats.begin();
 
 #ifdef __NOISE_BLANKERS__
             // Do noiseblankers
@@ -210,127 +240,171 @@ void QsDspProcessor::run() {
             // ======== <BLOCK NOISE BLANKER> ===========
             p_bnb->process(in_cpx);
             // ======== </BLOCK NOISE BLANKER> ===========
+            t = m_stats.lap(stNoiseBlanker, t);
 #endif
-            // apply LO
-            // ======== <TONE GENERATOR> ===========
-            p_tg0->process(in_cpx);
-            // ======== </TONE GENERATOR> ===========
-
-            // DOWNSAMPLER
-            dstlen = p_downconv->process(&in_cpx[0], &rs_cpx[0], m_bsize);
+            // apply LO and DOWNSAMPLER
+            // ======== <FRONT END> ===========
+            dstlen = p_frontend->process(&in_cpx[0], &rs_cpx[0], m_bsize);
+            // ======== </FRONT END> ===========
+            if (tagged)
+                QsGlobal::g_latency->pass(lhFrontEnd, *QsGlobal::g_cpx_sd_ring, in_tag, fe_delay_ns, dstlen);
             QsGlobal::g_cpx_sd_ring->write(rs_cpx, dstlen);
+            m_stats.lap(stFrontEnd, t);
         }
 
         while (QsGlobal::g_cpx_sd_ring->readAvail() >= m_bsize & m_thread_go == true) {
             // read data from integer resample buffer
             QsGlobal::g_cpx_sd_ring->read(rs_cpx_n, m_bsize);
+            bool tagged = QsGlobal::g_latency->take(lhSdRing, *QsGlobal::g_cpx_sd_ring, post_tag);
+            syncParams();
+            uint64_t t = m_stats.begin();
 
-            // main filter
+            // main filter, manual notches and spectral NR
             // ======== <MAIN FIR> ========
             p_main_filter->process(rs_cpx_n);
             // ======== </MAIN FIR> ========
+            t = m_stats.lap(stMainFilter, t);
 
-#ifdef __IIR_NOTCH__
-            p_iir0->process(rs_cpx_n);
-            p_iir1->process(rs_cpx_n);
-            p_iir2->process(rs_cpx_n);
-            p_iir3->process(rs_cpx_n);
-            p_iir4->process(rs_cpx_n);
-            p_iir5->process(rs_cpx_n);
-            p_iir6->process(rs_cpx_n);
-            p_iir7->process(rs_cpx_n);
-#endif
+            QSDEMODMODE demod_mode = m_params.demod_mode;
 
-            if (QsGlobal::g_memory->getDemodMode() == dmCW) {
-                // ======== <CW TONE GENERATOR> ===========
-                p_tg1->process(rs_cpx_n);
-                // ======== </CW TONE GENERATOR> ===========
-            }
+            // manual notches, CW tone, S meter, AGC with its limiter and the
+            // demodulator, back to back on L1 sized chunks
+            // ======== <CHUNKED STAGES> ===========
+            processChunks(&rs_cpx_n[0], m_bsize, demod_mode);
+            // ======== </CHUNKED STAGES> ===========
+            t = m_stats.begin();
 
-            // process through s meter
-            // ======== <S METER> ===========
-            p_sm->process(rs_cpx_n);
-            // ======== </S METER> ===========
-
-            // Do AGC
-            p_agc->process(rs_cpx_n);
-
-            QsSignalOps::Limit(rs_cpx_n, m_bsize);
-
-            // ======== <DEMODULATORS> ===========
-
-            switch (QsGlobal::g_memory->getDemodMode()) {
+            // post filter on the whole block for the AM, SAM and FM audio
+            // ======== <POST FILTER> ===========
+            switch (demod_mode) {
             case dmAM:
-                p_am->process(rs_cpx_n);
-                p_post_filter->process(rs_cpx_n);
-                break;
             case dmSAM:
-                p_sam->process(rs_cpx_n);
-                p_post_filter->process(rs_cpx_n);
-                break;
             case dmFMN:
-                p_fm->process(rs_cpx_n, NARROW);
-                p_post_filter->process(rs_cpx_n);
-                break;
             case dmFMW:
-                p_fm->process(rs_cpx_n, WIDE);
                 p_post_filter->process(rs_cpx_n);
+                t = m_stats.lap(stPostFilter, t);
                 break;
             default:
                 break;
             }
+            // ======== </POST FILTER> ===========
 
-            // ======== </DEMODULATORS> ===========
+            // decimate the mono audio when the audio rate stage is on
+            // ======== <AUDIO RATE> ===========
+            updateAudioRate();
+            // ======== </AUDIO RATE> ===========
+            t = m_stats.lap(stAudioRate, t);
 
+            // decided once per block from the S meter, ahead of the audio stages
+            // ======== <SQUELCH> ===========
+            bool squelched = p_sq->closed();
+            // ======== </SQUELCH> ===========
+            t = m_stats.lap(stSquelch, t);
+
+            if (squelched) {
+                // closed: the audio stages hold, the sinks get silence
+                outframes = holdAudio();
+                t = m_stats.lap(stResampler, t);
+            }
 #ifdef __BINAURAL__
             // ======== <BINAURAL> =============
-            if (!QsGlobal::g_memory->getBinauralMode()) {
-                QsSignalOps::CopyRealToImag(rs_cpx_n);
+            else if (m_params.binaural) {
+#ifdef __AUTO_NOTCH__
+                p_anf->process(rs_cpx_n);
+                t = m_stats.lap(stAutoNotch, t);
+#endif
+                p_nr->process(rs_cpx_n);
+                t = m_stats.lap(stNoiseReduction, t);
+
+                // ======== <RESAMPLER> ==========
+                outframes = resampler->process(&rs_cpx_n[0], m_bsize, &rs_out_cpx[0]);
+                QsSignalOps::Interleave(&rs_out_cpx[0], &rs_out_interleaved[0], outframes);
+                m_outframesX2 = outframes * 2;
+                t = m_stats.lap(stResampler, t);
+                p_vol->process(&rs_out_interleaved[0], m_outframesX2);
+                t = m_stats.lap(stVolume, t);
+                // ======== </RESAMPLER> ==========
             }
             // ======== </BINAURAL> =============
 #endif
+            else {
+                // mono audio from the real part, at rate / K after the audio decimator
+                QsSignalOps::RealFromComplex(&rs_cpx_n[0], &re_f[0], m_bsize);
+                float *audio = &re_f[0];
+                int audio_len = m_bsize;
+                if (p_audio_decim->factor() > 1) {
+                    audio_len = p_audio_decim->process(&re_f[0], m_bsize, &au_f[0]);
+                    audio = &au_f[0];
+                }
+                t = m_stats.lap(stAudioRate, t);
 #ifdef __AUTO_NOTCH__
-            // ======== <AUTO NOTCH FILTER> =============
-            p_anf->process(rs_cpx_n);
-            // ======== </AUTO NOTCH FILTER> =============
+                // ======== <AUTO NOTCH FILTER> =============
+                p_anf->process(audio, audio_len);
+                // ======== </AUTO NOTCH FILTER> =============
+                t = m_stats.lap(stAutoNotch, t);
 #endif
-            // ======== <NOISE REDUCTION FILTER> =============
-            p_nr->process(rs_cpx_n);
-            // ======== </NOISE REDUCTION FILTER> =============
-
-            // ======== <SQUELCH> ===========
-            p_sq->process(rs_cpx_n);
-            // ======== </SQUELCH> ===========
-
-            QsSignalOps::Interleave(rs_cpx_n, rs_in_interleaved, m_bsize);
-
-            // do fractional resampler to port audio rate
-            // ======== <RESAMPLER> ==========
-            sz = m_bsize;
-            outframes = m_req_outframes;
-            resampler->process(&rs_in_interleaved[0], sz, &rs_out_interleaved[0], &outframes);
-            m_outframesX2 = outframes * 2;
-
-            // ======== </RESAMPLER> ==========
-
-            // volume
-            // ======== <VOLUME WITH LIMITER> ===========
-            p_vol->process(rs_out_interleaved);
-            // ======== </VOLUME WITH LIMITER> ===========
+                // ======== <NOISE REDUCTION FILTER> =============
+                p_nr->process(audio, audio_len);
+                // ======== </NOISE REDUCTION FILTER> =============
+                t = m_stats.lap(stNoiseReduction, t);
+
+                // rational resampler to the output rate, volume, then duplicate to stereo at the sink
+                // ======== <RESAMPLER> ==========
+                outframes = resampler->process(audio, audio_len, &rs_out_mono[0]);
+                t = m_stats.lap(stResampler, t);
+                p_vol->processToStereo(&rs_out_mono[0], &rs_out_interleaved[0], outframes);
+                t = m_stats.lap(stVolume, t);
+                m_outframesX2 = outframes * 2;
+                // ======== </RESAMPLER> ==========
+            }
+            m_squelched = squelched;
 
 #ifdef __SOUND_OUT__
             if (QsGlobal::g_float_rt_ring->writeAvail() >= m_outframesX2) {
-                QsGlobal::g_float_rt_ring->write(rs_out_interleaved, m_outframesX2);
+                if (squelched)
+                    QsGlobal::g_float_rt_ring->writeZeros(m_outframesX2);
+                else
+                    QsGlobal::g_float_rt_ring->write(rs_out_interleaved, m_outframesX2);
+            } else {
+                QsGlobal::g_float_rt_ring->noteOverflow(m_outframesX2);
+                QsTrace::miss("rt ring overflow");
             }
 #endif
 #ifdef __DAC_OUT__
             if (QsGlobal::g_float_dac_ring->writeAvail() >= m_outframesX2) {
-                QsGlobal::g_float_dac_ring->write(rs_out_interleaved, m_outframesX2);
+                if (tagged) {
+                    // audio decimator then resampler, each at its own input rate
+                    double delay = p_audio_decim->groupDelay() / m_post_processing_rate +
+                                   resampler->groupDelay() / m_rs_input_rate;
+                    QsGlobal::g_latency->pass(lhPost, *QsGlobal::g_float_dac_ring, post_tag,
+                                              std::llround(delay * 1e9), m_outframesX2);
+                }
+                if (squelched)
+                    QsGlobal::g_float_dac_ring->writeZeros(m_outframesX2);
+                else
+                    QsGlobal::g_float_dac_ring->write(rs_out_interleaved, m_outframesX2);
+            } else {
+                QsGlobal::g_float_dac_ring->noteOverflow(m_outframesX2);
+                QsTrace::miss("dac ring overflow");
             }
 #endif
+            m_stats.lap(stOutput, t);
+            m_stats.endBlock();
+
+            // lazily sized stage state settles in the first blocks; from
+            // here on the block path must stay off the heap
+            if (++blocks == QS_DEFAULT_WARMUP_BLOCKS)
+                QsAllocGuard::arm("dspproc");
+            m_blocks.fetch_add(1, std::memory_order_relaxed);
         }
         sleep.usleep(1);
     }
+
+    m_stats.perf().close();
+    QsAllocGuard::disarm();
+    if (QsAllocGuard::enabled())
+        _debug() << "dspproc: " << QsAllocGuard::count() << " heap allocations after warm-up";
+
     m_is_running = false;
     _debug() << "dspproc thread stopped.";
 }
@@ -339,6 +413,7 @@ void QsDspProcessor::start() {
     // Start the thread only if it isn't already running
     if (!m_is_running && !m_thread_go) {
         m_thread_go = true;
+        m_blocks = 0;
         m_thread = std::thread(&QsDspProcessor::run, this); // Launch the run() method in a new thread
     }
 }
@@ -352,12 +427,176 @@ void QsDspProcessor::stop() {
 
 bool QsDspProcessor::isRunning() { return m_thread_go; }
 
+uint64_t QsDspProcessor::blocksProcessed() { return m_blocks.load(std::memory_order_relaxed); }
+
+double QsDspProcessor::cpuSeconds() { return threadCpuSeconds(m_thread); }
+
 void QsDspProcessor::clearBuffers() { QsGlobal::g_cpx_sd_ring->empty(); }
 
+// SETTINGS
+
+// Once per block: one load of the snapshot sequence, and only when it
+// moved, a copy of the snapshot and an update() per stage. Each stage
+// compares its group's version, so only the stages whose settings changed
+// do any work. A copy that overlaps a store keeps the old settings for
+// this block.
+void QsDspProcessor::syncParams() {
+    if (QsGlobal::g_memory->paramsSequence() == m_params_seq)
+        return;
+    if (!QsGlobal::g_memory->tryParams(m_params, m_params_seq))
+        return;
+
+    // a new filter or adaptive filter size is design work, not block work
+    QsAllocGuard::Pause pause;
+#ifdef __NOISE_BLANKERS__
+    p_anb->update(m_params);
+    p_bnb->update(m_params);
+#endif
+    p_tg0->update(m_params);
+    p_main_filter->update(m_params);
+#ifdef __IIR_NOTCH__
+    p_iir_notches->update(m_params);
+#endif
+    p_tg1->update(m_params);
+    p_sm->update(m_params);
+    p_agc->update(m_params);
+    p_sam->update(m_params);
+    p_fm->update(m_params);
+    p_post_filter->update(m_params);
+    p_sq->update(m_params);
+#ifdef __AUTO_NOTCH__
+    p_anf->update(m_params);
+#endif
+    p_nr->update(m_params);
+    p_vol->update(m_params);
+}
+
+// CHUNKED STAGES
+
+// The stateful per-sample stages between the main filter and the post
+// filter, each run over DSP_CHUNK samples before the next takes them, so
+// the chunk stays in L1 through all of them instead of the whole block
+// streaming through cache once per stage. The S meter sums power per chunk
+// and reads out once for the block; the AGC limiter likewise takes the
+// block's peak, so the demodulators run in a second pass after it.
+void QsDspProcessor::processChunks(Cpx *data, int length, int demod_mode) {
+    for (int base = 0; base < length; base += DSP_CHUNK) {
+        Cpx *chunk = data + base;
+        const int n = std::min(DSP_CHUNK, length - base);
+        uint64_t t = m_stats.begin();
+
+#ifdef __IIR_NOTCH__
+        p_iir_notches->process(chunk, n);
+        t = m_stats.lap(stNotch, t);
+#endif
+        if (demod_mode == dmCW) {
+            p_tg1->process(chunk, n);
+            t = m_stats.lap(stToneGen, t);
+        }
+
+        p_sm->accumulate(chunk, n);
+        t = m_stats.lap(stSMeter, t);
+        p_agc->apply(chunk, n);
+        m_stats.lap(stAgc, t);
+    }
+    p_sm->publish();
+
+    // the limiter decides on the block's peak, as it did on the whole block
+    uint64_t t = m_stats.begin();
+    p_agc->limit(data, length);
+    m_stats.lap(stAgc, t);
+
+    for (int base = 0; base < length; base += DSP_CHUNK) {
+        Cpx *chunk = data + base;
+        const int n = std::min(DSP_CHUNK, length - base);
+        t = m_stats.begin();
+
+        switch (demod_mode) {
+        case dmAM:
+            p_am->process(chunk, n);
+            break;
+        case dmSAM:
+            p_sam->process(chunk, n);
+            break;
+        case dmFMN:
+            p_fm->process(chunk, n, NARROW);
+            break;
+        case dmFMW:
+            p_fm->process(chunk, n, WIDE);
+            break;
+        default:
+            break;
+        }
+        m_stats.lap(stDemod, t);
+    }
+}
+
+// SQUELCH CLOSED
+
+// A closed block skips the auto notch, noise reduction, resampler filtering
+// and volume. The adaptive stages keep their weights (no updates on
+// silence) and drop their input history once, on the first closed block,
+// so they reopen as if they had been fed silence. The decimator and
+// resampler step over the block: phase, output count and history advance
+// exactly as for zeros, so the output rate is unchanged and nothing stale
+// leaks into the first open block.
+int QsDspProcessor::holdAudio() {
+    if (!m_squelched) {
+#ifdef __AUTO_NOTCH__
+        p_anf->hold();
+#endif
+        p_nr->hold();
+    }
+
+    int audio_len = m_bsize;
+#ifdef __BINAURAL__
+    if (!m_params.binaural)
+#endif
+        audio_len = p_audio_decim->skip(m_bsize);
+
+    int outframes = resampler->skip(audio_len);
+    m_outframesX2 = outframes * 2;
+    return outframes;
+}
+
 // RESAMPLER
 
 void QsDspProcessor::initResampler(int size) {
-    rs_in_interleaved.resize(size * 8);
-    rs_out_interleaved.resize(size * 8);
-    resampler = std::make_unique<Resampler>(std::round(m_rs_input_rate), std::round(m_rs_output_rate));
+    QsTrace::Span span("resampler design");
+    resampler = std::make_unique<Resampler>(m_rs_input_rate, m_rs_output_rate, m_rs_quality);
+    resampler->reserve(size);
+    int outframes = resampler->maxOutput(size);
+    rs_out_mono.resize(outframes);
+    rs_out_cpx.resize(outframes);
+    rs_out_interleaved.resize(outframes * 2);
+    _debug() << "resampler " << resampler->interpolation() << "/" << resampler->decimation() << ", "
+             << resampler->phaseLength() << " taps per phase";
+}
+
+// AUDIO RATE STAGE
+
+// Pick the audio decimation for the current filter edges; the resampler is
+// rebuilt from the new rate when the factor changes. Binaural stays at the
+// post processing rate.
+void QsDspProcessor::updateAudioRate() {
+    int factor = 1;
+    bool binaural = false;
+#ifdef __BINAURAL__
+    binaural = m_params.binaural;
+#endif
+    if (m_params.audio_rate_stage && !binaural) {
+        double bandwidth = std::max(std::abs(m_params.filter_lo), std::abs(m_params.filter_hi));
+        factor = QsAudioDecimator::chooseFactor(m_post_processing_rate, bandwidth, m_bsize, m_rs_rate);
+    }
+
+    if (factor != p_audio_decim->factor()) {
+        // a rate change rebuilds the decimator and resampler; not block work
+        QsAllocGuard::Pause pause;
+        QsTrace::Span span("audio rate design");
+        p_audio_decim->configure(factor);
+        p_audio_decim->reserve(m_bsize);
+        m_rs_input_rate = m_post_processing_rate / factor;
+        initResampler(m_bsize / factor);
+        _debug() << "audio rate stage: decimate by " << factor << ", " << p_audio_decim->taps() << " taps";
+    }
 }
@@ -0,0 +1,107 @@
+#include "../include/qs_dsp_stats.hpp"
+
+#include <cstdio>
+
+static const char *const STAGE_NAMES[stCount] = {
+    "nb",    "frontend", "mainfir", "notch", "tonegen", "smeter", "agc",    "demod", "postfir",
+    "audiorate", "squelch", "anf", "nr", "resampler", "volume", "output", "block"};
+
+QsDspStats::QsDspStats()
+    : m_enabled(true), m_reset(false), m_touched(0), m_block_ns(0.0), m_block_size(0), m_blocks(0), m_busy(0),
+      m_perf(STAGE_NAMES, stBlock) {
+    for (int i = 0; i < stCount; i++)
+        m_pending[i] = 0;
+    clear();
+}
+
+const char *QsDspStats::stageName(QsDspStage stage) { return STAGE_NAMES[stage]; }
+
+void QsDspStats::configure(double post_rate, int block_size) {
+    m_block_ns = post_rate > 0.0 ? block_size * 1e9 / post_rate : 0.0;
+    m_block_size = block_size;
+    for (int i = 0; i < stCount; i++)
+        m_pending[i] = 0;
+    m_touched = 0;
+    clear();
+}
+
+void QsDspStats::endBlock() {
+    if (m_reset.exchange(false, std::memory_order_relaxed))
+        clear();
+    // the front end counts its samples per lap, the post stages per block
+    if (m_perf.active()) {
+        for (int i = stFrontEnd + 1; i < stBlock; i++)
+            if (m_touched & (1u << i))
+                m_perf.addSamples(i, m_block_size);
+    }
+    m_perf.sync();
+    if (!m_touched)
+        return;
+    if (!enabled()) {
+        // trace only: the laps ran, nothing is recorded
+        for (int i = 0; i < stBlock; i++)
+            m_pending[i] = 0;
+        m_touched = 0;
+        return;
+    }
+
+    uint64_t total = 0;
+    for (int i = 0; i < stBlock; i++) {
+        if (m_touched & (1u << i)) {
+            m_hist[i].record(m_pending[i]);
+            total += m_pending[i];
+            m_pending[i] = 0;
+        }
+    }
+    m_hist[stBlock].record(total);
+    m_touched = 0;
+
+    m_busy.store(m_busy.load(std::memory_order_relaxed) + total, std::memory_order_relaxed);
+    m_blocks.store(m_blocks.load(std::memory_order_relaxed) + 1, std::memory_order_relaxed);
+}
+
+void QsDspStats::clear() {
+    for (QsHistogram &h : m_hist)
+        h.clear();
+    m_blocks.store(0, std::memory_order_relaxed);
+    m_busy.store(0, std::memory_order_relaxed);
+}
+
+QsDspStats::Summary QsDspStats::summary(QsDspStage stage) const {
+    const QsHistogram &h = m_hist[stage];
+    double scale = QsTicks::nsPerTick();
+    Summary s;
+    s.count = h.count();
+    s.p50_ns = h.percentile(0.50) * scale;
+    s.p99_ns = h.percentile(0.99) * scale;
+    s.max_ns = h.max() * scale;
+    s.mean_ns = h.mean() * scale;
+    return s;
+}
+
+double QsDspStats::utilization() const {
+    uint64_t blocks = m_blocks.load(std::memory_order_relaxed);
+    if (blocks == 0 || m_block_ns <= 0.0)
+        return 0.0;
+    return QsTicks::toNs(m_busy.load(std::memory_order_relaxed)) / (blocks * m_block_ns);
+}
+
+std::string QsDspStats::report() const {
+    char buf[96];
+    std::string out;
+
+    Summary block = summary(stBlock);
+    double peak = m_block_ns > 0.0 ? block.max_ns / m_block_ns : 0.0;
+    std::snprintf(buf, sizeof(buf), "blocks %llu, util %.4f, peak %.4f", static_cast<unsigned long long>(blocks()),
+                  utilization(), peak);
+    out = buf;
+
+    for (int i = 0; i < stCount; i++) {
+        Summary s = summary(static_cast<QsDspStage>(i));
+        if (s.count == 0)
+            continue;
+        std::snprintf(buf, sizeof(buf), ", %s %.0f/%.0f/%.0f", STAGE_NAMES[i], s.p50_ns, s.p99_ns, s.max_ns);
+        out += buf;
+    }
+    return out;
+}
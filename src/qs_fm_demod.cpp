@@ -1,15 +1,24 @@
 #include "../include/qs_fm_demod.hpp"
+#include "../include/qs_arena.hpp"
 
 #include "../include/qs_globals.hpp" // Include global definitions and dependencies
+#include "../include/qs_signalops.hpp"
 #include <algorithm>                 // for std::clamp
 #include <cmath>
 
 QsFMCombinedDemodulator::QsFMCombinedDemodulator()
-    : m_mode(NARROW), m_bw(0), m_limit(0), m_zeta(0), m_norm(0), m_cos(0), m_sin(0), m_ncoPhase(0), m_phaseError(0),
+    : m_mode(NARROW), m_detector(fmPll), m_bw(0), m_limit(0), m_zeta(0), m_norm(0), m_cos(0), m_sin(0), m_ncoPhase(0), m_phaseError(0),
       m_ncoFreq(0), m_ncoHighLimit(0), m_ncoLowLimit(0), m_alpha(0), m_beta(0), m_freqDcError(0), m_dc_alpha(0),
-      m_outgain(0) {}
+      m_outgain(0), m_prev(0.0, 0.0) {}
 
 void QsFMCombinedDemodulator::init(DemodMode mode) {
+    configure(mode);
+    update(QsGlobal::g_memory->params());
+}
+
+void QsFMCombinedDemodulator::update(const QsDspParams &params) { m_detector = params.fm_detector; }
+
+void QsFMCombinedDemodulator::configure(DemodMode mode) {
     m_mode = mode;
 
     // Set default parameters based on the selected mode
@@ -33,13 +42,34 @@ void QsFMCombinedDemodulator::init(DemodMode mode) {
     m_freqDcError = 0.0;
     m_dc_alpha = 1.0 - exp(-1.0 / (QsGlobal::g_memory->getDataPostProcRate() * 0.01));
     m_outgain = 0.45 * QsGlobal::g_memory->getDataPostProcRate() / (ONE_PI * m_bw);
+    m_prev = Cpx(0.0, 0.0);
 }
 
 void QsFMCombinedDemodulator::process(qs_vect_cpx &src_dst, DemodMode mode) {
+    process(src_dst.data(), static_cast<int>(src_dst.size()), mode);
+}
+
+void QsFMCombinedDemodulator::process(Cpx *src_dst, int length, DemodMode mode) {
     if (m_mode != mode) {
-        init(mode);
+        configure(mode);
     }
-    for (auto &sample : src_dst) {
+
+    if (length <= 0)
+        return;
+
+    if (m_detector == fmQuadrature)
+        processQuadrature(src_dst, length);
+    else
+        processPll(src_dst, length);
+}
+
+void QsFMCombinedDemodulator::processPll(Cpx *src_dst, int length) {
+    // Kept for a switch to the quadrature detector
+    m_prev = src_dst[length - 1];
+
+    for (int i = 0; i < length; i++) {
+        Cpx &sample = src_dst[i];
+
         // Precompute trigonometric functions for the NCO phase
         m_sin = sin(m_ncoPhase);
         m_cos = cos(m_ncoPhase);
@@ -73,3 +103,30 @@ void QsFMCombinedDemodulator::process(qs_vect_cpx &src_dst, DemodMode mode) {
         sample = Cpx(demodulated_value, demodulated_value);
     }
 }
+
+void QsFMCombinedDemodulator::processQuadrature(Cpx *src_dst, int length) {
+    QsArena::Scope scratch;
+    float *phase = scratch.alloc<float>(length);
+
+    // Phase step per sample in rad/sample, the quantity the PLL's NCO
+    // frequency tracks; this pass has no loop-carried state
+    QsSignalOps::PhaseDifference(src_dst, m_prev, phase, length);
+    m_prev = src_dst[length - 1];
+
+    // Same frequency limits, DC error compensation and gain as the PLL,
+    // with the loop state in float locals
+    const float dc_alpha = m_dc_alpha;
+    const float dc_keep = 1.0f - m_dc_alpha;
+    const float gain = m_outgain;
+    float dc_error = m_freqDcError;
+    for (int i = 0; i < length; i++) {
+        float freq = std::clamp(phase[i], m_ncoLowLimit, m_ncoHighLimit);
+        dc_error = dc_keep * dc_error + dc_alpha * freq;
+        float demodulated_value = (freq - dc_error) * gain;
+        src_dst[i] = Cpx(demodulated_value, demodulated_value);
+    }
+    m_freqDcError = dc_error;
+
+    // A switch back to the PLL starts on frequency
+    m_ncoFreq = std::clamp(phase[length - 1], m_ncoLowLimit, m_ncoHighLimit);
+}
@@ -0,0 +1,141 @@
+#include "../include/qs_frontend.hpp"
+#include "../include/qs_debugloggerclass.hpp"
+#include "../include/qs_defaults.hpp"
+#include "../include/qs_downcnv.hpp"
+#include "../include/qs_tone_gen.hpp"
+
+#include <algorithm>
+
+QsFrontEnd::QsFrontEnd()
+    : m_tg(nullptr), m_in(nullptr), m_in_length(0), m_block_size(0), m_overlap(0), m_head_decim(1),
+      m_parallel(false) {}
+
+QsFrontEnd::~QsFrontEnd() { m_pool.stop(); }
+
+double QsFrontEnd::init(QsToneGenerator *tg, double in_rate, double bandwidth, int block_size, int threads) {
+    m_pool.stop();
+    m_segments.clear();
+
+    m_tg = tg;
+    m_block_size = block_size;
+    m_plan = QsDecimationPlanner::plan(in_rate, bandwidth);
+    _debug() << "Decimation plan: " << m_plan.toString();
+
+    // head: the stages that run above in_rate / QS_FE_HEAD_DECIM
+    int head = 0;
+    m_head_decim = 1;
+    while (head < static_cast<int>(m_plan.stages.size()) && m_head_decim < QS_FE_HEAD_DECIM) {
+        m_head_decim *= m_plan.stages[head].ratio;
+        head++;
+    }
+
+    m_overlap = QsDownConvertor::historyLength(m_plan, 0, head);
+    m_overlap = ((m_overlap + m_head_decim - 1) / m_head_decim) * m_head_decim;
+
+    threads = std::min(threads, block_size / std::max(1, m_head_decim));
+    m_parallel = (in_rate >= QS_FE_PARALLEL_MIN_RATE) && (threads > 1) && (head > 0) &&
+                 ((block_size % (m_head_decim * threads)) == 0) && (m_overlap <= block_size);
+
+    m_chain = std::make_unique<QsDownConvertor>();
+    int stages = static_cast<int>(m_plan.stages.size());
+
+    if (!m_parallel) {
+        m_chain->setStages(m_plan, 0, stages);
+        return m_plan.out_rate;
+    }
+
+    m_chain->setStages(m_plan, head, stages);
+    m_odd_head = std::make_unique<QsDownConvertor>();
+    m_odd_head->setStages(m_plan, 0, head);
+
+    int seg_len = block_size / threads;
+    m_segments.resize(threads);
+    for (int i = 0; i < threads; i++) {
+        Segment &seg = m_segments[i];
+        seg.head = std::make_unique<QsDownConvertor>();
+        seg.head->setStages(m_plan, 0, head);
+        seg.scratch.assign(m_overlap + seg_len, Cpx(0.0, 0.0));
+        seg.start = i * seg_len;
+        seg.length = seg_len;
+    }
+
+    m_prev.assign(m_overlap, Cpx(0.0, 0.0));
+    m_mid.assign(block_size / m_head_decim, Cpx(0.0, 0.0));
+    m_pool.start(threads);
+
+    _debug() << "Front end: " << threads << " threads, head decimation " << m_head_decim << ", overlap "
+             << m_overlap;
+    return m_plan.out_rate;
+}
+
+int QsFrontEnd::process(Cpx *in_cpx, Cpx *out_cpx, int length) {
+    if (!m_parallel) {
+        // LO mixing is fused into the first decimation stage
+        int n = m_chain->process(in_cpx, out_cpx, length, m_tg->nco(), m_tg->nco().cursor());
+        m_tg->endBlock(length);
+        return n;
+    }
+
+    if (length != m_block_size)
+        return processSerial(in_cpx, out_cpx, length);
+
+    m_in = in_cpx;
+    m_in_length = length;
+    m_pool.run(&QsFrontEnd::segmentJob, this, static_cast<int>(m_segments.size()));
+    m_tg->endBlock(length);
+
+    // keep the raw history for the first segment of the next block
+    std::copy(in_cpx + length - m_overlap, in_cpx + length, m_prev.begin());
+
+    return m_chain->process(&m_mid[0], out_cpx, length / m_head_decim);
+}
+
+// A block the segments were not cut for: one head, warmed on the history
+// the way a segment is, runs the block in scratch sized pieces on this
+// thread and feeds the shared tail.
+int QsFrontEnd::processSerial(Cpx *in_cpx, Cpx *out_cpx, int length) {
+    const QsNco &nco = m_tg->nco();
+    qs_vect_cpx &scratch = m_segments[0].scratch; // the pool is idle
+    const int piece = static_cast<int>(scratch.size());
+
+    std::copy(m_prev.begin(), m_prev.end(), scratch.begin());
+    m_odd_head->process(&scratch[0], &scratch[0], m_overlap, nco, nco.cursor(-m_overlap));
+
+    int produced = 0;
+    for (int pos = 0; pos < length; pos += piece) {
+        int len = std::min(piece, length - pos);
+        std::copy(in_cpx + pos, in_cpx + pos + len, scratch.begin());
+        int n = m_odd_head->process(&scratch[0], &scratch[0], len, nco, nco.cursor(pos));
+        produced += m_chain->process(&scratch[0], out_cpx + produced, n);
+    }
+    m_tg->endBlock(length);
+
+    if (length >= m_overlap) {
+        std::copy(in_cpx + length - m_overlap, in_cpx + length, m_prev.begin());
+    } else {
+        std::copy(m_prev.begin() + length, m_prev.end(), m_prev.begin());
+        std::copy(in_cpx, in_cpx + length, m_prev.end() - length);
+    }
+    return produced;
+}
+
+void QsFrontEnd::segmentJob(void *ctx, int index) {
+    QsFrontEnd *fe = static_cast<QsFrontEnd *>(ctx);
+    fe->runSegment(fe->m_segments[index]);
+}
+
+void QsFrontEnd::runSegment(Segment &seg) {
+    // gather overlap + segment; negative indices reach into the previous block
+    int first = seg.start - m_overlap;
+    int total = m_overlap + seg.length;
+    for (int i = 0; i < total; i++) {
+        int v = first + i;
+        seg.scratch[i] = (v < 0) ? m_prev[m_overlap + v] : m_in[v];
+    }
+
+    // warm-up outputs are discarded, the rest is this segment's slice
+    const QsNco &nco = m_tg->nco();
+    int n = seg.head->process(&seg.scratch[0], &seg.scratch[0], total, nco, nco.cursor(first));
+    int skip = m_overlap / m_head_decim;
+    std::copy(seg.scratch.begin() + skip, seg.scratch.begin() + n, m_mid.begin() + seg.start / m_head_decim);
+}
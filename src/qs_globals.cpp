@@ -3,6 +3,7 @@
 // Define the static members
 QS1RServer* QsGlobal::g_server = nullptr;
 std::unique_ptr<QsMemory> QsGlobal::g_memory = std::make_unique<QsMemory>();
+std::unique_ptr<QsLatency> QsGlobal::g_latency = std::make_unique<QsLatency>();
 
 std::unique_ptr<QsCircularBuffer<std::complex<float>>> QsGlobal::g_cpx_readin_ring = nullptr;
 std::unique_ptr<QsCircularBuffer<std::complex<float>>> QsGlobal::g_cpx_sd_ring = nullptr;
@@ -1,9 +1,17 @@
 #include "../include/qs_hilbert.hpp"
+#include "../include/qs_arena.hpp"
 #include "../include/qs_filter.hpp"
 
-QsHilbert ::QsHilbert(int ntaps) { m_taps = MakeHilbertTaps(12, ntaps); }
+QsHilbert ::QsHilbert(int ntaps) {
+    m_taps = MakeHilbertTaps(12, ntaps);
+    m_hist.assign(m_taps.size() - 1, 0.0f);
+}
 
 int QsHilbert::process(qs_vect_f &in_f, qs_vect_cpx &out_cpx, unsigned int length) {
+    return process(in_f.data(), out_cpx.data(), length);
+}
+
+int QsHilbert::process(const float *in_f, Cpx *out_cpx, unsigned int length) {
     for (unsigned int i = 0; i < length; i++) {
         out_cpx[i].real(in_f[i + m_taps.size() / 2]); // Set the real part
         out_cpx[i].imag(filter(&in_f[i]));            // Set the imaginary part using the filter result
@@ -12,9 +20,15 @@ int QsHilbert::process(qs_vect_f &in_f, qs_vect_cpx &out_cpx, unsigned int lengt
 }
 
 int QsHilbert ::process(qs_vect_cpx &in_cpx, qs_vect_cpx &out_cpx, unsigned int length) {
-    qs_vect_f in_f(length);
-    QsSignalOps::RealFromComplex(in_cpx.data(), in_f.data(), length);
-    return process(in_f, out_cpx, length);
+    // the filter reads taps - 1 samples past each output: run on the
+    // previous block's tail followed by this block
+    const unsigned int hist = m_hist.size();
+    QsArena::Scope scratch;
+    float *in_f = scratch.alloc<float>(hist + length);
+    std::copy(m_hist.begin(), m_hist.end(), in_f);
+    QsSignalOps::RealFromComplex(in_cpx.data(), in_f + hist, length);
+    std::copy(in_f + length, in_f + length + hist, m_hist.begin());
+    return process(in_f, out_cpx.data(), length);
 }
 
 float QsHilbert ::filter(const float input[]) {
@@ -0,0 +1,49 @@
+#include "../include/qs_histogram.hpp"
+
+#include <algorithm>
+
+QsHistogram::QsHistogram() { clear(); }
+
+void QsHistogram::clear() {
+    for (std::atomic<uint64_t> &b : m_bucket)
+        b.store(0, std::memory_order_relaxed);
+    m_count.store(0, std::memory_order_relaxed);
+    m_sum.store(0, std::memory_order_relaxed);
+    m_max.store(0, std::memory_order_relaxed);
+}
+
+void QsHistogram::merge(const QsHistogram &other) {
+    for (int i = 0; i < BUCKETS; i++)
+        bump(m_bucket[i], other.m_bucket[i].load(std::memory_order_relaxed));
+    bump(m_count, other.count());
+    bump(m_sum, other.sum());
+    if (other.max() > max())
+        m_max.store(other.max(), std::memory_order_relaxed);
+}
+
+double QsHistogram::mean() const {
+    uint64_t n = count();
+    return n ? static_cast<double>(sum()) / n : 0.0;
+}
+
+double QsHistogram::bucketMid(int index) {
+    if (index < 16)
+        return index;
+    int octave = index / 8 + 2;
+    double width = static_cast<double>(1ull << (octave - 3));
+    return (8 + index % 8) * width + width / 2.0;
+}
+
+double QsHistogram::percentile(double q) const {
+    uint64_t n = count();
+    if (n == 0)
+        return 0.0;
+    uint64_t rank = static_cast<uint64_t>(q * (n - 1)) + 1;
+    uint64_t seen = 0;
+    for (int i = 0; i < BUCKETS; i++) {
+        seen += m_bucket[i].load(std::memory_order_relaxed);
+        if (seen >= rank)
+            return std::min(bucketMid(i), static_cast<double>(max()));
+    }
+    return static_cast<double>(max());
+}
@@ -8,6 +8,7 @@
 #include "../include/qs_file.hpp"
 #include "../include/qs_io_libusb.hpp"
 #include "../include/qs_textstream.hpp"
+#include "../include/qs_trace.hpp"
 #include <libusb-1.0/libusb.h>
 
 std::string QsIOLib_LibUSB::printVectorInHex(const std::vector<uint8_t> &ba) {
@@ -626,12 +627,14 @@ int QsIOLib_LibUSB::loadFpgaFromBitstream(const unsigned char *bitstream, unsign
 
 int QsIOLib_LibUSB::sendControlMessage(uint8_t request_type, uint8_t request, uint16_t value, uint16_t index,
                                        std::byte *data, uint16_t size, unsigned int timeout) {
+    QsTrace::Span span("usb control");
     return libusb_control_transfer(hdev, request_type, request, value, index, reinterpret_cast<unsigned char *>(data),
                                    size, timeout);
 }
 
 int QsIOLib_LibUSB::sendControlMessage(uint8_t request_type, uint8_t request, uint16_t value, uint16_t index,
                                        u_char *buf, uint16_t size, unsigned int timeout) {
+    QsTrace::Span span("usb control");
     return libusb_control_transfer(hdev, request_type, request, value, index, reinterpret_cast<unsigned char *>(buf),
                                    size, timeout);
 }
@@ -758,6 +761,7 @@ int QsIOLib_LibUSB::writeEP2(unsigned char *buffer, unsigned int length, unsigne
         return -1;
 
     int transfered;
+    QsTrace::Span span("ep2 write");
     int result = libusb_bulk_transfer(hdev, FX2_EP2, buffer, length, &transfered, timeout);
 
     if (result != LIBUSB_SUCCESS) {
@@ -775,6 +779,7 @@ int QsIOLib_LibUSB::writeEP4(unsigned char *buffer, unsigned int length, unsigne
         return -1;
 
     int transfered;
+    QsTrace::Span span("ep4 write");
     int result = libusb_bulk_transfer(hdev, FX2_EP4, buffer, length, &transfered, timeout);
 
     if (result != LIBUSB_SUCCESS) {
@@ -792,6 +797,7 @@ int QsIOLib_LibUSB::readEP6(unsigned char *buffer, unsigned int length, unsigned
         return -1;
 
     int transfered;
+    QsTrace::Span span("ep6 read");
     int result = libusb_bulk_transfer(hdev, FX2_EP6, (u_char *)buffer, length, &transfered, timeout);
 
     if (result != LIBUSB_SUCCESS) {
@@ -810,6 +816,7 @@ int QsIOLib_LibUSB::readEP8(unsigned char *buffer, unsigned int length, unsigned
         return -1;
 
     int transfered;
+    QsTrace::Span span("ep8 read");
     int result = libusb_bulk_transfer(hdev, FX2_EP8, (u_char *)buffer, length, &transfered, timeout);
 
     if (result != LIBUSB_SUCCESS) {
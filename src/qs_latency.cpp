@@ -0,0 +1,75 @@
+#include "../include/qs_latency.hpp"
+#include "../include/qs_defaults.hpp"
+
+#include <cstdio>
+
+static const char *const HOP_NAMES[lhCount] = {"readin", "frontend", "sd", "post", "dac", "total"};
+
+QsLatency::QsLatency() : m_window_ns(static_cast<int64_t>(QS_DEFAULT_LATENCY_WINDOW_S) * 1000000000LL) {
+    int64_t t = now();
+    for (Hop &hop : m_hop) {
+        hop.current.store(0, std::memory_order_relaxed);
+        hop.window_start = t;
+        hop.reset.store(false, std::memory_order_relaxed);
+        hop.gaps.store(0, std::memory_order_relaxed);
+        hop.last = 0;
+        hop.seen = false;
+    }
+}
+
+const char *QsLatency::hopName(QsLatencyHop hop) { return HOP_NAMES[hop]; }
+
+void QsLatency::rotate(Hop &hop, int64_t t) {
+    if (hop.reset.exchange(false, std::memory_order_relaxed)) {
+        hop.gen[0].clear();
+        hop.gen[1].clear();
+        hop.gaps.store(0, std::memory_order_relaxed);
+        hop.window_start = t;
+    } else if (t - hop.window_start >= m_window_ns) {
+        // the older generation starts over as the current one
+        int next = hop.current.load(std::memory_order_relaxed) ^ 1;
+        hop.gen[next].clear();
+        hop.current.store(next, std::memory_order_relaxed);
+        hop.window_start = t;
+    }
+}
+
+void QsLatency::record(QsLatencyHop hop, int64_t from_ns, int64_t to_ns) {
+    Hop &h = m_hop[hop];
+    rotate(h, to_ns);
+    int64_t ns = to_ns - from_ns;
+    h.gen[h.current.load(std::memory_order_relaxed)].record(ns > 0 ? static_cast<uint64_t>(ns) : 0);
+}
+
+void QsLatency::arrive(QsLatencyHop hop, const QsBlockTag &tag, uint64_t missing) {
+    Hop &h = m_hop[hop];
+    // sequence numbers going back mean the reader restarted, not a drop
+    if (h.seen && tag.first > h.last + 1)
+        missing += tag.first - h.last - 1;
+    if (missing)
+        h.gaps.store(h.gaps.load(std::memory_order_relaxed) + missing, std::memory_order_relaxed);
+    h.last = tag.last;
+    h.seen = true;
+}
+
+void QsLatency::requestReset() {
+    for (Hop &hop : m_hop)
+        hop.reset.store(true, std::memory_order_relaxed);
+}
+
+std::string QsLatency::report() const {
+    char buf[96];
+    std::string out;
+
+    for (int i = 0; i < lhCount; i++) {
+        const Hop &h = m_hop[i];
+        QsHistogram window;
+        window.merge(h.gen[0]);
+        window.merge(h.gen[1]);
+        std::snprintf(buf, sizeof(buf), "%s%s %.0f/%.0f/%.0f gaps %llu", i ? ", " : "", HOP_NAMES[i],
+                      window.percentile(0.50) / 1000.0, window.percentile(0.99) / 1000.0, window.max() / 1000.0,
+                      static_cast<unsigned long long>(h.gaps.load(std::memory_order_relaxed)));
+        out += buf;
+    }
+    return out;
+}
@@ -1,7 +1,9 @@
 #include "../include/qs_main_rx_filter.hpp"
+#include "../include/qs_arena.hpp"
+#include "../include/qs_trace.hpp"
 
 QsMainRxFilter::QsMainRxFilter()
-    : m_size(4096), m_samplerate(62500), m_filter_lo(100), m_filter_hi(3000.0), m_one_over_norm(1.0 / (m_size * 2.0)),
+    : m_size(4096), m_samplerate(62500), m_filter_lo(100), m_filter_hi(3000.0), m_version(0), m_one_over_norm(1.0 / (m_size * 2.0)),
       p_ovlpfft(new QsFFT()), p_filtfft(new QsFFT()) {}
 
 void QsMainRxFilter::init(int size) {
@@ -11,8 +13,10 @@ void QsMainRxFilter::init(int size) {
     p_ovlpfft->resize(m_size * 2);
     p_filtfft->resize(m_size * 2);
 
-    m_filter_lo = QsGlobal::g_memory->getFilterLo();
-    m_filter_hi = QsGlobal::g_memory->getFilterHi();
+    const QsDspParams params = QsGlobal::g_memory->params();
+    m_filter_lo = params.filter_lo;
+    m_filter_hi = params.filter_hi;
+    m_version = params.version[pgFilter];
 
     m_one_over_norm = 1.0 / (m_size * 2.0);
 
@@ -23,6 +27,9 @@ void QsMainRxFilter::init(int size) {
     cpx_1.resize(size * 2);
 
     filt_cpx0.resize(size * 2);
+    kernel_gain.resize(size * 2);
+    block_cpx0.resize(size * 2);
+    block_gain.resize(size * 2);
     ovlp.resize(size);
 
     QsSignalOps::Zero(cpx_0);
@@ -32,22 +39,44 @@ void QsMainRxFilter::init(int size) {
     QsSignalOps::Zero(tmpfilt0_re);
     QsSignalOps::Zero(tmpfilt0_im);
 
+    for (QsSpectralStage *stage : m_stages) {
+        stage->prepare(m_size * 2);
+        stage->update(params);
+    }
+
     MakeFilter(m_filter_lo, m_filter_hi);
 }
 
-void QsMainRxFilter::process(qs_vect_cpx &src_dst) {
-    if (m_filter_lo != QsGlobal::g_memory->getFilterLo() || m_filter_hi != QsGlobal::g_memory->getFilterHi()) {
-        m_filter_lo = QsGlobal::g_memory->getFilterLo();
-        m_filter_hi = QsGlobal::g_memory->getFilterHi();
-        MakeFilter(m_filter_lo, m_filter_hi);
+void QsMainRxFilter::addStage(QsSpectralStage *stage) {
+    // a stage runs once per block however often init() registers it
+    if (std::find(m_stages.begin(), m_stages.end(), stage) == m_stages.end())
+        m_stages.push_back(stage);
+}
+
+void QsMainRxFilter::update(const QsDspParams &params) {
+    bool rebuild = false;
+    for (QsSpectralStage *stage : m_stages)
+        rebuild |= stage->update(params);
+
+    if (params.version[pgFilter] != m_version) {
+        m_version = params.version[pgFilter];
+        rebuild |= m_filter_lo != params.filter_lo || m_filter_hi != params.filter_hi;
+        m_filter_lo = params.filter_lo;
+        m_filter_hi = params.filter_hi;
     }
+    if (rebuild)
+        MakeFilter(m_filter_lo, m_filter_hi);
+}
 
+void QsMainRxFilter::process(qs_vect_cpx &src_dst) {
     QsSignalOps::Zero(&cpx_0[0] + m_size, m_size);
     QsSignalOps::Copy(&src_dst[0], &cpx_0[0], m_size);
 
-    // filter
+    // filter, again with this block's kernel if a stage has dynamic gains
     p_ovlpfft->doDFTForward(cpx_0, m_size * 2);
     QsSignalOps::Multiply(filt_cpx0, cpx_0, cpx_1, m_size * 2);
+    if (MakeBlockFilter())
+        QsSignalOps::Multiply(block_cpx0, cpx_0, cpx_1, m_size * 2);
     p_ovlpfft->doDFTInverse(cpx_1, m_size * 2, m_one_over_norm);
 
     // overlap add
@@ -58,18 +87,63 @@ void QsMainRxFilter::process(qs_vect_cpx &src_dst) {
 }
 
 void QsMainRxFilter::MakeFilter(float lo, float hi) {
+    QsTrace::Span span("mainfir design");
     QsSignalOps::Zero(&filt_cpx0[0], m_size * 2);
 
     MakeFirBandpass(lo, hi, m_samplerate, 12, tmpfilt0_re, tmpfilt0_im, m_size);
 
     QsSignalOps::RealToComplex(&tmpfilt0_re[0], &tmpfilt0_im[0], &filt_cpx0[0], m_size);
     p_filtfft->doDFTForward(filt_cpx0, m_size * 2);
+
+    if (m_stages.empty())
+        return;
+
+    // fold the stages' static gains into the kernel
+    std::fill(kernel_gain.begin(), kernel_gain.end(), 1.0f);
+    for (QsSpectralStage *stage : m_stages)
+        stage->kernelGains(&kernel_gain[0], m_size * 2, m_samplerate);
+    if (std::all_of(kernel_gain.begin(), kernel_gain.end(), [](float g) { return g == 1.0f; }))
+        return;
+
+    for (int k = 0; k < m_size * 2; k++)
+        filt_cpx0[k] *= kernel_gain[k];
+
+    // cut the shaped kernel back to m_size taps so blocks of m_size still
+    // convolve linearly in the 2 * m_size transform
+    p_filtfft->doDFTInverse(filt_cpx0, m_size * 2, m_one_over_norm);
+    QsSignalOps::Zero(&filt_cpx0[0] + m_size, m_size);
+    p_filtfft->doDFTForward(filt_cpx0, m_size * 2);
+}
+
+bool QsMainRxFilter::MakeBlockFilter() {
+    if (m_stages.empty())
+        return false;
+
+    // the stages judge the filtered spectrum in cpx_1
+    bool dynamic = false;
+    std::fill(block_gain.begin(), block_gain.end(), 1.0f);
+    for (QsSpectralStage *stage : m_stages)
+        dynamic |= stage->blockGains(&cpx_1[0], &block_gain[0], m_size * 2);
+    if (!dynamic)
+        return false;
+
+    // shape the kernel and cut it back to m_size taps, as MakeFilter() does
+    // for the static gains; the gains' own response would otherwise add to
+    // the 2 * m_size - 1 samples a block and the kernel already fill
+    for (int k = 0; k < m_size * 2; k++)
+        block_cpx0[k] = filt_cpx0[k] * block_gain[k];
+    p_filtfft->doDFTInverse(block_cpx0, m_size * 2, m_one_over_norm);
+    QsSignalOps::Zero(&block_cpx0[0] + m_size, m_size);
+    p_filtfft->doDFTForward(block_cpx0, m_size * 2);
+    return true;
 }
 
 void QsMainRxFilter::MakeFirBandpass(float lo, float hi, float samplerate, int wtype, qs_vect_f &taps_re,
                                       qs_vect_f &taps_im, int length) {
-    qs_vect_f window;
-    window.resize(length);
+    // scratch from the thread's arena: this runs on the DSP thread when the
+    // filter edges move
+    QsArena::Scope scratch;
+    float *window = scratch.alloc<float>(length);
 
     float fl = lo / samplerate;
     float fh = hi / samplerate;
@@ -96,8 +170,8 @@ void QsMainRxFilter::MakeFirBandpass(float lo, float hi, float samplerate, int w
 }
 
 void QsMainRxFilter::MakeWindow(int wtype, int size, qs_vect_cpx &window) {
-    qs_vect_f fwindow;
-    fwindow.resize(size);
+    QsArena::Scope scratch;
+    float *fwindow = scratch.alloc<float>(size);
     MakeWindow(wtype, size, fwindow);
     for (int i = 0; i < size; i++) {
         window[i] = Cpx(fwindow[i], fwindow[i]); // Assign both real and imag from fwindow[i]
@@ -113,7 +187,9 @@ qs_vect_cpx QsMainRxFilter::MakeWindowComplex(int wtype, int size) {
     return window;
 }
 
-void QsMainRxFilter::MakeWindow(int wtype, int size, qs_vect_f &window) {
+void QsMainRxFilter::MakeWindow(int wtype, int size, qs_vect_f &window) { MakeWindow(wtype, size, &window[0]); }
+
+void QsMainRxFilter::MakeWindow(int wtype, int size, float *window) {
     int i, j, midn, midp1, midm1;
     float freq, rate, sr1, angle, expn, expsum, cx, two_pi;
 
@@ -4,7 +4,7 @@
 #include <algorithm>
 #include <iostream>
 
-QsMemory::QsMemory() {
+QsMemory::QsMemory() : m_params_next() {
     for (int i = 0; i < MAX_RECEIVERS; i++) {
         m_volume[i] = QS_DEFAULT_VOLUME;
 
@@ -35,6 +35,9 @@ QsMemory::QsMemory() {
 
         // BINAURAL
         m_binaural_mode[i] = QS_DEFAULT_BINAURAL_MODE;
+        m_fm_detector[i] = QS_DEFAULT_FM_DETECTOR;
+        m_sam_tracking[i] = QS_DEFAULT_SAM_TRACKING;
+        m_audio_rate_stage[i] = QS_DEFAULT_AUDIO_RATE_STAGE;
 
         // AVG NOISE BLANKER
         m_avg_nb_threshold[i] = QS_DEFAULT_ANB_THRESH;
@@ -50,6 +53,7 @@ QsMemory::QsMemory() {
         m_autonotch_delay[i] = QS_DEFAULT_AUTONOTCH_DELAY;
         m_autonotch_taps[i] = QS_DEFAULT_AUTONOTCH_TAPS;
         m_autonotch_leak[i] = QS_DEFAULT_AUTONOTCH_LEAK;
+        m_autonotch_alg[i] = QS_DEFAULT_AUTONOTCH_ALG;
 
         // NR
         m_noise_reduction_switch[i] = QS_DEFAULT_NOISERED_ON;
@@ -57,6 +61,8 @@ QsMemory::QsMemory() {
         m_noise_reduction_delay[i] = QS_DEFAULT_NOISERED_DELAY;
         m_noise_reduction_taps[i] = QS_DEFAULT_NOISERED_TAPS;
         m_noise_reduction_leak[i] = QS_DEFAULT_NOISERED_LEAK;
+        m_noise_reduction_mode[i] = QS_DEFAULT_NOISERED_MODE;
+        m_noise_reduction_alg[i] = QS_DEFAULT_NOISERED_ALG;
 
         // S METER
         m_s_meter_cv[i] = -160.0;
@@ -100,6 +106,7 @@ QsMemory::QsMemory() {
     m_dac_block_size = QS_DEFAULT_DAC_BLOCKSIZE;
     m_tx_block_size = QS_DEFAULT_TX_BLOCKSIZE;
     m_resampler_quality = QS_DEFAULT_RS_QUAL;
+    m_fe_threads = QS_DEFAULT_FE_THREADS;
     m_resampler_rate = QS_DEFAULT_RT_RATE;
     m_enc_clock_freq = QS_DEFAULT_ENC_FREQ;
     m_tx_filter_low = QS_DEFAULT_TX_FILT_LO;
@@ -118,13 +125,102 @@ QsMemory::QsMemory() {
 
     m_gate_level_val = pow(10.0, (m_gate_level_db / 20.0));
     m_mic_gain_val = pow(10.0, (m_mic_gain_db / 20.0));
+
+    // first snapshot, every group at version 1
+    std::lock_guard<std::mutex> lock(m_params_mutex);
+    fillParams(m_params_next);
+    for (int i = 0; i < pgCount; i++)
+        m_params_next.version[i] = 1;
+    m_params.store(m_params_next);
+}
+
+//****************************************************//
+//----------------DSP SETTINGS SNAPSHOT---------------//
+//****************************************************//
+
+QsDspParams QsMemory::params() {
+    QsDspParams value;
+    m_params.load(value);
+    return value;
+}
+
+uint64_t QsMemory::paramsSequence() { return m_params.sequence(); }
+
+bool QsMemory::tryParams(QsDspParams &value, uint64_t &seq) { return m_params.tryLoad(value, seq); }
+
+// The DSP chain runs receiver 1; settings of the others are not published.
+void QsMemory::publish(QsParamGroup group, int rx_num) {
+    if (rx_num != 0)
+        return;
+    std::lock_guard<std::mutex> lock(m_params_mutex);
+    fillParams(m_params_next);
+    m_params_next.version[group]++;
+    m_params.store(m_params_next);
+}
+
+void QsMemory::fillParams(QsDspParams &p) {
+    p.filter_lo = m_filter_low[0];
+    p.filter_hi = m_filter_high[0];
+
+    p.agc_decay = m_agc_decay_speed[0];
+    p.agc_threshold = m_agc_threshold[0];
+    p.agc_fixed_gain = m_agc_fixed_gain[0];
+    p.agc_slope = m_agc_slope[0];
+    p.agc_hang_time = m_agc_hangtime[0];
+    p.agc_hang_switch = m_agc_hangtime_switch[0];
+
+    p.tone_lo_freq = m_tone_frequency[0];
+    p.offset_freq = m_offset_frequency[0];
+    p.tx_offset_freq = m_tx_offset_freq;
+
+    p.demod_mode = m_demod_mode[0];
+    p.binaural = m_binaural_mode[0];
+    p.fm_detector = m_fm_detector[0];
+    p.sam_tracking = m_sam_tracking[0];
+    p.audio_rate_stage = m_audio_rate_stage[0];
+
+    p.anb_on = m_avg_nb_switch[0];
+    p.anb_threshold = m_avg_nb_threshold[0];
+    p.bnb_on = m_block_nb_switch[0];
+    p.bnb_threshold = m_block_nb_threshold[0];
+
+    p.anf_on = m_autonotch_switch[0];
+    p.anf_rate = m_autonotch_rate[0];
+    p.anf_leak = m_autonotch_leak[0];
+    p.anf_delay = m_autonotch_delay[0];
+    p.anf_taps = m_autonotch_taps[0];
+    p.anf_alg = m_autonotch_alg[0];
+
+    p.nr_on = m_noise_reduction_switch[0];
+    p.nr_rate = m_noise_reduction_rate[0];
+    p.nr_leak = m_noise_reduction_leak[0];
+    p.nr_delay = m_noise_reduction_delay[0];
+    p.nr_taps = m_noise_reduction_taps[0];
+    p.nr_mode = m_noise_reduction_mode[0];
+    p.nr_alg = m_noise_reduction_alg[0];
+
+    p.squelch_on = m_squelch_switch[0];
+    p.squelch_threshold = m_squelch_threshold[0];
+
+    p.volume = m_volume[0];
+
+    for (int i = 0; i < MAX_MAN_NOTCHES; i++) {
+        p.notch_freq[i] = static_cast<float>(m_notch_frequency[0][i]);
+        p.notch_bw[i] = static_cast<float>(m_notch_bandwidth[0][i]);
+        p.notch_on[i] = m_notch_enabled[0][i];
+    }
+
+    p.smeter_correction = m_smeter_correction;
 }
 
 //****************************************************//
 //--------------------VOLUME--------------------------//
 //****************************************************//
 
-void QsMemory::setVolume(double value, int rx_num) { m_volume[rx_num] = value; }
+void QsMemory::setVolume(double value, int rx_num) {
+    m_volume[rx_num] = value;
+    publish(pgVolume, rx_num);
+}
 
 double QsMemory::getVolume(int rx_num) { return m_volume[rx_num]; }
 
@@ -132,11 +228,17 @@ double QsMemory::getVolume(int rx_num) { return m_volume[rx_num]; }
 //----------------------AGC---------------------------//
 //****************************************************//
 
-void QsMemory::setAgcDecaySpeed(double value, int rx_num) { m_agc_decay_speed[rx_num] = value; }
+void QsMemory::setAgcDecaySpeed(double value, int rx_num) {
+    m_agc_decay_speed[rx_num] = value;
+    publish(pgAgc, rx_num);
+}
 
 double QsMemory::getAgcDecaySpeed(int rx_num) { return m_agc_decay_speed[rx_num]; }
 
-void QsMemory::setAgcFixedGain(double value, int rx_num) { m_agc_fixed_gain[rx_num] = value; }
+void QsMemory::setAgcFixedGain(double value, int rx_num) {
+    m_agc_fixed_gain[rx_num] = value;
+    publish(pgAgc, rx_num);
+}
 
 double QsMemory::getAgcFixedGain(int rx_num) { return m_agc_fixed_gain[rx_num]; }
 
@@ -144,6 +246,7 @@ void QsMemory::setAgcThreshold(double value, int rx_num) {
     m_agc_threshold[rx_num] = value;
     if (value == 0)
         _debug() << ("agc thesh was 0");
+    publish(pgAgc, rx_num);
 }
 
 double QsMemory::getAgcThreshold(int rx_num) {
@@ -152,15 +255,24 @@ double QsMemory::getAgcThreshold(int rx_num) {
     return m_agc_threshold[rx_num];
 }
 
-void QsMemory::setAgcSlope(double value, int rx_num) { m_agc_slope[rx_num] = value; }
+void QsMemory::setAgcSlope(double value, int rx_num) {
+    m_agc_slope[rx_num] = value;
+    publish(pgAgc, rx_num);
+}
 
 double QsMemory::getAgcSlope(int rx_num) { return m_agc_slope[rx_num]; }
 
-void QsMemory::setAgcHangTime(double value, int rx_num) { m_agc_hangtime[rx_num] = value; }
+void QsMemory::setAgcHangTime(double value, int rx_num) {
+    m_agc_hangtime[rx_num] = value;
+    publish(pgAgc, rx_num);
+}
 
 double QsMemory::getAgcHangTime(int rx_num) { return m_agc_hangtime[rx_num]; }
 
-void QsMemory::setAgcHangTimeSwitch(bool value, int rx_num) { m_agc_hangtime_switch[rx_num] = value; }
+void QsMemory::setAgcHangTimeSwitch(bool value, int rx_num) {
+    m_agc_hangtime_switch[rx_num] = value;
+    publish(pgAgc, rx_num);
+}
 
 bool QsMemory::getAgcHangTimeSwitch(int rx_num) { return m_agc_hangtime_switch[rx_num]; }
 
@@ -176,11 +288,17 @@ unsigned char QsMemory::getAgcCurrentGainC(int rx_num) { return m_agc_current_ga
 //---------------------FILTER-------------------------//
 //****************************************************//
 
-void QsMemory::setFilterLo(int value, int rx_num) { m_filter_low[rx_num] = value; }
+void QsMemory::setFilterLo(int value, int rx_num) {
+    m_filter_low[rx_num] = value;
+    publish(pgFilter, rx_num);
+}
 
 int QsMemory::getFilterLo(int rx_num) { return m_filter_low[rx_num]; }
 
-void QsMemory::setFilterHi(int value, int rx_num) { m_filter_high[rx_num] = value; }
+void QsMemory::setFilterHi(int value, int rx_num) {
+    m_filter_high[rx_num] = value;
+    publish(pgFilter, rx_num);
+}
 
 int QsMemory::getFilterHi(int rx_num) { return m_filter_high[rx_num]; }
 
@@ -210,7 +328,10 @@ void QsMemory::setCwSidetoneFreq(double value) { m_cw_sidetone_freq = value; }
 
 double QsMemory::getCwSidetoneFreq() { return m_cw_sidetone_freq; }
 
-void QsMemory::setTxOffsetFrequency(double value) { m_tx_offset_freq = value; }
+void QsMemory::setTxOffsetFrequency(double value) {
+    m_tx_offset_freq = value;
+    publish(pgToneGen);
+}
 
 double QsMemory::getTxOffsetFrequency() { return m_tx_offset_freq; }
 
@@ -266,11 +387,17 @@ double QsMemory::getTxLOFrequency() { return m_tx_frequency; }
 //---------------------TONE GEN-----------------------//
 //****************************************************//
 
-void QsMemory::setToneLoFrequency(double value, int rx_num) { m_tone_frequency[rx_num] = value; }
+void QsMemory::setToneLoFrequency(double value, int rx_num) {
+    m_tone_frequency[rx_num] = value;
+    publish(pgToneGen, rx_num);
+}
 
 double QsMemory::getToneLoFrequency(int rx_num) { return m_tone_frequency[rx_num]; }
 
-void QsMemory::setOffsetGeneratorFrequency(double value, int rx_num) { m_offset_frequency[rx_num] = value; }
+void QsMemory::setOffsetGeneratorFrequency(double value, int rx_num) {
+    m_offset_frequency[rx_num] = value;
+    publish(pgToneGen, rx_num);
+}
 
 double QsMemory::getOffsetGeneratorFrequency(int rx_num) { return m_offset_frequency[rx_num]; }
 
@@ -278,23 +405,56 @@ double QsMemory::getOffsetGeneratorFrequency(int rx_num) { return m_offset_frequ
 //------------------DEMODULATOR-----------------------//
 //****************************************************//
 
-void QsMemory::setDemodMode(QSDEMODMODE value, int rx_num) { m_demod_mode[rx_num] = value; }
+void QsMemory::setDemodMode(QSDEMODMODE value, int rx_num) {
+    m_demod_mode[rx_num] = value;
+    publish(pgDemod, rx_num);
+}
 
 QSDEMODMODE QsMemory::getDemodMode(int rx_num) { return m_demod_mode[rx_num]; }
 
-void QsMemory::setBinauralMode(bool value, int rx_num) { m_binaural_mode[rx_num] = value; }
+void QsMemory::setBinauralMode(bool value, int rx_num) {
+    m_binaural_mode[rx_num] = value;
+    publish(pgDemod, rx_num);
+}
 
 bool QsMemory::getBinauralMode(int rx_num) { return m_binaural_mode[rx_num]; }
 
+void QsMemory::setFmDetector(int value, int rx_num) {
+    m_fm_detector[rx_num] = value;
+    publish(pgDemod, rx_num);
+}
+
+int QsMemory::getFmDetector(int rx_num) { return m_fm_detector[rx_num]; }
+
+void QsMemory::setSamTracking(int value, int rx_num) {
+    m_sam_tracking[rx_num] = value;
+    publish(pgDemod, rx_num);
+}
+
+int QsMemory::getSamTracking(int rx_num) { return m_sam_tracking[rx_num]; }
+
+void QsMemory::setAudioRateStage(bool value, int rx_num) {
+    m_audio_rate_stage[rx_num] = value;
+    publish(pgDemod, rx_num);
+}
+
+bool QsMemory::getAudioRateStage(int rx_num) { return m_audio_rate_stage[rx_num]; }
+
 //****************************************************//
 //---------------------AVG NB------------------------//
 //****************************************************//
 
-void QsMemory::setAvgNoiseBlankerThreshold(double value, int rx_num) { m_avg_nb_threshold[rx_num] = value; }
+void QsMemory::setAvgNoiseBlankerThreshold(double value, int rx_num) {
+    m_avg_nb_threshold[rx_num] = value;
+    publish(pgNoiseBlanker, rx_num);
+}
 
 double QsMemory::getAvgNoiseBlankerThreshold(int rx_num) { return m_avg_nb_threshold[rx_num]; }
 
-void QsMemory::setAvgNoiseBlankerOn(bool value, int rx_num) { m_avg_nb_switch[rx_num] = value; }
+void QsMemory::setAvgNoiseBlankerOn(bool value, int rx_num) {
+    m_avg_nb_switch[rx_num] = value;
+    publish(pgNoiseBlanker, rx_num);
+}
 
 bool QsMemory::getAvgNoiseBlankerOn(int rx_num) { return m_avg_nb_switch[rx_num]; }
 
@@ -302,11 +462,17 @@ bool QsMemory::getAvgNoiseBlankerOn(int rx_num) { return m_avg_nb_switch[rx_num]
 //---------------------BLOCK NB----------------------//
 //***************************************************//
 
-void QsMemory::setBlockNoiseBlankerThreshold(double value, int rx_num) { m_block_nb_threshold[rx_num] = value; }
+void QsMemory::setBlockNoiseBlankerThreshold(double value, int rx_num) {
+    m_block_nb_threshold[rx_num] = value;
+    publish(pgNoiseBlanker, rx_num);
+}
 
 double QsMemory::getBlockNoiseBlankerThreshold(int rx_num) { return m_block_nb_threshold[rx_num]; }
 
-void QsMemory::setBlockNoiseBlankerOn(bool value, int rx_num) { m_block_nb_switch[rx_num] = value; }
+void QsMemory::setBlockNoiseBlankerOn(bool value, int rx_num) {
+    m_block_nb_switch[rx_num] = value;
+    publish(pgNoiseBlanker, rx_num);
+}
 
 bool QsMemory::getBlockNoiseBlankerOn(int rx_num) { return m_block_nb_switch[rx_num]; }
 
@@ -314,50 +480,101 @@ bool QsMemory::getBlockNoiseBlankerOn(int rx_num) { return m_block_nb_switch[rx_
 //--------------------AUTO NOTCH---------------------//
 //***************************************************//
 
-void QsMemory::setAutoNotchOn(bool value, int rx_num) { m_autonotch_switch[rx_num] = value; }
+void QsMemory::setAutoNotchOn(bool value, int rx_num) {
+    m_autonotch_switch[rx_num] = value;
+    publish(pgAutoNotch, rx_num);
+}
 
 bool QsMemory::getAutoNotchOn(int rx_num) { return m_autonotch_switch[rx_num]; }
 
-void QsMemory::setAutoNotchRate(double value, int rx_num) { m_autonotch_rate[rx_num] = value; }
+void QsMemory::setAutoNotchRate(double value, int rx_num) {
+    m_autonotch_rate[rx_num] = value;
+    publish(pgAutoNotch, rx_num);
+}
 
 double QsMemory::getAutoNotchRate(int rx_num) { return m_autonotch_rate[rx_num]; }
 
-void QsMemory::setAutoNotchLeak(double value, int rx_num) { m_autonotch_leak[rx_num] = value; }
+void QsMemory::setAutoNotchLeak(double value, int rx_num) {
+    m_autonotch_leak[rx_num] = value;
+    publish(pgAutoNotch, rx_num);
+}
 
 double QsMemory::getAutoNotchLeak(int rx_num) { return m_autonotch_leak[rx_num]; }
 
-void QsMemory::setAutoNotchDelay(int value, int rx_num) { m_autonotch_delay[rx_num] = value; }
+void QsMemory::setAutoNotchDelay(int value, int rx_num) {
+    m_autonotch_delay[rx_num] = value;
+    publish(pgAutoNotch, rx_num);
+}
 
 int QsMemory::getAutoNotchDelay(int rx_num) { return m_autonotch_delay[rx_num]; }
 
-void QsMemory::setAutoNotchTaps(int value, int rx_num) { m_autonotch_taps[rx_num] = value; }
+void QsMemory::setAutoNotchTaps(int value, int rx_num) {
+    m_autonotch_taps[rx_num] = value;
+    publish(pgAutoNotch, rx_num);
+}
 
 int QsMemory::getAutoNotchTaps(int rx_num) { return m_autonotch_taps[rx_num]; }
 
+void QsMemory::setAutoNotchAlgorithm(int value, int rx_num) {
+    m_autonotch_alg[rx_num] = value;
+    publish(pgAutoNotch, rx_num);
+}
+
+int QsMemory::getAutoNotchAlgorithm(int rx_num) { return m_autonotch_alg[rx_num]; }
+
 //***************************************************//
 //------------------NOISE REDUCTION------------------//
 //***************************************************//
 
-void QsMemory::setNoiseReductionOn(bool value, int rx_num) { m_noise_reduction_switch[rx_num] = value; }
+void QsMemory::setNoiseReductionOn(bool value, int rx_num) {
+    m_noise_reduction_switch[rx_num] = value;
+    publish(pgNoiseReduction, rx_num);
+}
 
 bool QsMemory::getNoiseReductionOn(int rx_num) { return m_noise_reduction_switch[rx_num]; }
 
-void QsMemory::setNoiseReductionRate(double value, int rx_num) { m_noise_reduction_rate[rx_num] = value; }
+void QsMemory::setNoiseReductionRate(double value, int rx_num) {
+    m_noise_reduction_rate[rx_num] = value;
+    publish(pgNoiseReduction, rx_num);
+}
 
 double QsMemory::getNoiseReductionRate(int rx_num) { return m_noise_reduction_rate[rx_num]; }
 
-void QsMemory::setNoiseReductionLeak(double value, int rx_num) { m_noise_reduction_leak[rx_num] = value; }
+void QsMemory::setNoiseReductionLeak(double value, int rx_num) {
+    m_noise_reduction_leak[rx_num] = value;
+    publish(pgNoiseReduction, rx_num);
+}
 
 double QsMemory::getNoiseReductionLeak(int rx_num) { return m_noise_reduction_leak[rx_num]; }
 
-void QsMemory::setNoiseReductionDelay(int value, int rx_num) { m_noise_reduction_delay[rx_num] = value; }
+void QsMemory::setNoiseReductionDelay(int value, int rx_num) {
+    m_noise_reduction_delay[rx_num] = value;
+    publish(pgNoiseReduction, rx_num);
+}
 
 int QsMemory::getNoiseReductionDelay(int rx_num) { return m_noise_reduction_delay[rx_num]; }
 
-void QsMemory::setNoiseReductionTaps(int value, int rx_num) { m_noise_reduction_taps[rx_num] = value; }
+void QsMemory::setNoiseReductionTaps(int value, int rx_num) {
+    m_noise_reduction_taps[rx_num] = value;
+    publish(pgNoiseReduction, rx_num);
+}
 
 int QsMemory::getNoiseReductionTaps(int rx_num) { return m_noise_reduction_taps[rx_num]; }
 
+void QsMemory::setNoiseReductionMode(int value, int rx_num) {
+    m_noise_reduction_mode[rx_num] = value;
+    publish(pgNoiseReduction, rx_num);
+}
+
+int QsMemory::getNoiseReductionMode(int rx_num) { return m_noise_reduction_mode[rx_num]; }
+
+void QsMemory::setNoiseReductionAlgorithm(int value, int rx_num) {
+    m_noise_reduction_alg[rx_num] = value;
+    publish(pgNoiseReduction, rx_num);
+}
+
+int QsMemory::getNoiseReductionAlgorithm(int rx_num) { return m_noise_reduction_alg[rx_num]; }
+
 //***************************************************//
 //-------------------S METER  -----------------------//
 //***************************************************//
@@ -373,11 +590,17 @@ unsigned char QsMemory::getSMeterCurrentValueC(int rx_num) { return m_s_meter_cv
 //***************************************************//
 //---------------------SQUELCH-----------------------//
 //***************************************************//
-void QsMemory::setSquelchOn(bool value, int rx_num) { m_squelch_switch[rx_num] = value; }
+void QsMemory::setSquelchOn(bool value, int rx_num) {
+    m_squelch_switch[rx_num] = value;
+    publish(pgSquelch, rx_num);
+}
 
 bool QsMemory::getSquelchOn(int rx_num) { return m_squelch_switch[rx_num]; }
 
-void QsMemory::setSquelchThreshold(double value, int rx_num) { m_squelch_threshold[rx_num] = value; }
+void QsMemory::setSquelchThreshold(double value, int rx_num) {
+    m_squelch_threshold[rx_num] = value;
+    publish(pgSquelch, rx_num);
+}
 
 double QsMemory::getSquelchThreshold(int rx_num) { return m_squelch_threshold[rx_num]; }
 
@@ -400,15 +623,24 @@ double QsMemory::getDisplayFreqOffset(int rx_num) { return m_display_freq_offset
 //***************************************************//
 //---------------------NOTCH-------------------------//
 //***************************************************//
-void QsMemory::setNotchFrequency(int number, float f0, int rx_num) { m_notch_frequency[rx_num][number] = f0; }
+void QsMemory::setNotchFrequency(int number, float f0, int rx_num) {
+    m_notch_frequency[rx_num][number] = f0;
+    publish(pgNotch, rx_num);
+}
 
 float QsMemory::getNotchFrequency(int number, int rx_num) { return m_notch_frequency[rx_num][number]; }
 
-void QsMemory::setNotchBandwidth(int number, float hz, int rx_num) { m_notch_bandwidth[rx_num][number] = hz; }
+void QsMemory::setNotchBandwidth(int number, float hz, int rx_num) {
+    m_notch_bandwidth[rx_num][number] = hz;
+    publish(pgNotch, rx_num);
+}
 
 float QsMemory::getNotchBandwidth(int number, int rx_num) { return m_notch_bandwidth[rx_num][number]; }
 
-void QsMemory::setNotchEnabled(int number, bool value, int rx_num) { m_notch_enabled[rx_num][number] = value; }
+void QsMemory::setNotchEnabled(int number, bool value, int rx_num) {
+    m_notch_enabled[rx_num][number] = value;
+    publish(pgNotch, rx_num);
+}
 
 bool QsMemory::getNotchEnabled(int number, int rx_num) { return m_notch_enabled[rx_num][number]; }
 
@@ -416,7 +648,10 @@ bool QsMemory::getNotchEnabled(int number, int rx_num) { return m_notch_enabled[
 //-------------------PS CORRECTIONS------------------//
 //***************************************************//
 
-void QsMemory::setSMeterCorrection(double value) { m_smeter_correction = value; }
+void QsMemory::setSMeterCorrection(double value) {
+    m_smeter_correction = value;
+    publish(pgSMeter);
+}
 
 double QsMemory::getSMeterCorrection() { return m_smeter_correction; }
 
@@ -528,6 +763,14 @@ void QsMemory::setResamplerQuality(int value) { m_resampler_quality = value; }
 
 int QsMemory::getResamplerQuality() { return m_resampler_quality; }
 
+//***************************************************//
+//---------------FRONT END THREADS-------------------//
+//***************************************************//
+
+void QsMemory::setFrontEndThreads(int value) { m_fe_threads = std::max(1, value); }
+
+int QsMemory::getFrontEndThreads() { return m_fe_threads; }
+
 //***************************************************//
 //------------------RESAMPLER RATE-------------------//
 //***************************************************//
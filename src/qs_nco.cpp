@@ -0,0 +1,128 @@
+#include "../include/qs_nco.hpp"
+#include "../include/qs_globals.hpp"
+
+#include <algorithm>
+#include <cmath>
+
+// phase = coarse (top 10 bits) + fine (next 10 bits) + residual (low 12 bits)
+#define NCO_TABLE_BITS 10
+#define NCO_TABLE_SIZE (1 << NCO_TABLE_BITS)
+#define NCO_RESIDUAL_BITS (32 - 2 * NCO_TABLE_BITS)
+
+namespace {
+
+struct NcoTables {
+    double coarse_re[NCO_TABLE_SIZE];
+    double coarse_im[NCO_TABLE_SIZE];
+    double fine_re[NCO_TABLE_SIZE];
+    double fine_im[NCO_TABLE_SIZE];
+
+    NcoTables() {
+        for (int i = 0; i < NCO_TABLE_SIZE; i++) {
+            double coarse = TWO_PI * i / NCO_TABLE_SIZE;
+            double fine = TWO_PI * i / (static_cast<double>(NCO_TABLE_SIZE) * NCO_TABLE_SIZE);
+            coarse_re[i] = cos(coarse);
+            coarse_im[i] = sin(coarse);
+            fine_re[i] = cos(fine);
+            fine_im[i] = sin(fine);
+        }
+    }
+};
+
+const NcoTables &ncoTables() {
+    static const NcoTables tables;
+    return tables;
+}
+
+} // namespace
+
+QsNco::QsNco() : m_freq(0.0), m_rate(1.0), m_amplitude(1.0), m_inc(0), m_phase(0), m_index(0) { buildTable(); }
+
+void QsNco::setFrequency(double freq, double rate) {
+    m_freq = freq;
+    m_rate = rate;
+    // cycles per sample, wrapped to [0, 1) and scaled to the accumulator
+    double cycles = freq / rate;
+    cycles -= floor(cycles);
+    m_inc = static_cast<uint32_t>(static_cast<uint64_t>(llround(cycles * 4294967296.0)));
+    buildTable();
+}
+
+void QsNco::setAmplitude(double amplitude) { m_amplitude = amplitude; }
+
+void QsNco::buildTable() {
+    // rotations by the quantised increment, so the table agrees with the
+    // accumulator exactly at every chunk start
+    double w = TWO_PI * static_cast<double>(m_inc) / 4294967296.0;
+    for (int k = 0; k < QS_NCO_CHUNK; k++) {
+        m_tab_re[k] = static_cast<float>(cos(w * k));
+        m_tab_im[k] = static_cast<float>(sin(w * k));
+    }
+}
+
+void QsNco::basePhasor(Cursor at, float &re, float &im) const {
+    const NcoTables &t = ncoTables();
+    uint32_t phase = at.phase - m_inc * (at.index & (QS_NCO_CHUNK - 1));
+
+    int c = phase >> (32 - NCO_TABLE_BITS);
+    int f = (phase >> NCO_RESIDUAL_BITS) & (NCO_TABLE_SIZE - 1);
+    double r = TWO_PI * (phase & ((1u << NCO_RESIDUAL_BITS) - 1)) / 4294967296.0;
+
+    double cf_re = t.coarse_re[c] * t.fine_re[f] - t.coarse_im[c] * t.fine_im[f];
+    double cf_im = t.coarse_im[c] * t.fine_re[f] + t.coarse_re[c] * t.fine_im[f];
+    // e^(jr) ~ 1 + jr - r^2/2; r < 6e-6 so the next term is below 1e-16
+    double r_re = 1.0 - 0.5 * r * r;
+    re = static_cast<float>(m_amplitude * (cf_re * r_re - cf_im * r));
+    im = static_cast<float>(m_amplitude * (cf_im * r_re + cf_re * r));
+}
+
+void QsNco::mix(Cpx *src_dst, int length) {
+    mix(src_dst, src_dst, length, cursor());
+    advance(length);
+}
+
+void QsNco::mix(const Cpx *src, Cpx *dst, int length, Cursor at) const {
+    const float *in = reinterpret_cast<const float *>(src);
+    float *out = reinterpret_cast<float *>(dst);
+    int i = 0;
+    while (i < length) {
+        Cursor c = cursor(at, i);
+        int k0 = c.index & (QS_NCO_CHUNK - 1);
+        int n = std::min(QS_NCO_CHUNK - k0, length - i);
+        float b_re, b_im;
+        basePhasor(c, b_re, b_im);
+
+        const float *t_re = m_tab_re + k0;
+        const float *t_im = m_tab_im + k0;
+        const float *x = in + 2 * i;
+        float *y = out + 2 * i;
+        for (int k = 0; k < n; k++) {
+            float o_re = b_re * t_re[k] - b_im * t_im[k];
+            float o_im = b_re * t_im[k] + b_im * t_re[k];
+            float x_re = x[2 * k];
+            float x_im = x[2 * k + 1];
+            y[2 * k] = x_re * o_re - x_im * o_im;
+            y[2 * k + 1] = x_re * o_im + x_im * o_re;
+        }
+        i += n;
+    }
+}
+
+void QsNco::generate(float *re, float *im, int length, Cursor at) const {
+    int i = 0;
+    while (i < length) {
+        Cursor c = cursor(at, i);
+        int k0 = c.index & (QS_NCO_CHUNK - 1);
+        int n = std::min(QS_NCO_CHUNK - k0, length - i);
+        float b_re, b_im;
+        basePhasor(c, b_re, b_im);
+
+        const float *t_re = m_tab_re + k0;
+        const float *t_im = m_tab_im + k0;
+        for (int k = 0; k < n; k++) {
+            re[i + k] = b_re * t_re[k] - b_im * t_im[k];
+            im[i + k] = b_re * t_im[k] + b_im * t_re[k];
+        }
+        i += n;
+    }
+}
@@ -82,99 +82,60 @@
 
 #include "../include/qs_nr_filter.hpp"
 
-QsNoiseReductionFilter::QsNoiseReductionFilter()
-    : m_nr_switch(false), m_nr_lms_sz(0), m_nr_delay(0), m_nr_dl_indx(0), m_nr_mask(0), m_nr_adapt_rate(0),
-      m_nr_leakage(0), m_nr_adapt_size(0) {}
+QsNoiseReductionFilter::QsNoiseReductionFilter() : m_nr_switch(false), m_version(0), m_nr_adapt_rate(0), m_nr_leakage(0) {}
 
 void QsNoiseReductionFilter::init(unsigned int size) {
-    m_nr_lms_sz = size;
-    m_nr_mask = m_nr_lms_sz - 1;
+    // Scratch for the real parts and the prediction
+    m_nr_in.resize(size);
+    m_nr_out.resize(size);
 
     // Initialize filter parameters from global memory
-    m_nr_switch = QsGlobal::g_memory->getNoiseReductionOn();
-    m_nr_adapt_rate = QsGlobal::g_memory->getNoiseReductionRate();
-    m_nr_leakage = QsGlobal::g_memory->getNoiseReductionLeak();
-    m_nr_adapt_size = QsGlobal::g_memory->getNoiseReductionTaps();
-    m_nr_delay = QsGlobal::g_memory->getNoiseReductionDelay();
-    m_nr_dl_indx = 0;
-
-    // Resize and zero-initialize the delay line and coefficients
-    m_nr_delay_line.resize(m_nr_lms_sz);
-    QsSignalOps::Zero(m_nr_delay_line);
-    m_nr_coeff.resize(m_nr_lms_sz * 2); // Allocating twice the size for future flexibility
-    QsSignalOps::Zero(m_nr_coeff);
+    m_version = 0;
+    update(QsGlobal::g_memory->params());
+    m_nr_engine.reset();
+}
+
+void QsNoiseReductionFilter::update(const QsDspParams &params) {
+    if (params.version[pgNoiseReduction] == m_version)
+        return;
+    m_version = params.version[pgNoiseReduction];
+
+    // spectral NR runs in the main filter
+    m_nr_switch = params.nr_on && params.nr_mode == nrLms;
+    m_nr_adapt_rate = params.nr_rate;
+    m_nr_leakage = params.nr_leak;
+    m_nr_engine.setRate(m_nr_adapt_rate, m_nr_leakage);
+
+    // The engine restarts itself when taps or delay change
+    m_nr_engine.configure(static_cast<QSADAPTALG>(params.nr_alg), params.nr_taps, params.nr_delay);
 }
 
 void QsNoiseReductionFilter::process(qs_vect_cpx &src_dst) {
-    // Fetch updated noise reduction switch state
-    m_nr_switch = QsGlobal::g_memory->getNoiseReductionOn();
+    int length = static_cast<int>(src_dst.size());
+    if (static_cast<int>(m_nr_in.size()) < length)
+        m_nr_in.resize(length);
+
+    for (int i = 0; i < length; i++)
+        m_nr_in[i] = src_dst[i].real();
 
+    if (process(m_nr_in.data(), length)) {
+        for (int i = 0; i < length; i++)
+            src_dst[i] = Cpx(m_nr_in[i], m_nr_in[i]);
+    }
+}
+
+bool QsNoiseReductionFilter::process(float *src_dst, int length) {
     if (m_nr_switch) {
-        // Fetch updated parameters if noise reduction is enabled
-        m_nr_adapt_rate = QsGlobal::g_memory->getNoiseReductionRate();
-        m_nr_leakage = QsGlobal::g_memory->getNoiseReductionLeak();
-
-        // Adapt filter size if the input size has changed
-        if (m_nr_lms_sz != src_dst.size()) {
-            m_nr_lms_sz = src_dst.size();
-            m_nr_mask = m_nr_lms_sz - 1;
-            m_nr_delay_line.resize(m_nr_lms_sz);
-            QsSignalOps::Zero(m_nr_delay_line);
-            m_nr_coeff.resize(m_nr_lms_sz * 2);
-            QsSignalOps::Zero(m_nr_coeff);
-        }
-
-        // Update filter taps if the number of adaptive taps has changed
-        unsigned int new_adapt_size = QsGlobal::g_memory->getNoiseReductionTaps();
-        if (m_nr_adapt_size != new_adapt_size) {
-            m_nr_adapt_size = new_adapt_size;
-            m_nr_dl_indx = 0;
-            QsSignalOps::Zero(m_nr_delay_line);
-            QsSignalOps::Zero(m_nr_coeff);
-        }
-
-        // Update delay if the noise reduction delay has changed
-        unsigned int new_delay = QsGlobal::g_memory->getNoiseReductionDelay();
-        if (m_nr_delay != new_delay) {
-            m_nr_delay = new_delay;
-            m_nr_dl_indx = 0;
-            QsSignalOps::Zero(m_nr_delay_line);
-            QsSignalOps::Zero(m_nr_coeff);
-        }
-
-        // Precompute scaling factor for coefficient leakage
-        double scl1 = 1.0 - m_nr_adapt_rate * m_nr_leakage;
-
-        // Process each sample in the input/output vector
-        for (auto &sample : src_dst) {
-            // Update the delay line with the current sample's real part
-            m_nr_delay_line[m_nr_dl_indx] = sample.real();
-            double accum = 0.0;
-            double sum_sq = 0.0;
-
-            // Compute the output based on adaptive coefficients and delay line
-            for (unsigned int j = 0; j < m_nr_adapt_size; j++) {
-                unsigned int k = (j + m_nr_delay + m_nr_dl_indx) & m_nr_mask;
-                sum_sq += m_nr_delay_line[k] * m_nr_delay_line[k];
-                accum += m_nr_coeff[j] * m_nr_delay_line[k];
-            }
-
-            // Compute the error and apply scaling
-            double error = sample.real() - accum;
-            double out = accum * 1.5; // Apply gain to the accumulated value
-            sample = Cpx(out, out);   // Set real and imaginary parts to the same value
-
-            // Adaptive update of coefficients
-            double scl2 = m_nr_adapt_rate / (sum_sq + 1e-10); // Prevent division by zero
-            error *= scl2;
-
-            for (unsigned int j = 0; j < m_nr_adapt_size; j++) {
-                unsigned int k = (j + m_nr_delay + m_nr_dl_indx) & m_nr_mask;
-                m_nr_coeff[j] = m_nr_coeff[j] * scl1 + error * m_nr_delay_line[k];
-            }
-
-            // Update delay line index
-            m_nr_dl_indx = (m_nr_dl_indx + 1) & m_nr_mask;
-        }
+        if (static_cast<int>(m_nr_out.size()) < length)
+            m_nr_out.resize(length);
+
+        m_nr_engine.process(src_dst, m_nr_out.data(), nullptr, length);
+
+        // Keep the correlated part of the signal, with the original 1.5 gain
+        for (int i = 0; i < length; i++)
+            src_dst[i] = m_nr_out[i] * 1.5f;
     }
+    return m_nr_switch;
 }
+
+void QsNoiseReductionFilter::hold() { m_nr_engine.clearHistory(); }
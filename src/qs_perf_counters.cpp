@@ -0,0 +1,250 @@
+#include "../include/qs_perf_counters.hpp"
+#include "../include/qs_alloc_guard.hpp"
+#include "../include/qs_debugloggerclass.hpp"
+
+#include <algorithm>
+#include <cerrno>
+#include <cstdio>
+#include <cstring>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/ioctl.h>
+#include <sys/syscall.h>
+#include <unistd.h>
+#endif
+
+#define PERF_SLOTS (peCount + 1) // the counters, then samples
+
+#ifdef __linux__
+static const struct {
+    uint32_t type;
+    uint64_t config;
+} PERF_EVENTS[peCount] = {
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CPU_CYCLES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_INSTRUCTIONS},
+    {PERF_TYPE_HW_CACHE, PERF_COUNT_HW_CACHE_L1D | (PERF_COUNT_HW_CACHE_OP_READ << 8) |
+                             (PERF_COUNT_HW_CACHE_RESULT_MISS << 16)},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_CACHE_MISSES},
+    {PERF_TYPE_HARDWARE, PERF_COUNT_HW_BRANCH_MISSES},
+};
+#endif
+
+QsPerfCounters::QsPerfCounters(const char *const *names, int stages)
+    : m_enabled(false), m_reset(false), m_errno(0), m_present(0), m_names(names), m_stages(stages),
+      m_sum(new std::atomic<uint64_t>[stages * PERF_SLOTS]) {
+    for (int i = 0; i < peCount; i++) {
+        m_fd[i] = -1;
+        m_id[i] = 0;
+        m_last[i] = 0;
+    }
+    clear();
+}
+
+QsPerfCounters::~QsPerfCounters() { close(); }
+
+void QsPerfCounters::setEnabled(bool value) {
+    // a new request retries an open that failed
+    if (value)
+        m_errno.store(0, std::memory_order_relaxed);
+    m_enabled.store(value, std::memory_order_relaxed);
+}
+
+std::string QsPerfCounters::error() const {
+    int err = m_errno.load(std::memory_order_relaxed);
+    switch (err) {
+    case 0:
+        return "";
+    case EACCES:
+    case EPERM:
+        return "not permitted (kernel.perf_event_paranoid)";
+    case ENOENT:
+    case ENODEV:
+    case EOPNOTSUPP:
+        return "no hardware counters";
+    case ENOSYS:
+        return "perf events not supported";
+    default:
+        return std::strerror(err);
+    }
+}
+
+bool QsPerfCounters::sync() {
+    bool want = enabled();
+    if (want && !active() && m_errno.load(std::memory_order_relaxed) == 0) {
+        if (!open()) {
+            QsAllocGuard::Pause pause;
+            _debug() << "perf counters unavailable: " << error();
+        }
+    } else if (!want && active()) {
+        close();
+    }
+    if (m_reset.exchange(false, std::memory_order_relaxed))
+        clear();
+    return active();
+}
+
+bool QsPerfCounters::open() {
+#ifdef __linux__
+    unsigned present = 0;
+    for (int i = 0; i < peCount; i++) {
+        perf_event_attr attr;
+        std::memset(&attr, 0, sizeof(attr));
+        attr.size = sizeof(attr);
+        attr.type = PERF_EVENTS[i].type;
+        attr.config = PERF_EVENTS[i].config;
+        attr.disabled = i == peCycles ? 1 : 0; // the leader starts the group
+        attr.exclude_kernel = 1;
+        attr.exclude_hv = 1;
+        attr.read_format = PERF_FORMAT_GROUP | PERF_FORMAT_ID;
+
+        // this thread, any CPU
+        int fd = static_cast<int>(syscall(SYS_perf_event_open, &attr, 0, -1, m_fd[peCycles], PERF_FLAG_FD_CLOEXEC));
+        if (fd < 0) {
+            if (i == peCycles) {
+                m_errno.store(errno, std::memory_order_relaxed);
+                return false;
+            }
+            continue; // a counter this CPU lacks
+        }
+        if (ioctl(fd, PERF_EVENT_IOC_ID, &m_id[i]) < 0) {
+            ::close(fd);
+            if (i == peCycles) {
+                m_errno.store(errno, std::memory_order_relaxed);
+                return false;
+            }
+            continue;
+        }
+        m_fd[i] = fd;
+        present |= 1u << i;
+    }
+    m_present.store(present, std::memory_order_relaxed);
+
+    ioctl(m_fd[peCycles], PERF_EVENT_IOC_RESET, PERF_IOC_FLAG_GROUP);
+    ioctl(m_fd[peCycles], PERF_EVENT_IOC_ENABLE, PERF_IOC_FLAG_GROUP);
+    read(m_last);
+    return true;
+#else
+    m_errno.store(ENOSYS, std::memory_order_relaxed);
+    return false;
+#endif
+}
+
+void QsPerfCounters::close() {
+#ifdef __linux__
+    // members first, the leader last
+    for (int i = peCount - 1; i >= 0; i--) {
+        if (m_fd[i] >= 0)
+            ::close(m_fd[i]);
+        m_fd[i] = -1;
+    }
+#endif
+}
+
+bool QsPerfCounters::read(uint64_t *values) {
+#ifdef __linux__
+    // nr, then a value and id per counter
+    uint64_t buf[1 + 2 * peCount];
+    if (::read(m_fd[peCycles], buf, sizeof(buf)) < static_cast<ssize_t>(sizeof(uint64_t)))
+        return false;
+    uint64_t nr = std::min<uint64_t>(buf[0], peCount);
+    for (uint64_t j = 0; j < nr; j++) {
+        for (int i = 0; i < peCount; i++) {
+            if (m_fd[i] >= 0 && m_id[i] == buf[2 + 2 * j]) {
+                values[i] = buf[1 + 2 * j];
+                break;
+            }
+        }
+    }
+    return true;
+#else
+    (void)values;
+    return false;
+#endif
+}
+
+void QsPerfCounters::mark() { read(m_last); }
+
+void QsPerfCounters::lap(int stage, uint64_t samples) {
+    uint64_t now[peCount];
+    for (int i = 0; i < peCount; i++)
+        now[i] = m_last[i];
+    if (!read(now))
+        return;
+    for (int i = 0; i < peCount; i++) {
+        add(stage, i, now[i] - m_last[i]);
+        m_last[i] = now[i];
+    }
+    add(stage, peCount, samples);
+}
+
+void QsPerfCounters::addSamples(int stage, uint64_t samples) { add(stage, peCount, samples); }
+
+void QsPerfCounters::add(int stage, int slot, uint64_t value) {
+    // one writer: a plain add, published for report()
+    std::atomic<uint64_t> &sum = m_sum[stage * PERF_SLOTS + slot];
+    sum.store(sum.load(std::memory_order_relaxed) + value, std::memory_order_relaxed);
+}
+
+void QsPerfCounters::clear() {
+    for (int i = 0; i < m_stages * PERF_SLOTS; i++)
+        m_sum[i].store(0, std::memory_order_relaxed);
+}
+
+std::vector<QsPerfCounters::Row> QsPerfCounters::rows() const {
+    unsigned present = m_present.load(std::memory_order_relaxed);
+
+    std::vector<Row> rows;
+    for (int s = 0; s < m_stages; s++) {
+        const std::atomic<uint64_t> *sum = &m_sum[s * PERF_SLOTS];
+        uint64_t samples = sum[peCount].load(std::memory_order_relaxed);
+        if (samples == 0)
+            continue;
+        double v[peCount];
+        for (int i = 0; i < peCount; i++)
+            v[i] = present & (1u << i) ? static_cast<double>(sum[i].load(std::memory_order_relaxed)) : -1.0;
+
+        Row row;
+        row.name = m_names[s];
+        row.samples = samples;
+        row.cycles = v[peCycles] >= 0.0 ? v[peCycles] / samples : -1.0;
+        row.ipc = v[peCycles] > 0.0 && v[peInstructions] >= 0.0 ? v[peInstructions] / v[peCycles] : -1.0;
+        row.l1d_misses = v[peL1dMisses] >= 0.0 ? v[peL1dMisses] / samples : -1.0;
+        row.llc_misses = v[peLlcMisses] >= 0.0 ? v[peLlcMisses] / samples : -1.0;
+        row.branch_misses = v[peBranchMisses] >= 0.0 ? v[peBranchMisses] / samples : -1.0;
+        rows.push_back(row);
+    }
+    return rows;
+}
+
+static void appendValue(std::string &out, const char *label, double value, const char *format) {
+    char buf[32];
+    if (value < 0.0)
+        std::snprintf(buf, sizeof(buf), " %s -", label);
+    else
+        std::snprintf(buf, sizeof(buf), format, label, value);
+    out += buf;
+}
+
+std::string QsPerfCounters::report() const {
+    std::string err = error();
+    if (!err.empty())
+        return "unavailable: " + err;
+
+    std::vector<Row> all = rows();
+    if (all.empty())
+        return enabled() ? "no samples" : "off";
+
+    std::string out;
+    for (const Row &row : all) {
+        if (!out.empty())
+            out += ", ";
+        out += row.name;
+        appendValue(out, "cyc", row.cycles, " %s %.2f");
+        appendValue(out, "ipc", row.ipc, " %s %.2f");
+        appendValue(out, "l1d", row.l1d_misses, " %s %.4f");
+        appendValue(out, "llc", row.llc_misses, " %s %.4f");
+        appendValue(out, "br", row.branch_misses, " %s %.4f");
+    }
+    return out;
+}
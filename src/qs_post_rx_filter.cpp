@@ -1,7 +1,9 @@
 #include "../include/qs_post_rx_filter.hpp"
+#include "../include/qs_arena.hpp"
+#include "../include/qs_trace.hpp"
 
 QsPostRxFilter::QsPostRxFilter()
-    : m_size(4096), m_samplerate(62500), m_filter_lo(100), m_filter_hi(3000.0), m_one_over_norm(1.0 / (m_size * 2.0)),
+    : m_size(4096), m_samplerate(62500), m_filter_lo(100), m_filter_hi(3000.0), m_version(0), m_one_over_norm(1.0 / (m_size * 2.0)),
       p_ovlpfft(new QsFFT()), p_filtfft(new QsFFT()) {}
 
 void QsPostRxFilter::init(int size) {
@@ -11,8 +13,10 @@ void QsPostRxFilter::init(int size) {
     p_ovlpfft->resize(m_size * 2);
     p_filtfft->resize(m_size * 2);
 
-    m_filter_lo = QsGlobal::g_memory->getFilterLo();
-    m_filter_hi = QsGlobal::g_memory->getFilterHi();
+    const QsDspParams params = QsGlobal::g_memory->params();
+    m_filter_lo = params.filter_lo;
+    m_filter_hi = params.filter_hi;
+    m_version = params.version[pgFilter];
 
     m_one_over_norm = 1.0 / (m_size * 2.0);
 
@@ -35,13 +39,18 @@ void QsPostRxFilter::init(int size) {
     MakeFilter(m_filter_lo, m_filter_hi);
 }
 
-void QsPostRxFilter::process(qs_vect_cpx &src_dst) {
-    if (m_filter_lo != QsGlobal::g_memory->getFilterLo() || m_filter_hi != QsGlobal::g_memory->getFilterHi()) {
-        m_filter_lo = QsGlobal::g_memory->getFilterLo();
-        m_filter_hi = QsGlobal::g_memory->getFilterHi();
+void QsPostRxFilter::update(const QsDspParams &params) {
+    if (params.version[pgFilter] == m_version)
+        return;
+    m_version = params.version[pgFilter];
+    if (m_filter_lo != params.filter_lo || m_filter_hi != params.filter_hi) {
+        m_filter_lo = params.filter_lo;
+        m_filter_hi = params.filter_hi;
         MakeFilter(m_filter_lo, m_filter_hi);
     }
+}
 
+void QsPostRxFilter::process(qs_vect_cpx &src_dst) {
     QsSignalOps::Zero(&cpx_0[0] + m_size, m_size);
     QsSignalOps::Copy(&src_dst[0], &cpx_0[0], m_size);
 
@@ -58,6 +67,7 @@ void QsPostRxFilter::process(qs_vect_cpx &src_dst) {
 }
 
 void QsPostRxFilter::MakeFilter(float lo, float hi) {
+    QsTrace::Span span("postfir design");
     QsSignalOps::Zero(&filt_cpx0[0], m_size * 2);
 
     MakeFirBandpass(lo, hi, m_samplerate, 12, tmpfilt0_re, tmpfilt0_im, m_size);
@@ -68,8 +78,10 @@ void QsPostRxFilter::MakeFilter(float lo, float hi) {
 
 void QsPostRxFilter::MakeFirBandpass(float lo, float hi, float samplerate, int wtype, qs_vect_f &taps_re,
                                       qs_vect_f &taps_im, int length) {
-    qs_vect_f window;
-    window.resize(length);
+    // scratch from the thread's arena: this runs on the DSP thread when the
+    // filter edges move
+    QsArena::Scope scratch;
+    float *window = scratch.alloc<float>(length);
 
     float fl = lo / samplerate;
     float fh = hi / samplerate;
@@ -96,8 +108,8 @@ void QsPostRxFilter::MakeFirBandpass(float lo, float hi, float samplerate, int w
 }
 
 void QsPostRxFilter::MakeWindow(int wtype, int size, qs_vect_cpx &window) {
-    qs_vect_f fwindow;
-    fwindow.resize(size);
+    QsArena::Scope scratch;
+    float *fwindow = scratch.alloc<float>(size);
     MakeWindow(wtype, size, fwindow);
     for (int i = 0; i < size; i++) {
         window[i] = Cpx(fwindow[i], fwindow[i]); // Assign both real and imag from fwindow[i]
@@ -113,7 +125,9 @@ qs_vect_cpx QsPostRxFilter::MakeWindowComplex(int wtype, int size) {
     return window;
 }
 
-void QsPostRxFilter::MakeWindow(int wtype, int size, qs_vect_f &window) {
+void QsPostRxFilter::MakeWindow(int wtype, int size, qs_vect_f &window) { MakeWindow(wtype, size, &window[0]); }
+
+void QsPostRxFilter::MakeWindow(int wtype, int size, float *window) {
     int i, j, midn, midp1, midm1;
     float freq, rate, sr1, angle, expn, expsum, cx, two_pi;
 
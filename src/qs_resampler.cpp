@@ -1,32 +1,228 @@
-#include "../include/qs_resampler.hpp" // Include the header file for the class
+#include "../include/qs_resampler.hpp"
+#include "../include/qs_globals.hpp"
+#include "../include/qs_signalops.hpp"
 
-Resampler::Resampler(int src_rate, int dest_rate) {
-    int error;
-    src_state = src_new(SRC_SINC_BEST_QUALITY, 1, &error); // Mono
-    if (!src_state) {
-        throw std::runtime_error("Error initializing resampler: " + std::string(src_strerror(error)));
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <numeric>
+#include <stdexcept>
+#include <string>
+
+#define RS_MAX_PHASES 4096
+#define RS_RATE_SCALE 4.0 // rates resolved to a quarter hertz
+
+// quality tier: stopband attenuation in dB, passband edge as a fraction of
+// half the lower rate
+static const double rs_tier_db[] = {60.0, 80.0, 100.0, 120.0};
+static const double rs_tier_passband[] = {0.70, 0.80, 0.85, 0.90};
+static const int rs_tiers = 4;
+
+static double besselI0(double x) {
+    double sum = 1.0;
+    double term = 1.0;
+    for (int k = 1; k < 64; k++) {
+        term *= (x / (2.0 * k)) * (x / (2.0 * k));
+        sum += term;
+        if (term < sum * 1e-16)
+            break;
+    }
+    return sum;
+}
+
+// Two channels against the same phase, coefficients loaded once.
+static inline void dotProduct2(const float *c, const float *xl, const float *xr, int n, float &yl, float &yr) {
+    qs_v4f accl0 = {0.0f, 0.0f, 0.0f, 0.0f};
+    qs_v4f accl1 = accl0, accr0 = accl0, accr1 = accl0;
+    for (int i = 0; i < n; i += 8) {
+        qs_v4f c0, c1, x0, x1;
+        memcpy(&c0, c + i, sizeof(qs_v4f));
+        memcpy(&c1, c + i + 4, sizeof(qs_v4f));
+        memcpy(&x0, xl + i, sizeof(qs_v4f));
+        memcpy(&x1, xl + i + 4, sizeof(qs_v4f));
+        accl0 += c0 * x0;
+        accl1 += c1 * x1;
+        memcpy(&x0, xr + i, sizeof(qs_v4f));
+        memcpy(&x1, xr + i + 4, sizeof(qs_v4f));
+        accr0 += c0 * x0;
+        accr1 += c1 * x1;
     }
-    src_ratio = static_cast<float>(dest_rate) / src_rate;
+    qs_v4f sl = accl0 + accl1;
+    qs_v4f sr = accr0 + accr1;
+    yl = (sl[0] + sl[2]) + (sl[1] + sl[3]);
+    yr = (sr[0] + sr[2]) + (sr[1] + sr[3]);
+}
+
+Resampler::Resampler(double src_rate, double dest_rate, int quality)
+    : m_interp(1), m_decim(1), m_taps(0), m_phase(0), m_offset(0) {
+    if (src_rate <= 0.0 || dest_rate <= 0.0)
+        throw std::runtime_error("Error initializing resampler: invalid rate");
+
+    if (!ratioSupported(src_rate, dest_rate))
+        throw std::runtime_error("Error initializing resampler: no rational ratio for " + std::to_string(src_rate) +
+                                 " to " + std::to_string(dest_rate));
+
+    long long src = std::llround(src_rate * RS_RATE_SCALE);
+    long long dst = std::llround(dest_rate * RS_RATE_SCALE);
+    long long g = std::gcd(src, dst);
+    m_interp = static_cast<int>(dst / g);
+    m_decim = static_cast<int>(src / g);
+
+    if (!passThrough())
+        design(src_rate, dest_rate, quality);
+    reset();
 }
 
-Resampler::~Resampler() {
-    if (src_state) {
-        src_delete(src_state);
+bool Resampler::ratioSupported(double src_rate, double dest_rate) {
+    double src = src_rate * RS_RATE_SCALE;
+    double dst = dest_rate * RS_RATE_SCALE;
+    if (src < 1.0 || dst < 1.0 || std::fabs(src - std::round(src)) > 1e-6 || std::fabs(dst - std::round(dst)) > 1e-6)
+        return false;
+    long long g = std::gcd(std::llround(src), std::llround(dst));
+    return std::llround(dst) / g <= RS_MAX_PHASES;
+}
+
+void Resampler::design(double src_rate, double dest_rate, int quality) {
+    int tier = std::clamp(quality, 0, rs_tiers - 1);
+    double atten = rs_tier_db[tier];
+    double stop = 0.5 * std::min(src_rate, dest_rate);
+    double pass = rs_tier_passband[tier] * stop;
+
+    // Kaiser length at the input rate is the length of one phase
+    double transition = (stop - pass) / src_rate;
+    int taps = static_cast<int>(std::ceil((atten - 7.95) / (14.36 * transition)));
+    m_taps = (taps + 7) & ~7;
+
+    int length = m_taps * m_interp;
+    double beta = 0.1102 * (atten - 8.7);
+    double fc = 0.5 * (pass + stop) / (src_rate * m_interp); // cycles per upsampled sample
+    double mid = 0.5 * (length - 1);
+    double norm = besselI0(beta);
+
+    std::vector<double> h(length);
+    double sum = 0.0;
+    for (int n = 0; n < length; n++) {
+        double t = n - mid;
+        double sinc = (t == 0.0) ? 2.0 * fc : std::sin(TWO_PI * fc * t) / (ONE_PI * t);
+        double r = t / mid;
+        h[n] = sinc * besselI0(beta * std::sqrt(std::max(0.0, 1.0 - r * r))) / norm;
+        sum += h[n];
     }
+
+    // phase p holds h[p + j*L] for input x[i - j]; stored oldest first
+    double gain = m_interp / sum;
+    m_coef.assign(static_cast<size_t>(length), 0.0f);
+    for (int p = 0; p < m_interp; p++)
+        for (int j = 0; j < m_taps; j++)
+            m_coef[p * m_taps + (m_taps - 1 - j)] = static_cast<float>(h[p + j * m_interp] * gain);
 }
 
-void Resampler::process(const float *input, size_t input_frames, float *output, size_t *output_frames) {
-    SRC_DATA src_data;
-    src_data.data_in = input;                // Pointer to input data
-    src_data.input_frames = input_frames;    // Total number of input frames
-    src_data.data_out = output;              // Pointer to output data
-    src_data.output_frames = *output_frames; // Maximum number of output frames
-    src_data.src_ratio = src_ratio;          // Resampling ratio
+void Resampler::reset() {
+    m_phase = 0;
+    m_offset = 0;
+    m_hist_l.assign(std::max(m_taps - 1, 0), 0.0f);
+    m_hist_r.assign(std::max(m_taps - 1, 0), 0.0f);
+}
+
+void Resampler::reserve(int input_frames) {
+    size_t length = std::max(m_taps - 1, 0) + input_frames;
+    m_hist_l.reserve(length);
+    m_hist_r.reserve(length);
+}
+
+int Resampler::maxOutput(int input_frames) const {
+    return static_cast<int>((static_cast<long long>(input_frames) * m_interp + m_decim - 1) / m_decim) + 1;
+}
+
+void Resampler::append(qs_vect_f &hist, const float *input, int input_frames, int stride) {
+    size_t past = m_taps - 1;
+    if (hist.size() < past + input_frames)
+        hist.resize(past + input_frames);
+    float *dst = &hist[past];
+    for (int i = 0; i < input_frames; i++)
+        dst[i] = input[i * stride];
+}
+
+void Resampler::retire(qs_vect_f &hist, int input_frames) {
+    if (m_taps > 1)
+        memmove(&hist[0], &hist[input_frames], (m_taps - 1) * sizeof(float));
+}
+
+// History after input_frames zeros: what is left of the old past, then zeros.
+void Resampler::silence(qs_vect_f &hist, int input_frames) {
+    int past = m_taps - 1;
+    int keep = std::max(past - input_frames, 0);
+    if (keep > 0)
+        memmove(&hist[0], &hist[past - keep], keep * sizeof(float));
+    std::fill(hist.begin() + keep, hist.begin() + past, 0.0f);
+}
+
+int Resampler::skip(int input_frames) {
+    if (passThrough())
+        return input_frames;
+
+    int produced = 0;
+    while (m_offset < input_frames) {
+        produced++;
+        m_phase += m_decim;
+        m_offset += m_phase / m_interp;
+        m_phase %= m_interp;
+    }
+    m_offset -= input_frames;
+
+    silence(m_hist_l, input_frames);
+    silence(m_hist_r, input_frames);
+    return produced;
+}
+
+int Resampler::process(const float *input, int input_frames, float *output) {
+    if (passThrough()) {
+        memcpy(output, input, input_frames * sizeof(float));
+        return input_frames;
+    }
+
+    append(m_hist_l, input, input_frames, 1);
+
+    const float *hist = &m_hist_l[0];
+    const float *coef = &m_coef[0];
+    int produced = 0;
+    while (m_offset < input_frames) {
+        output[produced++] = QsSignalOps::DotProduct8(coef + m_phase * m_taps, hist + m_offset, m_taps);
+        m_phase += m_decim;
+        m_offset += m_phase / m_interp;
+        m_phase %= m_interp;
+    }
+    m_offset -= input_frames;
+
+    retire(m_hist_l, input_frames);
+    return produced;
+}
+
+int Resampler::process(const Cpx *input, int input_frames, Cpx *output) {
+    if (passThrough()) {
+        std::copy(input, input + input_frames, output);
+        return input_frames;
+    }
+
+    const float *src = reinterpret_cast<const float *>(input);
+    append(m_hist_l, src, input_frames, 2);
+    append(m_hist_r, src + 1, input_frames, 2);
 
-    int error = src_process(src_state, &src_data);
-    if (error != 0) {
-        throw std::runtime_error("Error during resampling: " + std::string(src_strerror(error)));
+    const float *hist_l = &m_hist_l[0];
+    const float *hist_r = &m_hist_r[0];
+    const float *coef = &m_coef[0];
+    int produced = 0;
+    while (m_offset < input_frames) {
+        float yl, yr;
+        dotProduct2(coef + m_phase * m_taps, hist_l + m_offset, hist_r + m_offset, m_taps, yl, yr);
+        output[produced++] = Cpx(yl, yr);
+        m_phase += m_decim;
+        m_offset += m_phase / m_interp;
+        m_phase %= m_interp;
     }
+    m_offset -= input_frames;
 
-    *output_frames = src_data.output_frames_gen; // Update output frames count
+    retire(m_hist_l, input_frames);
+    retire(m_hist_r, input_frames);
+    return produced;
 }
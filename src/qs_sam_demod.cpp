@@ -77,14 +77,17 @@
 // }
 
 #include "../include/qs_sam_demod.hpp"
+#include <algorithm>
 #include <cmath>
 #include <stdexcept>
 
+#define SAM_TRACK_BLOCK 16 // samBlock samples per carrier loop update
+
 QsSAMDemodulator::QsSAMDemodulator()
     : m_sam_bw(0), m_sam_limit(0), m_sam_zeta(0), m_sam_alpha_constant(0), m_sam_beta_constant(0), m_sam_norm(0),
       m_sam_cos(0), m_sam_sin(0), m_sam_ncoPhase(0), m_sam_phaseError(0), m_sam_ncoFreq(0), m_sam_ncoHighLimit(0),
       m_sam_ncoLowLimit(0), m_sam_alpha(0), m_sam_beta(0), m_sam_mag(0), m_sam_atan(0), m_sam_z0(0), m_sam_z1(0),
-      m_sam_y0(0), m_sam_y1(0), m_sam_dc_alpha(0) {}
+      m_sam_y0(0), m_sam_y1(0), m_sam_dc_alpha(0), m_sam_tracking(samPerSample) {}
 
 void QsSAMDemodulator::init() {
     // Initialize demodulation parameters
@@ -109,14 +112,29 @@ void QsSAMDemodulator::init() {
     // Initialize other variables
     m_sam_mag = m_sam_atan = m_sam_z0 = m_sam_z1 = m_sam_y0 = m_sam_y1 = 0.0;
     m_sam_dc_alpha = 0.999; // DC alpha for smoothing
+
+    update(QsGlobal::g_memory->params());
 }
 
-void QsSAMDemodulator::process(qs_vect_cpx &src_dst) {
+void QsSAMDemodulator::update(const QsDspParams &params) { m_sam_tracking = params.sam_tracking; }
+
+void QsSAMDemodulator::process(qs_vect_cpx &src_dst) { process(src_dst.data(), static_cast<int>(src_dst.size())); }
+
+void QsSAMDemodulator::process(Cpx *src_dst, int length) {
+    if (m_sam_tracking == samBlock)
+        processBlock(src_dst, length);
+    else
+        processSample(src_dst, length);
+}
+
+void QsSAMDemodulator::processSample(Cpx *src_dst, int length) {
     // Temporary complex variable
     Cpx m_sam_tmp(0, 0);
 
-    // Loop over each sample in the input/output vector
-    for (auto &sample : src_dst) {
+    // Loop over each sample in the input/output block
+    for (int i = 0; i < length; i++) {
+        Cpx &sample = src_dst[i];
+
         // Compute the sine and cosine of the NCO phase
         m_sam_sin = -sin(m_sam_ncoPhase);
         m_sam_cos = cos(m_sam_ncoPhase);
@@ -160,3 +178,76 @@ void QsSAMDemodulator::process(qs_vect_cpx &src_dst) {
         m_sam_y1 = m_sam_y0;
     }
 }
+
+void QsSAMDemodulator::processBlock(Cpx *src_dst, int length) {
+    float *io = reinterpret_cast<float *>(src_dst);
+
+    float phase = m_sam_ncoPhase;
+    float freq = m_sam_ncoFreq;
+    float z1 = m_sam_z1;
+    float y1 = m_sam_y1;
+    const float dc_alpha = m_sam_dc_alpha;
+
+    for (int i = 0; i < length; i += SAM_TRACK_BLOCK) {
+        const int n = std::min(SAM_TRACK_BLOCK, length - i);
+        float *x = io + 2 * i;
+
+        // rotation e^-j(phase + k * freq), k = 0 .. n-1: each doubling pass
+        // extends the table by the rotation for its current length
+        float rc[SAM_TRACK_BLOCK];
+        float rs[SAM_TRACK_BLOCK];
+        rc[0] = std::cos(phase);
+        rs[0] = -std::sin(phase);
+        float sc = std::cos(freq);
+        float ss = -std::sin(freq);
+        for (int len = 1; len < n; len *= 2) {
+            for (int k = 0; k < len && k + len < n; k++) {
+                rc[k + len] = rc[k] * sc - rs[k] * ss;
+                rs[k + len] = rc[k] * ss + rs[k] * sc;
+            }
+            const float t = sc * sc - ss * ss;
+            ss = 2.0f * sc * ss;
+            sc = t;
+        }
+
+        // de-rotate, summing the segment for the loop
+        float yr[SAM_TRACK_BLOCK];
+        float yi[SAM_TRACK_BLOCK];
+        float sum_r = 0.0f;
+        float sum_i = 0.0f;
+        for (int k = 0; k < n; k++) {
+            yr[k] = rc[k] * x[2 * k] - rs[k] * x[2 * k + 1];
+            yi[k] = rc[k] * x[2 * k + 1] + rs[k] * x[2 * k];
+            sum_r += yr[k];
+            sum_i += yi[k];
+        }
+
+        // DC removal, I and Q together
+        for (int k = 0; k < n; k++) {
+            const float z0 = yr[k] + z1 * dc_alpha;
+            const float y0 = yi[k] + y1 * dc_alpha;
+            x[2 * k] = z0 - z1;
+            x[2 * k + 1] = y0 - y1;
+            z1 = z0;
+            y1 = y0;
+        }
+
+        // Loop update from the segment's mean: its phase is the error, its
+        // magnitude the amplitude weight the per-sample loop applies. Over n
+        // samples the per-sample loop shrinks a held error by
+        // (1 - alpha * mag)^n and integrates n of its frequency steps; the
+        // reduction is applied as a phase step at the segment boundary.
+        const float mag = std::sqrt(sum_r * sum_r + sum_i * sum_i) / n;
+        const float err = QsSignalOps::FastAtan2(sum_i, sum_r);
+        const float keep = 1.0f - std::min(m_sam_alpha * mag, 1.0f);
+        const float correction = (1.0f - std::pow(keep, static_cast<float>(n))) * err;
+
+        phase = std::fmod(phase + n * freq + correction, static_cast<float>(TWO_PI));
+        freq = std::clamp(freq + n * m_sam_beta * mag * err, m_sam_ncoLowLimit, m_sam_ncoHighLimit);
+    }
+
+    m_sam_ncoPhase = phase;
+    m_sam_ncoFreq = freq;
+    m_sam_z1 = z1;
+    m_sam_y1 = y1;
+}
@@ -0,0 +1,135 @@
+#include "../include/qs_simd.hpp"
+#include "../include/qs_signalops.hpp"
+
+// Scalar reference: the loops QsSignalOps ran before the dispatch table.
+// Every backend falls back here for its tail.
+
+static void scalarMultiplyCpx(const Cpx *a, const Cpx *b, Cpx *dst, uint32_t length) {
+    for (uint32_t i = 0; i < length; i++) {
+        float re = (a[i].real() * b[i].real()) - (a[i].imag() * b[i].imag());
+        float im = (a[i].real() * b[i].imag()) + (a[i].imag() * b[i].real());
+        dst[i] = Cpx(re, im);
+    }
+}
+
+static void scalarMultiplySplit(const float *a_re, const float *a_im, const float *b_re, const float *b_im,
+                                float *dst_re, float *dst_im, uint32_t length) {
+    for (uint32_t i = 0; i < length; i++) {
+        float re = (a_re[i] * b_re[i]) - (a_im[i] * b_im[i]);
+        float im = (a_re[i] * b_im[i]) + (a_im[i] * b_re[i]);
+        dst_re[i] = re;
+        dst_im[i] = im;
+    }
+}
+
+static void scalarAddCpx(const Cpx *a, const Cpx *b, Cpx *dst, uint32_t length) {
+    for (uint32_t i = 0; i < length; i++)
+        dst[i] = Cpx(a[i].real() + b[i].real(), a[i].imag() + b[i].imag());
+}
+
+static void scalarScaleCpx(Cpx *src_dst, float val, uint32_t length) {
+    for (uint32_t i = 0; i < length; i++)
+        src_dst[i] = Cpx(src_dst[i].real() * val, src_dst[i].imag() * val);
+}
+
+static void scalarDeInterleave(const float *src, float *dst_re, float *dst_im, uint32_t length) {
+    for (uint32_t i = 0; i < length; i++) {
+        dst_re[i] = src[2 * i];
+        dst_im[i] = src[2 * i + 1];
+    }
+}
+
+static void scalarRealToComplex(const float *re, const float *im, Cpx *dst, uint32_t length) {
+    for (uint32_t i = 0; i < length; i++)
+        dst[i] = Cpx(re[i], im[i]);
+}
+
+static void scalarRealFromComplex(const Cpx *src, float *dst_re, uint32_t length) {
+    for (uint32_t i = 0; i < length; i++)
+        dst_re[i] = src[i].real();
+}
+
+static void scalarIntToFloat(const int *src, float *dst, uint32_t length) {
+    for (uint32_t i = 0; i < length; i++)
+        dst[i] = static_cast<float>(src[i]) * INTTOFLOAT;
+}
+
+// saturates the way the vector backends do; NaN gives 0
+static void scalarFloatToShort(const float *src, short *dst, uint32_t length) {
+    for (uint32_t i = 0; i < length; i++) {
+        double v = src[i] * FLOATTOSHORT;
+        if (v >= 32767.0)
+            dst[i] = 32767;
+        else if (v <= -32768.0)
+            dst[i] = -32768;
+        else if (v == v)
+            dst[i] = static_cast<short>(v);
+        else
+            dst[i] = 0;
+    }
+}
+
+static float scalarDotProduct(const float *a, const float *b, int length) {
+    float sum = 0.0f;
+    for (int i = 0; i < length; i++)
+        sum += a[i] * b[i];
+    return sum;
+}
+
+static const QsSimdKernels scalar_kernels = {simdScalar,          "scalar",           scalarMultiplyCpx,
+                                             scalarMultiplySplit, scalarAddCpx,       scalarScaleCpx,
+                                             scalarDeInterleave,  scalarRealToComplex, scalarRealFromComplex,
+                                             scalarIntToFloat,    scalarFloatToShort, scalarDotProduct};
+
+const QsSimdKernels *QsSimd::s_active = &scalar_kernels;
+
+const QsSimdKernels &QsSimd::scalar() { return scalar_kernels; }
+
+const QsSimdKernels *QsSimd::table(QsSimdIsa isa) {
+    switch (isa) {
+    case simdScalar:
+        return &scalar_kernels;
+    case simdSse2:
+        return sse2Kernels();
+    case simdAvx2:
+        return avx2Kernels();
+    case simdAvx512:
+        return avx512Kernels();
+    case simdNeon:
+        return neonKernels();
+    }
+    return nullptr;
+}
+
+bool QsSimd::supported(QsSimdIsa isa) {
+    if (table(isa) == nullptr)
+        return false;
+#if defined(__x86_64__) || defined(__i386__)
+    switch (isa) {
+    case simdSse2:
+        return __builtin_cpu_supports("sse2");
+    case simdAvx2:
+        return __builtin_cpu_supports("avx2") && __builtin_cpu_supports("fma");
+    case simdAvx512:
+        return __builtin_cpu_supports("avx512f");
+    default:
+        break;
+    }
+#endif
+    return true;
+}
+
+bool QsSimd::select(QsSimdIsa isa) {
+    if (!supported(isa))
+        return false;
+    s_active = table(isa);
+    return true;
+}
+
+void QsSimd::init() {
+    static const QsSimdIsa order[] = {simdAvx512, simdAvx2, simdSse2, simdNeon};
+    for (QsSimdIsa isa : order)
+        if (select(isa))
+            return;
+    s_active = &scalar_kernels;
+}
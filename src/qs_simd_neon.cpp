@@ -0,0 +1,136 @@
+#include "../include/qs_simd.hpp"
+#include "../include/qs_signalops.hpp"
+
+// NEON backend, AArch64 only: NEON is part of the base ISA there, so no
+// runtime check is needed. 32 bit ARM NEON flushes denormals and has no
+// double lanes, so it stays on the scalar table.
+
+#if defined(__aarch64__) && defined(__ARM_NEON)
+
+#include <arm_neon.h>
+
+static void neonMultiplyCpx(const Cpx *a, const Cpx *b, Cpx *dst, uint32_t length) {
+    const float *pa = reinterpret_cast<const float *>(a);
+    const float *pb = reinterpret_cast<const float *>(b);
+    float *pd = reinterpret_cast<float *>(dst);
+    uint32_t i = 0;
+    for (; i + 4 <= length; i += 4) {
+        // vld2 splits re / im; vmla / vmls are unfused, as the scalar loop
+        float32x4x2_t va = vld2q_f32(pa + 2 * i);
+        float32x4x2_t vb = vld2q_f32(pb + 2 * i);
+        float32x4x2_t vd;
+        vd.val[0] = vmlsq_f32(vmulq_f32(va.val[0], vb.val[0]), va.val[1], vb.val[1]);
+        vd.val[1] = vmlaq_f32(vmulq_f32(va.val[0], vb.val[1]), va.val[1], vb.val[0]);
+        vst2q_f32(pd + 2 * i, vd);
+    }
+    QsSimd::scalar().multiplyCpx(a + i, b + i, dst + i, length - i);
+}
+
+static void neonMultiplySplit(const float *a_re, const float *a_im, const float *b_re, const float *b_im,
+                              float *dst_re, float *dst_im, uint32_t length) {
+    uint32_t i = 0;
+    for (; i + 4 <= length; i += 4) {
+        float32x4_t ar = vld1q_f32(a_re + i), ai = vld1q_f32(a_im + i);
+        float32x4_t br = vld1q_f32(b_re + i), bi = vld1q_f32(b_im + i);
+        vst1q_f32(dst_re + i, vmlsq_f32(vmulq_f32(ar, br), ai, bi));
+        vst1q_f32(dst_im + i, vmlaq_f32(vmulq_f32(ar, bi), ai, br));
+    }
+    QsSimd::scalar().multiplySplit(a_re + i, a_im + i, b_re + i, b_im + i, dst_re + i, dst_im + i, length - i);
+}
+
+static void neonAddCpx(const Cpx *a, const Cpx *b, Cpx *dst, uint32_t length) {
+    const float *pa = reinterpret_cast<const float *>(a);
+    const float *pb = reinterpret_cast<const float *>(b);
+    float *pd = reinterpret_cast<float *>(dst);
+    uint32_t i = 0;
+    for (; i + 2 <= length; i += 2)
+        vst1q_f32(pd + 2 * i, vaddq_f32(vld1q_f32(pa + 2 * i), vld1q_f32(pb + 2 * i)));
+    QsSimd::scalar().addCpx(a + i, b + i, dst + i, length - i);
+}
+
+static void neonScaleCpx(Cpx *src_dst, float val, uint32_t length) {
+    float *p = reinterpret_cast<float *>(src_dst);
+    uint32_t i = 0;
+    for (; i + 2 <= length; i += 2)
+        vst1q_f32(p + 2 * i, vmulq_n_f32(vld1q_f32(p + 2 * i), val));
+    QsSimd::scalar().scaleCpx(src_dst + i, val, length - i);
+}
+
+static void neonDeInterleave(const float *src, float *dst_re, float *dst_im, uint32_t length) {
+    uint32_t i = 0;
+    for (; i + 4 <= length; i += 4) {
+        float32x4x2_t v = vld2q_f32(src + 2 * i);
+        vst1q_f32(dst_re + i, v.val[0]);
+        vst1q_f32(dst_im + i, v.val[1]);
+    }
+    QsSimd::scalar().deInterleave(src + 2 * i, dst_re + i, dst_im + i, length - i);
+}
+
+static void neonRealToComplex(const float *re, const float *im, Cpx *dst, uint32_t length) {
+    float *pd = reinterpret_cast<float *>(dst);
+    uint32_t i = 0;
+    for (; i + 4 <= length; i += 4) {
+        float32x4x2_t v;
+        v.val[0] = vld1q_f32(re + i);
+        v.val[1] = vld1q_f32(im + i);
+        vst2q_f32(pd + 2 * i, v);
+    }
+    QsSimd::scalar().realToComplex(re + i, im + i, dst + i, length - i);
+}
+
+static void neonRealFromComplex(const Cpx *src, float *dst_re, uint32_t length) {
+    const float *ps = reinterpret_cast<const float *>(src);
+    uint32_t i = 0;
+    for (; i + 4 <= length; i += 4)
+        vst1q_f32(dst_re + i, vld2q_f32(ps + 2 * i).val[0]);
+    QsSimd::scalar().realFromComplex(src + i, dst_re + i, length - i);
+}
+
+static void neonIntToFloat(const int *src, float *dst, uint32_t length) {
+    const float k = static_cast<float>(INTTOFLOAT);
+    uint32_t i = 0;
+    for (; i + 4 <= length; i += 4)
+        vst1q_f32(dst + i, vmulq_n_f32(vcvtq_f32_s32(vld1q_s32(src + i)), k));
+    QsSimd::scalar().intToFloat(src + i, dst + i, length - i);
+}
+
+// the product is formed in double, as the scalar cast does, then truncated;
+// the conversions saturate and give 0 for NaN, as the scalar reference does
+static int32x4_t neonScaleToInt(float32x4_t x, float64x2_t k) {
+    int64x2_t lo = vcvtq_s64_f64(vmulq_f64(vcvt_f64_f32(vget_low_f32(x)), k));
+    int64x2_t hi = vcvtq_s64_f64(vmulq_f64(vcvt_high_f64_f32(x), k));
+    return vcombine_s32(vqmovn_s64(lo), vqmovn_s64(hi));
+}
+
+static void neonFloatToShort(const float *src, short *dst, uint32_t length) {
+    const float64x2_t k = vdupq_n_f64(FLOATTOSHORT);
+    uint32_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        int16x4_t lo = vqmovn_s32(neonScaleToInt(vld1q_f32(src + i), k));
+        int16x4_t hi = vqmovn_s32(neonScaleToInt(vld1q_f32(src + i + 4), k));
+        vst1q_s16(dst + i, vcombine_s16(lo, hi));
+    }
+    QsSimd::scalar().floatToShort(src + i, dst + i, length - i);
+}
+
+static float neonDotProduct(const float *a, const float *b, int length) {
+    float32x4_t acc0 = vdupq_n_f32(0.0f);
+    float32x4_t acc1 = acc0;
+    for (int i = 0; i < length; i += 8) {
+        acc0 = vfmaq_f32(acc0, vld1q_f32(a + i), vld1q_f32(b + i));
+        acc1 = vfmaq_f32(acc1, vld1q_f32(a + i + 4), vld1q_f32(b + i + 4));
+    }
+    return vaddvq_f32(vaddq_f32(acc0, acc1));
+}
+
+static const QsSimdKernels neon_kernels = {simdNeon,          "neon",           neonMultiplyCpx,   neonMultiplySplit,
+                                           neonAddCpx,        neonScaleCpx,     neonDeInterleave,  neonRealToComplex,
+                                           neonRealFromComplex, neonIntToFloat, neonFloatToShort,  neonDotProduct};
+
+const QsSimdKernels *QsSimd::neonKernels() { return &neon_kernels; }
+
+#else
+
+const QsSimdKernels *QsSimd::neonKernels() { return nullptr; }
+
+#endif
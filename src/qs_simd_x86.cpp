@@ -0,0 +1,392 @@
+#include "../include/qs_simd.hpp"
+#include "../include/qs_signalops.hpp"
+
+// SSE2, AVX2 + FMA and AVX-512F backends. Each function carries its own
+// target attribute, so this file builds with the default flags and nothing
+// here runs unless QsSimd::supported() has seen the feature in cpuid.
+
+#if defined(__x86_64__) || defined(__i386__)
+
+#include <immintrin.h>
+
+#define QS_SSE2 __attribute__((target("sse2")))
+#define QS_AVX2 __attribute__((target("avx2,fma")))
+#define QS_AVX512 __attribute__((target("avx512f")))
+
+// ======== <SSE2> =============
+
+static QS_SSE2 void sse2MultiplyCpx(const Cpx *a, const Cpx *b, Cpx *dst, uint32_t length) {
+    const float *pa = reinterpret_cast<const float *>(a);
+    const float *pb = reinterpret_cast<const float *>(b);
+    float *pd = reinterpret_cast<float *>(dst);
+    const __m128 sign = _mm_setr_ps(-0.0f, 0.0f, -0.0f, 0.0f);
+    uint32_t i = 0;
+    for (; i + 2 <= length; i += 2) {
+        __m128 va = _mm_loadu_ps(pa + 2 * i);
+        __m128 vb = _mm_loadu_ps(pb + 2 * i);
+        __m128 br = _mm_shuffle_ps(vb, vb, _MM_SHUFFLE(2, 2, 0, 0));
+        __m128 bi = _mm_shuffle_ps(vb, vb, _MM_SHUFFLE(3, 3, 1, 1));
+        __m128 sw = _mm_shuffle_ps(va, va, _MM_SHUFFLE(2, 3, 0, 1));
+        // re: ar * br - ai * bi, im: ai * br + ar * bi
+        _mm_storeu_ps(pd + 2 * i, _mm_add_ps(_mm_mul_ps(va, br), _mm_xor_ps(_mm_mul_ps(sw, bi), sign)));
+    }
+    QsSimd::scalar().multiplyCpx(a + i, b + i, dst + i, length - i);
+}
+
+static QS_SSE2 void sse2MultiplySplit(const float *a_re, const float *a_im, const float *b_re, const float *b_im,
+                                      float *dst_re, float *dst_im, uint32_t length) {
+    uint32_t i = 0;
+    for (; i + 4 <= length; i += 4) {
+        __m128 ar = _mm_loadu_ps(a_re + i), ai = _mm_loadu_ps(a_im + i);
+        __m128 br = _mm_loadu_ps(b_re + i), bi = _mm_loadu_ps(b_im + i);
+        _mm_storeu_ps(dst_re + i, _mm_sub_ps(_mm_mul_ps(ar, br), _mm_mul_ps(ai, bi)));
+        _mm_storeu_ps(dst_im + i, _mm_add_ps(_mm_mul_ps(ar, bi), _mm_mul_ps(ai, br)));
+    }
+    QsSimd::scalar().multiplySplit(a_re + i, a_im + i, b_re + i, b_im + i, dst_re + i, dst_im + i, length - i);
+}
+
+static QS_SSE2 void sse2AddCpx(const Cpx *a, const Cpx *b, Cpx *dst, uint32_t length) {
+    const float *pa = reinterpret_cast<const float *>(a);
+    const float *pb = reinterpret_cast<const float *>(b);
+    float *pd = reinterpret_cast<float *>(dst);
+    uint32_t i = 0;
+    for (; i + 2 <= length; i += 2)
+        _mm_storeu_ps(pd + 2 * i, _mm_add_ps(_mm_loadu_ps(pa + 2 * i), _mm_loadu_ps(pb + 2 * i)));
+    QsSimd::scalar().addCpx(a + i, b + i, dst + i, length - i);
+}
+
+static QS_SSE2 void sse2ScaleCpx(Cpx *src_dst, float val, uint32_t length) {
+    float *p = reinterpret_cast<float *>(src_dst);
+    const __m128 k = _mm_set1_ps(val);
+    uint32_t i = 0;
+    for (; i + 2 <= length; i += 2)
+        _mm_storeu_ps(p + 2 * i, _mm_mul_ps(_mm_loadu_ps(p + 2 * i), k));
+    QsSimd::scalar().scaleCpx(src_dst + i, val, length - i);
+}
+
+static QS_SSE2 void sse2DeInterleave(const float *src, float *dst_re, float *dst_im, uint32_t length) {
+    uint32_t i = 0;
+    for (; i + 4 <= length; i += 4) {
+        __m128 v0 = _mm_loadu_ps(src + 2 * i);
+        __m128 v1 = _mm_loadu_ps(src + 2 * i + 4);
+        _mm_storeu_ps(dst_re + i, _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(2, 0, 2, 0)));
+        _mm_storeu_ps(dst_im + i, _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(3, 1, 3, 1)));
+    }
+    QsSimd::scalar().deInterleave(src + 2 * i, dst_re + i, dst_im + i, length - i);
+}
+
+static QS_SSE2 void sse2RealToComplex(const float *re, const float *im, Cpx *dst, uint32_t length) {
+    float *pd = reinterpret_cast<float *>(dst);
+    uint32_t i = 0;
+    for (; i + 4 <= length; i += 4) {
+        __m128 r = _mm_loadu_ps(re + i);
+        __m128 m = _mm_loadu_ps(im + i);
+        _mm_storeu_ps(pd + 2 * i, _mm_unpacklo_ps(r, m));
+        _mm_storeu_ps(pd + 2 * i + 4, _mm_unpackhi_ps(r, m));
+    }
+    QsSimd::scalar().realToComplex(re + i, im + i, dst + i, length - i);
+}
+
+static QS_SSE2 void sse2RealFromComplex(const Cpx *src, float *dst_re, uint32_t length) {
+    const float *ps = reinterpret_cast<const float *>(src);
+    uint32_t i = 0;
+    for (; i + 4 <= length; i += 4) {
+        __m128 v0 = _mm_loadu_ps(ps + 2 * i);
+        __m128 v1 = _mm_loadu_ps(ps + 2 * i + 4);
+        _mm_storeu_ps(dst_re + i, _mm_shuffle_ps(v0, v1, _MM_SHUFFLE(2, 0, 2, 0)));
+    }
+    QsSimd::scalar().realFromComplex(src + i, dst_re + i, length - i);
+}
+
+static QS_SSE2 void sse2IntToFloat(const int *src, float *dst, uint32_t length) {
+    const __m128 k = _mm_set1_ps(static_cast<float>(INTTOFLOAT));
+    uint32_t i = 0;
+    for (; i + 4 <= length; i += 4) {
+        __m128i v = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src + i));
+        _mm_storeu_ps(dst + i, _mm_mul_ps(_mm_cvtepi32_ps(v), k));
+    }
+    QsSimd::scalar().intToFloat(src + i, dst + i, length - i);
+}
+
+// the product is formed in double, as the scalar cast does, clamped to the
+// short range (NaN to 0) so the conversion never sees an out of range value,
+// then truncated
+static QS_SSE2 __m128d sse2ClampShort(__m128d v) {
+    v = _mm_and_pd(v, _mm_cmpord_pd(v, v));
+    return _mm_min_pd(_mm_max_pd(v, _mm_set1_pd(-32768.0)), _mm_set1_pd(32767.0));
+}
+
+static QS_SSE2 __m128i sse2ScaleToInt(__m128 x, __m128d k) {
+    __m128i lo = _mm_cvttpd_epi32(sse2ClampShort(_mm_mul_pd(_mm_cvtps_pd(x), k)));
+    __m128i hi = _mm_cvttpd_epi32(sse2ClampShort(_mm_mul_pd(_mm_cvtps_pd(_mm_movehl_ps(x, x)), k)));
+    return _mm_unpacklo_epi64(lo, hi);
+}
+
+static QS_SSE2 void sse2FloatToShort(const float *src, short *dst, uint32_t length) {
+    const __m128d k = _mm_set1_pd(FLOATTOSHORT);
+    uint32_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        __m128i lo = sse2ScaleToInt(_mm_loadu_ps(src + i), k);
+        __m128i hi = sse2ScaleToInt(_mm_loadu_ps(src + i + 4), k);
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_packs_epi32(lo, hi));
+    }
+    QsSimd::scalar().floatToShort(src + i, dst + i, length - i);
+}
+
+// two partial sums, the same order as the qs_v4f DotProduct8 it replaces
+static QS_SSE2 float sse2DotProduct(const float *a, const float *b, int length) {
+    __m128 acc0 = _mm_setzero_ps();
+    __m128 acc1 = _mm_setzero_ps();
+    for (int i = 0; i < length; i += 8) {
+        acc0 = _mm_add_ps(acc0, _mm_mul_ps(_mm_loadu_ps(a + i), _mm_loadu_ps(b + i)));
+        acc1 = _mm_add_ps(acc1, _mm_mul_ps(_mm_loadu_ps(a + i + 4), _mm_loadu_ps(b + i + 4)));
+    }
+    float s[4];
+    _mm_storeu_ps(s, _mm_add_ps(acc0, acc1));
+    return (s[0] + s[2]) + (s[1] + s[3]);
+}
+
+// ======== </SSE2> =============
+
+// ======== <AVX2> =============
+
+static QS_AVX2 void avx2MultiplyCpx(const Cpx *a, const Cpx *b, Cpx *dst, uint32_t length) {
+    const float *pa = reinterpret_cast<const float *>(a);
+    const float *pb = reinterpret_cast<const float *>(b);
+    float *pd = reinterpret_cast<float *>(dst);
+    uint32_t i = 0;
+    for (; i + 4 <= length; i += 4) {
+        __m256 va = _mm256_loadu_ps(pa + 2 * i);
+        __m256 vb = _mm256_loadu_ps(pb + 2 * i);
+        __m256 sw = _mm256_permute_ps(va, 0xB1);
+        __m256 t = _mm256_mul_ps(sw, _mm256_movehdup_ps(vb));
+        _mm256_storeu_ps(pd + 2 * i, _mm256_fmaddsub_ps(va, _mm256_moveldup_ps(vb), t));
+    }
+    QsSimd::scalar().multiplyCpx(a + i, b + i, dst + i, length - i);
+}
+
+static QS_AVX2 void avx2MultiplySplit(const float *a_re, const float *a_im, const float *b_re, const float *b_im,
+                                      float *dst_re, float *dst_im, uint32_t length) {
+    uint32_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        __m256 ar = _mm256_loadu_ps(a_re + i), ai = _mm256_loadu_ps(a_im + i);
+        __m256 br = _mm256_loadu_ps(b_re + i), bi = _mm256_loadu_ps(b_im + i);
+        _mm256_storeu_ps(dst_re + i, _mm256_fmsub_ps(ar, br, _mm256_mul_ps(ai, bi)));
+        _mm256_storeu_ps(dst_im + i, _mm256_fmadd_ps(ar, bi, _mm256_mul_ps(ai, br)));
+    }
+    QsSimd::scalar().multiplySplit(a_re + i, a_im + i, b_re + i, b_im + i, dst_re + i, dst_im + i, length - i);
+}
+
+static QS_AVX2 void avx2AddCpx(const Cpx *a, const Cpx *b, Cpx *dst, uint32_t length) {
+    const float *pa = reinterpret_cast<const float *>(a);
+    const float *pb = reinterpret_cast<const float *>(b);
+    float *pd = reinterpret_cast<float *>(dst);
+    uint32_t i = 0;
+    for (; i + 4 <= length; i += 4)
+        _mm256_storeu_ps(pd + 2 * i, _mm256_add_ps(_mm256_loadu_ps(pa + 2 * i), _mm256_loadu_ps(pb + 2 * i)));
+    QsSimd::scalar().addCpx(a + i, b + i, dst + i, length - i);
+}
+
+static QS_AVX2 void avx2ScaleCpx(Cpx *src_dst, float val, uint32_t length) {
+    float *p = reinterpret_cast<float *>(src_dst);
+    const __m256 k = _mm256_set1_ps(val);
+    uint32_t i = 0;
+    for (; i + 4 <= length; i += 4)
+        _mm256_storeu_ps(p + 2 * i, _mm256_mul_ps(_mm256_loadu_ps(p + 2 * i), k));
+    QsSimd::scalar().scaleCpx(src_dst + i, val, length - i);
+}
+
+// shuffle_ps works within 128 bit lanes; the 64 bit permute restores order
+static QS_AVX2 void avx2DeInterleave(const float *src, float *dst_re, float *dst_im, uint32_t length) {
+    uint32_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        __m256 v0 = _mm256_loadu_ps(src + 2 * i);
+        __m256 v1 = _mm256_loadu_ps(src + 2 * i + 8);
+        __m256 re = _mm256_shuffle_ps(v0, v1, 0x88);
+        __m256 im = _mm256_shuffle_ps(v0, v1, 0xDD);
+        _mm256_storeu_ps(dst_re + i, _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(re), 0xD8)));
+        _mm256_storeu_ps(dst_im + i, _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(im), 0xD8)));
+    }
+    QsSimd::scalar().deInterleave(src + 2 * i, dst_re + i, dst_im + i, length - i);
+}
+
+static QS_AVX2 void avx2RealToComplex(const float *re, const float *im, Cpx *dst, uint32_t length) {
+    float *pd = reinterpret_cast<float *>(dst);
+    uint32_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        __m256 r = _mm256_loadu_ps(re + i);
+        __m256 m = _mm256_loadu_ps(im + i);
+        __m256 lo = _mm256_unpacklo_ps(r, m);
+        __m256 hi = _mm256_unpackhi_ps(r, m);
+        _mm256_storeu_ps(pd + 2 * i, _mm256_permute2f128_ps(lo, hi, 0x20));
+        _mm256_storeu_ps(pd + 2 * i + 8, _mm256_permute2f128_ps(lo, hi, 0x31));
+    }
+    QsSimd::scalar().realToComplex(re + i, im + i, dst + i, length - i);
+}
+
+static QS_AVX2 void avx2RealFromComplex(const Cpx *src, float *dst_re, uint32_t length) {
+    const float *ps = reinterpret_cast<const float *>(src);
+    uint32_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        __m256 v0 = _mm256_loadu_ps(ps + 2 * i);
+        __m256 v1 = _mm256_loadu_ps(ps + 2 * i + 8);
+        __m256 re = _mm256_shuffle_ps(v0, v1, 0x88);
+        _mm256_storeu_ps(dst_re + i, _mm256_castpd_ps(_mm256_permute4x64_pd(_mm256_castps_pd(re), 0xD8)));
+    }
+    QsSimd::scalar().realFromComplex(src + i, dst_re + i, length - i);
+}
+
+static QS_AVX2 void avx2IntToFloat(const int *src, float *dst, uint32_t length) {
+    const __m256 k = _mm256_set1_ps(static_cast<float>(INTTOFLOAT));
+    uint32_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        __m256i v = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src + i));
+        _mm256_storeu_ps(dst + i, _mm256_mul_ps(_mm256_cvtepi32_ps(v), k));
+    }
+    QsSimd::scalar().intToFloat(src + i, dst + i, length - i);
+}
+
+// as sse2ClampShort
+static QS_AVX2 __m256d avx2ClampShort(__m256d v) {
+    v = _mm256_and_pd(v, _mm256_cmp_pd(v, v, _CMP_ORD_Q));
+    return _mm256_min_pd(_mm256_max_pd(v, _mm256_set1_pd(-32768.0)), _mm256_set1_pd(32767.0));
+}
+
+static QS_AVX2 void avx2FloatToShort(const float *src, short *dst, uint32_t length) {
+    const __m256d k = _mm256_set1_pd(FLOATTOSHORT);
+    uint32_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        __m128i lo = _mm256_cvttpd_epi32(avx2ClampShort(_mm256_mul_pd(_mm256_cvtps_pd(_mm_loadu_ps(src + i)), k)));
+        __m128i hi = _mm256_cvttpd_epi32(avx2ClampShort(_mm256_mul_pd(_mm256_cvtps_pd(_mm_loadu_ps(src + i + 4)), k)));
+        _mm_storeu_si128(reinterpret_cast<__m128i *>(dst + i), _mm_packs_epi32(lo, hi));
+    }
+    QsSimd::scalar().floatToShort(src + i, dst + i, length - i);
+}
+
+static QS_AVX2 float avx2DotProduct(const float *a, const float *b, int length) {
+    __m256 acc0 = _mm256_setzero_ps();
+    __m256 acc1 = _mm256_setzero_ps();
+    int i = 0;
+    for (; i + 16 <= length; i += 16) {
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+        acc1 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i + 8), _mm256_loadu_ps(b + i + 8), acc1);
+    }
+    if (i < length)
+        acc0 = _mm256_fmadd_ps(_mm256_loadu_ps(a + i), _mm256_loadu_ps(b + i), acc0);
+    __m256 s8 = _mm256_add_ps(acc0, acc1);
+    __m128 s4 = _mm_add_ps(_mm256_castps256_ps128(s8), _mm256_extractf128_ps(s8, 1));
+    s4 = _mm_add_ps(s4, _mm_movehl_ps(s4, s4));
+    s4 = _mm_add_ss(s4, _mm_shuffle_ps(s4, s4, 1));
+    return _mm_cvtss_f32(s4);
+}
+
+// ======== </AVX2> =============
+
+// ======== <AVX-512> =============
+
+static QS_AVX512 void avx512MultiplyCpx(const Cpx *a, const Cpx *b, Cpx *dst, uint32_t length) {
+    const float *pa = reinterpret_cast<const float *>(a);
+    const float *pb = reinterpret_cast<const float *>(b);
+    float *pd = reinterpret_cast<float *>(dst);
+    uint32_t i = 0;
+    for (; i + 8 <= length; i += 8) {
+        __m512 va = _mm512_loadu_ps(pa + 2 * i);
+        __m512 vb = _mm512_loadu_ps(pb + 2 * i);
+        __m512 sw = _mm512_permute_ps(va, 0xB1);
+        __m512 t = _mm512_mul_ps(sw, _mm512_movehdup_ps(vb));
+        _mm512_storeu_ps(pd + 2 * i, _mm512_fmaddsub_ps(va, _mm512_moveldup_ps(vb), t));
+    }
+    QsSimd::scalar().multiplyCpx(a + i, b + i, dst + i, length - i);
+}
+
+static QS_AVX512 void avx512MultiplySplit(const float *a_re, const float *a_im, const float *b_re,
+                                          const float *b_im, float *dst_re, float *dst_im, uint32_t length) {
+    uint32_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m512 ar = _mm512_loadu_ps(a_re + i), ai = _mm512_loadu_ps(a_im + i);
+        __m512 br = _mm512_loadu_ps(b_re + i), bi = _mm512_loadu_ps(b_im + i);
+        _mm512_storeu_ps(dst_re + i, _mm512_fmsub_ps(ar, br, _mm512_mul_ps(ai, bi)));
+        _mm512_storeu_ps(dst_im + i, _mm512_fmadd_ps(ar, bi, _mm512_mul_ps(ai, br)));
+    }
+    QsSimd::scalar().multiplySplit(a_re + i, a_im + i, b_re + i, b_im + i, dst_re + i, dst_im + i, length - i);
+}
+
+static QS_AVX512 void avx512AddCpx(const Cpx *a, const Cpx *b, Cpx *dst, uint32_t length) {
+    const float *pa = reinterpret_cast<const float *>(a);
+    const float *pb = reinterpret_cast<const float *>(b);
+    float *pd = reinterpret_cast<float *>(dst);
+    uint32_t i = 0;
+    for (; i + 8 <= length; i += 8)
+        _mm512_storeu_ps(pd + 2 * i, _mm512_add_ps(_mm512_loadu_ps(pa + 2 * i), _mm512_loadu_ps(pb + 2 * i)));
+    QsSimd::scalar().addCpx(a + i, b + i, dst + i, length - i);
+}
+
+static QS_AVX512 void avx512ScaleCpx(Cpx *src_dst, float val, uint32_t length) {
+    float *p = reinterpret_cast<float *>(src_dst);
+    const __m512 k = _mm512_set1_ps(val);
+    uint32_t i = 0;
+    for (; i + 8 <= length; i += 8)
+        _mm512_storeu_ps(p + 2 * i, _mm512_mul_ps(_mm512_loadu_ps(p + 2 * i), k));
+    QsSimd::scalar().scaleCpx(src_dst + i, val, length - i);
+}
+
+static QS_AVX512 void avx512RealFromComplex(const Cpx *src, float *dst_re, uint32_t length) {
+    const __m512i even = _mm512_setr_epi32(0, 2, 4, 6, 8, 10, 12, 14, 16, 18, 20, 22, 24, 26, 28, 30);
+    const float *ps = reinterpret_cast<const float *>(src);
+    uint32_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m512 v0 = _mm512_loadu_ps(ps + 2 * i);
+        __m512 v1 = _mm512_loadu_ps(ps + 2 * i + 16);
+        _mm512_storeu_ps(dst_re + i, _mm512_permutex2var_ps(v0, even, v1));
+    }
+    QsSimd::scalar().realFromComplex(src + i, dst_re + i, length - i);
+}
+
+static QS_AVX512 void avx512IntToFloat(const int *src, float *dst, uint32_t length) {
+    const __m512 k = _mm512_set1_ps(static_cast<float>(INTTOFLOAT));
+    uint32_t i = 0;
+    for (; i + 16 <= length; i += 16) {
+        __m512i v = _mm512_loadu_si512(src + i);
+        _mm512_storeu_ps(dst + i, _mm512_mul_ps(_mm512_cvtepi32_ps(v), k));
+    }
+    QsSimd::scalar().intToFloat(src + i, dst + i, length - i);
+}
+
+static QS_AVX512 float avx512DotProduct(const float *a, const float *b, int length) {
+    __m512 acc = _mm512_setzero_ps();
+    int i = 0;
+    for (; i + 16 <= length; i += 16)
+        acc = _mm512_fmadd_ps(_mm512_loadu_ps(a + i), _mm512_loadu_ps(b + i), acc);
+    if (i < length)
+        acc = _mm512_fmadd_ps(_mm512_maskz_loadu_ps(0x00FF, a + i), _mm512_maskz_loadu_ps(0x00FF, b + i), acc);
+    return _mm512_reduce_add_ps(acc);
+}
+
+// ======== </AVX-512> =============
+
+static const QsSimdKernels sse2_kernels = {simdSse2,          "sse2",           sse2MultiplyCpx,   sse2MultiplySplit,
+                                           sse2AddCpx,        sse2ScaleCpx,     sse2DeInterleave,  sse2RealToComplex,
+                                           sse2RealFromComplex, sse2IntToFloat, sse2FloatToShort,  sse2DotProduct};
+
+static const QsSimdKernels avx2_kernels = {simdAvx2,          "avx2",           avx2MultiplyCpx,   avx2MultiplySplit,
+                                           avx2AddCpx,        avx2ScaleCpx,     avx2DeInterleave,  avx2RealToComplex,
+                                           avx2RealFromComplex, avx2IntToFloat, avx2FloatToShort,  avx2DotProduct};
+
+// the two register permutes cost more than AVX2's in-lane shuffles, so
+// (de)interleave and short conversion stay on the AVX2 kernels
+static const QsSimdKernels avx512_kernels = {simdAvx512,         "avx512",          avx512MultiplyCpx,
+                                             avx512MultiplySplit, avx512AddCpx,      avx512ScaleCpx,
+                                             avx2DeInterleave,   avx2RealToComplex, avx512RealFromComplex,
+                                             avx512IntToFloat,   avx2FloatToShort,  avx512DotProduct};
+
+const QsSimdKernels *QsSimd::sse2Kernels() { return &sse2_kernels; }
+const QsSimdKernels *QsSimd::avx2Kernels() { return &avx2_kernels; }
+const QsSimdKernels *QsSimd::avx512Kernels() { return &avx512_kernels; }
+
+#else
+
+const QsSimdKernels *QsSimd::sse2Kernels() { return nullptr; }
+const QsSimdKernels *QsSimd::avx2Kernels() { return nullptr; }
+const QsSimdKernels *QsSimd::avx512Kernels() { return nullptr; }
+
+#endif
@@ -26,27 +26,47 @@
 #include "../include/qs_smeter.hpp"
 #include "../include/qs_defines.hpp"
 
-QsSMeter::QsSMeter() : m_sm_tmp_val(0.0), m_sm_value(0.0) {}
+QsSMeter::QsSMeter() : m_sm_tmp_val(0.0), m_sm_value(0.0), m_sm_correction(0.0) {}
 
 void QsSMeter::init() {
     m_sm_tmp_val = 0.0;
     m_sm_value = 0.0;
+    update(QsGlobal::g_memory->params());
 }
 
+void QsSMeter::update(const QsDspParams &params) { m_sm_correction = params.smeter_correction; }
+
 void QsSMeter::process(qs_vect_cpx &src_dst) {
-    // Reset temporary value for new calculation
-    m_sm_tmp_val = 0.0;
+    accumulate(src_dst.data(), static_cast<int>(src_dst.size()));
+    publish();
+}
 
-    // Accumulate the power of each complex sample
-    for (const auto &cpx : src_dst) {
-        m_sm_tmp_val += std::norm(cpx); // Efficient way to calculate real^2 + imag^2
+void QsSMeter::accumulate(const Cpx *src, int length) {
+    // Accumulate the power of each complex sample, real^2 + imag^2, four lanes at a time
+    const float *x = reinterpret_cast<const float *>(src);
+    const int n = 2 * length;
+    qs_v4f acc = {0.0f, 0.0f, 0.0f, 0.0f};
+    int i = 0;
+    for (; i + 4 <= n; i += 4) {
+        qs_v4f v;
+        memcpy(&v, x + i, sizeof(qs_v4f));
+        acc += v * v;
     }
+    float sum = (acc[0] + acc[2]) + (acc[1] + acc[3]);
+    for (; i < n; i++)
+        sum += x[i] * x[i];
+    m_sm_tmp_val += sum;
+}
 
+void QsSMeter::publish() {
     // Compute the current S-meter value in dB
     m_sm_value = 10.0 * log10(m_sm_tmp_val + 1e-200); // Avoid log(0)
 
+    // Reset the accumulator for the next block
+    m_sm_tmp_val = 0.0;
+
     // Apply S-meter correction
-    double corrected_sm = m_sm_value + QsGlobal::g_memory->getSMeterCorrection();
+    double corrected_sm = m_sm_value + m_sm_correction;
 
     // Update global memory with the corrected S-meter value
     QsGlobal::g_memory->setSMeterCurrentValue(corrected_sm);
@@ -0,0 +1,65 @@
+#include "../include/qs_spectral_notch.hpp"
+#include "../include/qs_globals.hpp"
+
+#include <cmath>
+#include <complex>
+
+QsSpectralNotches::QsSpectralNotches() : m_version(0) {
+    for (int i = 0; i < MAX_MAN_NOTCHES; i++) {
+        m_f0[i] = 0.0;
+        m_bw[i] = 0.0;
+        m_enabled[i] = false;
+    }
+}
+
+bool QsSpectralNotches::update(const QsDspParams &params) {
+    if (params.version[pgNotch] == m_version)
+        return false;
+    m_version = params.version[pgNotch];
+
+    bool changed = false;
+    for (int i = 0; i < MAX_MAN_NOTCHES; i++) {
+        bool enabled = params.notch_on[i];
+        if (enabled != m_enabled[i] || (enabled && (m_f0[i] != params.notch_freq[i] || m_bw[i] != params.notch_bw[i])))
+            changed = true;
+        m_enabled[i] = enabled;
+        m_f0[i] = params.notch_freq[i];
+        m_bw[i] = params.notch_bw[i];
+    }
+    return changed;
+}
+
+void QsSpectralNotches::kernelGains(float *gain, int bins, float samplerate) {
+    double c0[MAX_MAN_NOTCHES];
+    double alpha[MAX_MAN_NOTCHES];
+    int active = 0;
+
+    for (int i = 0; i < MAX_MAN_NOTCHES; i++) {
+        if (!m_enabled[i] || m_f0[i] <= 0.0 || m_bw[i] <= 0.0 || m_f0[i] >= samplerate / 2.0)
+            continue;
+        double w0 = TWO_PI * m_f0[i] / samplerate;
+        c0[active] = cos(w0);
+        alpha[active] = sin(w0) / (2.0 * (m_f0[i] / m_bw[i]));
+        active++;
+    }
+    if (active == 0)
+        return;
+
+    // Magnitude of the RBJ band-reject biquad QS_IIR::initBandReject builds.
+    // Its numerator is e^-jw * 2(cos w - cos w0); keeping the sign of that
+    // factor gives a zero-phase response that is smooth through the null, so
+    // its impulse response is as short as the biquad's and survives the
+    // kernel truncation. |H| itself has a kink at the null and would lose
+    // most of the depth.
+    for (int k = 0; k < bins; k++) {
+        int kk = (k < bins / 2) ? k : k - bins;
+        std::complex<double> z1 = std::polar(1.0, -TWO_PI * kk / bins);
+        std::complex<double> z2 = z1 * z1;
+        double g = 1.0;
+        for (int n = 0; n < active; n++) {
+            std::complex<double> den = (1.0 + alpha[n]) - 2.0 * c0[n] * z1 + (1.0 - alpha[n]) * z2;
+            g *= 2.0 * (z1.real() - c0[n]) / std::abs(den);
+        }
+        gain[k] *= static_cast<float>(g);
+    }
+}
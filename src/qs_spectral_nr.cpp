@@ -0,0 +1,82 @@
+#include "../include/qs_spectral_nr.hpp"
+#include "../include/qs_defines.hpp"
+#include "../include/qs_globals.hpp"
+
+#include <algorithm>
+
+#define SNR_POWER_SMOOTH 0.7f // per-block smoothing of the bin power
+#define SNR_MIN_BLOCKS 16     // minimum-statistics window (~1 s at 15 blocks/s)
+#define SNR_MIN_BIAS 1.5f     // minimum of smoothed power to mean noise power
+#define SNR_OVERSUBTRACT 2.0f // noise subtraction factor
+#define SNR_GAIN_FLOOR 0.1f   // -20 dB maximum attenuation
+#define SNR_GAIN_SMOOTH 0.5f  // per-block smoothing of the gain
+#define SNR_EPSILON 1e-20f
+
+QsSpectralNoiseReduction::QsSpectralNoiseReduction() : m_enabled(false), m_active(false), m_window_count(0) {}
+
+void QsSpectralNoiseReduction::prepare(int bins) { reset(bins); }
+
+void QsSpectralNoiseReduction::reset(int bins) {
+    m_power.assign(bins, 0.0f);
+    m_min_cur.assign(bins, 0.0f);
+    m_min_prev.assign(bins, 0.0f);
+    m_gain.assign(bins, 1.0f);
+    m_raw.assign(bins, 1.0f);
+    m_window_count = 0;
+}
+
+bool QsSpectralNoiseReduction::update(const QsDspParams &params) {
+    m_enabled = params.nr_on && params.nr_mode == nrSpectral;
+    return false; // no static gains
+}
+
+bool QsSpectralNoiseReduction::blockGains(const Cpx *spectrum, float *block_gain, int bins) {
+    if (!m_enabled) {
+        m_active = false;
+        return false;
+    }
+
+    // start the estimates from this block when switched on or resized
+    bool fresh = !m_active || static_cast<int>(m_power.size()) != bins;
+    if (fresh)
+        reset(bins);
+    m_active = true;
+
+    float *power = m_power.data();
+    float *min_cur = m_min_cur.data();
+    float *min_prev = m_min_prev.data();
+    float *gain = m_gain.data();
+    float *raw = m_raw.data();
+
+    for (int k = 0; k < bins; k++) {
+        float p = spectrum[k].real() * spectrum[k].real() + spectrum[k].imag() * spectrum[k].imag();
+        power[k] = fresh ? p : SNR_POWER_SMOOTH * power[k] + (1.0f - SNR_POWER_SMOOTH) * p;
+        min_cur[k] = fresh ? power[k] : std::min(min_cur[k], power[k]);
+        if (fresh)
+            min_prev[k] = power[k];
+        float noise = SNR_MIN_BIAS * std::min(min_cur[k], min_prev[k]);
+        raw[k] = std::max(SNR_GAIN_FLOOR, 1.0f - SNR_OVERSUBTRACT * noise / (power[k] + SNR_EPSILON));
+    }
+
+    // the current window becomes the previous one
+    if (++m_window_count == SNR_MIN_BLOCKS) {
+        m_window_count = 0;
+        m_min_prev.swap(m_min_cur);
+        std::copy(m_power.begin(), m_power.end(), m_min_cur.begin());
+    }
+
+    // [1/4 1/2 1/4] across bins (circular, the spectrum wraps at +-rate/2),
+    // then over time
+    const float g_first = 0.25f * raw[bins - 1] + 0.5f * raw[0] + 0.25f * raw[1];
+    const float g_last = 0.25f * raw[bins - 2] + 0.5f * raw[bins - 1] + 0.25f * raw[0];
+    gain[0] = SNR_GAIN_SMOOTH * gain[0] + (1.0f - SNR_GAIN_SMOOTH) * g_first;
+    for (int k = 1; k < bins - 1; k++) {
+        float g = 0.25f * raw[k - 1] + 0.5f * raw[k] + 0.25f * raw[k + 1];
+        gain[k] = SNR_GAIN_SMOOTH * gain[k] + (1.0f - SNR_GAIN_SMOOTH) * g;
+    }
+    gain[bins - 1] = SNR_GAIN_SMOOTH * gain[bins - 1] + (1.0f - SNR_GAIN_SMOOTH) * g_last;
+
+    for (int k = 0; k < bins; k++)
+        block_gain[k] *= gain[k];
+    return true;
+}
@@ -31,16 +31,18 @@
 QsSquelch::QsSquelch() : m_sq_switch(false), m_sq_thresh(0), m_sq_hist(-120.0) {}
 
 void QsSquelch::init() {
-    m_sq_switch = QsGlobal::g_memory->getSquelchOn();
-    m_sq_thresh = QsGlobal::g_memory->getSquelchThreshold();
+    update(QsGlobal::g_memory->params());
     m_sq_hist = -120.0; // Initialize squelch history with a low value
 }
 
-void QsSquelch::process(qs_vect_cpx &src_dst) {
-    m_sq_switch = QsGlobal::g_memory->getSquelchOn();
+void QsSquelch::update(const QsDspParams &params) {
+    m_sq_switch = params.squelch_on;
+    m_sq_thresh = params.squelch_threshold;
+}
 
+bool QsSquelch::closed() {
     if (m_sq_switch) {
-        m_sq_thresh = QsGlobal::g_memory->getSquelchThreshold();
+        // written by the S meter on this thread, not a setting
         double s_meter_value = QsGlobal::g_memory->getSMeterCurrentValue();
 
         // Apply a weighted average for squelch hysteresis
@@ -50,9 +52,8 @@ void QsSquelch::process(qs_vect_cpx &src_dst) {
             m_sq_hist = (m_sq_hist * 0.9) + (s_meter_value * 0.1); // Slow decay
         }
 
-        // If squelch hysteresis is below the threshold, zero out the signal
-        if (m_sq_hist < m_sq_thresh) {
-            QsSignalOps::Zero(src_dst); // Mute signal if below squelch threshold
-        }
+        // Squelch hysteresis below the threshold mutes the block
+        return m_sq_hist < m_sq_thresh;
     }
+    return false;
 }
@@ -12,6 +12,7 @@ void QsState::readSettings() {
 
     m_block_size = settings->value("BlockSize", QS_DEFAULT_DSP_BLOCKSIZE);    
     m_rs_quality = (settings->value("ResamplerQuality", QS_DEFAULT_RS_QUAL));
+    m_fe_threads = (settings->value("FrontEndThreads", QS_DEFAULT_FE_THREADS));
     m_rta_audio_frames = (settings->value("RtAudioFrameSize", QS_DEFAULT_RT_FRAMES));
     m_clock_correction = (settings->value("ClockCorrection", QS_DEFAULT_CLOCK_CORRECT));
     m_encode_clk_freq = (settings->value("EncodeClockFreq", QS_DEFAULT_ENC_FREQ));
@@ -147,6 +148,14 @@ bool QsState::pga() { return m_pga_is_on; }
 
 int QsState::rsQual() { return m_rs_quality; }
 
+void QsState::setFrontEndThreads(int threads) {
+    m_fe_threads = threads;
+
+    settings->setValue("FrontEndThreads", m_fe_threads);
+}
+
+int QsState::frontEndThreads() { return m_fe_threads; }
+
 int QsState::rtAudioFrameSize() { return m_rta_audio_frames; }
 
 int QsState::rtAudioInDevId() { return m_rta_in_dev_id; }
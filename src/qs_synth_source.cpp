@@ -0,0 +1,59 @@
+#include "../include/qs_synth_source.hpp"
+#include "../include/qs_globals.hpp"
+#include "../include/qs_signalops.hpp"
+
+#include <algorithm>
+#include <cmath>
+#include <cstring>
+#include <random>
+#include <stdexcept>
+
+#define SYNTH_TABLE_BLOCKS 16
+
+QsSyntheticSource::QsSyntheticSource() : m_pos(0), m_tone_hz(0.0), m_bytes_read(0) {}
+
+void QsSyntheticSource::init(double rate, int block_size, double tone_hz, double tone_dbfs, double noise_dbfs) {
+    if (rate <= 0.0 || block_size <= 0)
+        throw std::runtime_error("QsSyntheticSource: bad rate or block size");
+
+    const int length = block_size * SYNTH_TABLE_BLOCKS;
+
+    // whole cycles over the table, so the wrap is phase continuous
+    double cycles = std::round(tone_hz * length / rate);
+    m_tone_hz = cycles * rate / length;
+
+    const double amp = std::pow(10.0, tone_dbfs / 20.0) * FLOATTOINT;
+    const double sigma = std::pow(10.0, noise_dbfs / 20.0) * FLOATTOINT / std::sqrt(2.0);
+
+    std::mt19937 gen(0x5157);
+    std::normal_distribution<double> noise(0.0, sigma);
+
+    m_table.resize(length * 2);
+    for (int i = 0; i < length; i++) {
+        double ph = TWO_PI * cycles * i / length;
+        double re = amp * std::cos(ph) + noise(gen);
+        double im = amp * std::sin(ph) + noise(gen);
+        m_table[2 * i] = static_cast<int>(std::max(-FLOATTOINT, std::min(FLOATTOINT - 1.0, re)));
+        m_table[2 * i + 1] = static_cast<int>(std::max(-FLOATTOINT, std::min(FLOATTOINT - 1.0, im)));
+    }
+    m_pos = 0;
+    m_bytes_read = 0;
+}
+
+int QsSyntheticSource::read(unsigned char *buffer, unsigned int length) {
+    if (!buffer || m_table.empty())
+        return -1;
+
+    const unsigned int table_bytes = static_cast<unsigned int>(m_table.size() * sizeof(int));
+    const unsigned char *table = reinterpret_cast<const unsigned char *>(&m_table[0]);
+
+    unsigned int done = 0;
+    while (done < length) {
+        unsigned int n = std::min(length - done, table_bytes - m_pos);
+        std::memcpy(buffer + done, table + m_pos, n);
+        done += n;
+        m_pos = (m_pos + n) % table_bytes;
+    }
+    m_bytes_read += length;
+    return static_cast<int>(length);
+}
@@ -0,0 +1,20 @@
+#include "../include/qs_ticks.hpp"
+
+// reference pair taken at static initialization
+static const uint64_t s_tick0 = QsTicks::now();
+static const std::chrono::steady_clock::time_point s_time0 = std::chrono::steady_clock::now();
+
+double QsTicks::nsPerTick() {
+#ifdef QS_TICKS_TSC
+    double ns = std::chrono::duration<double, std::nano>(std::chrono::steady_clock::now() - s_time0).count();
+    uint64_t t = now() - s_tick0;
+    return t > 0 ? ns / t : 0.0;
+#else
+    return 1.0;
+#endif
+}
+
+double QsTicks::toSteadyNs(uint64_t stamp) {
+    double base = std::chrono::duration<double, std::nano>(s_time0.time_since_epoch()).count();
+    return base + (static_cast<double>(stamp) - static_cast<double>(s_tick0)) * nsPerTick();
+}
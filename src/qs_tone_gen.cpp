@@ -66,77 +66,70 @@
 
 #include <cmath>
 
-QsToneGenerator::QsToneGenerator()
-    : m_tg_pos(rateDataRate), m_rate(0), m_tg_inc(0.0), m_tg_osc_cos(0.0), m_tg_osc_sin(0.0), m_tg_osc1_re(1.0),
-      m_tg_osc1_im(0.0), m_tg_lo_freq(0.0), m_tg_osc_re(0.0), m_tg_osc_im(0.0) {}
+// level the old recursive oscillator's 1.95 - |osc|^2 gain correction
+// settled at (sqrt(0.95)); kept so receive gain and S-meter calibration
+// do not move
+#define TG_OSC_MAG 0.97467943448089633
+
+QsToneGenerator::QsToneGenerator() : m_tg_pos(rateDataRate), m_version(0), m_rate(0), m_tg_lo_freq(0.0) {
+    m_nco.setAmplitude(TG_OSC_MAG);
+}
 
 void QsToneGenerator::init(QSDSPPOS pos) {
     m_tg_pos = pos;
 
-    // Set rate and frequency based on position
+    // Set rate based on position
     switch (m_tg_pos) {
     case rateDataRate:
         m_rate = QsGlobal::g_memory->getDataProcRate();
-        m_tg_lo_freq = QsGlobal::g_memory->getToneLoFrequency();
         break;
     case ratePostDataRate:
         m_rate = QsGlobal::g_memory->getDataPostProcRate();
-        m_tg_lo_freq = QsGlobal::g_memory->getOffsetGeneratorFrequency();
         break;
     case rateTxDataRate:
         m_rate = QsGlobal::g_memory->getDataPostProcRate(); // Assuming post-process rate
-        m_tg_lo_freq = QsGlobal::g_memory->getTxOffsetFrequency();
         break;
     default:
         throw std::runtime_error("Unknown position for tone generator");
     }
 
-    // Compute increment and sine/cosine components
-    m_tg_inc = TWO_PI * m_tg_lo_freq / m_rate;
-    m_tg_osc_cos = cos(m_tg_inc);
-    m_tg_osc_sin = sin(m_tg_inc);
+    m_version = 0;
+    m_tg_lo_freq = 0.0;
+    m_nco.setFrequency(m_tg_lo_freq, m_rate);
+    update(QsGlobal::g_memory->params());
 }
 
-void QsToneGenerator::process(qs_vect_cpx &src_dst) {
-    // Check if LO frequency has changed, recalculate increment and oscillation components
+void QsToneGenerator::update(const QsDspParams &params) {
+    if (params.version[pgToneGen] == m_version)
+        return;
+    m_version = params.version[pgToneGen];
+
+    // Check if LO frequency has changed; the NCO keeps its phase
     double new_lo_freq = 0.0;
     switch (m_tg_pos) {
     case rateDataRate:
-        new_lo_freq = QsGlobal::g_memory->getToneLoFrequency();
+        new_lo_freq = params.tone_lo_freq;
         break;
     case ratePostDataRate:
-        new_lo_freq = QsGlobal::g_memory->getOffsetGeneratorFrequency();
+        new_lo_freq = params.offset_freq;
         break;
     case rateTxDataRate:
-        new_lo_freq = QsGlobal::g_memory->getTxOffsetFrequency();
+        new_lo_freq = params.tx_offset_freq;
         break;
     }
 
     if (new_lo_freq != m_tg_lo_freq) {
         m_tg_lo_freq = new_lo_freq;
-        m_tg_inc = TWO_PI * m_tg_lo_freq / m_rate;
-        m_tg_osc_cos = cos(m_tg_inc);
-        m_tg_osc_sin = sin(m_tg_inc);
+        m_nco.setFrequency(m_tg_lo_freq, m_rate);
     }
+}
 
-    // Process the input/output vector
-    for (auto &sample : src_dst) {
-        // Save current sample for tone mixing
-        Cpx tg_temp = sample;
-
-        // Compute oscillation real and imaginary components
-        m_tg_osc_re = m_tg_osc1_re * m_tg_osc_cos - m_tg_osc1_im * m_tg_osc_sin;
-        m_tg_osc_im = m_tg_osc1_im * m_tg_osc_cos + m_tg_osc1_re * m_tg_osc_sin;
-
-        // Compute gain factor to maintain signal magnitude
-        double tg_gain = 1.95 - (m_tg_osc1_re * m_tg_osc1_re + m_tg_osc1_im * m_tg_osc1_im);
+void QsToneGenerator::process(qs_vect_cpx &src_dst) { process(src_dst.data(), static_cast<int>(src_dst.size())); }
 
-        // Update oscillation state with the computed gain
-        m_tg_osc1_re = tg_gain * m_tg_osc_re;
-        m_tg_osc1_im = tg_gain * m_tg_osc_im;
+void QsToneGenerator::process(Cpx *src_dst, int length) { m_nco.mix(src_dst, length); }
 
-        // Apply tone mixing to the current sample
-        sample.real(tg_temp.real() * m_tg_osc_re - tg_temp.imag() * m_tg_osc_im);
-        sample.imag(tg_temp.real() * m_tg_osc_im + tg_temp.imag() * m_tg_osc_re);
-    }
+void QsToneGenerator::mixSegment(const Cpx *src, Cpx *dst, int offset, int length) const {
+    m_nco.mix(src, dst, length, m_nco.cursor(offset));
 }
+
+void QsToneGenerator::endBlock(int length) { m_nco.advance(length); }
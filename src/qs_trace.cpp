@@ -0,0 +1,249 @@
+#include "../include/qs_trace.hpp"
+#include "../include/qs_debugloggerclass.hpp"
+#include "../include/qs_defaults.hpp"
+
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <cstring>
+#include <mutex>
+#include <thread>
+#include <vector>
+
+#include <sys/stat.h>
+
+#define TRACE_MAX_THREADS 16
+#define TRACE_POLL_MS 50
+
+static_assert((QS_DEFAULT_TRACE_EVENTS & (QS_DEFAULT_TRACE_EVENTS - 1)) == 0, "trace ring must be a power of two");
+
+namespace {
+
+// relaxed atomics so a dump racing the writer reads stale values, never torn ones
+struct Event {
+    std::atomic<const char *> name;
+    std::atomic<uint64_t> start;
+    std::atomic<uint64_t> aux; // duration << 1 | instant
+};
+
+struct Ring {
+    const char *name = nullptr;
+    std::atomic<bool> owned{false};
+    std::atomic<uint64_t> next{0}; // events recorded, written by the owner
+    Event *events = nullptr;        // never freed: rings are read at exit, after static destructors
+};
+
+Ring s_rings[TRACE_MAX_THREADS];
+std::atomic<int> s_ring_count(0);
+std::mutex s_attach_mutex;
+
+// releases the thread's ring for the next thread of the same name
+struct Owner {
+    Ring *ring = nullptr;
+    ~Owner() {
+        if (ring)
+            ring->owned.store(false, std::memory_order_release);
+    }
+};
+
+thread_local Ring *t_ring = nullptr;
+thread_local Owner t_owner;
+
+std::atomic<uint64_t> s_misses(0);
+std::atomic<int64_t> s_miss_at(0); // steady ns of a miss waiting for its dump, 0 for none
+std::atomic<int64_t> s_holdoff_until(0);
+unsigned int s_dumps = 0; // dump writer only
+
+// automatic dumps, off the real-time threads
+struct DumpWriter {
+    std::mutex mutex;
+    std::thread thread;
+    std::atomic<bool> go{false};
+
+    void start() {
+        std::lock_guard<std::mutex> lock(mutex);
+        if (thread.joinable())
+            return;
+        go = true;
+        thread = std::thread(&DumpWriter::run, this);
+    }
+
+    void stop() {
+        std::lock_guard<std::mutex> lock(mutex);
+        go = false;
+        if (thread.joinable())
+            thread.join();
+    }
+
+    void run();
+
+    ~DumpWriter() { stop(); }
+};
+
+DumpWriter s_writer;
+
+int64_t steadyNs() {
+    return std::chrono::duration_cast<std::chrono::nanoseconds>(std::chrono::steady_clock::now().time_since_epoch())
+        .count();
+}
+
+void DumpWriter::run() {
+    while (go) {
+        std::this_thread::sleep_for(std::chrono::milliseconds(TRACE_POLL_MS));
+        int64_t at = s_miss_at.load(std::memory_order_acquire);
+        if (at == 0)
+            continue;
+        int64_t now = steadyNs();
+        if (now - at < static_cast<int64_t>(QS_DEFAULT_TRACE_MISS_DELAY_MS) * 1000000)
+            continue;
+
+        char path[64];
+        std::snprintf(path, sizeof(path), "qs1r_trace_miss_%u.json", s_dumps++);
+        if (QsTrace::dumpNamed(path))
+            _debug() << "trace: deadline miss, wrote " << path;
+        else
+            _debug() << "trace: deadline miss, could not write " << path;
+        s_holdoff_until.store(now + static_cast<int64_t>(QS_DEFAULT_TRACE_HOLDOFF_S) * 1000000000,
+                              std::memory_order_relaxed);
+        s_miss_at.store(0, std::memory_order_release);
+    }
+}
+
+Ring *attachRing(const char *name) {
+    std::lock_guard<std::mutex> lock(s_attach_mutex);
+    int count = s_ring_count.load(std::memory_order_relaxed);
+    for (int i = 0; i < count; i++) {
+        bool expected = false;
+        if (std::strcmp(s_rings[i].name, name) == 0 && s_rings[i].owned.compare_exchange_strong(expected, true))
+            return &s_rings[i];
+    }
+    if (count == TRACE_MAX_THREADS)
+        return nullptr;
+
+    Ring &ring = s_rings[count];
+    ring.name = name;
+    ring.events = new Event[QS_DEFAULT_TRACE_EVENTS]();
+    ring.owned.store(true, std::memory_order_relaxed);
+    s_ring_count.store(count + 1, std::memory_order_release);
+    return &ring;
+}
+
+} // namespace
+
+std::atomic<bool> QsTrace::s_enabled(false);
+
+void QsTrace::attach(const char *name) {
+    if (t_ring)
+        return;
+    t_ring = attachRing(name);
+    t_owner.ring = t_ring;
+}
+
+void QsTrace::setEnabled(bool value) {
+    if (value)
+        s_writer.start();
+    s_enabled.store(value, std::memory_order_relaxed);
+    if (!value)
+        s_writer.stop();
+}
+
+void QsTrace::record(const char *name, uint64_t start, uint64_t duration, bool instant) {
+    if (!t_ring) {
+        attach("thread");
+        if (!t_ring)
+            return;
+    }
+    Ring &ring = *t_ring;
+    uint64_t i = ring.next.load(std::memory_order_relaxed);
+    Event &e = ring.events[i & (QS_DEFAULT_TRACE_EVENTS - 1)];
+    // next = i (stored by the last record) is visible before the slot is
+    // overwritten, so a dump that reads the new contents also sees the count
+    std::atomic_thread_fence(std::memory_order_release);
+    e.name.store(name, std::memory_order_relaxed);
+    e.start.store(start, std::memory_order_relaxed);
+    e.aux.store(duration << 1 | (instant ? 1 : 0), std::memory_order_relaxed);
+    ring.next.store(i + 1, std::memory_order_release);
+}
+
+void QsTrace::miss(const char *what) {
+    s_misses.fetch_add(1, std::memory_order_relaxed);
+    if (!enabled())
+        return;
+    instant(what);
+    int64_t now = steadyNs();
+    if (now < s_holdoff_until.load(std::memory_order_relaxed))
+        return;
+    int64_t none = 0;
+    s_miss_at.compare_exchange_strong(none, now, std::memory_order_acq_rel);
+}
+
+uint64_t QsTrace::misses() { return s_misses.load(std::memory_order_relaxed); }
+
+bool QsTrace::dump(const std::string &path) {
+    FILE *f = std::fopen(path.c_str(), "w");
+    if (!f)
+        return false;
+
+    struct Copy {
+        const char *name;
+        uint64_t start;
+        uint64_t aux;
+    };
+    std::vector<Copy> copy(QS_DEFAULT_TRACE_EVENTS);
+
+    std::fprintf(f, "{\"displayTimeUnit\":\"ns\",\"traceEvents\":[\n");
+    bool first = true;
+    int count = s_ring_count.load(std::memory_order_acquire);
+    for (int tid = 0; tid < count; tid++) {
+        Ring &ring = s_rings[tid];
+        std::fprintf(f, "%s{\"name\":\"thread_name\",\"ph\":\"M\",\"pid\":1,\"tid\":%d,\"args\":{\"name\":\"%s\"}}",
+                     first ? "" : ",\n", tid, ring.name);
+        first = false;
+
+        uint64_t end = ring.next.load(std::memory_order_acquire);
+        uint64_t base = end > QS_DEFAULT_TRACE_EVENTS ? end - QS_DEFAULT_TRACE_EVENTS : 0;
+        for (uint64_t i = base; i < end; i++) {
+            const Event &e = ring.events[i & (QS_DEFAULT_TRACE_EVENTS - 1)];
+            copy[i - base] = {e.name.load(std::memory_order_relaxed), e.start.load(std::memory_order_relaxed),
+                              e.aux.load(std::memory_order_relaxed)};
+        }
+        // the owner may have overwritten slots up to index now - N while we
+        // copied; those are dropped
+        std::atomic_thread_fence(std::memory_order_acquire);
+        uint64_t now = ring.next.load(std::memory_order_relaxed);
+        uint64_t valid = now >= QS_DEFAULT_TRACE_EVENTS ? std::max(base, now - QS_DEFAULT_TRACE_EVENTS + 1) : base;
+
+        for (uint64_t i = valid; i < end; i++) {
+            const Copy &c = copy[i - base];
+            double ts = QsTicks::toSteadyNs(c.start) / 1000.0;
+            if (c.aux & 1)
+                std::fprintf(f, ",\n{\"name\":\"%s\",\"ph\":\"i\",\"s\":\"t\",\"pid\":1,\"tid\":%d,\"ts\":%.3f}",
+                             c.name, tid, ts);
+            else
+                std::fprintf(f, ",\n{\"name\":\"%s\",\"ph\":\"X\",\"pid\":1,\"tid\":%d,\"ts\":%.3f,\"dur\":%.3f}",
+                             c.name, tid, ts, QsTicks::toNs(c.aux >> 1) / 1000.0);
+        }
+    }
+    std::fprintf(f, "\n]}\n");
+    return std::fclose(f) == 0;
+}
+
+bool QsTrace::dumpNamed(const std::string &name) {
+    if (name.empty() || name == "." || name.find("..") != std::string::npos || name.find('/') != std::string::npos)
+        return false;
+    // an existing directory is fine; anything else fails at the fopen
+    mkdir(QS_DEFAULT_TRACE_DIR, 0755);
+    return dump(std::string(QS_DEFAULT_TRACE_DIR) + name);
+}
+
+std::string QsTrace::status() {
+    uint64_t events = 0;
+    int count = s_ring_count.load(std::memory_order_acquire);
+    for (int i = 0; i < count; i++)
+        events += std::min<uint64_t>(s_rings[i].next.load(std::memory_order_relaxed), QS_DEFAULT_TRACE_EVENTS);
+
+    char buf[96];
+    std::snprintf(buf, sizeof(buf), "%d threads %d events %llu misses %llu", enabled() ? 1 : 0, count,
+                  static_cast<unsigned long long>(events), static_cast<unsigned long long>(misses()));
+    return buf;
+}
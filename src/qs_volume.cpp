@@ -1,19 +1,42 @@
 #include "../include/qs_volume.hpp"
 
-QsVolume ::QsVolume() : m_volume_db(0), m_volume_val(0) {}
+QsVolume ::QsVolume() : m_volume_db(0), m_volume_val(0), m_version(0) {}
 
-void QsVolume ::process(qs_vect_cpx &src_dst) {
-    m_volume_db = QsGlobal::g_memory->getVolume();
+void QsVolume ::init() {
+    m_version = 0;
+    update(QsGlobal::g_memory->params());
+}
+
+void QsVolume ::update(const QsDspParams &params) {
+    if (params.version[pgVolume] == m_version)
+        return;
+    m_version = params.version[pgVolume];
+    m_volume_db = params.volume;
     m_volume_val = pow(10.0, m_volume_db / 20.0);
+}
+
+void QsVolume ::process(qs_vect_cpx &src_dst) {
     for (cpx_itr = src_dst.begin(); cpx_itr != src_dst.end(); cpx_itr++) {
         (*cpx_itr) *= m_volume_val;
     }
 }
 
 void QsVolume ::process(qs_vect_f &src_dst) {
-    m_volume_db = QsGlobal::g_memory->getVolume();
-    m_volume_val = pow(10.0, m_volume_db / 20.0);
     for (f_itr = src_dst.begin(); f_itr != src_dst.end(); f_itr++) {
         (*f_itr) *= m_volume_val;
     }
 }
+
+void QsVolume ::process(float *src_dst, int length) {
+    for (int i = 0; i < length; i++) {
+        src_dst[i] *= m_volume_val;
+    }
+}
+
+void QsVolume ::processToStereo(const float *src, float *dst, int length) {
+    for (int i = 0; i < length; i++) {
+        const float value = src[i] * m_volume_val;
+        dst[2 * i] = value;
+        dst[2 * i + 1] = value;
+    }
+}
@@ -0,0 +1,84 @@
+#include "../include/qs_worker_pool.hpp"
+
+QsWorkerPool::QsWorkerPool()
+    : m_job(nullptr), m_ctx(nullptr), m_count(0), m_next(0), m_active(0), m_generation(0), m_quit(false) {}
+
+QsWorkerPool::~QsWorkerPool() { stop(); }
+
+void QsWorkerPool::start(int threads) {
+    stop();
+    {
+        // workers start at generation 0: a job posted by an earlier start()
+        // must not look new to them
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit = false;
+        m_generation = 0;
+        m_active = 0;
+    }
+    for (int i = 1; i < threads; i++)
+        m_threads.emplace_back(&QsWorkerPool::workerLoop, this);
+}
+
+void QsWorkerPool::stop() {
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_quit = true;
+    }
+    m_cv_go.notify_all();
+    for (std::thread &t : m_threads) {
+        if (t.joinable())
+            t.join();
+    }
+    m_threads.clear();
+}
+
+void QsWorkerPool::drain() {
+    int index;
+    while ((index = m_next.fetch_add(1, std::memory_order_relaxed)) < m_count)
+        m_job(m_ctx, index);
+}
+
+void QsWorkerPool::run(Job job, void *ctx, int count) {
+    if (m_threads.empty()) {
+        for (int i = 0; i < count; i++)
+            job(ctx, i);
+        return;
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+        m_job = job;
+        m_ctx = ctx;
+        m_count = count;
+        m_next.store(0, std::memory_order_relaxed);
+        m_active = static_cast<int>(m_threads.size());
+        m_generation++;
+    }
+    m_cv_go.notify_all();
+
+    drain();
+
+    std::unique_lock<std::mutex> lock(m_mutex);
+    m_cv_done.wait(lock, [this]() { return m_active == 0; });
+}
+
+void QsWorkerPool::workerLoop() {
+    uint64_t seen = 0; // start() reset the generation before the thread was made
+    for (;;) {
+        {
+            std::unique_lock<std::mutex> lock(m_mutex);
+            m_cv_go.wait(lock, [this, seen]() { return m_quit || m_generation != seen; });
+            if (m_quit)
+                return;
+            seen = m_generation;
+        }
+
+        drain();
+
+        {
+            std::lock_guard<std::mutex> lock(m_mutex);
+            if (--m_active == 0)
+                m_cv_done.notify_one();
+        }
+    }
+}